@@ -0,0 +1,28 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "AgentFrame.h"
+
+void AgentFrame::Update(const AgentInfo& agentInfo)
+{
+	position = agentInfo.Position;
+	heading = Elite::FastMath::OrientationToVector(agentInfo.Orientation);
+	orientation = Elite::FastMath::WrapAngle(agentInfo.Orientation);
+	grabRangeSquared = agentInfo.GrabRange * agentInfo.GrabRange;
+	fovRangeSquared = agentInfo.FOV_Range * agentInfo.FOV_Range;
+	cosHalfFOV = Elite::FastMath::Cos(agentInfo.FOV_Angle / 2.f);
+}
+
+bool AgentFrame::IsInFOV(const Elite::Vector2& worldPosition) const
+{
+	const Elite::Vector2 offset = worldPosition - position;
+	const float distanceSquared = offset.MagnitudeSquared();
+	if (distanceSquared > fovRangeSquared)
+		return false;
+
+	//cos(angle to the heading) >= cosHalfFOV, squared to skip the square root
+	const float along = offset.Dot(heading);
+	const float limitSquared = cosHalfFOV * cosHalfFOV * distanceSquared;
+	if (cosHalfFOV >= 0.f)
+		return along >= 0.f && along * along >= limitSquared;
+	return along >= 0.f || along * along <= limitSquared;
+}
@@ -0,0 +1,46 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// AgentFrame.h: What the behaviors derive from the AgentInfo, worked out once per tick
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+
+//-----------------------------------------------------------------
+// AGENT FRAME
+//-----------------------------------------------------------------
+// Filled in right after Agent_GetInfo, behaviors read it through a pointer in the blackboard
+// instead of copying the AgentInfo & redoing the trig. Ranges are only kept squared, so
+// they can only be compared against a DistanceSquared. 32 bytes, so a single cache line.
+struct AgentFrame
+{
+	Elite::Vector2 position = {};
+	Elite::Vector2 heading = { 0.f, -1.f }; //Unit vector the agent faces, x axis of agent space
+	float orientation = 0.f; //In [-pi, pi]
+	float grabRangeSquared = 0.f;
+	float fovRangeSquared = 0.f;
+	float cosHalfFOV = 1.f; //Cosine of half the FOV cone's angle
+
+	void Update(const AgentInfo& agentInfo);
+
+	//x along the heading, y to its left
+	Elite::Vector2 ToLocal(const Elite::Vector2& worldPosition) const
+	{
+		const Elite::Vector2 offset = worldPosition - position;
+		return Elite::Vector2{ offset.Dot(heading), heading.Cross(offset) };
+	}
+	//Same as ToLocal as a matrix, for batches: GetWorldToLocal().TransformPoints(xs, ys, localXs, localYs, count)
+	Matrix2x3 GetWorldToLocal() const
+	{
+		return Matrix2x3{ heading.x, -heading.y, heading.y, heading.x, -position.Dot(heading), -heading.Cross(position) };
+	}
+	//Angle to turn over to face the target, in [-pi, pi]
+	float GetAngleTo(const Elite::Vector2& target) const
+	{
+		const Elite::Vector2 local = ToLocal(target);
+		return Elite::FastMath::Atan2(local.y, local.x);
+	}
+
+	bool IsInGrabRange(const Elite::Vector2& worldPosition) const { return Elite::DistanceSquared(worldPosition, position) < grabRangeSquared; }
+	bool IsInFOV(const Elite::Vector2& worldPosition) const;
+};
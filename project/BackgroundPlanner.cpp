@@ -0,0 +1,193 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "BackgroundPlanner.h"
+
+//-----------------------------------------------------------------
+// LOOT ROUTE PLAN
+//-----------------------------------------------------------------
+bool LootRoutePlan::GetNextItem(ItemInfo& item) const
+{
+	for (const LootRoutePlanner::Stop& stop : tour)
+	{
+		if (stop.house == -1)
+		{
+			item = stop.item;
+			return true;
+		}
+	}
+	return false;
+}
+
+int LootRoutePlan::GetNextHouse() const
+{
+	for (const LootRoutePlanner::Stop& stop : tour)
+	{
+		if (stop.house != -1)
+			return stop.house;
+	}
+	return -1;
+}
+
+//-----------------------------------------------------------------
+// BACKGROUND PLANNER
+//-----------------------------------------------------------------
+BackgroundPlanner::BackgroundPlanner()
+{
+	m_Jobs.AddJob(&m_LootRoute, "Loot route improvement", PlanningBudget);
+}
+
+BackgroundPlanner::~BackgroundPlanner()
+{
+	Stop();
+}
+
+void BackgroundPlanner::Start()
+{
+	if (m_Thread.joinable())
+		return;
+
+	m_IsRunning.store(true, std::memory_order_release);
+	m_Thread = std::thread{ &BackgroundPlanner::Run, this };
+}
+
+void BackgroundPlanner::Stop()
+{
+	m_IsRunning.store(false, std::memory_order_release);
+	Wake();
+	if (m_Thread.joinable())
+		m_Thread.join();
+}
+
+void BackgroundPlanner::SetWalls(const WorldInfo& worldInfo, const std::vector<WallTree::Segment>& walls)
+{
+	m_PendingWorldInfo = worldInfo;
+	m_PendingWalls = walls;
+	m_AreWallsPending = true;
+}
+
+void BackgroundPlanner::SubmitSnapshot(const WorldSnapshot& world)
+{
+	Snapshot* pSnapshot = m_Snapshots.BeginPush();
+	if (!pSnapshot)
+	{
+		++m_DroppedSnapshots;
+		return;
+	}
+
+	pSnapshot->id = m_NextSnapshotId++;
+	pSnapshot->submitTime = Elite::ProfileClock::now();
+	pSnapshot->world = world;
+
+	pSnapshot->hasNewWalls = m_AreWallsPending;
+	if (m_AreWallsPending)
+	{
+		pSnapshot->worldInfo = m_PendingWorldInfo;
+		pSnapshot->walls = m_PendingWalls;
+		m_AreWallsPending = false;
+	}
+
+	m_Snapshots.EndPush();
+	Wake();
+}
+
+const LootRoutePlan& BackgroundPlanner::AcquireLootRoute()
+{
+	if (m_LootRoutes.Acquire())
+		++m_AcquiredPlans;
+	return m_LootRoutes.GetFront();
+}
+
+void BackgroundPlanner::PrintTickReport() const
+{
+	printf("Background planner: %u snapshots sent, %u dropped, %u plans received\n",
+		m_NextSnapshotId - 1, m_DroppedSnapshots, m_AcquiredPlans);
+}
+
+void BackgroundPlanner::PrintReport() const
+{
+	m_SnapshotToPlanStats.Print("Snapshot to plan latency (us)");
+	m_LootRoute.GetUpdateStats().Print("Loot route upkeep per snapshot (us)");
+	printf("Loot route: %u improvements, distance oracle: %u queries, %u floods\n",
+		m_LootRoute.GetImprovementCount(), m_DistanceOracle.GetQueryCount(), m_DistanceOracle.GetFloodCount());
+	m_Jobs.PrintReport();
+}
+
+void BackgroundPlanner::Run()
+{
+	while (m_IsRunning.load(std::memory_order_acquire))
+	{
+		const bool hasNewSnapshot = ConsumeSnapshots();
+		m_Jobs.Tick();
+
+		if (hasNewSnapshot || m_LootRoute.GetImprovementCount() != m_PublishedImprovementCount)
+		{
+			PublishLootRoute();
+		}
+		else if (m_LootRoute.IsDone())
+		{
+			//Nothing to do until the next tick
+			Park();
+		}
+	}
+}
+
+void BackgroundPlanner::Park()
+{
+	//A snapshot sent since the last ConsumeSnapshots left the flag set, so it's never slept through
+	std::unique_lock<std::mutex> lock{ m_ParkingMutex };
+	m_ParkingCondition.wait(lock, [this]()
+		{
+			return m_IsWakePending || !m_IsRunning.load(std::memory_order_acquire);
+		});
+	m_IsWakePending = false;
+}
+
+void BackgroundPlanner::Wake()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_ParkingMutex };
+		m_IsWakePending = true;
+	}
+	m_ParkingCondition.notify_one();
+}
+
+bool BackgroundPlanner::ConsumeSnapshots()
+{
+	//Walls of every snapshot are applied, only the newest world matters
+	bool hasNewSnapshot = false;
+	for (const Snapshot* pSnapshot = m_Snapshots.BeginPop(); pSnapshot; pSnapshot = m_Snapshots.BeginPop())
+	{
+		if (pSnapshot->hasNewWalls)
+			m_DistanceOracle.Initialize(pSnapshot->worldInfo, pSnapshot->walls);
+
+		m_LatestWorld = pSnapshot->world;
+		m_PlannedSnapshotId = pSnapshot->id;
+		m_PlannedSubmitTime = pSnapshot->submitTime;
+		hasNewSnapshot = true;
+
+		m_Snapshots.EndPop();
+	}
+
+	if (hasNewSnapshot)
+	{
+		LootRoutePlanner::GatherStops(m_LatestWorld, m_LatestStops);
+		m_LootRoute.Update(m_LatestWorld, m_LatestStops, m_DistanceOracle);
+		m_IsLatencyPending = true;
+	}
+	return hasNewSnapshot;
+}
+
+void BackgroundPlanner::PublishLootRoute()
+{
+	LootRoutePlan& plan = m_LootRoutes.GetBack();
+	m_LootRoute.GetTour(plan.tour);
+	plan.snapshotId = m_PlannedSnapshotId;
+	m_LootRoutes.Publish();
+	m_PublishedImprovementCount = m_LootRoute.GetImprovementCount();
+
+	if (m_IsLatencyPending)
+	{
+		m_SnapshotToPlanStats.AddSample(Elite::ElapsedMicroseconds(m_PlannedSubmitTime));
+		m_IsLatencyPending = false;
+	}
+}
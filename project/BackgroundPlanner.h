@@ -0,0 +1,117 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// BackgroundPlanner.h: Runs the heavy planning on its own thread, away from the tick
+/*=============================================================================*/
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Exam_HelperStructs.h"
+#include "EConcurrency.h"
+#include "ETimeSlicing.h"
+#include "GridDistanceOracle.h"
+#include "LootRoutePlanner.h"
+#include "WorldModel.h"
+
+//-----------------------------------------------------------------
+// LOOT ROUTE PLAN
+//-----------------------------------------------------------------
+//What the planning thread publishes, read-only for the tick thread
+struct LootRoutePlan
+{
+	std::vector<LootRoutePlanner::Stop> tour = {};
+	unsigned int snapshotId = 0; //Newest snapshot the plan is based on
+
+	//First item on the tour, false when the tour has none
+	bool GetNextItem(ItemInfo& item) const;
+	//First house on the tour, -1 when the tour has none
+	int GetNextHouse() const;
+};
+
+//-----------------------------------------------------------------
+// BACKGROUND PLANNER
+//-----------------------------------------------------------------
+// The tick thread hands world snapshots to the planning thread through a lock-free ring,
+// plans come back through a triple buffer. A snapshot shares everything that didn't
+// change with the previous one, so sending one doesn't copy the world. The tick thread never
+// waits: a full ring drops the snapshot (the next tick sends a newer one) and until a new
+// plan is published the previous one keeps being followed. A planning thread with nothing
+// left to improve parks until the next snapshot, the tick thread only takes the parking lock
+// long enough to flag that one was sent.
+// The distance oracle & the route planner only ever get touched by the planning thread.
+class BackgroundPlanner final
+{
+public:
+	static const unsigned int SnapshotCapacity = 4;
+	static constexpr double PlanningBudget = 2000.0; //Microseconds of planning between two looks at the ring
+
+	BackgroundPlanner();
+	~BackgroundPlanner();
+
+	BackgroundPlanner(const BackgroundPlanner&) = delete;
+	BackgroundPlanner& operator=(const BackgroundPlanner&) = delete;
+
+	void Start();
+	//Joins the planning thread
+	void Stop();
+
+	//Tick thread, sent along with the next snapshot
+	void SetWalls(const WorldInfo& worldInfo, const std::vector<WallTree::Segment>& walls);
+	//Tick thread
+	void SubmitSnapshot(const WorldSnapshot& world);
+	//Tick thread, stays valid until the next call
+	const LootRoutePlan& AcquireLootRoute();
+
+	//Tick thread
+	void PrintTickReport() const;
+	//Only once the planning thread is stopped
+	void PrintReport() const;
+
+private:
+	struct Snapshot
+	{
+		unsigned int id;
+		Elite::ProfileClock::time_point submitTime;
+		WorldSnapshot world;
+
+		bool hasNewWalls;
+		WorldInfo worldInfo;
+		std::vector<WallTree::Segment> walls;
+	};
+
+	Elite::SpscRing<Snapshot, SnapshotCapacity> m_Snapshots{};
+	Elite::TripleBuffer<LootRoutePlan> m_LootRoutes{};
+	std::thread m_Thread{};
+	std::atomic<bool> m_IsRunning{ false };
+	std::mutex m_ParkingMutex{};
+	std::condition_variable m_ParkingCondition{};
+	bool m_IsWakePending = false; //Guarded by the mutex, set on every snapshot sent
+
+	//Tick thread only
+	unsigned int m_NextSnapshotId = 1;
+	unsigned int m_DroppedSnapshots = 0;
+	unsigned int m_AcquiredPlans = 0;
+	bool m_AreWallsPending = false;
+	WorldInfo m_PendingWorldInfo = {};
+	std::vector<WallTree::Segment> m_PendingWalls = {};
+
+	//Planning thread only
+	GridDistanceOracle m_DistanceOracle{};
+	LootRoutePlanner m_LootRoute{};
+	Elite::BudgetedJobScheduler m_Jobs{};
+	WorldSnapshot m_LatestWorld{};
+	std::vector<LootRoutePlanner::Stop> m_LatestStops = {};
+	unsigned int m_PlannedSnapshotId = 0;
+	Elite::ProfileClock::time_point m_PlannedSubmitTime{};
+	bool m_IsLatencyPending = false;
+	unsigned int m_PublishedImprovementCount = 0;
+	Elite::SampleStats m_SnapshotToPlanStats{}; //Microseconds
+
+	void Run();
+	void Park();
+	void Wake();
+	//True when there was a new snapshot
+	bool ConsumeSnapshots();
+	void PublishLootRoute();
+};
@@ -10,8 +10,18 @@
 //-----------------------------------------------------------------
 #include "EliteMath/EMath.h"
 #include "EBehaviorTree.h"
+#include "EGoap.h"
 #include "Stucts.h"
-#include "IExaminterface.h"
+#include "Inventory.h"
+#include "SteeringPipeline.h"
+#include "PurgeZoneMemory.h"
+#include "InfluenceMap.h"
+#include "BackgroundPlanner.h"
+#include "HouseRegistry.h"
+#include "ItemMemory.h"
+#include "WorldModel.h"
+#include "AgentFrame.h"
+#include "IExamInterface.h"
 using namespace Elite;
 //-----------------------------------------------------------------
 // Behaviors
@@ -20,104 +30,97 @@ using namespace Elite;
 // Helpers //
 void RemoveItemFromMemory(const ItemInfo& item, Elite::Blackboard* pBlackboard)
 {
-	std::vector<ItemInfo>* pItemMemory = nullptr;
+	ItemMemory* pItemMemory = nullptr;
+	WorldModel* pWorldModel = nullptr;
 	pBlackboard->GetData("ItemMemory", pItemMemory);
+	pBlackboard->GetData("WorldModel", pWorldModel);
 
-	for (ItemInfo& itemInMemory : (*pItemMemory))
-	{
-		if (itemInMemory.Location == item.Location)
-		{
-			itemInMemory = (*pItemMemory)[(*pItemMemory).size() - 1];
-			pItemMemory->pop_back();
-			break;
-		}
-	}
+	const int removed = pItemMemory->Remove(item.Location);
+	if (removed != -1)
+		pWorldModel->RemoveItem(removed);
 }
 
 // MOVEMENT
+Vector2 GetSeekVelocity(Elite::Blackboard* pBlackboard, const Vector2& target)
+{
+	AgentInfo agentInfo{};
+	IExamInterface* pluginInterface = nullptr;
+	pBlackboard->GetData("AgentInfo", agentInfo);
+	pBlackboard->GetData("PluginInterface", pluginInterface);
+
+	Vector2 velocity = pluginInterface->NavMesh_GetClosestPathPoint(target) - agentInfo.Position;
+	velocity.Normalize();
+	velocity *= agentInfo.MaxLinearSpeed;
+
+	return velocity;
+}
+float GetFaceAngularVelocity(const AgentFrame& agentFrame, const Vector2& target)
+{
+	// the angle in agent space is already the shortest way round
+	const float deltaAngle = agentFrame.GetAngleTo(target);
+
+	// multiply desired by some value to make it go as fast as possible (30.f)
+	return deltaAngle * 50.f;
+}
 BehaviorState Seek(Elite::Blackboard* pBlackboard)
 {
 	Vector2 targetPos{};
-	AgentInfo agentInfo{};
-	SteeringPlugin_Output output{};
 	bool canRun = false;
-	IExamInterface* pluginInterface = nullptr;
+	SteeringPipeline* pSteering = nullptr;
 
 	bool dataAvailable = pBlackboard->GetData("Target", targetPos)
-		&& pBlackboard->GetData("AgentInfo", agentInfo)
 		&& pBlackboard->GetData("IsRunning", canRun)
-		&& pBlackboard->GetData("PluginInterface", pluginInterface);
+		&& pBlackboard->GetData("SteeringPipeline", pSteering);
 
 	if (!dataAvailable)
 	{
 		return Failure;
 	}
 
-	targetPos = pluginInterface->NavMesh_GetClosestPathPoint(targetPos);
-
-	output.RunMode = canRun;
-	output.LinearVelocity = targetPos - agentInfo.Position;
-	output.LinearVelocity.Normalize();
-	output.LinearVelocity *= agentInfo.MaxLinearSpeed;
-
-	//if (DistanceSquared(targetPos, agentInfo.Position) < exp2f(2.f))
-	//{
-	//	output.LinearVelocity = Elite::ZeroVector2;
-	//}
+	// go around the purge zones we know of instead of walking into them
+	AgentInfo agentInfo{};
+	PurgeZoneMemory* pPurgeZones = nullptr;
+	pBlackboard->GetData("AgentInfo", agentInfo);
+	pBlackboard->GetData("PurgeZoneMemory", pPurgeZones);
+	targetPos = pPurgeZones->GetSafeTarget(agentInfo.Position, targetPos, agentInfo.AgentSize);
 
-	pBlackboard->ChangeData("SteeringOutput", output);
+	pSteering->AddLinear(GetSeekVelocity(pBlackboard, targetPos), 1.f, SteeringPriority::Normal, canRun);
 	return Success;
 }
 BehaviorState Flee(Elite::Blackboard* pBlackboard)
 {
-	Seek(pBlackboard);
-
-	SteeringPlugin_Output output{};
-	pBlackboard->GetData("SteeringOutput", output);
-
-	output.LinearVelocity *= -1;
+	Vector2 targetPos{};
+	bool canRun = false;
+	SteeringPipeline* pSteering = nullptr;
+	pBlackboard->GetData("Target", targetPos);
+	pBlackboard->GetData("IsRunning", canRun);
+	pBlackboard->GetData("SteeringPipeline", pSteering);
 
-	pBlackboard->ChangeData("SteeringOutput", output);
+	pSteering->AddLinear(GetSeekVelocity(pBlackboard, targetPos) * -1.f, 1.f, SteeringPriority::High, canRun);
 	return Success;
 }
 BehaviorState Face(Elite::Blackboard* pBlackboard)
 {
 	Vector2 target{};
-	AgentInfo agentInfo{};
+	const AgentFrame* pAgentFrame = nullptr;
+	SteeringPipeline* pSteering = nullptr;
 	pBlackboard->GetData("Target", target);
-	pBlackboard->GetData("AgentInfo", agentInfo);
-
-	SteeringPlugin_Output output{};
-
-	const Vector2 toTarget{ target - agentInfo.Position };
-
-	const float angleTo{ atan2f(toTarget.y, toTarget.x) + float(E_PI_2) };
-	float angleFrom{ agentInfo.Orientation };
-	
-	angleFrom = atan2f(sinf(angleFrom), cosf(angleFrom)); // makes angle between 0 & 360deg
-
-	float deltaAngle = angleTo - angleFrom;
-
-	constexpr float Pi2 = float(E_PI) * 2.f;
-	if (deltaAngle > E_PI)
-		deltaAngle -= Pi2;
-	else if (deltaAngle < -E_PI)
-		deltaAngle += Pi2;
-
-	// multiply desired by some value to make it go as fast as possible (30.f)
-	output.AngularVelocity = deltaAngle * 50.f;
+	pBlackboard->GetData("AgentFrame", pAgentFrame);
+	pBlackboard->GetData("SteeringPipeline", pSteering);
 
-	output.AutoOrient = false;
-
-	pBlackboard->ChangeData("SteeringOutput", output);
+	pSteering->AddAngular(GetFaceAngularVelocity(*pAgentFrame, target), 1.f, SteeringPriority::High);
 	return Success;
 }
 BehaviorState StrafeAndTurn(Elite::Blackboard* pBlackboard)
 {
 	StrafeInfo strafeInfo{};
 	AgentInfo agentInfo{};
+	const AgentFrame* pAgentFrame = nullptr;
+	SteeringPipeline* pSteering = nullptr;
 	pBlackboard->GetData("StrafeInfo", strafeInfo);
 	pBlackboard->GetData("AgentInfo", agentInfo);
+	pBlackboard->GetData("AgentFrame", pAgentFrame);
+	pBlackboard->GetData("SteeringPipeline", pSteering);
 
 	if (!strafeInfo.isStrafing)
 	{
@@ -137,24 +140,11 @@ BehaviorState StrafeAndTurn(Elite::Blackboard* pBlackboard)
 		}
 	}
 
-	// seek in the direction we were going
-	Vector2 seekTarget = agentInfo.Position + (strafeInfo.startLinearVelocity * 5);
-	pBlackboard->ChangeData("Target", seekTarget);
-	Seek(pBlackboard);
-
-	SteeringPlugin_Output seekOutput{};
-	pBlackboard->GetData("SteeringOutput", seekOutput);
-
-	// get point to face to
-	Vector2 faceTarget = agentInfo.Position + Elite::OrientationToVector(strafeInfo.endOrientation);
-	pBlackboard->ChangeData("Target", faceTarget);
-	Face(pBlackboard);
-
-	SteeringPlugin_Output output{};
-	pBlackboard->GetData("SteeringOutput", output);
-	
-	output.LinearVelocity = seekOutput.LinearVelocity;
-	pBlackboard->ChangeData("SteeringOutput", output);
+	// keep going in the direction we were going while turning around
+	const Vector2 seekTarget = agentInfo.Position + (strafeInfo.startLinearVelocity * 5);
+	const Vector2 faceTarget = agentInfo.Position + Elite::OrientationToVector(strafeInfo.endOrientation);
+	pSteering->AddLinear(GetSeekVelocity(pBlackboard, seekTarget), 1.f, SteeringPriority::Normal);
+	pSteering->AddAngular(GetFaceAngularVelocity(*pAgentFrame, faceTarget), 1.f, SteeringPriority::High);
 	return Success;
 }
 
@@ -216,13 +206,12 @@ BehaviorState PickupItem(Elite::Blackboard* pBlackboard)
 {
 	std::list<EntityInfo>* itemsInFov = nullptr;
 	IExamInterface* pluginInterface = nullptr;
-	AgentInfo agentInfo{};
+	const AgentFrame* pAgentFrame = nullptr;
 	Inventory* inventory = nullptr;
 	pBlackboard->GetData("ItemsInFOV", itemsInFov);
 	pBlackboard->GetData("PluginInterface", pluginInterface);
-	pBlackboard->GetData("AgentInfo", agentInfo);
+	pBlackboard->GetData("AgentFrame", pAgentFrame);
 	pBlackboard->GetData("Inventory", inventory);
-	const float squaredGrabRange = exp2f(agentInfo.GrabRange);
 
 	EntityInfo itemToGrab{};
 
@@ -231,19 +220,7 @@ BehaviorState PickupItem(Elite::Blackboard* pBlackboard)
 		ItemInfo itemInfo;
 		pluginInterface->Item_GetInfo(item, itemInfo);
 
-		if (inventory->currentGuns < inventory->maxGuns && itemInfo.Type == eItemType::PISTOL)
-		{
-			itemToGrab = item;
-			break;
-		}
-
-		if (inventory->currentMedkits < inventory->maxMedkits && itemInfo.Type == eItemType::MEDKIT)
-		{
-			itemToGrab = item;
-			break;
-		}
-
-		if (inventory->currentFood < inventory->maxFood && itemInfo.Type == eItemType::FOOD)
+		if (inventory->NeedsItem(itemInfo.Type) && !inventory->IsRefused(itemInfo.ItemHash))
 		{
 			itemToGrab = item;
 			break;
@@ -253,54 +230,21 @@ BehaviorState PickupItem(Elite::Blackboard* pBlackboard)
 	if (itemToGrab.EntityHash != 0)
 	{
 		ItemInfo item;
-		if (DistanceSquared(itemToGrab.Location, agentInfo.Position) < squaredGrabRange && pluginInterface->Item_Grab(itemToGrab, item))
+		if (pAgentFrame->IsInGrabRange(itemToGrab.Location) && pluginInterface->Item_Grab(itemToGrab, item))
 		{
-			unsigned int index = 0;
-			switch (item.Type)
-			{
-			case eItemType::PISTOL:
-				index = inventory->currentGuns;
-				break;
-			case eItemType::MEDKIT:
-				index = inventory->currentMedkits;
-				break;
-			case eItemType::FOOD:
-				index = inventory->currentFood;
-				break;
-			}
-
-			unsigned int indexOffset = 0;
-			switch (item.Type)
+			// no free slot for it or the interface refused, forget it so it isn't fetched over & over
+			if (!inventory->AddItem(item))
 			{
-			case eItemType::MEDKIT:
-				indexOffset = inventory->maxGuns;
-				break;
-			case eItemType::FOOD:
-				indexOffset = inventory->maxGuns + inventory->maxMedkits;
-				break;
+				if (inventory->MarkRefused(item.ItemHash))
+					printf("WARNING: Grabbed item of type %d doesn't fit in the inventory, leaving it be\n", static_cast<int>(item.Type));
+				pBlackboard->ChangeData("ItemBeingFetched", ItemInfo{});
+				RemoveItemFromMemory(item, pBlackboard);
+				return Failure;
 			}
 
-			pluginInterface->Inventory_AddItem(indexOffset + index, item);
-			inventory->inventorySlots[indexOffset + index] = item;
-
-#pragma region Delete Item from memory and fetch
 			// Remove item from memory & reset fetch
 			pBlackboard->ChangeData("ItemBeingFetched", ItemInfo{});
 			RemoveItemFromMemory(item, pBlackboard);
-#pragma endregion
-
-			switch (item.Type)
-			{
-			case eItemType::PISTOL:
-				inventory->currentGuns++;
-				break;
-			case eItemType::MEDKIT:
-				inventory->currentMedkits++;
-				break;
-			case eItemType::FOOD:
-				inventory->currentFood++;
-				break;
-			}
 		}
 
 		pBlackboard->ChangeData("Target", itemToGrab.Location);
@@ -332,20 +276,11 @@ bool SeesGarbage(Elite::Blackboard* pBlackboard)
 bool GarbageIsInGrabRange(Elite::Blackboard* pBlackboard)
 {
 	ItemInfo garbageItem{};
-	AgentInfo agentInfo{};
+	const AgentFrame* pAgentFrame = nullptr;
 	pBlackboard->GetData("GarbageSeen", garbageItem);
-	pBlackboard->GetData("AgentInfo", agentInfo);
-	
+	pBlackboard->GetData("AgentFrame", pAgentFrame);
 
-	if (garbageItem.ItemHash != 0)
-	{
-		const float sqrGrabRange = exp2f(agentInfo.GrabRange);
-		if (DistanceSquared(agentInfo.Position, garbageItem.Location) < sqrGrabRange)
-		{
-			return true;
-		}
-	}
-	return false;
+	return garbageItem.ItemHash != 0 && pAgentFrame->IsInGrabRange(garbageItem.Location);
 }
 BehaviorState DestroyGarbageInRange(Elite::Blackboard* pBlackboard)
 {
@@ -399,76 +334,29 @@ bool IsInNeedOfItem(Elite::Blackboard* pBlackboard)
 	Inventory* inventory = nullptr;
 	pBlackboard->GetData("Inventory", inventory);
 
-	bool inNeedOfPistol = inventory->currentGuns < inventory->maxGuns;
-	bool inNeedOfMedkit = inventory->currentMedkits < inventory->maxMedkits;
-	bool inNeedOfFood = inventory->currentFood < inventory->maxFood;
-
-	return inNeedOfPistol || inNeedOfMedkit || inNeedOfFood;
+	return inventory->NeedsAnyItem();
 }
 bool IsANeededItemClose(Elite::Blackboard* pBlackboard)
 {
-	Inventory* inventory = nullptr;
-	std::vector<ItemInfo>* pItemMemory = nullptr;
+	const LootRoutePlan* pLootRoute = nullptr;
 	float itemFetchMaxRange = 0;
-	AgentInfo agentInfo{};
+	const AgentFrame* pAgentFrame = nullptr;
 
-	pBlackboard->GetData("Inventory", inventory);
-	pBlackboard->GetData("ItemMemory", pItemMemory);
+	pBlackboard->GetData("LootRoute", pLootRoute);
 	pBlackboard->GetData("ItemFetchMaxRange", itemFetchMaxRange);
-	pBlackboard->GetData("AgentInfo", agentInfo);
-
-	const float sqrMaxRange = exp2f(itemFetchMaxRange);
-
-	bool inNeedOfPistol = inventory->currentGuns < inventory->maxGuns;
-	bool inNeedOfMedkit = inventory->currentMedkits < inventory->maxMedkits;
-	bool inNeedOfFood = inventory->currentFood < inventory->maxFood;
+	pBlackboard->GetData("AgentFrame", pAgentFrame);
 
-	ItemInfo itemInRange{};
-
-	for (ItemInfo& item : (*pItemMemory))
-	{
-		if (DistanceSquared(item.Location, agentInfo.Position) > sqrMaxRange)
-		{
-			continue;
-		}
-
-		if (inNeedOfPistol && item.Type == eItemType::PISTOL)
-		{
-			itemInRange = item;
-			break;
-		}
-		else if (inNeedOfMedkit && item.Type == eItemType::MEDKIT)
-		{
-			itemInRange = item;
-			break;
-		}
-		else if (inNeedOfFood && item.Type == eItemType::FOOD)
-		{
-			itemInRange = item;
-			break;
-		}
-	}
+	const float sqrMaxRange = itemFetchMaxRange * itemFetchMaxRange;
 
-	if (itemInRange.ItemHash != 0)
+	// the route only holds items we need that aren't in a purge zone, in the order to pick them up
+	ItemInfo nextItem{};
+	if (pLootRoute->GetNextItem(nextItem) && DistanceSquared(nextItem.Location, pAgentFrame->position) <= sqrMaxRange)
 	{
-		pBlackboard->ChangeData("ItemBeingFetched", itemInRange);
+		pBlackboard->ChangeData("ItemBeingFetched", nextItem);
 		return true;
 	}
 	return false;
 }
-BehaviorState SetNeededItemAsTarget(Elite::Blackboard* pBlackboard)
-{
-	ItemInfo neededItem{};
-	pBlackboard->GetData("ItemBeingFetched", neededItem);
-
-	if (neededItem.ItemHash == 0)
-	{
-		return Failure;
-	}
-
-	pBlackboard->ChangeData("Target", neededItem.Location);
-	return Success;
-}
 
 bool IsHurt(Elite::Blackboard* pBlackboard)
 {
@@ -484,59 +372,30 @@ bool ShouldUseMedkit(Elite::Blackboard* pBlackboard)
 	const float maxHealth = 10.f;
 	AgentInfo agentInfo{};
 	Inventory* inventory = nullptr;
-	IExamInterface* pluginInterface = nullptr;
 
 	pBlackboard->GetData("AgentInfo", agentInfo);
 	pBlackboard->GetData("Inventory", inventory);
-	pBlackboard->GetData("PluginInterface", pluginInterface);
 
-	if (inventory->currentMedkits != 0)
-	{
-		const float damageTaken = maxHealth - agentInfo.Health;
+	const int medkitToUse = inventory->GetBestMedkit(maxHealth - agentInfo.Health);
+	pBlackboard->ChangeData("MedkitToUse", medkitToUse);
 
-		for (unsigned int i = inventory->maxGuns; i < (inventory->maxGuns + inventory->maxMedkits); i++)
-		{
-			if (inventory->inventorySlots[i].ItemHash != 0)
-			{
-				const int healthRestored = pluginInterface->Medkit_GetHealth(inventory->inventorySlots[i]);
-				if (healthRestored < damageTaken)
-				{
-					pBlackboard->ChangeData("MedkitToUse", int(i));
-					return true;
-				}
-			}
-		}
-		pBlackboard->ChangeData("MedkitToUse", -1);
-		return false;
-	}
-	else
-	{
-		pBlackboard->ChangeData("MedkitToUse", -1);
-		return false;
-	}
+	return medkitToUse >= 0;
 }
 BehaviorState UseMedkit(Elite::Blackboard* pBlackboard)
 {
 	int indexOfMedkitToUse = 0;
 	Inventory* inventory = nullptr;
-	IExamInterface* pluginInterface = nullptr;
 
 	pBlackboard->GetData("MedkitToUse", indexOfMedkitToUse);
 	pBlackboard->GetData("Inventory", inventory);
-	pBlackboard->GetData("PluginInterface", pluginInterface);
 
-	if (unsigned int(indexOfMedkitToUse) < inventory->maxGuns 
-		|| unsigned int(indexOfMedkitToUse) >= inventory->maxGuns + inventory->maxMedkits 
-		|| inventory->inventorySlots[indexOfMedkitToUse].ItemHash == 0)
+	if (!inventory->IsSlotOfType(indexOfMedkitToUse, eItemType::MEDKIT))
 	{
 		// if index isn't a medkit index or if the item at the index doesn't exist
 		return Failure;
 	}
 
-	pluginInterface->Inventory_UseItem(indexOfMedkitToUse);
-	pluginInterface->Inventory_RemoveItem(indexOfMedkitToUse);
-	inventory->inventorySlots[indexOfMedkitToUse] = ItemInfo{};
-	inventory->currentMedkits--;
+	inventory->UseItem(indexOfMedkitToUse);
 	pBlackboard->ChangeData("MedkitToUse", -1);
 
 	return Success;
@@ -554,52 +413,37 @@ bool IsHungry(Elite::Blackboard* pBlackboard)
 bool ShouldEat(Elite::Blackboard* pBlackboard)
 {
 	const float maxEnergy = 10.f;
-	const unsigned int foodIndex = 4;
 	AgentInfo agentInfo{};
 	Inventory* inventory = nullptr;
-	IExamInterface* pluginInterface = nullptr;
 
 	pBlackboard->GetData("AgentInfo", agentInfo);
 	pBlackboard->GetData("Inventory", inventory);
-	pBlackboard->GetData("PluginInterface", pluginInterface);
-
-	if (inventory->currentFood != 0)
-	{
-		const float energyNeed = maxEnergy - agentInfo.Energy;
 
-		if (inventory->inventorySlots[foodIndex].ItemHash != 0)
-		{
-			const int energyRestored = pluginInterface->Food_GetEnergy(inventory->inventorySlots[foodIndex]);
-			if (energyRestored < energyNeed)
-			{
-				return true;
-			}
-		}
-		return false;
-	}
-	else
+	const int foodToUse = inventory->GetAnyFood();
+	if (foodToUse >= 0 && inventory->GetValue(foodToUse) < maxEnergy - agentInfo.Energy)
 	{
-		return false;
+		pBlackboard->ChangeData("FoodToUse", foodToUse);
+		return true;
 	}
+
+	pBlackboard->ChangeData("FoodToUse", -1);
+	return false;
 }
 BehaviorState UseFood(Elite::Blackboard* pBlackboard)
 {
-	int indexOfFoodToUse = 4;
+	int indexOfFoodToUse = 0;
 	Inventory* inventory = nullptr;
-	IExamInterface* pluginInterface = nullptr;
 
+	pBlackboard->GetData("FoodToUse", indexOfFoodToUse);
 	pBlackboard->GetData("Inventory", inventory);
-	pBlackboard->GetData("PluginInterface", pluginInterface);
 
-	if (inventory->inventorySlots[indexOfFoodToUse].ItemHash == 0)
+	if (!inventory->IsSlotOfType(indexOfFoodToUse, eItemType::FOOD))
 	{
 		return Failure;
 	}
 
-	pluginInterface->Inventory_UseItem(indexOfFoodToUse);
-	pluginInterface->Inventory_RemoveItem(indexOfFoodToUse);
-	inventory->inventorySlots[indexOfFoodToUse] = ItemInfo{};
-	inventory->currentFood--;
+	inventory->UseItem(indexOfFoodToUse);
+	pBlackboard->ChangeData("FoodToUse", -1);
 
 	return Success;
 }
@@ -613,43 +457,30 @@ bool SeesPurgeZone(Elite::Blackboard* pBlackboard)
 }
 bool IsInPurgeZone(Elite::Blackboard* pBlackboard)
 {
-	std::list<PurgeZoneInfo>* purgeZoneInFOV = nullptr;
-	PurgeZoneInfo* dangerousPurgeZone = nullptr;
-	AgentInfo agentInfo{};
-
-	pBlackboard->GetData("PurgeZonesInFOV", purgeZoneInFOV);
-	pBlackboard->GetData("DangerousPurgeZone", dangerousPurgeZone);
-	pBlackboard->GetData("AgentInfo", agentInfo);
-
-	bool isInsidePurgeZone = false;
-
-	for (PurgeZoneInfo& purgeZone : (*purgeZoneInFOV))
-	{
-		if (DistanceSquared(purgeZone.Center, agentInfo.Position) < exp2f(purgeZone.Radius))
-		{
-			dangerousPurgeZone = &purgeZone;
-			isInsidePurgeZone = true;
-		}
-	}
+	PurgeZoneMemory* pPurgeZones = nullptr;
+	pBlackboard->GetData("PurgeZoneMemory", pPurgeZones);
 
-	return isInsidePurgeZone;
+	return pPurgeZones->IsAgentInside();
 }
 BehaviorState LeavePurgeZone(Elite::Blackboard* pBlackboard)
 {
 	AgentInfo agentInfo{};
-	PurgeZoneInfo* dangerousPurgeZone = nullptr;
-	pBlackboard->GetData("DangerousPurgeZone", dangerousPurgeZone);
+	PurgeZoneMemory* pPurgeZones = nullptr;
+	SteeringPipeline* pSteering = nullptr;
 	pBlackboard->GetData("AgentInfo", agentInfo);
+	pBlackboard->GetData("PurgeZoneMemory", pPurgeZones);
+	pBlackboard->GetData("SteeringPipeline", pSteering);
 
-	if (!dangerousPurgeZone)
+	if (!pPurgeZones->IsAgentInside())
 	{
-		dangerousPurgeZone = nullptr;
 		return Failure;
 	}
 
-	pBlackboard->ChangeData("Target", dangerousPurgeZone->Center);
+	// staying in the zone is deadly, this gets the speed budget before anything else
+	Vector2 exitVelocity = pPurgeZones->GetExitVector();
+	exitVelocity.Normalize();
+	pSteering->AddLinear(exitVelocity * agentInfo.MaxLinearSpeed, 1.f, SteeringPriority::Critical, true);
 	pBlackboard->ChangeData("IsRunning", true);
-	Flee(pBlackboard);
 
 	return Success;
 }
@@ -666,17 +497,15 @@ bool IsArmed(Elite::Blackboard* pBlackboard)
 	Inventory* inventory = nullptr;
 	pBlackboard->GetData("Inventory", inventory);
 
-	return inventory->currentGuns > 0;
+	return inventory->HasItem(eItemType::PISTOL);
 }
 bool IsFacingEnemy(Elite::Blackboard* pBlackboard)
 {
 	std::list<EnemyInfo>* enemiesInFOV = nullptr;
-	AgentInfo agentInfo{};
-	SteeringPlugin_Output lastSteering{};
+	const AgentFrame* pAgentFrame = nullptr;
 
 	pBlackboard->GetData("EnemiesInFOV", enemiesInFOV);
-	pBlackboard->GetData("AgentInfo", agentInfo);
-	pBlackboard->GetData("SteeringOutput", lastSteering);
+	pBlackboard->GetData("AgentFrame", pAgentFrame);
 
 	if (enemiesInFOV->size() == 0)
 	{
@@ -685,19 +514,14 @@ bool IsFacingEnemy(Elite::Blackboard* pBlackboard)
 
 	EnemyInfo& targetEnemy = enemiesInFOV->front();
 
-	Vector2 toTargetNormal = (targetEnemy.Location - agentInfo.Position).GetNormalized();
-	Vector2 heading = OrientationToVector(agentInfo.Orientation);
-
-	const float dotResult = heading.Dot(toTargetNormal);
+	Vector2 toTargetNormal = (targetEnemy.Location - pAgentFrame->position).GetNormalized();
 
-	//const float longDistanceSquared = exp2f((agentInfo.FOV_Range / 3) * 2);
-	//if (DistanceSquared(agentInfo.Position, targetEnemy.Location) > longDistanceSquared)
-	//{
-	//	return abs(dotResult - 1.f) < 0.005f; // long range needs a narrower margin, at close range this causes jittering
-	//}
+	const float dotResult = pAgentFrame->heading.Dot(toTargetNormal);
 
+	// long range needs a narrower margin, at close range this causes jittering
 	float accuracyMargin = 0.01f;
-	if (DistanceSquared(agentInfo.Position, targetEnemy.Location) >  exp2f(agentInfo.FOV_Range / 2))
+	const float closeRangeSquared = pAgentFrame->fovRangeSquared / 4.f; // half the FOV range
+	if (DistanceSquared(pAgentFrame->position, targetEnemy.Location) > closeRangeSquared)
 	{
 		accuracyMargin = 0.00001f;
 	}
@@ -730,14 +554,11 @@ bool IsStrafing(Elite::Blackboard* pBlackboard)
 }
 BehaviorState Shoot(Elite::Blackboard* pBlackboard)
 {
-	IExamInterface* pluginInterface = nullptr;
-	AgentInfo agentInfo{};
 	Inventory* inventory = nullptr;
-	pBlackboard->GetData("PluginInterface", pluginInterface);
-	pBlackboard->GetData("AgentInfo", agentInfo);
 	pBlackboard->GetData("Inventory", inventory);
 
-	if (inventory->currentGuns == 0)
+	const int indexOfWeaponWithLeastAmmo = inventory->GetLeastAmmoGun();
+	if (indexOfWeaponWithLeastAmmo < 0)
 	{
 		return Failure;
 	}
@@ -748,36 +569,7 @@ BehaviorState Shoot(Elite::Blackboard* pBlackboard)
 		pBlackboard->ChangeData("StrafeInfo", strafeInfo);
 	}
 
-	unsigned int lowestAmmo = 100;
-	int indexOfWeaponWithLeastAmmo = -1;
-	for (unsigned int i = 0; i < inventory->maxGuns; i++)
-	{
-		ItemInfo& itemAtIndex = inventory->inventorySlots[i];
-
-		if (itemAtIndex.ItemHash != 0)
-		{
-			unsigned int weaponAmmo = pluginInterface->Weapon_GetAmmo(itemAtIndex);
-			if (weaponAmmo < lowestAmmo)
-			{
-				lowestAmmo = weaponAmmo;
-				indexOfWeaponWithLeastAmmo = i;
-			}
-		}
-	}
-
-	if (indexOfWeaponWithLeastAmmo < 0)
-	{
-		return Failure;
-	}
-
-	ItemInfo& weaponToUse = inventory->inventorySlots[indexOfWeaponWithLeastAmmo];
-	pluginInterface->Inventory_UseItem(indexOfWeaponWithLeastAmmo);
-	if (pluginInterface->Weapon_GetAmmo(weaponToUse) == 0)
-	{
-		pluginInterface->Inventory_RemoveItem(indexOfWeaponWithLeastAmmo);
-		inventory->inventorySlots[indexOfWeaponWithLeastAmmo] = ItemInfo{};
-		inventory->currentGuns--;
-	}
+	inventory->UseItem(indexOfWeaponWithLeastAmmo);
 	return Success;
 }
 BehaviorState SetEnemyAsTarget(Elite::Blackboard* pBlackboard)
@@ -845,31 +637,42 @@ BehaviorState ExpandingSquareSearch(Elite::Blackboard* pBlackboard)
 
 	if (DistanceSquared(searchData.lastSearchPosition, agentInfo.Position) < squaredSearchDistanceMargin)
 	{
-		float distanceToTravel = searchData.distance * (1 + searchData.step / 2);
-		Elite::Vector2 newTarget = searchData.lastSearchPosition;
+		// legs that walk through where zombies were are skipped, a few in a row at most so the square keeps growing
+		const float maxLegDanger = 4.f; // about walking right past a normal zombie
+		const int maxSkippedLegs = 3;
+		const InfluenceMap* pInfluenceMap = nullptr;
+		pBlackboard->GetData("InfluenceMap", pInfluenceMap);
 
-		switch (searchData.step % 4)
+		for (int skippedLegs = 0; skippedLegs <= maxSkippedLegs; ++skippedLegs)
 		{
-		case 0:
-			// go left
-			newTarget.x -= distanceToTravel;
-			break;
-		case 1:
-			// go up
-			newTarget.y += distanceToTravel;
-			break;
-		case 2:
-			// go right
-			newTarget.x += distanceToTravel;
-			break;
-		case 3:
-			// go down
-			newTarget.y -= distanceToTravel;
-			break;
-		}
+			float distanceToTravel = searchData.distance * (1 + searchData.step / 2);
+			Elite::Vector2 newTarget = searchData.lastSearchPosition;
 
-		searchData.lastSearchPosition = newTarget;
-		searchData.step++;
+			switch (searchData.step % 4)
+			{
+			case 0:
+				// go left
+				newTarget.x -= distanceToTravel;
+				break;
+			case 1:
+				// go up
+				newTarget.y += distanceToTravel;
+				break;
+			case 2:
+				// go right
+				newTarget.x += distanceToTravel;
+				break;
+			case 3:
+				// go down
+				newTarget.y -= distanceToTravel;
+				break;
+			}
+
+			searchData.lastSearchPosition = newTarget;
+			searchData.step++;
+			if (pInfluenceMap == nullptr || pInfluenceMap->GetPathDanger(agentInfo.Position, newTarget) < maxLegDanger)
+				break;
+		}
 		pBlackboard->ChangeData("ExpandingSquareSearchData", searchData);
 	}
 
@@ -877,24 +680,38 @@ BehaviorState ExpandingSquareSearch(Elite::Blackboard* pBlackboard)
 	return Success;
 }
 
+bool KnowsAHouse(Elite::Blackboard* pBlackboard)
+{
+	std::vector<HouseInfo>* pDiscoveredHouses = nullptr;
+	pBlackboard->GetData("DiscoveredHouses", pDiscoveredHouses);
+
+	return !pDiscoveredHouses->empty();
+}
 BehaviorState SetHouseAsTarget(Elite::Blackboard* pBlackboard)
 {
 	std::vector<HouseInfo>* pDiscoveredHouses = nullptr;
 	int lastHouseIndex = 0;
-	AgentInfo agentInfo{};
 	pBlackboard->GetData("DiscoveredHouses", pDiscoveredHouses);
 	pBlackboard->GetData("LastHouseTargetIndex", lastHouseIndex);
-	pBlackboard->GetData("AgentInfo", agentInfo);
 
-	const bool isCloseEnough = DistanceSquared((*pDiscoveredHouses)[lastHouseIndex].Center, agentInfo.Position) < 10.f;
+	// the next house on the loot route, the route skips houses we've been to recently
+	const LootRoutePlan* pLootRoute = nullptr;
+	pBlackboard->GetData("LootRoute", pLootRoute);
+	const int routeHouse = pLootRoute->GetNextHouse();
+	if (routeHouse >= 0)
+	{
+		pBlackboard->ChangeData("LastHouseTargetIndex", routeHouse);
+		pBlackboard->ChangeData("Target", (*pDiscoveredHouses)[routeHouse].Center);
+		return Success;
+	}
 
-	if (isCloseEnough)
+	// every house was visited recently, go to the one that will have restocked first
+	HouseRegistry* pHouseRegistry = nullptr;
+	pBlackboard->GetData("HouseRegistry", pHouseRegistry);
+	const int bestHouse = pHouseRegistry->GetBestHouse();
+	if (bestHouse >= 0)
 	{
-		lastHouseIndex++;
-		if (lastHouseIndex == (*pDiscoveredHouses).size())
-		{
-			lastHouseIndex = 0;
-		}
+		lastHouseIndex = bestHouse;
 		pBlackboard->ChangeData("LastHouseTargetIndex", lastHouseIndex);
 	}
 
@@ -904,4 +721,221 @@ BehaviorState SetHouseAsTarget(Elite::Blackboard* pBlackboard)
 }
 
 
+//-----------------------------------------------------------------
+// GOAP (world state, goal selection & actions)
+//-----------------------------------------------------------------
+const float GoapBadHealth = 5.f;
+const float GoapLowEnergy = 3.f;
+
+bool FindClosestRememberedItem(Elite::Blackboard* pBlackboard, eItemType type, ItemInfo& closestItem)
+{
+	ItemMemory* pItemMemory = nullptr;
+	AgentInfo agentInfo{};
+	pBlackboard->GetData("ItemMemory", pItemMemory);
+	pBlackboard->GetData("AgentInfo", agentInfo);
+
+	PurgeZoneMemory* pPurgeZones = nullptr;
+	pBlackboard->GetData("PurgeZoneMemory", pPurgeZones);
+
+	return pItemMemory->FindClosest(type, agentInfo.Position, *pPurgeZones, closestItem);
+}
+GoapWorldState GetGoapWorldState(Elite::Blackboard* pBlackboard)
+{
+	Inventory* inventory = nullptr;
+	ItemMemory* pItemMemory = nullptr;
+	AgentInfo agentInfo{};
+	pBlackboard->GetData("Inventory", inventory);
+	pBlackboard->GetData("ItemMemory", pItemMemory);
+	pBlackboard->GetData("AgentInfo", agentInfo);
+
+	GoapWorldState state = 0;
+	if (inventory->HasItem(eItemType::PISTOL)) state |= eHoldsGun;
+	if (inventory->HasItem(eItemType::MEDKIT)) state |= eHoldsMedkit;
+	if (inventory->HasItem(eItemType::FOOD)) state |= eHoldsFood;
+	if (inventory->NeedsItem(eItemType::PISTOL)) state |= eNeedsGun;
+	if (inventory->NeedsItem(eItemType::MEDKIT)) state |= eNeedsMedkit;
+	if (inventory->NeedsItem(eItemType::FOOD)) state |= eNeedsFood;
+
+	const unsigned int knownTypes = pItemMemory->GetKnownTypes();
+	if (knownTypes & (1u << static_cast<unsigned int>(eItemType::PISTOL))) state |= eKnowsGun;
+	if (knownTypes & (1u << static_cast<unsigned int>(eItemType::MEDKIT))) state |= eKnowsMedkit;
+	if (knownTypes & (1u << static_cast<unsigned int>(eItemType::FOOD))) state |= eKnowsFood;
+
+	if (agentInfo.Health < GoapBadHealth) state |= eBadlyHurt;
+	if (agentInfo.Energy < GoapLowEnergy) state |= eStarving;
+
+	return state;
+}
+int SelectGoapGoal(Elite::Blackboard*, GoapWorldState state)
+{
+	if (state & eBadlyHurt) return eGoalHealed;
+	if (state & eStarving) return eGoalFed;
+	// only stock up on what we know where to find, the rest of the tree looks for the others
+	if ((state & (eNeedsGun | eKnowsGun)) == (eNeedsGun | eKnowsGun)) return eGoalArmed;
+	if ((state & (eNeedsMedkit | eKnowsMedkit)) == (eNeedsMedkit | eKnowsMedkit)) return eGoalMedkitsStocked;
+	if ((state & (eNeedsFood | eKnowsFood)) == (eNeedsFood | eKnowsFood)) return eGoalFoodStocked;
+	return eGoalNone;
+}
+
+BehaviorState GoapFetchItem(Elite::Blackboard* pBlackboard, eItemType type)
+{
+	Inventory* inventory = nullptr;
+	std::list<EntityInfo>* itemsInFov = nullptr;
+	const AgentFrame* pAgentFrame = nullptr;
+	pBlackboard->GetData("Inventory", inventory);
+	pBlackboard->GetData("ItemsInFOV", itemsInFov);
+	pBlackboard->GetData("AgentFrame", pAgentFrame);
+
+	// grab whatever needed item is in reach first
+	const unsigned int countBefore = inventory->GetCount(type);
+	if (SeesItem(pBlackboard))
+	{
+		PickupItem(pBlackboard);
+	}
+	if (inventory->GetCount(type) > countBefore)
+	{
+		return Success;
+	}
+
+	// the loot route's next item when it's the type we're after, it's ordered to pick up the rest on the way
+	const LootRoutePlan* pLootRoute = nullptr;
+	pBlackboard->GetData("LootRoute", pLootRoute);
+	ItemInfo closestItem{};
+	if ((!pLootRoute->GetNextItem(closestItem) || closestItem.Type != type) && !FindClosestRememberedItem(pBlackboard, type, closestItem))
+	{
+		return Failure;
+	}
+
+	if (pAgentFrame->IsInGrabRange(closestItem.Location))
+	{
+		ItemMemory* pItemMemory = nullptr;
+		pBlackboard->GetData("ItemMemory", pItemMemory);
+
+		bool isStillThere = false;
+		for (const EntityInfo& item : *itemsInFov)
+		{
+			isStillThere |= pItemMemory->IsSameLocation(item.Location, closestItem.Location);
+		}
+
+		if (!isStillThere)
+		{
+			// standing on it and it's gone, the memory is stale
+			RemoveItemFromMemory(closestItem, pBlackboard);
+			return Failure;
+		}
+	}
+
+	pBlackboard->ChangeData("ItemBeingFetched", closestItem);
+	pBlackboard->ChangeData("Target", closestItem.Location);
+	Seek(pBlackboard);
+	return Running;
+}
+BehaviorState GoapFetchGun(Elite::Blackboard* pBlackboard)
+{
+	return GoapFetchItem(pBlackboard, eItemType::PISTOL);
+}
+BehaviorState GoapFetchMedkit(Elite::Blackboard* pBlackboard)
+{
+	return GoapFetchItem(pBlackboard, eItemType::MEDKIT);
+}
+BehaviorState GoapFetchFood(Elite::Blackboard* pBlackboard)
+{
+	return GoapFetchItem(pBlackboard, eItemType::FOOD);
+}
+BehaviorState GoapUseMedkit(Elite::Blackboard* pBlackboard)
+{
+	const float maxHealth = 10.f;
+	AgentInfo agentInfo{};
+	Inventory* inventory = nullptr;
+	pBlackboard->GetData("AgentInfo", agentInfo);
+	pBlackboard->GetData("Inventory", inventory);
+
+	// badly hurt, wasting part of a medkit is better than dying
+	int medkit = inventory->GetBestMedkit(maxHealth - agentInfo.Health);
+	if (medkit < 0)
+	{
+		medkit = inventory->GetBestMedkit(FLT_MAX);
+	}
+
+	return (medkit >= 0 && inventory->UseItem(medkit)) ? Success : Failure;
+}
+BehaviorState GoapEat(Elite::Blackboard* pBlackboard)
+{
+	Inventory* inventory = nullptr;
+	pBlackboard->GetData("Inventory", inventory);
+
+	const int food = inventory->GetAnyFood();
+	return (food >= 0 && inventory->UseItem(food)) ? Success : Failure;
+}
+
+//-----------------------------------------------------------------
+// Considerations (Utility AI inputs, normalized to [0, 1])
+//-----------------------------------------------------------------
+float DamageTaken(Elite::Blackboard* pBlackboard)
+{
+	const float maxHealth = 10.f;
+	AgentInfo agentInfo{};
+	pBlackboard->GetData("AgentInfo", agentInfo);
+
+	return (maxHealth - agentInfo.Health) / maxHealth;
+}
+float HasUsableMedkit(Elite::Blackboard* pBlackboard)
+{
+	const float maxHealth = 10.f;
+	AgentInfo agentInfo{};
+	Inventory* inventory = nullptr;
+	pBlackboard->GetData("AgentInfo", agentInfo);
+	pBlackboard->GetData("Inventory", inventory);
+
+	return inventory->GetBestMedkit(maxHealth - agentInfo.Health) >= 0 ? 1.f : 0.f;
+}
+float EnergyMissing(Elite::Blackboard* pBlackboard)
+{
+	const float maxEnergy = 10.f;
+	AgentInfo agentInfo{};
+	pBlackboard->GetData("AgentInfo", agentInfo);
+
+	return (maxEnergy - agentInfo.Energy) / maxEnergy;
+}
+float HasUsableFood(Elite::Blackboard* pBlackboard)
+{
+	const float maxEnergy = 10.f;
+	AgentInfo agentInfo{};
+	Inventory* inventory = nullptr;
+	pBlackboard->GetData("AgentInfo", agentInfo);
+	pBlackboard->GetData("Inventory", inventory);
+
+	const int food = inventory->GetAnyFood();
+	return (food >= 0 && inventory->GetValue(food) < maxEnergy - agentInfo.Energy) ? 1.f : 0.f;
+}
+float PurgeZoneDanger(Elite::Blackboard* pBlackboard)
+{
+	return IsInPurgeZone(pBlackboard) ? 1.f : 0.f;
+}
+float ZombieThreat(Elite::Blackboard* pBlackboard)
+{
+	if (IsZombieInFOV(pBlackboard))
+	{
+		return 1.f;
+	}
+	// bitten by something we can't see, or still finishing a strafe
+	return (WasBitten(pBlackboard) || IsStrafing(pBlackboard)) ? 0.8f : 0.f;
+}
+float LootOpportunity(Elite::Blackboard* pBlackboard)
+{
+	if (SeesItem(pBlackboard))
+	{
+		return 1.f;
+	}
+	return (IsInNeedOfItem(pBlackboard) && IsANeededItemClose(pBlackboard)) ? 0.7f : 0.f;
+}
+float ExplorationLeft(Elite::Blackboard* pBlackboard)
+{
+	return IsDoneExploring(pBlackboard) ? 0.f : 1.f;
+}
+float KnownHouses(Elite::Blackboard* pBlackboard)
+{
+	return KnowsAHouse(pBlackboard) ? 1.f : 0.f;
+}
+
 #endif
\ No newline at end of file
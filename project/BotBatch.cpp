@@ -0,0 +1,256 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "BotBatch.h"
+using namespace Elite;
+
+namespace
+{
+	BotBatch& GetBots(void* pAgents) { return *static_cast<BotBatch*>(pAgents); }
+
+	//Leaves that need headings gather the angles per chunk, so the sines & cosines go 4 or 8 at once
+	const unsigned int HeadingChunk = 64;
+	void GetHeadings(const float* orientations, unsigned int count, float* headingsX, float* headingsY)
+	{
+		//Same as OrientationToVector, {sin, -cos}
+		FastMath::SinCos(orientations, headingsX, headingsY, count);
+		for (unsigned int i = 0; i < count; ++i)
+			headingsY[i] = -headingsY[i];
+	}
+}
+
+namespace BotBatchConditionals
+{
+	void IsHurt(void* pAgents, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		const BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+			results[i] = BotBatch::MaxHealth - bots.health[agents[i]] > 0.0001f;
+	}
+	void ShouldUseMedkit(void* pAgents, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		//A medkit that doesn't go to waste, there is one when the smallest doesn't
+		const BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const float medkit = bots.smallestMedkitValues[agents[i]];
+			results[i] = medkit > 0.f && medkit < BotBatch::MaxHealth - bots.health[agents[i]];
+		}
+	}
+	void IsHungry(void* pAgents, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		const BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+			results[i] = BotBatch::MaxEnergy - bots.energy[agents[i]] > 0.0001f;
+	}
+	void ShouldEat(void* pAgents, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		const BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const float food = bots.smallestFoodValues[agents[i]];
+			results[i] = food > 0.f && food < BotBatch::MaxEnergy - bots.energy[agents[i]];
+		}
+	}
+	void IsInPurgeZone(void* pAgents, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		const BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+			results[i] = bots.isInPurgeZone[agents[i]] != 0;
+	}
+	void IsZombieInFOV(void* pAgents, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		const BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+			results[i] = bots.seesEnemy[agents[i]] != 0;
+	}
+	void IsArmed(void* pAgents, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		const BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+			results[i] = bots.ammo[agents[i]] > 0;
+	}
+	void IsFacingEnemy(void* pAgents, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		const BotBatch& bots = GetBots(pAgents);
+		for (unsigned int first = 0; first < count; first += HeadingChunk)
+		{
+			const unsigned int chunkCount = std::min(count - first, HeadingChunk);
+			float orientations[HeadingChunk], headingsX[HeadingChunk], headingsY[HeadingChunk];
+			for (unsigned int i = 0; i < chunkCount; ++i)
+				orientations[i] = bots.orientations[agents[first + i]];
+			GetHeadings(orientations, chunkCount, headingsX, headingsY);
+
+			for (unsigned int i = 0; i < chunkCount; ++i)
+			{
+				const unsigned int a = agents[first + i];
+				const Vector2 toEnemy = Vector2{ bots.enemiesX[a] - bots.positionsX[a], bots.enemiesY[a] - bots.positionsY[a] };
+				const bool isClose = toEnemy.MagnitudeSquared() <= bots.fovRanges[a] * bots.fovRanges[a] / 4.f;
+				const float margin = isClose ? BotBatch::CloseFacingMargin : BotBatch::FarFacingMargin;
+				results[first + i] = bots.seesEnemy[a] && AreEqual(toEnemy.GetNormalized().Dot(Vector2{ headingsX[i], headingsY[i] }), 1.f, margin);
+			}
+		}
+	}
+	void SeesItem(void* pAgents, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		const BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+			results[i] = bots.seesItem[agents[i]] != 0;
+	}
+
+}
+
+namespace
+{
+	// Actions
+	void UseMedkit(void* pAgents, const unsigned int* agents, unsigned int count, BehaviorState* results)
+	{
+		BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			bots.decisions[agents[i]] |= BotBatch::eUseMedkit;
+			results[i] = Success;
+		}
+	}
+	void Eat(void* pAgents, const unsigned int* agents, unsigned int count, BehaviorState* results)
+	{
+		BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			bots.decisions[agents[i]] |= BotBatch::eEat;
+			results[i] = Success;
+		}
+	}
+	void LeavePurgeZone(void* pAgents, const unsigned int* agents, unsigned int count, BehaviorState* results)
+	{
+		BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const unsigned int a = agents[i];
+			bots.targetsX[a] = bots.positionsX[a] + bots.exitsX[a];
+			bots.targetsY[a] = bots.positionsY[a] + bots.exitsY[a];
+			bots.isRunning[a] = 1;
+			results[i] = Success;
+		}
+	}
+	void Shoot(void* pAgents, const unsigned int* agents, unsigned int count, BehaviorState* results)
+	{
+		BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			bots.decisions[agents[i]] |= BotBatch::eShoot;
+			results[i] = Success;
+		}
+	}
+	void FaceEnemy(void* pAgents, const unsigned int* agents, unsigned int count, BehaviorState* results)
+	{
+		BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const unsigned int a = agents[i];
+			bots.targetsX[a] = bots.enemiesX[a];
+			bots.targetsY[a] = bots.enemiesY[a];
+			results[i] = Running;
+		}
+	}
+	void SeekItem(void* pAgents, const unsigned int* agents, unsigned int count, BehaviorState* results)
+	{
+		BotBatch& bots = GetBots(pAgents);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const unsigned int a = agents[i];
+			bots.targetsX[a] = bots.itemsX[a];
+			bots.targetsY[a] = bots.itemsY[a];
+			results[i] = Running;
+		}
+	}
+	void Wander(void* pAgents, const unsigned int* agents, unsigned int count, BehaviorState* results)
+	{
+		//Straight ahead, bending a bit per bot so they don't all walk the same line
+		const float wanderDistance = 10.f;
+		BotBatch& bots = GetBots(pAgents);
+		for (unsigned int first = 0; first < count; first += HeadingChunk)
+		{
+			const unsigned int chunkCount = std::min(count - first, HeadingChunk);
+			float orientations[HeadingChunk], headingsX[HeadingChunk], headingsY[HeadingChunk];
+			for (unsigned int i = 0; i < chunkCount; ++i)
+			{
+				const unsigned int a = agents[first + i];
+				orientations[i] = bots.orientations[a] + ((a & 1) ? 0.3f : -0.3f);
+			}
+			GetHeadings(orientations, chunkCount, headingsX, headingsY);
+
+			for (unsigned int i = 0; i < chunkCount; ++i)
+			{
+				const unsigned int a = agents[first + i];
+				bots.targetsX[a] = bots.positionsX[a] + headingsX[i] * wanderDistance;
+				bots.targetsY[a] = bots.positionsY[a] + headingsY[i] * wanderDistance;
+				results[first + i] = Running;
+			}
+		}
+	}
+}
+
+void BotBatch::Resize(unsigned int botCount)
+{
+	for (std::vector<float>* pField : { &positionsX, &positionsY, &orientations, &fovRanges, &health, &energy, &exitsX, &exitsY,
+		&enemiesX, &enemiesY, &itemsX, &itemsY, &smallestMedkitValues, &smallestFoodValues, &targetsX, &targetsY })
+		pField->resize(botCount, 0.f);
+	for (std::vector<unsigned char>* pField : { &isInPurgeZone, &seesEnemy, &seesItem, &isRunning, &decisions })
+		pField->resize(botCount, 0);
+	ammo.resize(botCount, 0);
+}
+
+BatchedBehavior BotBatch::CreateBehavior()
+{
+	using namespace BotBatchConditionals;
+	return BatchedSelector(
+		{
+			BatchedSequence(
+				{
+					BatchedConditionalLeaf(IsHurt),
+					BatchedConditionalLeaf(ShouldUseMedkit),
+					BatchedActionLeaf(UseMedkit)
+				}
+			),
+			BatchedSequence(
+				{
+					BatchedConditionalLeaf(IsHungry),
+					BatchedConditionalLeaf(ShouldEat),
+					BatchedActionLeaf(Eat)
+				}
+			),
+			BatchedSequence(
+				{
+					BatchedConditionalLeaf(IsInPurgeZone),
+					BatchedActionLeaf(LeavePurgeZone),
+					// with a zombie in sight, fall through so combat can face & shoot while we flee
+					BatchedInvertedConditionalLeaf(IsZombieInFOV)
+				}
+			),
+			BatchedSequence(
+				{
+					BatchedConditionalLeaf(IsZombieInFOV),
+					BatchedConditionalLeaf(IsArmed),
+					BatchedSelector(
+						{
+							BatchedSequence(
+								{
+									BatchedConditionalLeaf(IsFacingEnemy),
+									BatchedActionLeaf(Shoot)
+								}
+							),
+							BatchedActionLeaf(FaceEnemy)
+						}
+					)
+				}
+			),
+			BatchedSequence(
+				{
+					BatchedConditionalLeaf(SeesItem),
+					BatchedActionLeaf(SeekItem)
+				}
+			),
+			BatchedActionLeaf(Wander)
+		}
+	);
+}
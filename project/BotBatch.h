@@ -0,0 +1,84 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// BotBatch.h: A model of the bot's top level decisions for many agents at once, for tuning runs
+/*=============================================================================*/
+#pragma once
+#include "EBatchedBehaviorTree.h"
+
+//-----------------------------------------------------------------
+// BOT BATCH
+//-----------------------------------------------------------------
+// What every bot knows & decides, one array per field. Whoever runs the bots fills in
+// the perception before each update, the batched tree fills in the decisions. Flags
+// are bytes, not a vector<bool>, so leaves can read & write them without bit fiddling.
+// This is a separate model for tuning runs, not the plugin's tree: the plugin's leaves
+// read one Blackboard per agent & act through the interface. The conditionals below
+// stand in for the Behaviors.h leaves of the same name & decide the same on the same
+// situation (BotBatchLeavesTest), the actions only write down decisions. Looting houses
+// & exploring are left out, bots that have nothing else to do wander.
+struct BotBatch
+{
+	static constexpr float MaxHealth = 10.f;
+	static constexpr float MaxEnergy = 10.f;
+	static constexpr float CloseFacingMargin = 0.01f; //IsFacingEnemy's margins, close is within half the FOV range
+	static constexpr float FarFacingMargin = 0.00001f;
+
+	enum Decision : unsigned char
+	{
+		eNoDecision = 0,
+		eUseMedkit = 1 << 0,
+		eEat = 1 << 1,
+		eShoot = 1 << 2
+	};
+
+	//Perception
+	std::vector<float> positionsX = {};
+	std::vector<float> positionsY = {};
+	std::vector<float> orientations = {};
+	std::vector<float> fovRanges = {};
+	std::vector<float> health = {};
+	std::vector<float> energy = {};
+	std::vector<unsigned char> isInPurgeZone = {};
+	std::vector<float> exitsX = {}; //Shortest way out of the purge zone
+	std::vector<float> exitsY = {};
+	std::vector<unsigned char> seesEnemy = {};
+	std::vector<float> enemiesX = {}; //First enemy in sight, the one the plugin aims at
+	std::vector<float> enemiesY = {};
+	std::vector<unsigned char> seesItem = {};
+	std::vector<float> itemsX = {};
+	std::vector<float> itemsY = {};
+
+	//Inventory, 0 when none is held. A medkit or food item fits when the smallest one does
+	std::vector<float> smallestMedkitValues = {};
+	std::vector<float> smallestFoodValues = {};
+	std::vector<unsigned int> ammo = {};
+
+	//Decisions
+	std::vector<float> targetsX = {};
+	std::vector<float> targetsY = {};
+	std::vector<unsigned char> isRunning = {};
+	std::vector<unsigned char> decisions = {};
+
+	void Resize(unsigned int botCount);
+	unsigned int GetCount() const { return static_cast<unsigned int>(health.size()); }
+
+	//Heal, eat, leave purge zones, fight, loot & wander, same priorities as the bot's behavior tree
+	static Elite::BatchedBehavior CreateBehavior();
+};
+
+//-----------------------------------------------------------------
+// BOT BATCH CONDITIONALS
+//-----------------------------------------------------------------
+namespace BotBatchConditionals
+{
+	void IsHurt(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+	void ShouldUseMedkit(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+	void IsHungry(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+	void ShouldEat(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+	void IsInPurgeZone(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+	void IsZombieInFOV(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+	void IsArmed(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+	void IsFacingEnemy(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+	void SeesItem(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+}
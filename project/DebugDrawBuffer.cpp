@@ -0,0 +1,157 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "DebugDrawBuffer.h"
+#include "IExamInterface.h"
+using namespace Elite;
+
+namespace
+{
+	bool IsSamePoint(const Vector2& a, const Vector2& b) { return a.x == b.x && a.y == b.y; }
+	bool IsSameColor(const Vector3& a, const Vector3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+	bool Overlaps(const Vector2& min, const Vector2& max, const Vector2& visibleMin, const Vector2& visibleMax)
+	{
+		return min.x <= visibleMax.x && max.x >= visibleMin.x && min.y <= visibleMax.y && max.y >= visibleMin.y;
+	}
+}
+
+void DebugDrawBuffer::Clear()
+{
+	m_Vertices.clear();
+	m_Shapes.clear();
+	m_Circles.clear();
+	m_Points.clear();
+}
+
+void DebugDrawBuffer::AddSegment(const Vector2& p1, const Vector2& p2, const Vector3& color, DebugLayer layer)
+{
+	//Continues the last strip when it ends where this segment starts
+	if (!m_Shapes.empty())
+	{
+		Shape& last = m_Shapes.back();
+		if (!last.isClosed && last.layer == layer && IsSameColor(last.color, color) && IsSamePoint(m_Vertices.back(), p1))
+		{
+			AddVertex(last, p2);
+			return;
+		}
+	}
+
+	Shape& strip = AddShape(p1, color, layer);
+	AddVertex(strip, p2);
+}
+
+void DebugDrawBuffer::AddPolygon(const Vector2* points, unsigned int count, const Vector3& color, DebugLayer layer, bool isSolid)
+{
+	if (count == 0)
+		return;
+
+	Shape& polygon = AddShape(points[0], color, layer);
+	polygon.isClosed = true;
+	polygon.isSolid = isSolid;
+	for (unsigned int i = 1; i < count; ++i)
+		AddVertex(polygon, points[i]);
+}
+
+void DebugDrawBuffer::AddCircle(const Vector2& center, float radius, const Vector3& color, DebugLayer layer, bool isSolid)
+{
+	m_Circles.push_back(Circle{ center, radius, color, layer, isSolid });
+}
+
+void DebugDrawBuffer::AddPoint(const Vector2& position, float size, const Vector3& color, DebugLayer layer)
+{
+	m_Points.push_back(Point{ position, size, color, layer });
+}
+
+void DebugDrawBuffer::SetLayerEnabled(DebugLayer layer, bool isEnabled)
+{
+	if (isEnabled)
+		m_EnabledLayers |= GetLayerBit(layer);
+	else
+		m_EnabledLayers &= ~GetLayerBit(layer);
+}
+
+DebugDrawBuffer::FlushStats DebugDrawBuffer::Flush(IBaseInterface* pInterface, const Vector2& visibleMin, const Vector2& visibleMax) const
+{
+	FlushStats stats{};
+	stats.primitiveCount = static_cast<unsigned int>(m_Shapes.size() + m_Circles.size() + m_Points.size());
+
+	for (const Shape& shape : m_Shapes)
+	{
+		if (!IsLayerEnabled(shape.layer))
+			continue;
+		if (!Overlaps(shape.boundsMin, shape.boundsMax, visibleMin, visibleMax))
+		{
+			++stats.culledCount;
+			continue;
+		}
+
+		const Vector2* pVertices = &m_Vertices[shape.firstVertex];
+		unsigned int vertexCount = shape.vertexCount;
+		bool isClosed = shape.isClosed;
+		if (!isClosed && vertexCount >= 4 && IsSamePoint(pVertices[0], pVertices[vertexCount - 1]))
+		{
+			//Strip that came back to its start, the polygon closes it itself
+			isClosed = true;
+			--vertexCount;
+		}
+
+		if (isClosed && shape.isSolid)
+			pInterface->Draw_SolidPolygon(pVertices, int(vertexCount), shape.color);
+		else if (isClosed)
+			pInterface->Draw_Polygon(pVertices, int(vertexCount), shape.color);
+		else
+		{
+			for (unsigned int i = 1; i < vertexCount; ++i)
+				pInterface->Draw_Segment(pVertices[i - 1], pVertices[i], shape.color);
+			stats.drawCallCount += vertexCount - 2;
+		}
+		++stats.drawCallCount;
+	}
+
+	for (const Circle& circle : m_Circles)
+	{
+		if (!IsLayerEnabled(circle.layer))
+			continue;
+		const Vector2 extent{ circle.radius, circle.radius };
+		if (!Overlaps(circle.center - extent, circle.center + extent, visibleMin, visibleMax))
+		{
+			++stats.culledCount;
+			continue;
+		}
+
+		if (circle.isSolid)
+			pInterface->Draw_SolidCircle(circle.center, circle.radius, Vector2{}, circle.color);
+		else
+			pInterface->Draw_Circle(circle.center, circle.radius, circle.color);
+		++stats.drawCallCount;
+	}
+
+	for (const Point& point : m_Points)
+	{
+		if (!IsLayerEnabled(point.layer))
+			continue;
+		if (!Overlaps(point.position, point.position, visibleMin, visibleMax))
+		{
+			++stats.culledCount;
+			continue;
+		}
+
+		pInterface->Draw_Point(point.position, point.size, point.color);
+		++stats.drawCallCount;
+	}
+	return stats;
+}
+
+DebugDrawBuffer::Shape& DebugDrawBuffer::AddShape(const Vector2& first, const Vector3& color, DebugLayer layer)
+{
+	m_Shapes.push_back(Shape{ static_cast<unsigned int>(m_Vertices.size()), 1, first, first, color, layer, false, false });
+	m_Vertices.push_back(first);
+	return m_Shapes.back();
+}
+
+void DebugDrawBuffer::AddVertex(Shape& shape, const Vector2& vertex)
+{
+	m_Vertices.push_back(vertex);
+	++shape.vertexCount;
+	shape.boundsMin = Vector2{ std::min(shape.boundsMin.x, vertex.x), std::min(shape.boundsMin.y, vertex.y) };
+	shape.boundsMax = Vector2{ std::max(shape.boundsMax.x, vertex.x), std::max(shape.boundsMax.y, vertex.y) };
+}
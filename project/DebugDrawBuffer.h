@@ -0,0 +1,94 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// DebugDrawBuffer.h: Debug primitives gathered during the tick, drawn in one go in Render
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+
+class IBaseInterface;
+
+//Every primitive is on one layer, layers are switched on & off as a whole
+enum class DebugLayer : unsigned int
+{
+	Agent,
+	Memory,
+	Houses,
+	Route,
+	Grids,
+	Danger,
+	//---
+	Count
+};
+
+//-----------------------------------------------------------------
+// DEBUG DRAW BUFFER
+//-----------------------------------------------------------------
+// Every Draw_* call crosses into the host, so instead of drawing while deciding, primitives
+// are appended to one array per kind & flushed once per frame. The flush skips disabled
+// layers and whatever is outside the visible world rectangle. Segments that continue the
+// previous one (same end point, color & layer) grow one strip, a strip that comes back to
+// its start is drawn as a single polygon instead of a call per segment.
+// Stays filled until the next Clear, so frames rendered between two ticks redraw the same.
+class DebugDrawBuffer final
+{
+public:
+	struct FlushStats
+	{
+		unsigned int primitiveCount;
+		unsigned int culledCount; //Outside the visible rectangle, disabled layers aren't counted
+		unsigned int drawCallCount;
+	};
+
+	void Clear();
+
+	void AddSegment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, DebugLayer layer);
+	//Closed, the last point connects back to the first
+	void AddPolygon(const Elite::Vector2* points, unsigned int count, const Elite::Vector3& color, DebugLayer layer, bool isSolid = false);
+	void AddCircle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, DebugLayer layer, bool isSolid = false);
+	void AddPoint(const Elite::Vector2& position, float size, const Elite::Vector3& color, DebugLayer layer);
+
+	void SetLayerEnabled(DebugLayer layer, bool isEnabled);
+	bool IsLayerEnabled(DebugLayer layer) const { return (m_EnabledLayers & GetLayerBit(layer)) != 0; }
+
+	FlushStats Flush(IBaseInterface* pInterface, const Elite::Vector2& visibleMin, const Elite::Vector2& visibleMax) const;
+
+private:
+	//Strips & polygons share the vertex array
+	struct Shape
+	{
+		unsigned int firstVertex;
+		unsigned int vertexCount;
+		Elite::Vector2 boundsMin;
+		Elite::Vector2 boundsMax;
+		Elite::Vector3 color;
+		DebugLayer layer;
+		bool isClosed;
+		bool isSolid;
+	};
+	struct Circle
+	{
+		Elite::Vector2 center;
+		float radius;
+		Elite::Vector3 color;
+		DebugLayer layer;
+		bool isSolid;
+	};
+	struct Point
+	{
+		Elite::Vector2 position;
+		float size;
+		Elite::Vector3 color;
+		DebugLayer layer;
+	};
+
+	std::vector<Elite::Vector2> m_Vertices = {};
+	std::vector<Shape> m_Shapes = {};
+	std::vector<Circle> m_Circles = {};
+	std::vector<Point> m_Points = {};
+	unsigned int m_EnabledLayers = ~0u;
+
+	static unsigned int GetLayerBit(DebugLayer layer) { return 1u << static_cast<unsigned int>(layer); }
+	Shape& AddShape(const Elite::Vector2& first, const Elite::Vector3& color, DebugLayer layer);
+	void AddVertex(Shape& shape, const Elite::Vector2& vertex);
+};
@@ -0,0 +1,209 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EBatchedBehaviorTree.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// BATCHED BEHAVIOR TREE
+//-----------------------------------------------------------------
+const unsigned int BatchedBehaviorTree::ChunkSize;
+
+BatchedBehaviorTree::BatchedBehaviorTree(const BatchedBehavior& root)
+{
+	Flatten(root, NoNode);
+}
+
+void BatchedBehaviorTree::SetAgentCount(unsigned int agentCount)
+{
+	m_AgentCount = agentCount;
+	m_States.assign(agentCount, Failure);
+	m_PartialIndices.assign(m_PartialSequenceCount * agentCount, 0);
+
+	m_Chunks.resize((agentCount + ChunkSize - 1) / ChunkSize);
+	for (Chunk& chunk : m_Chunks)
+	{
+		chunk.arrivals.resize(m_Nodes.size());
+		for (std::vector<unsigned int>& arrivals : chunk.arrivals)
+			arrivals.reserve(ChunkSize);
+	}
+}
+
+void BatchedBehaviorTree::Update(void* pAgents, JobSystem& jobSystem)
+{
+	m_pUpdateAgents = pAgents;
+	const unsigned int chunkCount = static_cast<unsigned int>(m_Chunks.size());
+	if (jobSystem.ShouldRunInline(m_AgentCount))
+	{
+		UpdateChunks(this, 0, chunkCount);
+		return;
+	}
+
+	//A chunk per job, the threshold is about agents & not chunks
+	std::atomic<unsigned int> pending{ 0 };
+	for (unsigned int chunk = 0; chunk < chunkCount; ++chunk)
+		jobSystem.Run(&BatchedBehaviorTree::UpdateChunks, this, chunk, chunk + 1, pending);
+	jobSystem.Wait(pending);
+}
+
+unsigned int BatchedBehaviorTree::Flatten(const BatchedBehavior& behavior, unsigned int parent)
+{
+	const unsigned int node = static_cast<unsigned int>(m_Nodes.size());
+	const unsigned int childCount = static_cast<unsigned int>(behavior.children.size());
+	const unsigned int firstChild = static_cast<unsigned int>(m_Children.size());
+	const unsigned int partialSlot = (behavior.type == BatchedNodeType::PartialSequence) ? m_PartialSequenceCount++ : 0;
+	m_Nodes.push_back(Node{ behavior.type, parent, NoNode, firstChild, childCount, partialSlot, behavior.fpConditional, behavior.fpAction });
+
+	//Children come right after their parent & its earlier children's subtrees
+	m_Children.resize(firstChild + childCount);
+	unsigned int previousChild = NoNode;
+	for (unsigned int c = 0; c < childCount; ++c)
+	{
+		const unsigned int child = Flatten(behavior.children[c], node);
+		m_Children[firstChild + c] = child;
+		if (previousChild != NoNode)
+			m_Nodes[previousChild].nextSibling = child;
+		previousChild = child;
+	}
+	return node;
+}
+
+void BatchedBehaviorTree::UpdateChunks(void* pData, unsigned int begin, unsigned int end)
+{
+	BatchedBehaviorTree* pTree = static_cast<BatchedBehaviorTree*>(pData);
+	for (unsigned int chunk = begin; chunk < end; ++chunk)
+		pTree->UpdateChunk(chunk);
+}
+
+void BatchedBehaviorTree::UpdateChunk(unsigned int chunkIndex)
+{
+	Chunk& chunk = m_Chunks[chunkIndex];
+	const unsigned int firstAgent = chunkIndex * ChunkSize;
+	const unsigned int lastAgent = std::min(firstAgent + ChunkSize, m_AgentCount);
+	for (unsigned int agent = firstAgent; agent < lastAgent; ++agent)
+		chunk.arrivals[0].push_back(agent);
+
+	unsigned int leafCalls = 0;
+	unsigned int leafAgents = 0;
+	for (unsigned int n = 0; n < m_Nodes.size(); ++n)
+	{
+		const std::vector<unsigned int>& arrivals = chunk.arrivals[n];
+		const unsigned int count = static_cast<unsigned int>(arrivals.size());
+		if (count == 0)
+			continue;
+
+		const Node& node = m_Nodes[n];
+		switch (node.type)
+		{
+		case BatchedNodeType::Selector:
+		case BatchedNodeType::Sequence:
+		case BatchedNodeType::PartialSequence:
+			for (unsigned int agent : arrivals)
+				Enter(chunk, n, agent);
+			break;
+		case BatchedNodeType::Conditional:
+		case BatchedNodeType::InvertedConditional:
+		{
+			const bool passesOn = (node.type == BatchedNodeType::Conditional);
+			if (node.fpConditional)
+				node.fpConditional(m_pUpdateAgents, arrivals.data(), count, chunk.conditionResults);
+			for (unsigned int a = 0; a < count; ++a)
+			{
+				const bool isMet = node.fpConditional && chunk.conditionResults[a] == passesOn;
+				Resolve(chunk, n, arrivals[a], isMet ? Success : Failure);
+			}
+			break;
+		}
+		case BatchedNodeType::Action:
+			if (node.fpAction)
+				node.fpAction(m_pUpdateAgents, arrivals.data(), count, chunk.actionResults);
+			for (unsigned int a = 0; a < count; ++a)
+				Resolve(chunk, n, arrivals[a], node.fpAction ? chunk.actionResults[a] : Failure);
+			break;
+		}
+
+		if (node.type >= BatchedNodeType::Conditional)
+		{
+			++leafCalls;
+			leafAgents += count;
+		}
+		chunk.arrivals[n].clear();
+	}
+
+	m_LeafCallCount.fetch_add(leafCalls, std::memory_order_relaxed);
+	m_LeafAgentCount.fetch_add(leafAgents, std::memory_order_relaxed);
+}
+
+void BatchedBehaviorTree::Enter(Chunk& chunk, unsigned int node, unsigned int agent)
+{
+	const Node& composite = m_Nodes[node];
+	unsigned int child = 0;
+	if (composite.type == BatchedNodeType::PartialSequence)
+	{
+		unsigned char& current = m_PartialIndices[composite.partialSlot * m_AgentCount + agent];
+		if (current >= composite.childCount)
+		{
+			//Every child succeeded over the previous ticks
+			current = 0;
+			Resolve(chunk, node, agent, Success);
+			return;
+		}
+		child = current;
+	}
+	else if (composite.childCount == 0)
+	{
+		Resolve(chunk, node, agent, composite.type == BatchedNodeType::Sequence ? Success : Failure);
+		return;
+	}
+
+	chunk.arrivals[m_Children[composite.firstChild + child]].push_back(agent);
+}
+
+void BatchedBehaviorTree::Resolve(Chunk& chunk, unsigned int node, unsigned int agent, BehaviorState state)
+{
+	for (;;)
+	{
+		const Node& current = m_Nodes[node];
+		if (current.parent == NoNode)
+		{
+			m_States[agent] = state;
+			return;
+		}
+
+		const Node& parent = m_Nodes[current.parent];
+		switch (parent.type)
+		{
+		case BatchedNodeType::Selector:
+			if (state == Failure && current.nextSibling != NoNode)
+			{
+				chunk.arrivals[current.nextSibling].push_back(agent);
+				return;
+			}
+			break;
+		case BatchedNodeType::Sequence:
+			if (state == Success && current.nextSibling != NoNode)
+			{
+				chunk.arrivals[current.nextSibling].push_back(agent);
+				return;
+			}
+			break;
+		case BatchedNodeType::PartialSequence:
+		{
+			//One child per tick, same as BehaviorPartialSequence
+			unsigned char& index = m_PartialIndices[parent.partialSlot * m_AgentCount + agent];
+			if (state == Success)
+			{
+				++index;
+				state = Running;
+			}
+			else if (state == Failure)
+			{
+				index = 0;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+		node = current.parent;
+	}
+}
@@ -0,0 +1,121 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EBatchedBehaviorTree.h: One behavior tree definition ticking many agents at once
+/*=============================================================================*/
+#ifndef ELITE_BATCHED_BEHAVIOR_TREE
+#define ELITE_BATCHED_BEHAVIOR_TREE
+
+//--- Includes ---
+#include <vector>
+#include "EBehaviorTree.h"
+#include "EJobSystem.h"
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// BATCHED BEHAVIOR TREE HELPERS
+	//-----------------------------------------------------------------
+	//Leaves run on a batch, agents[i] is an index into whatever pAgents holds
+	using BatchedConditional = void(*)(void* pAgents, const unsigned int* agents, unsigned int count, bool* results);
+	using BatchedAction = void(*)(void* pAgents, const unsigned int* agents, unsigned int count, BehaviorState* results);
+
+	enum class BatchedNodeType
+	{
+		Selector,
+		Sequence,
+		PartialSequence,
+		Conditional,
+		InvertedConditional,
+		Action
+	};
+
+	//Description of a tree, written the same way as one made of IBehaviors
+	struct BatchedBehavior
+	{
+		BatchedNodeType type;
+		std::vector<BatchedBehavior> children;
+		BatchedConditional fpConditional;
+		BatchedAction fpAction;
+	};
+
+	inline BatchedBehavior BatchedSelector(std::vector<BatchedBehavior> children) { return BatchedBehavior{ BatchedNodeType::Selector, children, nullptr, nullptr }; }
+	inline BatchedBehavior BatchedSequence(std::vector<BatchedBehavior> children) { return BatchedBehavior{ BatchedNodeType::Sequence, children, nullptr, nullptr }; }
+	inline BatchedBehavior BatchedPartialSequence(std::vector<BatchedBehavior> children) { return BatchedBehavior{ BatchedNodeType::PartialSequence, children, nullptr, nullptr }; }
+	inline BatchedBehavior BatchedConditionalLeaf(BatchedConditional fp) { return BatchedBehavior{ BatchedNodeType::Conditional, {}, fp, nullptr }; }
+	inline BatchedBehavior BatchedInvertedConditionalLeaf(BatchedConditional fp) { return BatchedBehavior{ BatchedNodeType::InvertedConditional, {}, fp, nullptr }; }
+	inline BatchedBehavior BatchedActionLeaf(BatchedAction fp) { return BatchedBehavior{ BatchedNodeType::Action, {}, nullptr, fp }; }
+
+	//-----------------------------------------------------------------
+	// BATCHED BEHAVIOR TREE
+	//-----------------------------------------------------------------
+	// The description gets flattened in pre-order. A node only ever hands agents on to
+	// nodes further down that order (its first child, the next sibling of itself or of an
+	// ancestor), so one sweep over the nodes ticks every agent: each node is visited once
+	// with every agent that reached it this tick and each leaf function runs once per batch.
+	// Results are the same as ticking a BehaviorTree per agent. Agents are split in chunks
+	// of ChunkSize that sweep the tree on their own, spread over the job system.
+	// What the agents know lives with the caller (pAgents), the tree only keeps its own
+	// per-agent state: the result of the last tick & where partial sequences are at.
+	class BatchedBehaviorTree final
+	{
+	public:
+		static const unsigned int ChunkSize = 256;
+		static const unsigned int NoNode = 0xFFFFFFFF;
+
+		explicit BatchedBehaviorTree(const BatchedBehavior& root);
+
+		void SetAgentCount(unsigned int agentCount);
+		unsigned int GetAgentCount() const { return m_AgentCount; }
+
+		void Update(void* pAgents, JobSystem& jobSystem);
+		BehaviorState GetState(unsigned int agent) const { return m_States[agent]; }
+
+		unsigned int GetNodeCount() const { return static_cast<unsigned int>(m_Nodes.size()); }
+		//Leaf function calls & the agents they got, summed over every update
+		unsigned int GetLeafCallCount() const { return m_LeafCallCount.load(std::memory_order_relaxed); }
+		unsigned int GetLeafAgentCount() const { return m_LeafAgentCount.load(std::memory_order_relaxed); }
+
+	private:
+		struct Node
+		{
+			BatchedNodeType type;
+			unsigned int parent;
+			unsigned int nextSibling;
+			unsigned int firstChild; //Into m_Children
+			unsigned int childCount;
+			unsigned int partialSlot; //Partial sequences only, which of the per-agent indices is theirs
+			BatchedConditional fpConditional;
+			BatchedAction fpAction;
+		};
+
+		//Scratch of one chunk, the agents waiting at every node
+		struct Chunk
+		{
+			std::vector<std::vector<unsigned int>> arrivals;
+			bool conditionResults[ChunkSize];
+			BehaviorState actionResults[ChunkSize];
+		};
+
+		std::vector<Node> m_Nodes = {};
+		std::vector<unsigned int> m_Children = {};
+		unsigned int m_PartialSequenceCount = 0;
+
+		unsigned int m_AgentCount = 0;
+		std::vector<BehaviorState> m_States = {};
+		std::vector<unsigned char> m_PartialIndices = {}; //Partial sequence major
+		std::vector<Chunk> m_Chunks = {};
+
+		void* m_pUpdateAgents = nullptr;
+		std::atomic<unsigned int> m_LeafCallCount{ 0 };
+		std::atomic<unsigned int> m_LeafAgentCount{ 0 };
+
+		unsigned int Flatten(const BatchedBehavior& behavior, unsigned int parent);
+		static void UpdateChunks(void* pData, unsigned int begin, unsigned int end);
+		void UpdateChunk(unsigned int chunk);
+		void Enter(Chunk& chunk, unsigned int node, unsigned int agent);
+		//Hands the result up until a composite sends the agent on or the root is done with it
+		void Resolve(Chunk& chunk, unsigned int node, unsigned int agent, BehaviorState state);
+	};
+}
+#endif
@@ -33,6 +33,16 @@ namespace Elite
 		virtual ~IBehavior() = default;
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) = 0;
 
+		//Composites walk their children, so both ends need a tree that was built the same way
+		virtual void SaveState(CheckpointWriter& writer) const { writer.Write(m_CurrentState); }
+		virtual void LoadState(CheckpointReader& reader) { reader.Read(m_CurrentState); }
+		//Reads what LoadState would without changing anything, false when it doesn't fit this behavior
+		virtual bool ValidateState(CheckpointReader& reader) const
+		{
+			BehaviorState state = Failure;
+			return reader.Read(state) && state >= Failure && state <= Running;
+		}
+
 	protected:
 		BehaviorState m_CurrentState = Failure;
 	};
@@ -56,6 +66,34 @@ namespace Elite
 
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) override = 0;
 
+		virtual void SaveState(CheckpointWriter& writer) const override
+		{
+			IBehavior::SaveState(writer);
+			writer.Write(static_cast<unsigned int>(m_ChildrenBehaviors.size()));
+			for (const IBehavior* pChild : m_ChildrenBehaviors)
+				pChild->SaveState(writer);
+		}
+		virtual void LoadState(CheckpointReader& reader) override
+		{
+			IBehavior::LoadState(reader);
+			unsigned int childCount = 0;
+			reader.Read(childCount);
+			for (IBehavior* pChild : m_ChildrenBehaviors)
+				pChild->LoadState(reader);
+		}
+		virtual bool ValidateState(CheckpointReader& reader) const override
+		{
+			unsigned int childCount = 0;
+			if (!IBehavior::ValidateState(reader) || !reader.Read(childCount) || childCount != m_ChildrenBehaviors.size())
+				return false;
+			for (const IBehavior* pChild : m_ChildrenBehaviors)
+			{
+				if (!pChild->ValidateState(reader))
+					return false;
+			}
+			return true;
+		}
+
 	protected:
 		std::vector<IBehavior*> m_ChildrenBehaviors = {};
 	};
@@ -92,6 +130,22 @@ namespace Elite
 
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
 
+		virtual void SaveState(CheckpointWriter& writer) const override
+		{
+			BehaviorSequence::SaveState(writer);
+			writer.Write(m_CurrentBehaviorIndex);
+		}
+		virtual void LoadState(CheckpointReader& reader) override
+		{
+			BehaviorSequence::LoadState(reader);
+			reader.Read(m_CurrentBehaviorIndex);
+		}
+		virtual bool ValidateState(CheckpointReader& reader) const override
+		{
+			unsigned int behaviorIndex = 0;
+			return BehaviorSequence::ValidateState(reader) && reader.Read(behaviorIndex) && behaviorIndex < m_ChildrenBehaviors.size();
+		}
+
 	private:
 		unsigned int m_CurrentBehaviorIndex = 0;
 	};
@@ -160,6 +214,32 @@ namespace Elite
 				
 			m_CurrentState = m_pRootComposite->Execute(m_pBlackBoard);
 		}
+
+		virtual void SaveState(CheckpointWriter& writer) const override
+		{
+			writer.WriteTag("BTRE");
+			writer.Write(m_CurrentState);
+			if (m_pRootComposite)
+				m_pRootComposite->SaveState(writer);
+		}
+		virtual bool LoadState(CheckpointReader& reader) override
+		{
+			//Checked on a copy of the reader first
+			CheckpointReader checkReader = reader;
+			if (!ValidateState(checkReader))
+				return false;
+
+			reader.ReadTag("BTRE");
+			reader.Read(m_CurrentState);
+			if (m_pRootComposite)
+				m_pRootComposite->LoadState(reader);
+			return reader.IsValid();
+		}
+		virtual bool ValidateState(CheckpointReader& reader) const override
+		{
+			BehaviorState state = Failure;
+			return reader.ReadTag("BTRE") && reader.Read(state) && (!m_pRootComposite || m_pRootComposite->ValidateState(reader));
+		}
 		Blackboard* GetBlackboard() const
 		{ return m_pBlackBoard;	}
 
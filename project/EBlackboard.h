@@ -9,7 +9,10 @@
 
 //Includes
 #include <unordered_map>
+#include <unordered_set>
 #include "stdafx.h"
+#include "EBlackboardJournal.h"
+#include "ECheckpoint.h"
 
 namespace Elite
 {
@@ -21,6 +24,12 @@ namespace Elite
 	public:
 		IBlackBoardField() = default;
 		virtual ~IBlackBoardField() = default;
+
+		//Bytes the value takes in a checkpoint, 0 when it isn't checkpointed
+		virtual unsigned int GetStateSize() const = 0;
+		virtual void SaveState(CheckpointWriter& writer) const = 0;
+		//The restored value is recorded in the journal like any other change
+		virtual void LoadState(const unsigned char* pBytes, BlackboardJournal& journal, unsigned int key) = 0;
 	};
 
 	//BlackboardField does not take ownership of pointers whatsoever!
@@ -33,68 +42,201 @@ namespace Elite
 		T GetData() { return m_Data; };
 		void SetData(T data) { m_Data = data; }
 
+		//Pointers are how the plugin hands its objects to the behaviors, those objects are checkpointed themselves
+		virtual unsigned int GetStateSize() const override { return IsCheckpointed::value ? sizeof(T) : 0; }
+		virtual void SaveState(CheckpointWriter& writer) const override { SaveState(writer, IsCheckpointed{}); }
+		virtual void LoadState(const unsigned char* pBytes, BlackboardJournal& journal, unsigned int key) override
+		{
+			if (LoadState(pBytes, IsCheckpointed{}))
+				journal.Record(key, m_Data);
+		}
+
 	private:
+		using IsCheckpointed = std::integral_constant<bool, std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value>;
+
 		T m_Data;
+
+		void SaveState(CheckpointWriter& writer, std::true_type) const { writer.Write(m_Data); }
+		void SaveState(CheckpointWriter&, std::false_type) const {}
+		bool LoadState(const unsigned char* pBytes, std::true_type) { memcpy(&m_Data, pBytes, sizeof(T)); return true; }
+		bool LoadState(const unsigned char*, std::false_type) { return false; }
+	};
+
+	//Id of a blackboard entry, looking it up once saves hashing the name on every access
+	struct BlackboardKey
+	{
+		unsigned int id;
+	};
+
+	//Values read from a checkpoint, only applied once every entry checked out
+	struct BlackboardState
+	{
+		std::vector<unsigned char> bytes = {}; //Entry after entry, GetStateSize bytes each
 	};
 
 	//-----------------------------------------------------------------
 	// BLACKBOARD (BASE)
 	//-----------------------------------------------------------------
+	// Every AddData & ChangeData is recorded in the journal.
 	class Blackboard final
 	{
 	public:
+		static const unsigned int NoKey = 0xFFFFFFFF;
+
 		~Blackboard()
 		{
-			for (auto el : m_BlackboardData)
-				SAFE_DELETE(el.second);
-			m_BlackboardData.clear();
+			for (auto pField : m_Fields)
+				SAFE_DELETE(pField);
+			m_Fields.clear();
 		}
 
 		//Add data to the blackboard
 		template<typename T> bool AddData(const std::string& name, T data)
 		{
-			auto it = m_BlackboardData.find(name);
-			if (it == m_BlackboardData.end())
+			auto it = m_KeyIds.find(name);
+			if (it == m_KeyIds.end())
 			{
-				m_BlackboardData[name] = new BlackboardField<T>(data);
+				const unsigned int size = std::is_trivially_copyable<T>::value ? sizeof(T) : 0;
+				const unsigned int key = m_Journal.AddKey(name, size, &JournalFormat<T>::Format);
+				m_KeyIds[name] = key;
+				m_Fields.push_back(new BlackboardField<T>(data));
+				m_Journal.Record(key, data);
 				return true;
 			}
 			printf("WARNING: Data '%s' of type '%s' already in Blackboard \n", name.c_str(), typeid(T).name());
 			return false;
 		}
 
+		BlackboardKey GetKey(const std::string& name) const
+		{
+			auto it = m_KeyIds.find(name);
+			return BlackboardKey{ it == m_KeyIds.end() ? NoKey : it->second };
+		}
+
 		//Change the data of the blackboard
-		template<typename T> bool ChangeData(const std::string& name, T data)
+		template<typename T> bool ChangeData(BlackboardKey key, T data)
 		{
-			auto it = m_BlackboardData.find(name);
-			if (it != m_BlackboardData.end())
+			BlackboardField<T>* p = GetField<T>(key);
+			if (p)
 			{
-				BlackboardField<T>* p = dynamic_cast<BlackboardField<T>*>(m_BlackboardData[name]);
-				if (p)
-				{
-					p->SetData(data);
-					return true;
-				}
+				p->SetData(data);
+				m_Journal.Record(key.id, data);
+				return true;
 			}
-			printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", name.c_str(), typeid(T).name());
+			WarnMissing(key, typeid(T).name());
 			return false;
 		}
+		template<typename T> bool ChangeData(const std::string& name, T data)
+		{
+			return ChangeData(GetKey(name), data) || WarnMissing(name, typeid(T).name());
+		}
 
 		//Get the data from the blackboard
-		template<typename T> bool GetData(const std::string& name, T& data)
+		template<typename T> bool GetData(BlackboardKey key, T& data)
 		{
-			BlackboardField<T>* p = dynamic_cast<BlackboardField<T>*>(m_BlackboardData[name]);
+			BlackboardField<T>* p = GetField<T>(key);
 			if (p != nullptr)
 			{
 				data = p->GetData();
 				return true;
 			}
-			printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", name.c_str(), typeid(T).name());
+			WarnMissing(key, typeid(T).name());
 			return false;
 		}
+		template<typename T> bool GetData(const std::string& name, T& data)
+		{
+			return GetData(GetKey(name), data) || WarnMissing(name, typeid(T).name());
+		}
+
+		//Every entry's name & size, with the value when it isn't a pointer, in the order the entries were added
+		void SaveState(CheckpointWriter& writer) const
+		{
+			writer.WriteTag("BLBD");
+			writer.Write(static_cast<unsigned int>(m_Fields.size()));
+			for (unsigned int key = 0; key < m_Fields.size(); ++key)
+			{
+				writer.WriteString(m_Journal.GetKeyName(key));
+				writer.Write(m_Fields[key]->GetStateSize());
+				m_Fields[key]->SaveState(writer);
+			}
+		}
+		//Checks every entry against this blackboard without changing it, false when any doesn't match
+		bool ReadState(CheckpointReader& reader, BlackboardState& state) const
+		{
+			unsigned int fieldCount = 0;
+			if (!reader.ReadTag("BLBD") || !reader.Read(fieldCount))
+				return false;
+			if (fieldCount != m_Fields.size())
+			{
+				printf("WARNING: Checkpoint has %u blackboard entries where %u were expected \n", fieldCount, static_cast<unsigned int>(m_Fields.size()));
+				return false;
+			}
+
+			//Names are compared where they are in the checkpoint, a state that's read into again doesn't allocate
+			state.bytes.clear();
+			for (unsigned int key = 0; key < fieldCount; ++key)
+			{
+				const char* pName = nullptr;
+				unsigned int nameLength = 0, size = 0;
+				if (!reader.ReadString(pName, nameLength) || !reader.Read(size))
+					return false;
+				if (m_Journal.GetKeyName(key).compare(0, std::string::npos, pName, nameLength) != 0 || size != m_Fields[key]->GetStateSize())
+				{
+					printf("WARNING: Checkpoint has blackboard entry '%.*s' of %u bytes where '%s' of %u bytes was expected \n",
+						int(nameLength), pName, size, m_Journal.GetKeyName(key).c_str(), m_Fields[key]->GetStateSize());
+					return false;
+				}
+
+				state.bytes.resize(state.bytes.size() + size);
+				if (!reader.ReadBytes(state.bytes.data() + state.bytes.size() - size, size))
+					return false;
+			}
+			return true;
+		}
+		//A state ReadState accepted
+		void ApplyState(const BlackboardState& state)
+		{
+			unsigned int offset = 0;
+			for (unsigned int key = 0; key < m_Fields.size(); ++key)
+			{
+				m_Fields[key]->LoadState(state.bytes.data() + offset, m_Journal, key);
+				offset += m_Fields[key]->GetStateSize();
+			}
+		}
+		//Nothing changes unless the whole part checks out
+		bool LoadState(CheckpointReader& reader)
+		{
+			BlackboardState state{};
+			if (!ReadState(reader, state))
+				return false;
+			ApplyState(state);
+			return true;
+		}
+
+		BlackboardJournal& GetJournal() { return m_Journal; }
+		const BlackboardJournal& GetJournal() const { return m_Journal; }
 
 	private:
-		std::unordered_map<std::string, IBlackBoardField*> m_BlackboardData;
+		std::unordered_map<std::string, unsigned int> m_KeyIds;
+		std::vector<IBlackBoardField*> m_Fields;
+		BlackboardJournal m_Journal;
+		std::unordered_set<std::string> m_WarnedNames; //Each missing name is only reported once, printing every tick wrecks the timing
+
+		template<typename T> BlackboardField<T>* GetField(BlackboardKey key) const
+		{
+			return key.id < m_Fields.size() ? dynamic_cast<BlackboardField<T>*>(m_Fields[key.id]) : nullptr;
+		}
+		void WarnMissing(BlackboardKey key, const char* typeName)
+		{
+			if (key.id < m_Fields.size())
+				WarnMissing(m_Journal.GetKeyName(key.id), typeName);
+		}
+		bool WarnMissing(const std::string& name, const char* typeName)
+		{
+			if (m_WarnedNames.insert(name).second)
+				printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", name.c_str(), typeName);
+			return false;
+		}
 	};
 }
 #endif
\ No newline at end of file
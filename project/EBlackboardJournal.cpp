@@ -0,0 +1,261 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EBlackboardJournal.h"
+using namespace Elite;
+
+namespace
+{
+	const char JournalMagic[4] = { 'B', 'B', 'J', '1' };
+
+	//Folding copies the same few bytes over & over, a word at a time beats calling memcpy for that
+	void CopyBytes(unsigned char* pTo, const unsigned char* pFrom, unsigned int size)
+	{
+		unsigned int b = 0;
+		for (; b + 8 <= size; b += 8)
+			memcpy(pTo + b, pFrom + b, 8);
+		for (; b < size; ++b)
+			pTo[b] = pFrom[b];
+	}
+
+	template<typename T>
+	void WriteValue(std::ofstream& file, const T& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+	template<typename T>
+	bool ReadValue(std::ifstream& file, T& value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+}
+
+//-----------------------------------------------------------------
+// JOURNAL FORMATTERS
+//-----------------------------------------------------------------
+void Elite::FormatJournalBytes(const unsigned char* bytes, unsigned int size, char* text, unsigned int textSize)
+{
+	if (size == 0)
+	{
+		snprintf(text, textSize, "(not recorded)");
+		return;
+	}
+
+	unsigned int written = 0;
+	for (unsigned int b = 0; b < size && written + 4 < textSize; ++b)
+		written += snprintf(text + written, textSize - written, "%02x ", bytes[b]);
+	if (written > 0)
+		text[written - 1] = '\0';
+}
+
+//-----------------------------------------------------------------
+// BLACKBOARD JOURNAL
+//-----------------------------------------------------------------
+const unsigned int BlackboardJournal::Capacity;
+const unsigned int BlackboardJournal::PayloadSize;
+const unsigned int BlackboardJournal::FoldSize;
+
+BlackboardJournal::BlackboardJournal()
+	: m_Entries(Capacity)
+{
+}
+
+unsigned int BlackboardJournal::AddKey(const std::string& name, unsigned int valueSize, JournalFormatter fpFormatter)
+{
+	assert(m_Keys.size() < NoKey && valueSize <= PayloadSize * 255 && "Too many keys or too big a value for the journal");
+
+	const unsigned int key = static_cast<unsigned int>(m_Keys.size());
+	m_Keys.push_back(Key{ name, static_cast<unsigned int>(m_Base.size()), valueSize, fpFormatter });
+	m_Base.resize(m_Base.size() + valueSize, 0);
+	return key;
+}
+
+unsigned int BlackboardJournal::GetOldestTick() const
+{
+	if (m_WriteCount == m_FoldedCount)
+		return m_Tick;
+	return m_Entries[m_FoldedCount % Capacity].tick;
+}
+
+void BlackboardJournal::Append(unsigned int key, const void* pValue, unsigned int size)
+{
+	const unsigned char* pBytes = static_cast<const unsigned char*>(pValue);
+	unsigned int part = 0;
+	do
+	{
+		if (m_WriteCount - m_FoldedCount == Capacity)
+			FoldOldest();
+
+		Entry& entry = m_Entries[m_WriteCount % Capacity];
+		const unsigned int offset = part * PayloadSize;
+		const unsigned int partSize = std::min(size - offset, PayloadSize);
+		entry.tick = m_Tick;
+		entry.key = static_cast<unsigned short>(key);
+		entry.part = static_cast<unsigned char>(part);
+		entry.size = static_cast<unsigned char>(partSize);
+		if (partSize > 0)
+			memcpy(entry.bytes, pBytes + offset, partSize);
+
+		++m_WriteCount;
+		++part;
+	} while (part * PayloadSize < size);
+}
+
+void BlackboardJournal::FoldOldest()
+{
+	//A block at a time, folding an entry per write reads the ring a cold line at a time.
+	//The block runs on to the end of its last tick, so every tick left has all its changes in the ring
+	unsigned long long end = m_FoldedCount + FoldSize;
+	const unsigned int lastTick = m_Entries[(end - 1) % Capacity].tick;
+	while (end < m_WriteCount && m_Entries[end % Capacity].tick == lastTick)
+		++end;
+	for (unsigned long long i = m_FoldedCount; i < end; ++i)
+		Apply(m_Entries[i % Capacity], m_Base);
+	m_FoldedCount = end;
+}
+
+void BlackboardJournal::Apply(const Entry& entry, std::vector<unsigned char>& image) const
+{
+	if (entry.size > 0)
+		CopyBytes(image.data() + m_Keys[entry.key].offset + entry.part * PayloadSize, entry.bytes, entry.size);
+}
+
+void BlackboardJournal::Rebuild(unsigned int tick, std::vector<unsigned char>& image) const
+{
+	image = m_Base;
+	for (unsigned long long i = m_FoldedCount; i < m_WriteCount; ++i)
+	{
+		const Entry& entry = m_Entries[i % Capacity];
+		if (entry.tick > tick)
+			break;
+		Apply(entry, image);
+	}
+}
+
+bool BlackboardJournal::UpdateView(unsigned int tick, JournalView& view) const
+{
+	const bool isValid = view.generation == m_Generation && view.image.size() == m_Base.size()
+		&& view.position >= m_FoldedCount && view.position <= m_WriteCount;
+	if (isValid && view.tick == tick && view.writeCount == m_WriteCount)
+		return false;
+
+	//The image only holds the entries up to position, the base image has everything folded since
+	if (!isValid || tick < view.tick)
+	{
+		view.image = m_Base;
+		view.position = m_FoldedCount;
+		view.generation = m_Generation;
+	}
+	for (; view.position < m_WriteCount; ++view.position)
+	{
+		const Entry& entry = m_Entries[view.position % Capacity];
+		if (entry.tick > tick)
+			break;
+		Apply(entry, view.image);
+	}
+	view.tick = tick;
+	view.writeCount = m_WriteCount;
+
+	//The tick's own entries are the last ones applied
+	view.isKeyChanged.assign(m_Keys.size(), 0);
+	for (unsigned long long i = view.position; i > m_FoldedCount; --i)
+	{
+		const Entry& entry = m_Entries[(i - 1) % Capacity];
+		if (entry.tick != tick)
+			break;
+		view.isKeyChanged[entry.key] = 1;
+	}
+	return true;
+}
+
+void BlackboardJournal::FormatValue(const std::vector<unsigned char>& image, unsigned int key, char* text, unsigned int textSize) const
+{
+	const Key& info = m_Keys[key];
+	const unsigned char* pBytes = image.data() + info.offset;
+	if (info.fpFormatter && info.size > 0)
+		info.fpFormatter(pBytes, info.size, text, textSize);
+	else
+		FormatJournalBytes(pBytes, info.size, text, textSize);
+}
+
+unsigned int BlackboardJournal::CountChanges(unsigned int key, unsigned int fromTick, unsigned int toTick) const
+{
+	unsigned int changes = 0;
+	for (unsigned long long i = m_FoldedCount; i < m_WriteCount; ++i)
+	{
+		const Entry& entry = m_Entries[i % Capacity];
+		if (entry.tick > toTick)
+			break;
+		if (entry.key == key && entry.part == 0 && entry.tick >= fromTick)
+			++changes;
+	}
+	return changes;
+}
+
+bool BlackboardJournal::Dump(const char* filePath) const
+{
+	std::ofstream file{ filePath, std::ios::binary };
+	if (!file)
+		return false;
+
+	file.write(JournalMagic, sizeof(JournalMagic));
+	WriteValue(file, static_cast<unsigned int>(m_Keys.size()));
+	for (const Key& key : m_Keys)
+	{
+		WriteValue(file, static_cast<unsigned int>(key.name.size()));
+		file.write(key.name.data(), key.name.size());
+		WriteValue(file, key.size);
+	}
+
+	//Oldest entry first, so the file reads like a ring that never wrapped
+	WriteValue(file, static_cast<unsigned int>(m_Base.size()));
+	file.write(reinterpret_cast<const char*>(m_Base.data()), m_Base.size());
+	WriteValue(file, m_Tick);
+	WriteValue(file, m_WriteCount - m_FoldedCount);
+	for (unsigned long long i = m_FoldedCount; i < m_WriteCount; ++i)
+		WriteValue(file, m_Entries[i % Capacity]);
+	return static_cast<bool>(file);
+}
+
+bool BlackboardJournal::Load(const char* filePath)
+{
+	std::ifstream file{ filePath, std::ios::binary };
+	char magic[sizeof(JournalMagic)] = {};
+	if (!file.read(magic, sizeof(magic)) || memcmp(magic, JournalMagic, sizeof(magic)) != 0)
+		return false;
+
+	unsigned int keyCount = 0;
+	if (!ReadValue(file, keyCount))
+		return false;
+
+	std::vector<Key> keys{};
+	unsigned int offset = 0;
+	for (unsigned int k = 0; k < keyCount; ++k)
+	{
+		unsigned int nameLength = 0;
+		if (!ReadValue(file, nameLength))
+			return false;
+		std::string name(nameLength, '\0');
+		unsigned int size = 0;
+		if (!file.read(&name[0], nameLength) || !ReadValue(file, size))
+			return false;
+		keys.push_back(Key{ name, offset, size, nullptr });
+		offset += size;
+	}
+
+	unsigned int baseSize = 0;
+	if (!ReadValue(file, baseSize) || baseSize != offset)
+		return false;
+	std::vector<unsigned char> base(baseSize);
+	unsigned int tick = 0;
+	unsigned long long entryCount = 0;
+	if (!file.read(reinterpret_cast<char*>(base.data()), baseSize) || !ReadValue(file, tick) || !ReadValue(file, entryCount) || entryCount > Capacity)
+		return false;
+
+	for (unsigned long long i = 0; i < entryCount; ++i)
+	{
+		if (!ReadValue(file, m_Entries[i]))
+			return false;
+	}
+
+	m_Keys = std::move(keys);
+	m_Base = std::move(base);
+	m_Tick = tick;
+	m_WriteCount = entryCount;
+	m_FoldedCount = 0;
+	++m_Generation;
+	return true;
+}
@@ -0,0 +1,170 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EBlackboardJournal.h: Every blackboard change in a fixed ring, to rebuild past ticks
+/*=============================================================================*/
+#ifndef ELITE_BLACKBOARD_JOURNAL
+#define ELITE_BLACKBOARD_JOURNAL
+
+//--- Includes ---
+#include <vector>
+#include <string>
+#include <type_traits>
+#include <cstring>
+#include "EliteMath/EMath.h"
+
+namespace Elite
+{
+	//Writes a readable version of a recorded value into text
+	using JournalFormatter = void(*)(const unsigned char* bytes, unsigned int size, char* text, unsigned int textSize);
+
+	//-----------------------------------------------------------------
+	// JOURNAL FORMATTERS
+	//-----------------------------------------------------------------
+	// Anything without a formatter of its own is shown as bytes
+	void FormatJournalBytes(const unsigned char* bytes, unsigned int size, char* text, unsigned int textSize);
+
+	template<typename T>
+	struct JournalFormat
+	{
+		static void Format(const unsigned char* bytes, unsigned int size, char* text, unsigned int textSize) { FormatJournalBytes(bytes, size, text, textSize); }
+	};
+	template<typename T>
+	struct JournalFormat<T*>
+	{
+		static void Format(const unsigned char* bytes, unsigned int, char* text, unsigned int textSize)
+		{
+			T* pointer = nullptr;
+			memcpy(&pointer, bytes, sizeof(pointer));
+			snprintf(text, textSize, "%p", static_cast<const void*>(pointer));
+		}
+	};
+	template<>
+	struct JournalFormat<bool>
+	{
+		static void Format(const unsigned char* bytes, unsigned int, char* text, unsigned int textSize) { snprintf(text, textSize, "%s", bytes[0] ? "true" : "false"); }
+	};
+	template<>
+	struct JournalFormat<int>
+	{
+		static void Format(const unsigned char* bytes, unsigned int, char* text, unsigned int textSize)
+		{
+			int value = 0;
+			memcpy(&value, bytes, sizeof(value));
+			snprintf(text, textSize, "%d", value);
+		}
+	};
+	template<>
+	struct JournalFormat<float>
+	{
+		static void Format(const unsigned char* bytes, unsigned int, char* text, unsigned int textSize)
+		{
+			float value = 0.f;
+			memcpy(&value, bytes, sizeof(value));
+			snprintf(text, textSize, "%.3f", value);
+		}
+	};
+	template<>
+	struct JournalFormat<Vector2>
+	{
+		static void Format(const unsigned char* bytes, unsigned int, char* text, unsigned int textSize)
+		{
+			Vector2 value{};
+			memcpy(&value, bytes, sizeof(value));
+			snprintf(text, textSize, "(%.2f, %.2f)", value.x, value.y);
+		}
+	};
+
+	//-----------------------------------------------------------------
+	// JOURNAL VIEW
+	//-----------------------------------------------------------------
+	// One rebuilt tick that's kept up to date by the journal. Staying on a tick costs nothing,
+	// moving forward only applies the entries in between, going back rebuilds from the base image.
+	struct JournalView
+	{
+		unsigned int tick = 0;
+		unsigned long long position = 0; //Entries before this one are in the image
+		unsigned long long writeCount = 0; //Of the journal at the last update
+		unsigned int generation = 0; //Of the journal's contents, a Load starts over
+		std::vector<unsigned char> image = {};
+		std::vector<unsigned char> isKeyChanged = {}; //Per key, whether it changed in the tick
+	};
+
+	//-----------------------------------------------------------------
+	// BLACKBOARD JOURNAL
+	//-----------------------------------------------------------------
+	// Appending copies the value into one or more fixed-size entries of a ring, no locks &
+	// no allocations. Types that can't be copied as bytes only leave a mark that they changed.
+	// Before the ring overwrites its oldest entries they're folded into a base image, so any
+	// tick still in the ring can be rebuilt: the base image plus every entry up to it.
+	// Owned by the blackboard & only touched by the thread that owns the blackboard.
+	class BlackboardJournal final
+	{
+	public:
+		static const unsigned int Capacity = 1 << 16; //Entries, 2 MB
+		static const unsigned int PayloadSize = 24;
+		static const unsigned int FoldSize = 1 << 10; //Entries folded into the base image at once, rounded up to whole ticks
+		static const unsigned int NoKey = 0xFFFF;
+
+		struct Entry
+		{
+			unsigned int tick;
+			unsigned short key;
+			unsigned char part; //Which PayloadSize slice of the value
+			unsigned char size; //Bytes used in this entry
+			unsigned char bytes[PayloadSize];
+		};
+
+		BlackboardJournal();
+
+		unsigned int AddKey(const std::string& name, unsigned int valueSize, JournalFormatter fpFormatter);
+		template<typename T>
+		void Record(unsigned int key, const T& value) { Record(key, value, std::is_trivially_copyable<T>{}); }
+		void NextTick() { ++m_Tick; }
+
+		unsigned int GetTick() const { return m_Tick; }
+		//Oldest tick that can still be rebuilt
+		unsigned int GetOldestTick() const;
+		unsigned int GetKeyCount() const { return static_cast<unsigned int>(m_Keys.size()); }
+		const std::string& GetKeyName(unsigned int key) const { return m_Keys[key].name; }
+		unsigned long long GetWriteCount() const { return m_WriteCount; }
+
+		//Every value as it was at the end of that tick, one image with the keys at their offsets
+		void Rebuild(unsigned int tick, std::vector<unsigned char>& image) const;
+		//Moves the view to the end of that tick, returns false when nothing had to change
+		bool UpdateView(unsigned int tick, JournalView& view) const;
+		void FormatValue(const std::vector<unsigned char>& image, unsigned int key, char* text, unsigned int textSize) const;
+		//Ticks in which the key changed, within the rebuildable range
+		unsigned int CountChanges(unsigned int key, unsigned int fromTick, unsigned int toTick) const;
+
+		bool Dump(const char* filePath) const;
+		//Replaces the keys & entries, formatters don't survive a dump so everything shows as bytes
+		bool Load(const char* filePath);
+
+	private:
+		struct Key
+		{
+			std::string name;
+			unsigned int offset; //Into the images
+			unsigned int size; //0 when only changes are recorded
+			JournalFormatter fpFormatter;
+		};
+
+		std::vector<Entry> m_Entries;
+		std::vector<Key> m_Keys = {};
+		std::vector<unsigned char> m_Base = {}; //Values before the oldest entry still in the ring
+		unsigned long long m_WriteCount = 0;
+		unsigned long long m_FoldedCount = 0; //Oldest entry that isn't part of the base image yet
+		unsigned int m_Tick = 0;
+		unsigned int m_Generation = 0;
+
+		template<typename T>
+		void Record(unsigned int key, const T& value, std::true_type) { Append(key, &value, sizeof(T)); }
+		template<typename T>
+		void Record(unsigned int key, const T&, std::false_type) { Append(key, nullptr, 0); }
+		void Append(unsigned int key, const void* pValue, unsigned int size);
+		void FoldOldest();
+		void Apply(const Entry& entry, std::vector<unsigned char>& image) const;
+	};
+}
+#endif
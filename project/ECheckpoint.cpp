@@ -0,0 +1,89 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "ECheckpoint.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// CHECKPOINT WRITER
+//-----------------------------------------------------------------
+void CheckpointWriter::WriteBytes(const void* pBytes, size_t size)
+{
+	const size_t offset = m_Blob.size();
+	m_Blob.resize(offset + size);
+	if (size > 0)
+		memcpy(m_Blob.data() + offset, pBytes, size);
+}
+
+//-----------------------------------------------------------------
+// CHECKPOINT READER
+//-----------------------------------------------------------------
+bool CheckpointReader::ReadString(std::string& text)
+{
+	unsigned int length = 0;
+	if (!Read(length) || !CanRead(length))
+		return Fail();
+
+	text.assign(reinterpret_cast<const char*>(m_pData + m_Position), length);
+	m_Position += length;
+	return true;
+}
+
+bool CheckpointReader::ReadString(const char*& pText, unsigned int& length)
+{
+	unsigned int readLength = 0;
+	if (!Read(readLength) || !CanRead(readLength))
+		return Fail();
+
+	pText = reinterpret_cast<const char*>(m_pData + m_Position);
+	length = readLength;
+	m_Position += readLength;
+	return true;
+}
+
+bool CheckpointReader::ReadTag(const char(&tag)[5])
+{
+	char readTag[4] = {};
+	if (!ReadBytes(readTag, sizeof(readTag)))
+		return false;
+	if (memcmp(readTag, tag, sizeof(readTag)) != 0)
+	{
+		printf("WARNING: Checkpoint has '%.4s' where '%s' was expected \n", readTag, tag);
+		return Fail();
+	}
+	return true;
+}
+
+bool CheckpointReader::ReadBytes(void* pBytes, size_t size)
+{
+	if (!CanRead(size))
+		return Fail();
+
+	if (size > 0)
+		memcpy(pBytes, m_pData + m_Position, size);
+	m_Position += size;
+	return true;
+}
+
+//-----------------------------------------------------------------
+// CHECKPOINT FILES
+//-----------------------------------------------------------------
+bool Elite::WriteCheckpointFile(const char* filePath, const std::vector<unsigned char>& blob)
+{
+	std::ofstream file{ filePath, std::ios::binary };
+	if (!file)
+		return false;
+	file.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+	return static_cast<bool>(file);
+}
+
+bool Elite::ReadCheckpointFile(const char* filePath, std::vector<unsigned char>& blob)
+{
+	std::ifstream file{ filePath, std::ios::binary | std::ios::ate };
+	if (!file)
+		return false;
+
+	const std::streamsize size = file.tellg();
+	file.seekg(0);
+	blob.resize(static_cast<size_t>(size));
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(blob.data()), size));
+}
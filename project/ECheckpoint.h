@@ -0,0 +1,122 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// ECheckpoint.h: Flat binary checkpoints of state, to fork runs from
+/*=============================================================================*/
+#ifndef ELITE_CHECKPOINT
+#define ELITE_CHECKPOINT
+
+//--- Includes ---
+#include <vector>
+#include <string>
+#include <cstring>
+#include <type_traits>
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// CHECKPOINT WRITER
+	//-----------------------------------------------------------------
+	// Values are stored as their bytes, arrays as a count followed by their elements. Nothing
+	// in the blob points anywhere, so it can be written to a file as is & read back from a
+	// mapped view of that file. Reading it back needs everything set up the same way.
+	class CheckpointWriter final
+	{
+	public:
+		explicit CheckpointWriter(std::vector<unsigned char>& blob) : m_Blob(blob) { m_Blob.clear(); }
+
+		template<typename T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only types that can be copied as bytes go in a checkpoint");
+			WriteBytes(&value, sizeof(T));
+		}
+		template<typename T>
+		void WriteArray(const std::vector<T>& values)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only types that can be copied as bytes go in a checkpoint");
+			Write(static_cast<unsigned int>(values.size()));
+			WriteBytes(values.data(), values.size() * sizeof(T));
+		}
+		void WriteString(const std::string& text)
+		{
+			Write(static_cast<unsigned int>(text.size()));
+			WriteBytes(text.data(), text.size());
+		}
+		//Marks the start of a part, reading it back checks it's the part that was expected
+		void WriteTag(const char(&tag)[5]) { WriteBytes(tag, 4); }
+		void WriteBytes(const void* pBytes, size_t size);
+
+	private:
+		std::vector<unsigned char>& m_Blob;
+	};
+
+	//-----------------------------------------------------------------
+	// CHECKPOINT READER
+	//-----------------------------------------------------------------
+	// Reads straight from the memory it's given, arrays are assigned into the existing vectors
+	// so restoring into the same objects over & over doesn't allocate. Once a read runs past the
+	// end or a tag doesn't match, every following read fails & leaves its target untouched.
+	// A copy reads on from the same position without moving the original, to check a part
+	// before loading it for real.
+	class CheckpointReader final
+	{
+	public:
+		CheckpointReader(const unsigned char* pData, size_t size) : m_pData(pData), m_Size(size) {}
+
+		template<typename T>
+		bool Read(T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only types that can be copied as bytes go in a checkpoint");
+			return ReadBytes(&value, sizeof(T));
+		}
+		template<typename T>
+		bool ReadArray(std::vector<T>& values)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only types that can be copied as bytes go in a checkpoint");
+			unsigned int count = 0;
+			if (!Read(count) || !CanRead(size_t(count) * sizeof(T)))
+				return Fail();
+
+			const T* pFirst = reinterpret_cast<const T*>(m_pData + m_Position);
+			values.assign(pFirst, pFirst + count);
+			m_Position += size_t(count) * sizeof(T);
+			return true;
+		}
+		//Only the count of an array, its elements are then read one by one, to check them without a vector
+		template<typename T>
+		bool ReadArrayCount(unsigned int& count)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only types that can be copied as bytes go in a checkpoint");
+			unsigned int readCount = 0;
+			if (!Read(readCount) || !CanRead(size_t(readCount) * sizeof(T)))
+				return Fail();
+			count = readCount;
+			return true;
+		}
+		bool ReadString(std::string& text);
+		//The string where it is in the data, not terminated, to compare it without a copy
+		bool ReadString(const char*& pText, unsigned int& length);
+		bool ReadTag(const char(&tag)[5]);
+		bool ReadBytes(void* pBytes, size_t size);
+
+		bool IsValid() const { return m_IsValid; }
+		bool IsAtEnd() const { return m_Position == m_Size; }
+
+	private:
+		const unsigned char* m_pData = nullptr;
+		size_t m_Size = 0;
+		size_t m_Position = 0;
+		bool m_IsValid = true;
+
+		bool CanRead(size_t size) const { return m_IsValid && size <= m_Size - m_Position; }
+		bool Fail() { m_IsValid = false; return false; }
+	};
+
+	//-----------------------------------------------------------------
+	// CHECKPOINT FILES
+	//-----------------------------------------------------------------
+	bool WriteCheckpointFile(const char* filePath, const std::vector<unsigned char>& blob);
+	bool ReadCheckpointFile(const char* filePath, std::vector<unsigned char>& blob);
+}
+#endif
@@ -0,0 +1,92 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EConcurrency.h: Lock-free hand-off between exactly one producer & one consumer thread
+/*=============================================================================*/
+#ifndef ELITE_CONCURRENCY
+#define ELITE_CONCURRENCY
+
+//--- Includes ---
+#include <atomic>
+
+namespace Elite
+{
+	//Keeps the producer & consumer counters on separate cache lines
+	const unsigned int CacheLineSize = 64;
+
+	//-----------------------------------------------------------------
+	// SINGLE PRODUCER SINGLE CONSUMER RING
+	//-----------------------------------------------------------------
+	// Elements are written & read in place, so slots keep the memory of their containers
+	// and nothing gets allocated once every slot has been used. Neither side ever waits:
+	// BeginPush returns nullptr when the ring is full, BeginPop when it's empty.
+	template<typename T, unsigned int Capacity>
+	class SpscRing final
+	{
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+	public:
+		//Producer, fill in the slot & call EndPush
+		T* BeginPush()
+		{
+			const unsigned int head = m_Head.load(std::memory_order_relaxed);
+			if (head - m_Tail.load(std::memory_order_acquire) == Capacity)
+				return nullptr;
+			return &m_Slots[head & (Capacity - 1)];
+		}
+		void EndPush() { m_Head.store(m_Head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+		//Consumer, the slot can't be touched anymore after EndPop
+		const T* BeginPop()
+		{
+			const unsigned int tail = m_Tail.load(std::memory_order_relaxed);
+			if (tail == m_Head.load(std::memory_order_acquire))
+				return nullptr;
+			return &m_Slots[tail & (Capacity - 1)];
+		}
+		void EndPop() { m_Tail.store(m_Tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+	private:
+		T m_Slots[Capacity] = {};
+		std::atomic<unsigned int> m_Head{ 0 }; //Written by the producer
+		char m_Padding[CacheLineSize] = {};
+		std::atomic<unsigned int> m_Tail{ 0 }; //Written by the consumer
+	};
+
+	//-----------------------------------------------------------------
+	// TRIPLE BUFFER
+	//-----------------------------------------------------------------
+	// Latest value wins. The writer fills the back buffer and swaps it with the middle one,
+	// the reader swaps the middle one with its front buffer when it holds something new.
+	// Both swaps are a single atomic exchange, so neither side ever waits on the other.
+	template<typename T>
+	class TripleBuffer final
+	{
+	public:
+		//Writer, the back buffer still holds an older value that has to be overwritten
+		T& GetBack() { return m_Buffers[m_Back]; }
+		void Publish() { m_Back = m_Middle.exchange(m_Back | IsNewBit, std::memory_order_acq_rel) & IndexMask; }
+
+		//Reader, false when nothing was published since the last call
+		bool Acquire()
+		{
+			if ((m_Middle.load(std::memory_order_relaxed) & IsNewBit) == 0)
+				return false;
+			m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & IndexMask;
+			return true;
+		}
+		const T& GetFront() const { return m_Buffers[m_Front]; }
+
+	private:
+		static const unsigned int IndexMask = 3;
+		static const unsigned int IsNewBit = 4;
+
+		T m_Buffers[3] = {};
+		unsigned int m_Front = 0; //Reader only
+		char m_Padding[CacheLineSize] = {};
+		std::atomic<unsigned int> m_Middle{ 1 };
+		char m_Padding2[CacheLineSize] = {};
+		unsigned int m_Back = 2; //Writer only
+	};
+}
+#endif
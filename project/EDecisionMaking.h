@@ -1,6 +1,9 @@
 #pragma once
 namespace Elite
 {
+	class CheckpointWriter;
+	class CheckpointReader;
+
 	class IDecisionMaking
 	{
 	public:
@@ -9,5 +12,12 @@ namespace Elite
 
 		virtual void Update(float deltaT) = 0;
 
+		//Whatever the decision maker & its behaviors carry from one tick to the next
+		virtual void SaveState(CheckpointWriter& writer) const = 0;
+		//Leaves everything as it was when the checkpoint doesn't fit
+		virtual bool LoadState(CheckpointReader& reader) = 0;
+		//Reads what LoadState would without changing anything, false when it doesn't fit
+		virtual bool ValidateState(CheckpointReader& reader) const = 0;
+
 	};
 }
@@ -0,0 +1,247 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EFiniteStateMachine.h"
+using namespace Elite;
+
+const unsigned int FiniteStateMachine::MaxStateDepth;
+
+FiniteStateMachine::~FiniteStateMachine()
+{
+	for (State& state : m_States)
+		SAFE_DELETE(state.pBehavior);
+	m_States.clear();
+	SAFE_DELETE(m_pBlackBoard); //Takes ownership of passed blackboard!
+}
+
+FSMStateId FiniteStateMachine::AddState(const std::string& name, FSMStateId parent, IBehavior* pBehavior,
+	FSMCallback onEnter, FSMCallback onExit)
+{
+	if (parent != InvalidFSMState && parent >= m_States.size())
+	{
+		printf("WARNING: State '%s' has an unknown parent, it isn't added\n", name.c_str());
+		SAFE_DELETE(pBehavior);
+		return InvalidFSMState;
+	}
+
+	const FSMStateId id = static_cast<FSMStateId>(m_States.size());
+	const unsigned int depth = (parent == InvalidFSMState) ? 0 : m_States[parent].depth + 1;
+	if (depth >= MaxStateDepth)
+	{
+		printf("WARNING: State '%s' would be nested %u levels deep, the most is %u, it isn't added\n", name.c_str(), depth + 1, MaxStateDepth);
+		SAFE_DELETE(pBehavior);
+		return InvalidFSMState;
+	}
+	m_States.push_back(State{ name, parent, InvalidFSMState, depth, pBehavior, onEnter, onExit, 0, 0 });
+
+	if (parent != InvalidFSMState && m_States[parent].initialChild == InvalidFSMState)
+		m_States[parent].initialChild = id;
+
+	if (m_StartState == InvalidFSMState)
+		m_StartState = id;
+
+	return id;
+}
+
+void FiniteStateMachine::AddTransition(FSMStateId from, FSMStateId to, FSMCondition condition)
+{
+	assert(from < m_States.size() && to < m_States.size() && "Transition between unknown states");
+	m_Transitions.push_back(Transition{ from, to, condition });
+	m_IsTableDirty = true;
+}
+
+const std::string& FiniteStateMachine::GetStateName(FSMStateId state) const
+{
+	static const std::string none = "None";
+	if (state >= m_States.size())
+		return none;
+
+	return m_States[state].name;
+}
+
+void FiniteStateMachine::Update(float /*deltaTime*/)
+{
+	if (m_IsTableDirty)
+		BuildTransitionTable();
+
+	if (m_CurrentState == InvalidFSMState)
+	{
+		if (m_StartState == InvalidFSMState)
+			return;
+
+		ChangeState(m_StartState);
+	}
+
+	EvaluateTransitions();
+
+	for (FSMStateId stateId : m_ActiveChain)
+	{
+		IBehavior* pBehavior = m_States[stateId].pBehavior;
+		if (pBehavior)
+			pBehavior->Execute(m_pBlackBoard);
+	}
+}
+
+void FiniteStateMachine::SaveState(CheckpointWriter& writer) const
+{
+	writer.WriteTag("FSMS");
+	writer.Write(static_cast<unsigned int>(m_States.size()));
+	writer.Write(m_CurrentState);
+	writer.WriteArray(m_ActiveChain);
+	for (const State& state : m_States)
+	{
+		if (state.pBehavior)
+			state.pBehavior->SaveState(writer);
+	}
+}
+
+bool FiniteStateMachine::LoadState(CheckpointReader& reader)
+{
+	//Checked on a copy of the reader first
+	CheckpointReader checkReader = reader;
+	if (!ValidateState(checkReader))
+		return false;
+
+	unsigned int stateCount = 0;
+	reader.ReadTag("FSMS");
+	reader.Read(stateCount);
+	reader.Read(m_CurrentState);
+	reader.ReadArray(m_ActiveChain);
+	for (State& state : m_States)
+	{
+		if (state.pBehavior)
+			state.pBehavior->LoadState(reader);
+	}
+	return reader.IsValid();
+}
+
+bool FiniteStateMachine::ValidateState(CheckpointReader& reader) const
+{
+	unsigned int stateCount = 0, chainLength = 0;
+	FSMStateId currentState = InvalidFSMState;
+	if (!reader.ReadTag("FSMS") || !reader.Read(stateCount) || stateCount != m_States.size())
+		return false;
+	if (!reader.Read(currentState) || !reader.ReadArrayCount<FSMStateId>(chainLength))
+		return false;
+	if (currentState != InvalidFSMState && currentState >= stateCount)
+		return false;
+	for (unsigned int i = 0; i < chainLength; ++i)
+	{
+		FSMStateId stateId = InvalidFSMState;
+		if (!reader.Read(stateId) || stateId >= stateCount)
+			return false;
+	}
+
+	for (const State& state : m_States)
+	{
+		if (state.pBehavior && !state.pBehavior->ValidateState(reader))
+			return false;
+	}
+	return true;
+}
+
+void FiniteStateMachine::EvaluateTransitions()
+{
+	//Only the guards of the active chain are evaluated, outer states can interrupt inner ones
+	for (FSMStateId stateId : m_ActiveChain)
+	{
+		const State& state = m_States[stateId];
+		const Transition* pTransition = m_Transitions.data() + state.firstTransition;
+		const Transition* pEnd = pTransition + state.transitionCount;
+
+		for (; pTransition != pEnd; ++pTransition)
+		{
+			if (!IsActive(pTransition->to) && pTransition->condition(m_pBlackBoard))
+			{
+				ChangeState(pTransition->to);
+				return;
+			}
+		}
+	}
+}
+
+void FiniteStateMachine::BuildTransitionTable()
+{
+	std::stable_sort(m_Transitions.begin(), m_Transitions.end(),
+		[](const Transition& a, const Transition& b) { return a.from < b.from; });
+
+	for (State& state : m_States)
+	{
+		state.firstTransition = 0;
+		state.transitionCount = 0;
+	}
+
+	for (unsigned int i = 0; i < m_Transitions.size(); ++i)
+	{
+		State& state = m_States[m_Transitions[i].from];
+		if (state.transitionCount == 0)
+			state.firstTransition = i;
+		++state.transitionCount;
+	}
+
+	m_IsTableDirty = false;
+}
+
+void FiniteStateMachine::BuildActiveChain()
+{
+	m_ActiveChain.clear();
+	if (m_CurrentState == InvalidFSMState)
+		return;
+
+	m_ActiveChain.resize(m_States[m_CurrentState].depth + 1);
+	for (FSMStateId state = m_CurrentState; state != InvalidFSMState; state = m_States[state].parent)
+		m_ActiveChain[m_States[state].depth] = state;
+}
+
+bool FiniteStateMachine::IsActive(FSMStateId state) const
+{
+	const unsigned int depth = m_States[state].depth;
+	return depth < m_ActiveChain.size() && m_ActiveChain[depth] == state;
+}
+
+bool FiniteStateMachine::IsAncestorOrSelf(FSMStateId ancestor, FSMStateId state) const
+{
+	for (; state != InvalidFSMState; state = m_States[state].parent)
+	{
+		if (state == ancestor)
+			return true;
+	}
+	return false;
+}
+
+void FiniteStateMachine::ChangeState(FSMStateId target)
+{
+	//Exit up to the common ancestor
+	FSMStateId commonAncestor = m_CurrentState;
+	while (commonAncestor != InvalidFSMState && !IsAncestorOrSelf(commonAncestor, target))
+	{
+		const State& state = m_States[commonAncestor];
+		if (state.onExit)
+			state.onExit(m_pBlackBoard);
+		commonAncestor = state.parent;
+	}
+
+	//Enter down to the target (collected bottom-up, entered top-down), AddState keeps it within MaxStateDepth
+	FSMStateId enterPath[MaxStateDepth] = {};
+	unsigned int pathLength = 0;
+	for (FSMStateId state = target; state != commonAncestor; state = m_States[state].parent)
+		enterPath[pathLength++] = state;
+
+	for (unsigned int i = pathLength; i > 0; --i)
+	{
+		const State& state = m_States[enterPath[i - 1]];
+		if (state.onEnter)
+			state.onEnter(m_pBlackBoard);
+	}
+
+	//Composite states descend into their initial child
+	FSMStateId leaf = target;
+	while (m_States[leaf].initialChild != InvalidFSMState)
+	{
+		leaf = m_States[leaf].initialChild;
+		if (m_States[leaf].onEnter)
+			m_States[leaf].onEnter(m_pBlackBoard);
+	}
+
+	m_CurrentState = leaf;
+	BuildActiveChain();
+}
@@ -0,0 +1,97 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EFiniteStateMachine.h: Table driven hierarchical finite state machine
+/*=============================================================================*/
+#ifndef ELITE_FINITE_STATE_MACHINE
+#define ELITE_FINITE_STATE_MACHINE
+
+//--- Includes ---
+#include "EBlackboard.h"
+#include "EBehaviorTree.h"
+#include "EDecisionMaking.h"
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// FSM HELPERS
+	//-----------------------------------------------------------------
+	using FSMStateId = unsigned int;
+	const FSMStateId InvalidFSMState = 0xFFFFFFFF;
+
+	using FSMCondition = std::function<bool(Blackboard*)>;
+	using FSMCallback = std::function<void(Blackboard*)>;
+
+	//-----------------------------------------------------------------
+	// FINITE STATE MACHINE (IDecisionMaking)
+	//-----------------------------------------------------------------
+	// States and transitions live in flat arrays, the transitions sorted on their source state,
+	// so a tick only evaluates the guards of the active state and its ancestors (outermost first).
+	// A state can own a nested behavior, every behavior along the active chain is executed
+	// each tick, from the outermost state to the active leaf.
+	// Entering a composite state descends into its first child.
+	class FiniteStateMachine final : public Elite::IDecisionMaking
+	{
+	public:
+		static const unsigned int MaxStateDepth = 16; //Nesting levels, deeper states are refused
+
+		explicit FiniteStateMachine(Blackboard* pBlackBoard) : m_pBlackBoard(pBlackBoard) {}
+		~FiniteStateMachine();
+
+		//Returns InvalidFSMState when the parent is unknown or already MaxStateDepth levels deep
+		FSMStateId AddState(const std::string& name, FSMStateId parent = InvalidFSMState, IBehavior* pBehavior = nullptr,
+			FSMCallback onEnter = nullptr, FSMCallback onExit = nullptr);
+		void AddTransition(FSMStateId from, FSMStateId to, FSMCondition condition);
+		void SetStartState(FSMStateId state) { m_StartState = state; }
+
+		virtual void Update(float deltaTime) override;
+		//Restoring puts the machine back in its state without running any enter or exit callbacks
+		virtual void SaveState(CheckpointWriter& writer) const override;
+		virtual bool LoadState(CheckpointReader& reader) override;
+		virtual bool ValidateState(CheckpointReader& reader) const override;
+
+		Blackboard* GetBlackboard() const { return m_pBlackBoard; }
+		FSMStateId GetCurrentState() const { return m_CurrentState; }
+		const std::string& GetStateName(FSMStateId state) const;
+
+	private:
+		struct State
+		{
+			std::string name;
+			FSMStateId parent;
+			FSMStateId initialChild;
+			unsigned int depth;
+			IBehavior* pBehavior;
+			FSMCallback onEnter;
+			FSMCallback onExit;
+
+			//Range in the sorted transition table
+			unsigned int firstTransition;
+			unsigned int transitionCount;
+		};
+
+		struct Transition
+		{
+			FSMStateId from;
+			FSMStateId to;
+			FSMCondition condition;
+		};
+
+		Blackboard* m_pBlackBoard = nullptr;
+		std::vector<State> m_States = {};
+		std::vector<Transition> m_Transitions = {};
+		std::vector<FSMStateId> m_ActiveChain = {}; //Root first, active leaf last
+
+		FSMStateId m_StartState = InvalidFSMState;
+		FSMStateId m_CurrentState = InvalidFSMState;
+		bool m_IsTableDirty = false;
+
+		void BuildTransitionTable();
+		void EvaluateTransitions();
+		void BuildActiveChain();
+		bool IsActive(FSMStateId state) const;
+		bool IsAncestorOrSelf(FSMStateId ancestor, FSMStateId state) const;
+		void ChangeState(FSMStateId target);
+	};
+}
+#endif
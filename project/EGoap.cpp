@@ -0,0 +1,235 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EGoap.h"
+using namespace Elite;
+
+namespace
+{
+	unsigned int CountBits(GoapWorldState bits)
+	{
+		unsigned int count = 0;
+		for (; bits != 0; bits &= bits - 1)
+			++count;
+		return count;
+	}
+}
+
+//-----------------------------------------------------------------
+// GOAP PLANNER
+//-----------------------------------------------------------------
+unsigned int GoapPlanner::AddAction(const GoapAction& action)
+{
+	assert(action.cost > 0.f && "GOAP actions need a positive cost");
+	m_Actions.push_back(action);
+
+	//Cheapest price for changing a single bit, an action that changes several bits at once
+	//must not make the heuristic overestimate
+	const unsigned int changedBits = CountBits(action.setEffects | action.clearEffects);
+	if (changedBits > 0)
+	{
+		const float costPerBit = action.cost / changedBits;
+		if (m_MinCostPerBit <= 0.f || costPerBit < m_MinCostPerBit)
+			m_MinCostPerBit = costPerBit;
+	}
+
+	m_PlanCache.clear();
+	return static_cast<unsigned int>(m_Actions.size() - 1);
+}
+
+unsigned int GoapPlanner::AddGoal(const GoapCondition& goal)
+{
+	m_Goals.push_back(goal);
+	return static_cast<unsigned int>(m_Goals.size() - 1);
+}
+
+const std::vector<unsigned int>* GoapPlanner::FindPlan(GoapWorldState start, unsigned int goal)
+{
+	assert(goal < m_Goals.size() && "Unknown GOAP goal");
+
+	const unsigned long long key = (static_cast<unsigned long long>(goal) << 32) | start;
+	auto cached = m_PlanCache.find(key);
+	if (cached != m_PlanCache.end())
+	{
+		++m_CacheHits;
+		return cached->second.isReachable ? &cached->second.actions : nullptr;
+	}
+
+	if (m_PlanCache.size() >= MaxCachedPlans)
+		m_PlanCache.clear();
+
+	++m_PlansSearched;
+	CachedPlan& plan = m_PlanCache[key];
+	plan.isReachable = Search(start, m_Goals[goal], plan.actions);
+	return plan.isReachable ? &plan.actions : nullptr;
+}
+
+float GoapPlanner::Heuristic(GoapWorldState state, const GoapCondition& goal) const
+{
+	return CountBits((state ^ goal.values) & goal.mask) * m_MinCostPerBit;
+}
+
+bool GoapPlanner::Search(GoapWorldState start, const GoapCondition& goal, std::vector<unsigned int>& plan)
+{
+	plan.clear();
+	m_NodePool.clear();
+	m_OpenList.clear();
+	m_BestNodes.clear();
+
+	//Min heap on the estimated total cost
+	const auto compare = [this](int a, int b)
+	{
+		return m_NodePool[a].estimatedTotalCost > m_NodePool[b].estimatedTotalCost;
+	};
+
+	m_NodePool.push_back(Node{ start, 0.f, Heuristic(start, goal), -1, -1 });
+	m_OpenList.push_back(0);
+	m_BestNodes[start] = 0;
+
+	while (!m_OpenList.empty() && m_NodePool.size() < MaxExpandedNodes)
+	{
+		std::pop_heap(m_OpenList.begin(), m_OpenList.end(), compare);
+		const int current = m_OpenList.back();
+		m_OpenList.pop_back();
+
+		const Node node = m_NodePool[current];
+		if (m_BestNodes[node.state] != current)
+			continue; //Stale entry, a cheaper way to this state was found later
+
+		if (goal.IsMetBy(node.state))
+		{
+			for (int n = current; m_NodePool[n].parent != -1; n = m_NodePool[n].parent)
+				plan.push_back(static_cast<unsigned int>(m_NodePool[n].action));
+			std::reverse(plan.begin(), plan.end());
+			return true;
+		}
+
+		for (unsigned int a = 0; a < m_Actions.size(); ++a)
+		{
+			const GoapAction& action = m_Actions[a];
+			if (!action.preconditions.IsMetBy(node.state))
+				continue;
+
+			const GoapWorldState nextState = action.Apply(node.state);
+			if (nextState == node.state)
+				continue;
+
+			const float costSoFar = node.costSoFar + action.cost;
+			auto best = m_BestNodes.find(nextState);
+			if (best != m_BestNodes.end() && m_NodePool[best->second].costSoFar <= costSoFar)
+				continue;
+
+			const int next = static_cast<int>(m_NodePool.size());
+			m_NodePool.push_back(Node{ nextState, costSoFar, costSoFar + Heuristic(nextState, goal), current, int(a) });
+			m_BestNodes[nextState] = next;
+			m_OpenList.push_back(next);
+			std::push_heap(m_OpenList.begin(), m_OpenList.end(), compare);
+		}
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------
+// BEHAVIOR GOAP (IBehavior)
+//-----------------------------------------------------------------
+BehaviorState BehaviorGoap::Execute(Blackboard* pBlackBoard)
+{
+	const GoapWorldState state = m_fpWorldState(pBlackBoard);
+	const int goal = m_fpGoalSelector(pBlackBoard, state);
+
+	//Nothing to do, let the rest of the tree take over
+	if (goal < 0 || m_pPlanner->GetGoal(goal).IsMetBy(state))
+	{
+		m_HasPlan = false;
+		m_Goal = goal;
+		return m_CurrentState = Failure;
+	}
+
+	if (!m_HasPlan || goal != m_Goal || state != m_ExpectedStates[m_Cursor])
+		Replan(state, goal);
+
+	if (!m_HasPlan)
+		return m_CurrentState = Failure;
+
+	const GoapAction& action = m_pPlanner->GetAction(m_Plan[m_Cursor]);
+	switch (action.fpExecute(pBlackBoard))
+	{
+	case Failure:
+		m_HasPlan = false;
+		return m_CurrentState = Failure;
+	case Success:
+		++m_Cursor;
+		if (m_Cursor == m_Plan.size())
+		{
+			m_HasPlan = false;
+			return m_CurrentState = Success;
+		}
+		break;
+	default:
+		break;
+	}
+
+	return m_CurrentState = Running;
+}
+
+void BehaviorGoap::SaveState(CheckpointWriter& writer) const
+{
+	IBehavior::SaveState(writer);
+	writer.WriteArray(m_Plan);
+	writer.WriteArray(m_ExpectedStates);
+	writer.Write(m_Cursor);
+	writer.Write(m_Goal);
+	writer.Write(m_HasPlan);
+}
+
+void BehaviorGoap::LoadState(CheckpointReader& reader)
+{
+	IBehavior::LoadState(reader);
+	reader.ReadArray(m_Plan);
+	reader.ReadArray(m_ExpectedStates);
+	reader.Read(m_Cursor);
+	reader.Read(m_Goal);
+	reader.Read(m_HasPlan);
+}
+
+bool BehaviorGoap::ValidateState(CheckpointReader& reader) const
+{
+	std::vector<unsigned int> plan{};
+	std::vector<GoapWorldState> expectedStates{};
+	unsigned int cursor = 0;
+	int goal = -1;
+	bool hasPlan = false;
+	if (!IBehavior::ValidateState(reader) || !reader.ReadArray(plan) || !reader.ReadArray(expectedStates)
+		|| !reader.Read(cursor) || !reader.Read(goal) || !reader.Read(hasPlan))
+		return false;
+
+	//Planned with other actions or goals, following it would index past them
+	if (plan.size() != expectedStates.size() || (hasPlan && cursor >= plan.size()) || goal >= int(m_pPlanner->GetGoalCount()))
+		return false;
+	for (unsigned int action : plan)
+	{
+		if (action >= m_pPlanner->GetActionCount())
+			return false;
+	}
+	return true;
+}
+
+void BehaviorGoap::Replan(GoapWorldState state, int goal)
+{
+	m_Goal = goal;
+	m_Cursor = 0;
+	m_HasPlan = false;
+
+	const std::vector<unsigned int>* pPlan = m_pPlanner->FindPlan(state, static_cast<unsigned int>(goal));
+	if (!pPlan || pPlan->empty())
+		return;
+
+	m_Plan = *pPlan;
+	m_ExpectedStates.resize(m_Plan.size());
+	for (unsigned int i = 0; i < m_Plan.size(); ++i)
+	{
+		m_ExpectedStates[i] = state;
+		state = m_pPlanner->GetAction(m_Plan[i]).Apply(state);
+	}
+	m_HasPlan = true;
+}
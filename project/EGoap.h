@@ -0,0 +1,142 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EGoap.h: Goal oriented action planner over a bitset world state
+/*=============================================================================*/
+#ifndef ELITE_GOAP
+#define ELITE_GOAP
+
+//--- Includes ---
+#include <unordered_map>
+#include "EBlackboard.h"
+#include "EBehaviorTree.h"
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// GOAP HELPERS
+	//-----------------------------------------------------------------
+	//Every bit of the world state is one fact (has gun, knows a house, ...)
+	using GoapWorldState = unsigned int;
+
+	struct GoapCondition
+	{
+		GoapWorldState mask = 0; //Bits that matter
+		GoapWorldState values = 0; //Required value of those bits
+
+		bool IsMetBy(GoapWorldState state) const { return (state & mask) == values; }
+	};
+
+	struct GoapAction
+	{
+		std::string name = {};
+		float cost = 1.f;
+		GoapCondition preconditions = {};
+		GoapWorldState setEffects = 0;
+		GoapWorldState clearEffects = 0;
+		//Running while busy, Success once the effects are achieved
+		std::function<BehaviorState(Blackboard*)> fpExecute = nullptr;
+
+		GoapWorldState Apply(GoapWorldState state) const { return (state & ~clearEffects) | setEffects; }
+	};
+
+	//-----------------------------------------------------------------
+	// GOAP PLANNER
+	//-----------------------------------------------------------------
+	// A* from the current world state over the actions, plans are cached on (goal, start state)
+	// so a world state that has been seen before never gets planned again.
+	class GoapPlanner final
+	{
+	public:
+		GoapPlanner() = default;
+		~GoapPlanner() = default;
+
+		unsigned int AddAction(const GoapAction& action);
+		unsigned int AddGoal(const GoapCondition& goal);
+
+		const GoapAction& GetAction(unsigned int action) const { return m_Actions[action]; }
+		const GoapCondition& GetGoal(unsigned int goal) const { return m_Goals[goal]; }
+		unsigned int GetActionCount() const { return static_cast<unsigned int>(m_Actions.size()); }
+		unsigned int GetGoalCount() const { return static_cast<unsigned int>(m_Goals.size()); }
+
+		//Returns nullptr when the goal can't be reached from this state
+		const std::vector<unsigned int>* FindPlan(GoapWorldState start, unsigned int goal);
+		void ClearCache() { m_PlanCache.clear(); }
+
+		unsigned int GetCacheHits() const { return m_CacheHits; }
+		unsigned int GetPlansSearched() const { return m_PlansSearched; }
+
+	private:
+		struct Node
+		{
+			GoapWorldState state;
+			float costSoFar;
+			float estimatedTotalCost;
+			int parent;
+			int action;
+		};
+
+		struct CachedPlan
+		{
+			bool isReachable;
+			std::vector<unsigned int> actions;
+		};
+
+		static const unsigned int MaxExpandedNodes = 2048;
+		static const unsigned int MaxCachedPlans = 4096;
+
+		std::vector<GoapAction> m_Actions = {};
+		std::vector<GoapCondition> m_Goals = {};
+		float m_MinCostPerBit = 0.f; //Keeps the heuristic admissible
+
+		//Reused between searches so planning doesn't allocate once warmed up
+		std::vector<Node> m_NodePool = {};
+		std::vector<int> m_OpenList = {};
+		std::unordered_map<GoapWorldState, int> m_BestNodes = {};
+
+		std::unordered_map<unsigned long long, CachedPlan> m_PlanCache = {};
+		unsigned int m_CacheHits = 0;
+		unsigned int m_PlansSearched = 0;
+
+		float Heuristic(GoapWorldState state, const GoapCondition& goal) const;
+		bool Search(GoapWorldState start, const GoapCondition& goal, std::vector<unsigned int>& plan);
+	};
+
+	//-----------------------------------------------------------------
+	// BEHAVIOR GOAP (IBehavior)
+	//-----------------------------------------------------------------
+	// Leaf that follows a plan with a cursor. It only replans when the goal changes, the running
+	// action fails or the perceived world state differs from what the plan expected at the cursor.
+	class BehaviorGoap final : public IBehavior
+	{
+	public:
+		//-1 when there is nothing to plan for, gets the world state the getter returned this tick
+		using GoalSelector = std::function<int(Blackboard*, GoapWorldState)>;
+		using WorldStateGetter = std::function<GoapWorldState(Blackboard*)>;
+
+		explicit BehaviorGoap(GoapPlanner* pPlanner, GoalSelector fpGoalSelector, WorldStateGetter fpWorldState)
+			: m_pPlanner(pPlanner), m_fpGoalSelector(fpGoalSelector), m_fpWorldState(fpWorldState) {}
+		virtual ~BehaviorGoap() { SAFE_DELETE(m_pPlanner); } //Takes ownership of the planner
+		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		//The plan & where we are in it, the planner's cache rebuilds itself
+		virtual void SaveState(CheckpointWriter& writer) const override;
+		virtual void LoadState(CheckpointReader& reader) override;
+		virtual bool ValidateState(CheckpointReader& reader) const override;
+
+		int GetCurrentAction() const { return m_HasPlan ? int(m_Plan[m_Cursor]) : -1; }
+
+	private:
+		GoapPlanner* m_pPlanner = nullptr;
+		GoalSelector m_fpGoalSelector = nullptr;
+		WorldStateGetter m_fpWorldState = nullptr;
+
+		std::vector<unsigned int> m_Plan = {};
+		std::vector<GoapWorldState> m_ExpectedStates = {}; //World state expected before each step
+		unsigned int m_Cursor = 0;
+		int m_Goal = -1;
+		bool m_HasPlan = false;
+
+		void Replan(GoapWorldState state, int goal);
+	};
+}
+#endif
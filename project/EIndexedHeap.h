@@ -0,0 +1,173 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EIndexedHeap.h: Binary min-heap over ids [0, n) that can change the key of any id
+/*=============================================================================*/
+#ifndef ELITE_INDEXED_HEAP
+#define ELITE_INDEXED_HEAP
+
+#include <vector>
+#include <algorithm>
+#include "ECheckpoint.h"
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// INDEXED HEAP
+	//-----------------------------------------------------------------
+	// Every id remembers where it sits in the heap, so changing its key (both ways)
+	// or removing it is O(log n) instead of a search through the heap.
+	template<typename Key>
+	class IndexedHeap final
+	{
+	public:
+		static const unsigned int NotInHeap = 0xFFFFFFFF;
+
+		bool IsEmpty() const { return m_Heap.empty(); }
+		unsigned int GetSize() const { return static_cast<unsigned int>(m_Heap.size()); }
+		//One past the highest id ever pushed
+		unsigned int GetIdCount() const { return static_cast<unsigned int>(m_Keys.size()); }
+		bool Contains(unsigned int id) const { return id < m_Positions.size() && m_Positions[id] != NotInHeap; }
+
+		unsigned int GetTop() const { return m_Heap.front(); }
+		//Id at a position in the heap, the children of position p are at 2p + 1 & 2p + 2
+		unsigned int GetAt(unsigned int position) const { return m_Heap[position]; }
+		const Key& GetKey(unsigned int id) const { return m_Keys[id]; }
+
+		//Inserts the id, or changes its key when it's already in the heap
+		void Push(unsigned int id, const Key& key)
+		{
+			if (id >= m_Positions.size())
+			{
+				m_Positions.resize(id + 1, NotInHeap);
+				m_Keys.resize(id + 1);
+			}
+
+			if (Contains(id))
+			{
+				ChangeKey(id, key);
+				return;
+			}
+
+			m_Keys[id] = key;
+			m_Positions[id] = static_cast<unsigned int>(m_Heap.size());
+			m_Heap.push_back(id);
+			SiftUp(m_Positions[id]);
+		}
+
+		void ChangeKey(unsigned int id, const Key& key)
+		{
+			const bool isDecrease = key < m_Keys[id];
+			m_Keys[id] = key;
+			if (isDecrease)
+				SiftUp(m_Positions[id]);
+			else
+				SiftDown(m_Positions[id]);
+		}
+
+		void Remove(unsigned int id)
+		{
+			if (!Contains(id))
+				return;
+
+			const unsigned int position = m_Positions[id];
+			Swap(position, static_cast<unsigned int>(m_Heap.size() - 1));
+			m_Heap.pop_back();
+			m_Positions[id] = NotInHeap;
+
+			//The last id took its place, it can need to go either way
+			if (position < m_Heap.size())
+			{
+				const unsigned int movedId = m_Heap[position];
+				SiftUp(position);
+				SiftDown(m_Positions[movedId]);
+			}
+		}
+
+		unsigned int Pop()
+		{
+			const unsigned int top = GetTop();
+			Remove(top);
+			return top;
+		}
+
+		void Clear()
+		{
+			for (unsigned int id : m_Heap)
+				m_Positions[id] = NotInHeap;
+			m_Heap.clear();
+		}
+
+		//The heap as it is, restoring doesn't sift anything but checks every id & position lines up
+		void SaveState(CheckpointWriter& writer) const
+		{
+			writer.WriteArray(m_Heap);
+			writer.WriteArray(m_Positions);
+			writer.WriteArray(m_Keys);
+		}
+		bool LoadState(CheckpointReader& reader)
+		{
+			if (!reader.ReadArray(m_Heap) || !reader.ReadArray(m_Positions) || !reader.ReadArray(m_Keys))
+				return false;
+			if (m_Positions.size() != m_Keys.size() || m_Heap.size() > m_Keys.size())
+				return false;
+			for (unsigned int position = 0; position < m_Heap.size(); ++position)
+			{
+				if (m_Heap[position] >= m_Positions.size() || m_Positions[m_Heap[position]] != position)
+					return false;
+			}
+			return size_t(std::count_if(m_Positions.begin(), m_Positions.end(),
+				[](unsigned int position) { return position != NotInHeap; })) == m_Heap.size();
+		}
+
+	private:
+		std::vector<unsigned int> m_Heap = {}; //Ids, heap ordered on their key
+		std::vector<unsigned int> m_Positions = {}; //Per id, where it is in m_Heap
+		std::vector<Key> m_Keys = {}; //Per id
+
+		void Swap(unsigned int a, unsigned int b)
+		{
+			std::swap(m_Heap[a], m_Heap[b]);
+			m_Positions[m_Heap[a]] = a;
+			m_Positions[m_Heap[b]] = b;
+		}
+
+		void SiftUp(unsigned int position)
+		{
+			while (position > 0)
+			{
+				const unsigned int parent = (position - 1) / 2;
+				if (!(m_Keys[m_Heap[position]] < m_Keys[m_Heap[parent]]))
+					break;
+
+				Swap(position, parent);
+				position = parent;
+			}
+		}
+
+		void SiftDown(unsigned int position)
+		{
+			const unsigned int size = static_cast<unsigned int>(m_Heap.size());
+			while (true)
+			{
+				const unsigned int left = position * 2 + 1;
+				const unsigned int right = left + 1;
+				unsigned int smallest = position;
+
+				if (left < size && m_Keys[m_Heap[left]] < m_Keys[m_Heap[smallest]])
+					smallest = left;
+				if (right < size && m_Keys[m_Heap[right]] < m_Keys[m_Heap[smallest]])
+					smallest = right;
+				if (smallest == position)
+					break;
+
+				Swap(position, smallest);
+				position = smallest;
+			}
+		}
+	};
+
+	template<typename Key>
+	const unsigned int IndexedHeap<Key>::NotInHeap;
+}
+#endif
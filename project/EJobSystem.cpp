@@ -0,0 +1,376 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EJobSystem.h"
+using namespace Elite;
+
+namespace
+{
+	//0 for the thread that forks, 1..n for the workers
+	thread_local unsigned int t_ThreadIndex = 0;
+
+	unsigned int NextRandom(unsigned int& state)
+	{
+		//xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+}
+
+//-----------------------------------------------------------------
+// WORK STEALING DEQUE
+//-----------------------------------------------------------------
+bool WorkStealingDeque::Push(Job* pJob)
+{
+	const long long bottom = m_Bottom.load(std::memory_order_relaxed);
+	const long long top = m_Top.load(std::memory_order_acquire);
+	if (bottom - top >= Capacity)
+		return false;
+
+	m_Jobs[bottom & (Capacity - 1)].store(pJob, std::memory_order_relaxed);
+	//Sequentially consistent for the parking handshake, see JobSystem::Park
+	m_Bottom.store(bottom + 1, std::memory_order_seq_cst);
+	return true;
+}
+
+Job* WorkStealingDeque::Pop()
+{
+	const long long bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+	m_Bottom.store(bottom, std::memory_order_seq_cst);
+	long long top = m_Top.load(std::memory_order_seq_cst);
+
+	if (top > bottom)
+	{
+		//Was empty
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* pJob = m_Jobs[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		//Last job, a thief might be taking it at the same time
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			pJob = nullptr;
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return pJob;
+}
+
+Job* WorkStealingDeque::Steal()
+{
+	long long top = m_Top.load(std::memory_order_seq_cst);
+	const long long bottom = m_Bottom.load(std::memory_order_seq_cst);
+	if (top >= bottom)
+		return nullptr;
+
+	Job* pJob = m_Jobs[top & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr; //Lost against the owner or another thief
+	return pJob;
+}
+
+bool WorkStealingDeque::IsEmpty() const
+{
+	return m_Top.load(std::memory_order_seq_cst) >= m_Bottom.load(std::memory_order_seq_cst);
+}
+
+//-----------------------------------------------------------------
+// JOB SYSTEM
+//-----------------------------------------------------------------
+const unsigned int JobSystem::MaxWorkers;
+const unsigned int JobSystem::SpinsBeforeParking;
+
+JobSystem::~JobSystem()
+{
+	Stop();
+}
+
+void JobSystem::Start(unsigned int workerCount)
+{
+	if (!m_ThreadData.empty())
+		return;
+
+	workerCount = std::min(workerCount, MaxWorkers);
+	for (unsigned int t = 0; t <= workerCount; ++t)
+	{
+		ThreadData* pThreadData = new ThreadData{};
+		for (Job& job : pThreadData->jobs)
+			job.isInUse.store(false, std::memory_order_relaxed);
+		pThreadData->nextJob = 0;
+		pThreadData->randomState = 2463534242u + t;
+		m_ThreadData.push_back(pThreadData);
+	}
+
+	t_ThreadIndex = 0;
+	m_IsRunning.store(true, std::memory_order_release);
+	for (unsigned int w = 1; w <= workerCount; ++w)
+		m_Workers.push_back(std::thread{ &JobSystem::WorkerLoop, this, w });
+}
+
+void JobSystem::Stop()
+{
+	m_IsRunning.store(false, std::memory_order_release);
+	WakeWorkers(true);
+	for (std::thread& worker : m_Workers)
+		worker.join();
+	m_Workers.clear();
+
+	for (ThreadData*& pThreadData : m_ThreadData)
+		SAFE_DELETE(pThreadData);
+	m_ThreadData.clear();
+}
+
+void JobSystem::Run(JobFunction fpFunction, void* pData, unsigned int begin, unsigned int end, std::atomic<unsigned int>& pending)
+{
+	if (m_ThreadData.empty())
+	{
+		fpFunction(pData, begin, end);
+		return;
+	}
+
+	//Jobs finish in any order, nested forks can keep old ones queued
+	ThreadData& threadData = *m_ThreadData[t_ThreadIndex];
+	Job* pJob = nullptr;
+	for (unsigned int tries = 0; tries < JobsPerThread && !pJob; ++tries)
+	{
+		Job& candidate = threadData.jobs[threadData.nextJob];
+		threadData.nextJob = (threadData.nextJob + 1) % JobsPerThread;
+		if (!candidate.isInUse.load(std::memory_order_acquire))
+			pJob = &candidate;
+	}
+
+	if (!pJob)
+	{
+		fpFunction(pData, begin, end);
+		return;
+	}
+
+	pJob->fpFunction = fpFunction;
+	pJob->pData = pData;
+	pJob->begin = begin;
+	pJob->end = end;
+	pJob->pPending = &pending;
+	pJob->isInUse.store(true, std::memory_order_relaxed);
+
+	pending.fetch_add(1, std::memory_order_relaxed);
+	if (!threadData.deque.Push(pJob))
+	{
+		Execute(pJob); //Full, nobody would see it anyway
+		return;
+	}
+
+	//Either a worker that's parking sees the job or we see the worker
+	if (m_ParkedCount.load(std::memory_order_seq_cst) > 0)
+		WakeWorkers(false);
+}
+
+void JobSystem::Wait(const std::atomic<unsigned int>& pending)
+{
+	while (pending.load(std::memory_order_acquire) != 0)
+	{
+		Job* pJob = m_ThreadData.empty() ? nullptr : FindJob(t_ThreadIndex);
+		if (pJob)
+			Execute(pJob);
+		else
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::ParallelFor(unsigned int count, unsigned int batchSize, JobFunction fpFunction, void* pData)
+{
+	if (ShouldRunInline(count))
+	{
+		fpFunction(pData, 0, count);
+		return;
+	}
+
+	//Not more batches than there are jobs
+	batchSize = std::max(batchSize, count / (JobsPerThread / 2) + 1);
+
+	std::atomic<unsigned int> pending{ 0 };
+	for (unsigned int begin = 0; begin < count; begin += batchSize)
+		Run(fpFunction, pData, begin, std::min(begin + batchSize, count), pending);
+	Wait(pending);
+}
+
+void JobSystem::WorkerLoop(unsigned int threadIndex)
+{
+	t_ThreadIndex = threadIndex;
+
+	unsigned int idleCount = 0;
+	while (m_IsRunning.load(std::memory_order_acquire))
+	{
+		Job* pJob = FindJob(threadIndex);
+		if (pJob)
+		{
+			Execute(pJob);
+			idleCount = 0;
+		}
+		else if (++idleCount < SpinsBeforeParking)
+		{
+			std::this_thread::yield();
+		}
+		else
+		{
+			//Nothing to do for a while, most likely in between ticks
+			Park();
+			idleCount = 0;
+		}
+	}
+}
+
+Job* JobSystem::FindJob(unsigned int threadIndex)
+{
+	ThreadData& threadData = *m_ThreadData[threadIndex];
+	Job* pJob = threadData.deque.Pop();
+	if (pJob)
+		return pJob;
+
+	const unsigned int threadCount = static_cast<unsigned int>(m_ThreadData.size());
+	const unsigned int victim = NextRandom(threadData.randomState) % threadCount;
+	if (victim == threadIndex)
+		return nullptr;
+
+	pJob = m_ThreadData[victim]->deque.Steal();
+	if (pJob)
+		m_StealCount.fetch_add(1, std::memory_order_relaxed);
+	return pJob;
+}
+
+void JobSystem::Execute(Job* pJob)
+{
+	std::atomic<unsigned int>* pPending = pJob->pPending;
+	pJob->fpFunction(pJob->pData, pJob->begin, pJob->end);
+	pJob->isInUse.store(false, std::memory_order_release); //The thread that forked it can reuse it now
+	pPending->fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::Park()
+{
+	std::unique_lock<std::mutex> lock{ m_ParkingMutex };
+	const unsigned int wakeCount = m_WakeCount;
+	//The push & this are both sequentially consistent, so a job that's pushed before
+	//Run could see us parked is seen by the check below instead
+	m_ParkedCount.fetch_add(1, std::memory_order_seq_cst);
+	if (!HasQueuedJobs())
+	{
+		m_ParkingCondition.wait(lock, [this, wakeCount]()
+			{
+				return m_WakeCount != wakeCount || !m_IsRunning.load(std::memory_order_acquire);
+			});
+	}
+	m_ParkedCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void JobSystem::WakeWorkers(bool wakeAll)
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_ParkingMutex };
+		++m_WakeCount;
+	}
+	if (wakeAll)
+		m_ParkingCondition.notify_all();
+	else
+		m_ParkingCondition.notify_one();
+}
+
+bool JobSystem::HasQueuedJobs() const
+{
+	for (const ThreadData* pThreadData : m_ThreadData)
+	{
+		if (!pThreadData->deque.IsEmpty())
+			return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------
+// TASK GRAPH
+//-----------------------------------------------------------------
+unsigned int TaskGraph::AddTask(const char* name, std::function<void()> fpTask, std::initializer_list<unsigned int> dependencies)
+{
+	const unsigned int index = static_cast<unsigned int>(m_Tasks.size());
+	m_Tasks.push_back(std::unique_ptr<Task>{ new Task{} });
+	Task& task = *m_Tasks.back();
+	task.name = name;
+	task.fpTask = fpTask;
+	task.dependencyCount = static_cast<unsigned int>(dependencies.size());
+	task.isOnCallingThread = false;
+
+	for (unsigned int dependency : dependencies)
+	{
+		assert(dependency < index && "Dependencies have to be added first");
+		m_Tasks[dependency]->successors.push_back(index);
+	}
+	return index;
+}
+
+unsigned int TaskGraph::AddCallingThreadTask(const char* name, std::function<void()> fpTask)
+{
+	const unsigned int index = AddTask(name, fpTask);
+	m_Tasks[index]->isOnCallingThread = true;
+	return index;
+}
+
+void TaskGraph::Execute(JobSystem& jobSystem, unsigned int elementCount)
+{
+	if (jobSystem.GetWorkerCount() == 0 || elementCount < m_ForkThreshold)
+	{
+		ExecuteInline();
+		return;
+	}
+
+	m_pJobSystem = &jobSystem;
+	for (const std::unique_ptr<Task>& pTask : m_Tasks)
+		pTask->remainingDependencies.store(pTask->dependencyCount, std::memory_order_relaxed);
+
+	for (unsigned int t = 0; t < m_Tasks.size(); ++t)
+	{
+		if (m_Tasks[t]->dependencyCount == 0 && !m_Tasks[t]->isOnCallingThread)
+			jobSystem.Run(&TaskGraph::RunTask, this, t, t + 1, m_Pending);
+	}
+	//Their successors get forked as soon as they're done, like any other task's
+	for (unsigned int t = 0; t < m_Tasks.size(); ++t)
+	{
+		if (m_Tasks[t]->isOnCallingThread)
+			RunTask(this, t, 0);
+	}
+	jobSystem.Wait(m_Pending);
+}
+
+void TaskGraph::ExecuteInline()
+{
+	for (const std::unique_ptr<Task>& pTask : m_Tasks)
+	{
+		ScopedTimer timer{ pTask->cost };
+		pTask->fpTask();
+	}
+}
+
+void TaskGraph::PrintReport() const
+{
+	for (const std::unique_ptr<Task>& pTask : m_Tasks)
+	{
+		const std::string label = std::string{ pTask->name } + " cost per tick (us)";
+		pTask->cost.Print(label.c_str());
+	}
+}
+
+void TaskGraph::RunTask(void* pData, unsigned int task, unsigned int)
+{
+	TaskGraph* pGraph = static_cast<TaskGraph*>(pData);
+	Task& current = *pGraph->m_Tasks[task];
+	{
+		ScopedTimer timer{ current.cost };
+		current.fpTask();
+	}
+
+	//Forked before this job counts as done, so the graph can't look finished in between
+	for (unsigned int successor : current.successors)
+	{
+		if (pGraph->m_Tasks[successor]->remainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			pGraph->m_pJobSystem->Run(&TaskGraph::RunTask, pGraph, successor, successor + 1, pGraph->m_Pending);
+	}
+}
@@ -0,0 +1,176 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EJobSystem.h: Work-stealing fork/join jobs to spread one tick over several cores
+/*=============================================================================*/
+#ifndef ELITE_JOB_SYSTEM
+#define ELITE_JOB_SYSTEM
+
+//--- Includes ---
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <functional>
+#include <memory>
+#include "EConcurrency.h"
+#include "EProfiler.h"
+
+namespace Elite
+{
+	//Works on [begin, end) of whatever pData points to
+	using JobFunction = void(*)(void* pData, unsigned int begin, unsigned int end);
+
+	struct Job
+	{
+		JobFunction fpFunction;
+		void* pData;
+		unsigned int begin;
+		unsigned int end;
+		std::atomic<unsigned int>* pPending; //Counter of the fork this job belongs to
+		std::atomic<bool> isInUse;
+	};
+
+	//-----------------------------------------------------------------
+	// WORK STEALING DEQUE
+	//-----------------------------------------------------------------
+	// Chase-Lev deque with a fixed capacity. The owning thread pushes & pops at the bottom
+	// (LIFO, the data it just touched is still in cache), other threads steal from the top.
+	class WorkStealingDeque final
+	{
+	public:
+		static const long long Capacity = 1024;
+
+		//Owner only, false when full
+		bool Push(Job* pJob);
+		//Owner only
+		Job* Pop();
+		//Any thread
+		Job* Steal();
+		//Any thread, can be out of date by the time it returns
+		bool IsEmpty() const;
+
+	private:
+		std::atomic<long long> m_Top{ 0 };
+		char m_Padding[CacheLineSize] = {};
+		std::atomic<long long> m_Bottom{ 0 };
+		std::atomic<Job*> m_Jobs[Capacity];
+	};
+
+	//-----------------------------------------------------------------
+	// JOB SYSTEM
+	//-----------------------------------------------------------------
+	// Thread 0 is the thread that calls Start & forks, the workers are 1..n. Only those threads
+	// can fork or wait. Waiting never sleeps: the thread runs its own & stolen jobs until the
+	// fork is done. Without workers, or below the inline threshold, everything runs inline.
+	// Workers that found nothing for a while park on a condition variable, Run wakes one of
+	// them per job for as long as any are parked, so in between ticks they cost nothing.
+	class JobSystem final
+	{
+	public:
+		static const unsigned int MaxWorkers = 7;
+		static const unsigned int JobsPerThread = 1024; //Jobs in flight per thread, more than that runs inline
+		static const unsigned int SpinsBeforeParking = 64; //Yields, a fork right after the last one skips the wake up
+
+		JobSystem() = default;
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		void Start(unsigned int workerCount);
+		void Stop();
+
+		unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_Workers.size()); }
+		//Element count below which ParallelFor & the batched behavior tree don't bother the workers. The default
+		//is where forking starts to pay off for cheap elements, like a house refresh at about 20 ns,
+		//see Tests/JobSystemBench.cpp
+		void SetInlineThreshold(unsigned int threshold) { m_InlineThreshold = threshold; }
+		bool ShouldRunInline(unsigned int elementCount) const { return m_Workers.empty() || elementCount < m_InlineThreshold; }
+
+		//Fork, pending gets incremented now & decremented once the job ran
+		void Run(JobFunction fpFunction, void* pData, unsigned int begin, unsigned int end, std::atomic<unsigned int>& pending);
+		//Join
+		void Wait(const std::atomic<unsigned int>& pending);
+
+		//Splits [0, count) in batches & waits for all of them
+		void ParallelFor(unsigned int count, unsigned int batchSize, JobFunction fpFunction, void* pData);
+
+		unsigned int GetStealCount() const { return m_StealCount.load(std::memory_order_relaxed); }
+		unsigned int GetParkedCount() const { return m_ParkedCount.load(std::memory_order_relaxed); }
+
+	private:
+		struct ThreadData
+		{
+			WorkStealingDeque deque;
+			Job jobs[JobsPerThread];
+			unsigned int nextJob; //Where to start looking for a free job
+			unsigned int randomState;
+		};
+
+		std::vector<std::thread> m_Workers = {};
+		std::vector<ThreadData*> m_ThreadData = {}; //Thread 0 first
+		std::atomic<bool> m_IsRunning{ false };
+		std::atomic<unsigned int> m_StealCount{ 0 };
+		unsigned int m_InlineThreshold = 256;
+
+		std::mutex m_ParkingMutex{};
+		std::condition_variable m_ParkingCondition{};
+		std::atomic<unsigned int> m_ParkedCount{ 0 };
+		unsigned int m_WakeCount = 0; //Guarded by the mutex, a parked worker only leaves when it changed
+
+		void WorkerLoop(unsigned int threadIndex);
+		//Own jobs first, then steals from a random thread
+		Job* FindJob(unsigned int threadIndex);
+		void Execute(Job* pJob);
+		//Returns once there might be a job, or when stopping
+		void Park();
+		void WakeWorkers(bool wakeAll);
+		bool HasQueuedJobs() const;
+	};
+
+	//-----------------------------------------------------------------
+	// TASK GRAPH
+	//-----------------------------------------------------------------
+	// Tick phases & what they depend on. A task is forked as soon as its last dependency
+	// finished. Tasks are added in an order where dependencies come first, which is also
+	// the order they run in when the graph runs inline. Forking only pays off when the tasks
+	// take a lot longer than waking a worker, which is a few microseconds, so below the fork
+	// threshold the graph runs inline.
+	class TaskGraph final
+	{
+	public:
+		unsigned int AddTask(const char* name, std::function<void()> fpTask, std::initializer_list<unsigned int> dependencies = {});
+		//Never forked, runs on the thread that calls Execute before it waits on the rest (for work
+		//that has to stay on that thread, like talking to the framework). Has no dependencies
+		unsigned int AddCallingThreadTask(const char* name, std::function<void()> fpTask);
+		void SetForkThreshold(unsigned int threshold) { m_ForkThreshold = threshold; }
+		//Runs every task once, inline without workers or when elementCount is below the fork threshold
+		void Execute(JobSystem& jobSystem, unsigned int elementCount);
+		//Runs every task once on this thread, in the order they were added
+		void ExecuteInline();
+
+		void PrintReport() const;
+
+	private:
+		struct Task
+		{
+			const char* name;
+			std::function<void()> fpTask;
+			std::vector<unsigned int> successors;
+			unsigned int dependencyCount;
+			bool isOnCallingThread;
+			std::atomic<unsigned int> remainingDependencies;
+			SampleStats cost; //Microseconds
+		};
+
+		std::vector<std::unique_ptr<Task>> m_Tasks = {};
+		JobSystem* m_pJobSystem = nullptr;
+		std::atomic<unsigned int> m_Pending{ 0 };
+		unsigned int m_ForkThreshold = 64;
+
+		static void RunTask(void* pData, unsigned int task, unsigned int);
+	};
+}
+#endif
@@ -0,0 +1,199 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EPersistentVector.h: Vectors that publish immutable versions sharing their unchanged parts
+/*=============================================================================*/
+#ifndef ELITE_PERSISTENT_VECTOR
+#define ELITE_PERSISTENT_VECTOR
+
+//--- Includes ---
+#include <memory>
+#include <algorithm>
+
+namespace Elite
+{
+	template<typename T>
+	class VersionedVector;
+
+	//-----------------------------------------------------------------
+	// PERSISTENT VECTOR
+	//-----------------------------------------------------------------
+	// A published version of a VersionedVector, it never changes. A trie with 32 elements
+	// per leaf & 32 children per branch, versions share every node that didn't change in
+	// between. Copying one is copying a pointer, so any thread can hold on to a version
+	// for as long as it likes. Nodes are freed by whoever lets go of them last.
+	template<typename T>
+	class PersistentVector final
+	{
+	public:
+		static const unsigned int Bits = 5;
+		static const unsigned int Branching = 1u << Bits;
+		static const unsigned int Mask = Branching - 1;
+
+		unsigned int GetSize() const { return m_Size; }
+		bool IsEmpty() const { return m_Size == 0; }
+
+		const T& operator[](unsigned int index) const
+		{
+			const Node* pNode = m_pRoot.get();
+			for (unsigned int shift = m_Shift; shift > 0; shift -= Bits)
+				pNode = static_cast<const Branch*>(pNode)->children[(index >> shift) & Mask].get();
+			return static_cast<const Leaf*>(pNode)->values[index & Mask];
+		}
+
+		//Visits every element in order, a leaf at a time instead of a walk down the trie per element
+		template<typename Function>
+		void ForEach(Function function) const
+		{
+			if (m_Size > 0)
+				ForEach(m_pRoot.get(), m_Shift, 0, function);
+		}
+
+	private:
+		friend class VersionedVector<T>;
+
+		struct Node
+		{
+			unsigned int version; //Version of the VersionedVector that may still change it
+		};
+		struct Leaf : Node
+		{
+			T values[Branching];
+		};
+		struct Branch : Node
+		{
+			std::shared_ptr<Node> children[Branching];
+		};
+
+		std::shared_ptr<Node> m_pRoot = nullptr;
+		unsigned int m_Size = 0;
+		unsigned int m_Shift = 0; //0 when the root is a leaf
+
+		template<typename Function>
+		unsigned int ForEach(const Node* pNode, unsigned int shift, unsigned int first, Function& function) const
+		{
+			if (shift == 0)
+			{
+				const Leaf* pLeaf = static_cast<const Leaf*>(pNode);
+				const unsigned int last = std::min(first + Branching, m_Size);
+				for (unsigned int i = first; i < last; ++i)
+					function(pLeaf->values[i - first]);
+				return last;
+			}
+
+			const Branch* pBranch = static_cast<const Branch*>(pNode);
+			for (unsigned int c = 0; c < Branching && first < m_Size; ++c)
+				first = ForEach(pBranch->children[c].get(), shift - Bits, first, function);
+			return first;
+		}
+	};
+
+	//-----------------------------------------------------------------
+	// VERSIONED VECTOR
+	//-----------------------------------------------------------------
+	// The writable side, owned by one thread. Nodes made since the last Publish are changed
+	// in place, the first change to a node that's part of a published version copies it and
+	// the path above it. Publishing is O(1), what it costs is paid by the changes: O(log n)
+	// copied nodes for the first change to a leaf after a publish, nothing for the next ones.
+	template<typename T>
+	class VersionedVector final
+	{
+	public:
+		VersionedVector() = default;
+		//Copies would change each other's unpublished nodes
+		VersionedVector(const VersionedVector&) = delete;
+		VersionedVector& operator=(const VersionedVector&) = delete;
+
+		unsigned int GetSize() const { return m_Current.m_Size; }
+		const T& operator[](unsigned int index) const { return m_Current[index]; }
+
+		void PushBack(const T& value)
+		{
+			if (m_Current.m_Size == GetCapacity())
+			{
+				//Full, the old root becomes the first child of a new one
+				std::shared_ptr<Branch> pRoot = std::make_shared<Branch>();
+				pRoot->version = m_Version;
+				pRoot->children[0] = m_Current.m_pRoot;
+				m_Current.m_pRoot = pRoot;
+				m_Current.m_Shift += Vector::Bits;
+			}
+
+			GetMutable(m_Current.m_Size) = value;
+			++m_Current.m_Size;
+		}
+		//The last element takes the place of the removed one, same as a swap & pop on a vector
+		void RemoveSwap(unsigned int index)
+		{
+			const unsigned int last = m_Current.m_Size - 1;
+			if (index != last)
+			{
+				//Copied out first, making the leaf owned can free the one the last element is read from
+				const T value = m_Current[last];
+				GetMutable(index) = value;
+			}
+			--m_Current.m_Size;
+		}
+		void Set(unsigned int index, const T& value) { GetMutable(index) = value; }
+		void Resize(unsigned int size)
+		{
+			while (m_Current.m_Size < size)
+				PushBack(T{});
+			m_Current.m_Size = size;
+		}
+		void Clear() { m_Current = Vector{}; }
+
+		//The version as it is now, later changes won't touch it
+		PersistentVector<T> Publish()
+		{
+			++m_Version;
+			return m_Current;
+		}
+
+		unsigned int GetCopiedNodeCount() const { return m_CopiedNodeCount; }
+
+	private:
+		using Vector = PersistentVector<T>;
+		using Node = typename Vector::Node;
+		using Leaf = typename Vector::Leaf;
+		using Branch = typename Vector::Branch;
+
+		Vector m_Current{};
+		unsigned int m_Version = 1;
+		unsigned int m_CopiedNodeCount = 0;
+
+		unsigned int GetCapacity() const { return 1u << (m_Current.m_Shift + Vector::Bits); }
+
+		//Walks down to the element, copying every node on the way that's shared with a published version
+		T& GetMutable(unsigned int index)
+		{
+			std::shared_ptr<Node>* pNode = &m_Current.m_pRoot;
+			for (unsigned int shift = m_Current.m_Shift; shift > 0; shift -= Vector::Bits)
+			{
+				Branch& branch = MakeOwned<Branch>(*pNode);
+				pNode = &branch.children[(index >> shift) & Vector::Mask];
+			}
+			return MakeOwned<Leaf>(*pNode).values[index & Vector::Mask];
+		}
+
+		template<typename NodeType>
+		NodeType& MakeOwned(std::shared_ptr<Node>& pNode)
+		{
+			if (!pNode)
+			{
+				std::shared_ptr<NodeType> pNew = std::make_shared<NodeType>();
+				pNew->version = m_Version;
+				pNode = pNew;
+			}
+			else if (pNode->version != m_Version)
+			{
+				std::shared_ptr<NodeType> pCopy = std::make_shared<NodeType>(static_cast<const NodeType&>(*pNode));
+				pCopy->version = m_Version;
+				pNode = pCopy;
+				++m_CopiedNodeCount;
+			}
+			return static_cast<NodeType&>(*pNode);
+		}
+	};
+}
+#endif
@@ -0,0 +1,77 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EProfiler.h: Lightweight timing helpers to measure the cost of a tick phase
+/*=============================================================================*/
+#ifndef ELITE_PROFILER
+#define ELITE_PROFILER
+
+#include <chrono>
+#include <cfloat>
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// HIGH RESOLUTION CLOCK
+	//-----------------------------------------------------------------
+	using ProfileClock = std::chrono::high_resolution_clock;
+
+	inline double ElapsedMicroseconds(ProfileClock::time_point start, ProfileClock::time_point end = ProfileClock::now())
+	{
+		return std::chrono::duration<double, std::micro>(end - start).count();
+	}
+
+	//-----------------------------------------------------------------
+	// SAMPLE STATISTICS
+	//-----------------------------------------------------------------
+	class SampleStats final
+	{
+	public:
+		void AddSample(double value)
+		{
+			++m_Count;
+			m_Total += value;
+			m_Last = value;
+			if (value < m_Min) m_Min = value;
+			if (value > m_Max) m_Max = value;
+		}
+		void Reset() { *this = SampleStats{}; }
+
+		unsigned int GetCount() const { return m_Count; }
+		double GetLast() const { return m_Last; }
+		double GetAverage() const { return m_Count ? m_Total / m_Count : 0.0; }
+		double GetMin() const { return m_Count ? m_Min : 0.0; }
+		double GetMax() const { return m_Count ? m_Max : 0.0; }
+
+		void Print(const char* name) const
+		{
+			printf("%s: %u samples, avg %.2f, min %.2f, max %.2f\n", name, GetCount(), GetAverage(), GetMin(), GetMax());
+		}
+
+	private:
+		unsigned int m_Count = 0;
+		double m_Total = 0.0;
+		double m_Last = 0.0;
+		double m_Min = DBL_MAX;
+		double m_Max = 0.0;
+	};
+
+	//-----------------------------------------------------------------
+	// SCOPED TIMER
+	//-----------------------------------------------------------------
+	//Adds the lifetime of the timer (in microseconds) to the given statistics
+	class ScopedTimer final
+	{
+	public:
+		explicit ScopedTimer(SampleStats& stats) : m_Stats(stats), m_Start(ProfileClock::now()) {}
+		~ScopedTimer() { m_Stats.AddSample(ElapsedMicroseconds(m_Start)); }
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		SampleStats& m_Stats;
+		ProfileClock::time_point m_Start;
+	};
+}
+#endif
@@ -0,0 +1,50 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "ETimeSlicing.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// BUDGETED JOB SCHEDULER
+//-----------------------------------------------------------------
+void BudgetedJobScheduler::AddJob(IBudgetedJob* pJob, const char* name, double budgetMicroseconds)
+{
+	m_Jobs.push_back(Job{ pJob, name, budgetMicroseconds, 0, 0, SampleStats{}, SampleStats{} });
+}
+
+void BudgetedJobScheduler::Tick()
+{
+	for (Job& job : m_Jobs)
+	{
+		if (job.pJob->IsDone())
+			continue;
+
+		const ProfileClock::time_point start = ProfileClock::now();
+		do
+		{
+			job.pJob->Step();
+			++job.stepCount;
+		} while (!job.pJob->IsDone() && ElapsedMicroseconds(start) < job.budget);
+
+		job.costPerTick.AddSample(ElapsedMicroseconds(start));
+		++job.ticksRunning;
+
+		//A plan that restarted before it converged counts as one long plan
+		if (job.pJob->IsDone())
+		{
+			job.ticksToConverge.AddSample(double(job.ticksRunning));
+			job.ticksRunning = 0;
+		}
+	}
+}
+
+void BudgetedJobScheduler::PrintReport() const
+{
+	for (const Job& job : m_Jobs)
+	{
+		printf("%s: %u steps, budget %.0fus per tick\n", job.name, job.stepCount, job.budget);
+		printf("  ");
+		job.ticksToConverge.Print("Ticks to converge");
+		printf("  ");
+		job.costPerTick.Print("Cost per tick (us)");
+	}
+}
@@ -0,0 +1,63 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// ETimeSlicing.h: Runs long computations a few microseconds per tick
+/*=============================================================================*/
+#ifndef ELITE_TIME_SLICING
+#define ELITE_TIME_SLICING
+
+//--- Includes ---
+#include <vector>
+#include "EProfiler.h"
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// BUDGETED JOB (BASE)
+	//-----------------------------------------------------------------
+	// A computation split into small resumable steps. Whatever the job has produced so far
+	// stays usable while it isn't done, so a stale plan is followed until the new one converged.
+	class IBudgetedJob
+	{
+	public:
+		IBudgetedJob() = default;
+		virtual ~IBudgetedJob() = default;
+
+		virtual bool IsDone() const = 0;
+		//Does a small, bounded piece of the work and returns
+		virtual void Step() = 0;
+	};
+
+	//-----------------------------------------------------------------
+	// BUDGETED JOB SCHEDULER
+	//-----------------------------------------------------------------
+	// Every tick each job that isn't done gets stepped until it's done or its budget is used.
+	// A job always gets at least one step per tick, so a too small budget can't starve it.
+	class BudgetedJobScheduler final
+	{
+	public:
+		BudgetedJobScheduler() = default;
+		~BudgetedJobScheduler() = default;
+
+		//The job isn't owned, name has to outlive the scheduler
+		void AddJob(IBudgetedJob* pJob, const char* name, double budgetMicroseconds);
+		void Tick();
+
+		void PrintReport() const;
+
+	private:
+		struct Job
+		{
+			IBudgetedJob* pJob;
+			const char* name;
+			double budget; //Microseconds per tick
+			unsigned int ticksRunning; //Ticks spent on the current plan
+			unsigned int stepCount;
+			SampleStats ticksToConverge;
+			SampleStats costPerTick; //Microseconds, only ticks the job had work
+		};
+
+		std::vector<Job> m_Jobs = {};
+	};
+}
+#endif
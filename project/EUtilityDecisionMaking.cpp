@@ -0,0 +1,216 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EUtilityDecisionMaking.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// RESPONSE CURVE
+//-----------------------------------------------------------------
+float ResponseCurve::Evaluate(float x) const
+{
+	x = Clamp(x, 0.f, 1.f);
+
+	float y = 0.f;
+	switch (type)
+	{
+	case Type::Linear:
+		y = slope * (x - xShift) + yShift;
+		break;
+	case Type::Polynomial:
+		y = slope * powf(x - xShift, exponent) + yShift;
+		break;
+	case Type::Logistic:
+		y = slope / (1.f + expf(-exponent * (x - xShift))) + yShift;
+		break;
+	case Type::Step:
+		y = (x >= xShift) ? slope : yShift;
+		break;
+	}
+	return Clamp(y, 0.f, 1.f);
+}
+
+ResponseCurve ResponseCurve::CreateLinear(float slope, float yShift)
+{
+	return ResponseCurve{ Type::Linear, slope, 1.f, 0.f, yShift };
+}
+
+ResponseCurve ResponseCurve::CreateQuadratic(float slope, float yShift)
+{
+	return ResponseCurve{ Type::Polynomial, slope, 2.f, 0.f, yShift };
+}
+
+ResponseCurve ResponseCurve::CreateLogistic(float steepness, float midPoint)
+{
+	return ResponseCurve{ Type::Logistic, 1.f, steepness, midPoint, 0.f };
+}
+
+ResponseCurve ResponseCurve::CreateStep(float threshold, float low, float high)
+{
+	return ResponseCurve{ Type::Step, high, 1.f, threshold, low };
+}
+
+//-----------------------------------------------------------------
+// UTILITY DECISION MAKER (IDecisionMaking)
+//-----------------------------------------------------------------
+UtilityDecisionMaker::UtilityDecisionMaker(Blackboard* pBlackBoard, std::vector<Consideration> considerations,
+	std::vector<UtilityAction> actions, float hysteresis)
+	: m_pBlackBoard(pBlackBoard)
+	, m_Considerations(considerations)
+	, m_Hysteresis(hysteresis)
+{
+	for (unsigned int a = 0; a < actions.size(); ++a)
+	{
+		const UtilityAction& action = actions[a];
+		m_ActionNames.push_back(action.name);
+		m_ActionWeights.push_back(action.weight);
+		m_ActionTermCounts.push_back(static_cast<unsigned int>(action.terms.size()));
+		m_ActionBehaviors.push_back(action.pBehavior);
+
+		for (const UtilityAction::Term& term : action.terms)
+		{
+			assert(term.considerationIndex < m_Considerations.size() && "Action uses an unknown consideration");
+			m_Terms.push_back(ScoringTerm{ a, term.considerationIndex, term.curve });
+		}
+	}
+
+	m_Inputs.resize(m_Considerations.size());
+	m_Scores.resize(actions.size());
+	m_Ranking.resize(actions.size());
+}
+
+UtilityDecisionMaker::~UtilityDecisionMaker()
+{
+	for (auto pb : m_ActionBehaviors)
+		SAFE_DELETE(pb);
+	m_ActionBehaviors.clear();
+	SAFE_DELETE(m_pBlackBoard); //Takes ownership of passed blackboard!
+}
+
+void UtilityDecisionMaker::Update(float /*deltaTime*/)
+{
+	EvaluateConsiderations();
+	ScoreActions();
+
+	for (unsigned int i = 0; i < m_Ranking.size(); ++i)
+		m_Ranking[i] = i;
+	std::sort(m_Ranking.begin(), m_Ranking.end(),
+		[this](unsigned int a, unsigned int b) { return m_Scores[a] > m_Scores[b]; });
+
+	//Best action first, fall through to the next best when it can't execute this tick
+	m_CurrentAction = -1;
+	for (unsigned int action : m_Ranking)
+	{
+		if (m_Scores[action] <= 0.f)
+			break;
+
+		IBehavior* pBehavior = m_ActionBehaviors[action];
+		if (pBehavior && pBehavior->Execute(m_pBlackBoard) != Failure)
+		{
+			m_CurrentAction = int(action);
+			break;
+		}
+	}
+}
+
+void UtilityDecisionMaker::SaveState(CheckpointWriter& writer) const
+{
+	//The winner decides the hysteresis of the next tick, the scores are only kept for display
+	writer.WriteTag("UTIL");
+	writer.Write(static_cast<unsigned int>(m_ActionBehaviors.size()));
+	writer.Write(m_CurrentAction);
+	writer.WriteArray(m_Scores);
+	for (const IBehavior* pBehavior : m_ActionBehaviors)
+	{
+		if (pBehavior)
+			pBehavior->SaveState(writer);
+	}
+}
+
+bool UtilityDecisionMaker::LoadState(CheckpointReader& reader)
+{
+	//Checked on a copy of the reader first
+	CheckpointReader checkReader = reader;
+	if (!ValidateState(checkReader))
+		return false;
+
+	unsigned int actionCount = 0;
+	reader.ReadTag("UTIL");
+	reader.Read(actionCount);
+	reader.Read(m_CurrentAction);
+	reader.ReadArray(m_Scores);
+	for (IBehavior* pBehavior : m_ActionBehaviors)
+	{
+		if (pBehavior)
+			pBehavior->LoadState(reader);
+	}
+	return reader.IsValid();
+}
+
+bool UtilityDecisionMaker::ValidateState(CheckpointReader& reader) const
+{
+	unsigned int actionCount = 0, scoreCount = 0;
+	int currentAction = -1;
+	if (!reader.ReadTag("UTIL") || !reader.Read(actionCount) || actionCount != m_ActionBehaviors.size())
+		return false;
+	if (!reader.Read(currentAction) || !reader.ReadArrayCount<float>(scoreCount) || scoreCount != actionCount)
+		return false;
+	if (currentAction < -1 || currentAction >= int(actionCount))
+		return false;
+	for (unsigned int i = 0; i < scoreCount; ++i)
+	{
+		float score = 0.f;
+		if (!reader.Read(score))
+			return false;
+	}
+
+	for (const IBehavior* pBehavior : m_ActionBehaviors)
+	{
+		if (pBehavior && !pBehavior->ValidateState(reader))
+			return false;
+	}
+	return true;
+}
+
+const std::string& UtilityDecisionMaker::GetActionName(int action) const
+{
+	static const std::string none = "None";
+	if (action < 0 || action >= int(m_ActionNames.size()))
+		return none;
+
+	return m_ActionNames[action];
+}
+
+void UtilityDecisionMaker::EvaluateConsiderations()
+{
+	//Every input is evaluated exactly once, no matter how many actions use it
+	for (unsigned int i = 0; i < m_Considerations.size(); ++i)
+		m_Inputs[i] = Clamp(m_Considerations[i](m_pBlackBoard), 0.f, 1.f);
+}
+
+void UtilityDecisionMaker::ScoreActions()
+{
+	for (unsigned int a = 0; a < m_Scores.size(); ++a)
+		m_Scores[a] = 1.f;
+
+	//Single pass over the flattened terms, multiplying the curve outputs per action
+	for (const ScoringTerm& term : m_Terms)
+		m_Scores[term.actionIndex] *= term.curve.Evaluate(m_Inputs[term.considerationIndex]);
+
+	for (unsigned int a = 0; a < m_Scores.size(); ++a)
+	{
+		//Compensate for the amount of terms, otherwise actions with many terms always lose
+		const unsigned int termCount = m_ActionTermCounts[a];
+		if (termCount > 1 && m_Scores[a] > 0.f)
+		{
+			const float modification = 1.f - (1.f / termCount);
+			const float makeUp = (1.f - m_Scores[a]) * modification;
+			m_Scores[a] += makeUp * m_Scores[a];
+		}
+
+		m_Scores[a] *= m_ActionWeights[a];
+
+		//Hysteresis, the running action needs to be beaten by a margin before we switch
+		if (int(a) == m_CurrentAction)
+			m_Scores[a] *= 1.f + m_Hysteresis;
+	}
+}
@@ -0,0 +1,115 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EUtilityDecisionMaking.h: Utility AI, scores every action and executes the best one
+/*=============================================================================*/
+#ifndef ELITE_UTILITY_DECISION_MAKING
+#define ELITE_UTILITY_DECISION_MAKING
+
+//--- Includes ---
+#include "EBlackboard.h"
+#include "EBehaviorTree.h"
+#include "EDecisionMaking.h"
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// RESPONSE CURVE
+	//-----------------------------------------------------------------
+	//Maps a normalized input [0, 1] to a normalized utility [0, 1]
+	struct ResponseCurve
+	{
+		enum class Type
+		{
+			Linear,		// slope * (x - xShift) + yShift
+			Polynomial,	// slope * (x - xShift)^exponent + yShift
+			Logistic,	// slope / (1 + e^(-exponent * (x - xShift))) + yShift
+			Step		// x >= xShift ? slope : yShift
+		};
+
+		Type type = Type::Linear;
+		float slope = 1.f;
+		float exponent = 1.f;
+		float xShift = 0.f;
+		float yShift = 0.f;
+
+		float Evaluate(float x) const;
+
+		static ResponseCurve CreateLinear(float slope = 1.f, float yShift = 0.f);
+		static ResponseCurve CreateQuadratic(float slope = 1.f, float yShift = 0.f);
+		static ResponseCurve CreateLogistic(float steepness = 10.f, float midPoint = 0.5f);
+		static ResponseCurve CreateStep(float threshold = 0.5f, float low = 0.f, float high = 1.f);
+	};
+
+	//-----------------------------------------------------------------
+	// UTILITY ACTION
+	//-----------------------------------------------------------------
+	//Returns the normalized input of a consideration, evaluated once per tick
+	using Consideration = std::function<float(Blackboard*)>;
+
+	struct UtilityAction
+	{
+		struct Term
+		{
+			unsigned int considerationIndex;
+			ResponseCurve curve;
+		};
+
+		std::string name = {};
+		float weight = 1.f;
+		std::vector<Term> terms = {};
+		IBehavior* pBehavior = nullptr; //Ownership is taken by the decision maker
+	};
+
+	//-----------------------------------------------------------------
+	// UTILITY DECISION MAKER (IDecisionMaking)
+	//-----------------------------------------------------------------
+	class UtilityDecisionMaker final : public Elite::IDecisionMaking
+	{
+	public:
+		explicit UtilityDecisionMaker(Blackboard* pBlackBoard, std::vector<Consideration> considerations,
+			std::vector<UtilityAction> actions, float hysteresis = 0.15f);
+		~UtilityDecisionMaker();
+
+		virtual void Update(float deltaTime) override;
+		virtual void SaveState(CheckpointWriter& writer) const override;
+		virtual bool LoadState(CheckpointReader& reader) override;
+		virtual bool ValidateState(CheckpointReader& reader) const override;
+
+		Blackboard* GetBlackboard() const { return m_pBlackBoard; }
+		//Winner of the last tick, -1 if nothing could execute
+		int GetCurrentAction() const { return m_CurrentAction; }
+		const std::string& GetActionName(int action) const;
+		float GetScore(int action) const { return m_Scores[action]; }
+
+	private:
+		//Flattened (action, consideration, curve) triplets, sorted per action
+		struct ScoringTerm
+		{
+			unsigned int actionIndex;
+			unsigned int considerationIndex;
+			ResponseCurve curve;
+		};
+
+		Blackboard* m_pBlackBoard = nullptr;
+		std::vector<Consideration> m_Considerations = {};
+		std::vector<ScoringTerm> m_Terms = {};
+
+		std::vector<std::string> m_ActionNames = {};
+		std::vector<float> m_ActionWeights = {};
+		std::vector<unsigned int> m_ActionTermCounts = {};
+		std::vector<IBehavior*> m_ActionBehaviors = {};
+
+		//Per tick scratch, allocated once
+		std::vector<float> m_Inputs = {};
+		std::vector<float> m_Scores = {};
+		std::vector<unsigned int> m_Ranking = {};
+
+		float m_Hysteresis = 0.f;
+		int m_CurrentAction = -1;
+
+		void EvaluateConsiderations();
+		void ScoreActions();
+	};
+}
+#endif
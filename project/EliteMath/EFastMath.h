@@ -0,0 +1,246 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EFastMath.h: Polynomial sin, cos, atan2 & angle wrapping, scalar & 4/8 floats at once
+/*=============================================================================*/
+#ifndef ELITE_MATH_FAST_MATH
+#define ELITE_MATH_FAST_MATH
+//Standard C++ includes
+#include <math.h>
+#include <cstring>
+#include "EMathUtilities.h"
+#include "EVector2.h"
+
+//SSE2 is there on every x64 build & on x86 unless /arch:IA32, AVX needs /arch:AVX or -mavx
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ELITE_FAST_MATH_SSE
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#define ELITE_FAST_MATH_AVX
+#include <immintrin.h>
+#endif
+
+namespace Elite {
+	//-----------------------------------------------------------------
+	// FAST MATH
+	//-----------------------------------------------------------------
+	// Every function is written once over a lane type, float, Float4 or Float8, so the scalar &
+	// wide versions give the same results. Maximum errors against double precision libm, as checked
+	// by Tests/FastMathAccuracy.cpp (--exhaustive walks every float in the range):
+	//   Sin, Cos     |angle| <= 8192   8e-8 absolute (1.3 ulp near 1)
+	//   Atan2        any y, x          2.8e-7 rad, atan2(0, 0) is 0, signed zeros like libm
+	//   WrapAngle    |angle| <= 8192   into [-pi, pi], 2e-7 rad from the exact wrap
+	// Beyond 8192 radians the range reduction loses bits, NaN & infinity aren't handled.
+	namespace FastMath {
+		//=== Lane types ===
+		inline float Select(bool mask, float a, float b) { return mask ? a : b; }
+		inline bool And(bool a, bool b) { return a && b; }
+		inline bool Or(bool a, bool b) { return a || b; }
+		inline float Abs(float v) { return fabsf(v); }
+		inline float Floor(float v) { return floorf(v); }
+		inline float Min(float a, float b) { return a < b ? a : b; }
+		inline float Max(float a, float b) { return a > b ? a : b; }
+		inline bool SignBit(float v)
+		{
+			unsigned int bits;
+			memcpy(&bits, &v, sizeof(bits));
+			return (bits >> 31) != 0;
+		}
+		inline float FlipSign(float v, bool mask) { return mask ? -v : v; }
+
+#ifdef ELITE_FAST_MATH_SSE
+		struct Float4
+		{
+			__m128 v;
+			Float4() = default;
+			Float4(__m128 value) : v(value) {}
+			Float4(float value) : v(_mm_set1_ps(value)) {}
+		};
+		inline Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+		inline Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+		inline Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+		inline Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v, b.v); }
+		inline Float4 operator-(Float4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.f)); }
+		inline Float4 operator<(Float4 a, Float4 b) { return _mm_cmplt_ps(a.v, b.v); }
+		inline Float4 operator>(Float4 a, Float4 b) { return _mm_cmpgt_ps(a.v, b.v); }
+		inline Float4 operator>=(Float4 a, Float4 b) { return _mm_cmpge_ps(a.v, b.v); }
+		inline Float4 operator==(Float4 a, Float4 b) { return _mm_cmpeq_ps(a.v, b.v); }
+		inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+		inline Float4 And(Float4 a, Float4 b) { return _mm_and_ps(a.v, b.v); }
+		inline Float4 Or(Float4 a, Float4 b) { return _mm_or_ps(a.v, b.v); }
+		inline Float4 Abs(Float4 v) { return _mm_andnot_ps(_mm_set1_ps(-0.f), v.v); }
+		inline Float4 Floor(Float4 v)
+		{
+			//No SSE4.1 round, truncate & step down where that went up
+			const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(v.v));
+			return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, v.v), _mm_set1_ps(1.f)));
+		}
+		inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+		inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+		inline Float4 SignBit(Float4 v) { return _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(v.v), 31)); }
+		inline Float4 FlipSign(Float4 v, Float4 mask) { return _mm_xor_ps(v.v, _mm_and_ps(mask.v, _mm_set1_ps(-0.f))); }
+#endif
+
+#ifdef ELITE_FAST_MATH_AVX
+		struct Float8
+		{
+			__m256 v;
+			Float8() = default;
+			Float8(__m256 value) : v(value) {}
+			Float8(float value) : v(_mm256_set1_ps(value)) {}
+		};
+		inline Float8 operator+(Float8 a, Float8 b) { return _mm256_add_ps(a.v, b.v); }
+		inline Float8 operator-(Float8 a, Float8 b) { return _mm256_sub_ps(a.v, b.v); }
+		inline Float8 operator*(Float8 a, Float8 b) { return _mm256_mul_ps(a.v, b.v); }
+		inline Float8 operator/(Float8 a, Float8 b) { return _mm256_div_ps(a.v, b.v); }
+		inline Float8 operator-(Float8 a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.f)); }
+		inline Float8 operator<(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+		inline Float8 operator>(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+		inline Float8 operator>=(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+		inline Float8 operator==(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+		inline Float8 Select(Float8 mask, Float8 a, Float8 b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+		inline Float8 And(Float8 a, Float8 b) { return _mm256_and_ps(a.v, b.v); }
+		inline Float8 Or(Float8 a, Float8 b) { return _mm256_or_ps(a.v, b.v); }
+		inline Float8 Abs(Float8 v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), v.v); }
+		inline Float8 Floor(Float8 v) { return _mm256_floor_ps(v.v); }
+		inline Float8 Min(Float8 a, Float8 b) { return _mm256_min_ps(a.v, b.v); }
+		inline Float8 Max(Float8 a, Float8 b) { return _mm256_max_ps(a.v, b.v); }
+		//No 256-bit integer shifts before AVX2, compare the sign bit instead
+		inline Float8 SignBit(Float8 v) { return _mm256_blendv_ps(_mm256_setzero_ps(), _mm256_castsi256_ps(_mm256_set1_epi32(-1)), v.v); } //blendv picks on the sign bit
+		inline Float8 FlipSign(Float8 v, Float8 mask) { return _mm256_xor_ps(v.v, _mm256_and_ps(mask.v, _mm256_set1_ps(-0.f))); }
+#endif
+
+		//=== Kernels ===
+		//Angle in [-pi, pi], 2pi split in two so subtracting whole turns stays exact
+		template<typename V>
+		inline V WrapAngle(V angle)
+		{
+			const V turns = Floor(angle * 0.159154943091895f + 0.5f);
+			return (angle - turns * 6.28125f) - turns * 1.93530717958647692e-3f;
+		}
+
+		template<typename V>
+		inline void SinCos(V angle, V& sine, V& cosine)
+		{
+			//Quarter turns to take off, pi/2 split in three so that stays exact
+			const V quarters = Floor(angle * 0.636619772367581f + 0.5f);
+			const V r = ((angle - quarters * 1.5703125f) - quarters * 4.837512969970703125e-4f) - quarters * 7.54978995489188216e-8f;
+
+			//Minimax polynomials over [-pi/4, pi/4]
+			const V z = r * r;
+			const V sinR = ((z * -1.9515295891e-4f + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+			const V cosR = ((z * 2.443315711809948e-5f - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - z * 0.5f + 1.f;
+
+			//Quarter turn 0: sin, cos  1: cos, -sin  2: -sin, -cos  3: -cos, sin
+			const V quadrant = quarters - Floor(quarters * 0.25f) * 4.f;
+			const auto isOdd = Or(quadrant == 1.f, quadrant == 3.f);
+			sine = FlipSign(Select(isOdd, cosR, sinR), quadrant >= 2.f);
+			cosine = FlipSign(Select(isOdd, sinR, cosR), Or(quadrant == 1.f, quadrant == 2.f));
+		}
+
+		template<typename V>
+		inline V Atan2(V y, V x)
+		{
+			//atan over [0, 1], tan(pi/8) and up is shifted down by pi/4
+			const V absX = Abs(x);
+			const V absY = Abs(y);
+			const V largest = Max(absX, absY);
+			const V smallest = Min(absX, absY);
+			const auto isShifted = smallest > largest * 0.414213562373095f;
+			const V t = Select(isShifted, smallest - largest, smallest) / Max(Select(isShifted, smallest + largest, largest), FLT_MIN);
+
+			const V z = t * t;
+			V angle = (((z * 8.05374449538e-2f - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * t + t;
+			angle = Select(isShifted, angle + 0.785398163397448f, angle);
+
+			//Back to the octant y & x are in
+			angle = Select(absY > absX, V(1.57079632679490f) - angle, angle);
+			angle = Select(SignBit(x), V(3.14159265358979f) - angle, angle);
+			return FlipSign(angle, SignBit(y));
+		}
+
+		//=== Scalar ===
+		inline float Sin(float angle)
+		{
+			float sine, cosine;
+			SinCos(angle, sine, cosine);
+			return sine;
+		}
+		inline float Cos(float angle)
+		{
+			float sine, cosine;
+			SinCos(angle, sine, cosine);
+			return cosine;
+		}
+		//Same convention as Elite::OrientationToVector & Elite::GetOrientationFromVelocity
+		inline Vector2 OrientationToVector(float orientation)
+		{
+			float sine, cosine;
+			SinCos(orientation, sine, cosine);
+			return Vector2{ sine, -cosine };
+		}
+		inline float GetOrientationFromVelocity(const Vector2& velocity)
+		{
+			return Atan2(velocity.x, -velocity.y);
+		}
+
+		//=== Arrays ===
+		// The widest lanes the build has, scalar for what's left. Outputs may be the inputs
+		inline void SinCos(const float* angles, float* sines, float* cosines, unsigned int count)
+		{
+			unsigned int i = 0;
+#if defined(ELITE_FAST_MATH_AVX)
+			for (; i + 8 <= count; i += 8)
+			{
+				Float8 sine, cosine;
+				SinCos(Float8(_mm256_loadu_ps(angles + i)), sine, cosine);
+				_mm256_storeu_ps(sines + i, sine.v);
+				_mm256_storeu_ps(cosines + i, cosine.v);
+			}
+#endif
+#if defined(ELITE_FAST_MATH_SSE)
+			for (; i + 4 <= count; i += 4)
+			{
+				Float4 sine, cosine;
+				SinCos(Float4(_mm_loadu_ps(angles + i)), sine, cosine);
+				_mm_storeu_ps(sines + i, sine.v);
+				_mm_storeu_ps(cosines + i, cosine.v);
+			}
+#endif
+			for (; i < count; ++i)
+				SinCos(angles[i], sines[i], cosines[i]);
+		}
+
+		inline void Atan2(const float* ys, const float* xs, float* angles, unsigned int count)
+		{
+			unsigned int i = 0;
+#if defined(ELITE_FAST_MATH_AVX)
+			for (; i + 8 <= count; i += 8)
+				_mm256_storeu_ps(angles + i, Atan2(Float8(_mm256_loadu_ps(ys + i)), Float8(_mm256_loadu_ps(xs + i))).v);
+#endif
+#if defined(ELITE_FAST_MATH_SSE)
+			for (; i + 4 <= count; i += 4)
+				_mm_storeu_ps(angles + i, Atan2(Float4(_mm_loadu_ps(ys + i)), Float4(_mm_loadu_ps(xs + i))).v);
+#endif
+			for (; i < count; ++i)
+				angles[i] = Atan2(ys[i], xs[i]);
+		}
+
+		inline void WrapAngles(const float* angles, float* wrapped, unsigned int count)
+		{
+			unsigned int i = 0;
+#if defined(ELITE_FAST_MATH_AVX)
+			for (; i + 8 <= count; i += 8)
+				_mm256_storeu_ps(wrapped + i, WrapAngle(Float8(_mm256_loadu_ps(angles + i))).v);
+#endif
+#if defined(ELITE_FAST_MATH_SSE)
+			for (; i + 4 <= count; i += 4)
+				_mm_storeu_ps(wrapped + i, WrapAngle(Float4(_mm_loadu_ps(angles + i))).v);
+#endif
+			for (; i < count; ++i)
+				wrapped[i] = WrapAngle(angles[i]);
+		}
+	}
+}
+#endif
@@ -15,6 +15,10 @@
 #include "EVector2.h"
 #include "EVector3.h"
 #include "EMat22.h"
+/* --- FAST APPROXIMATIONS --- */
+#include "EFastMath.h"
+#include "EMatrix2x3.h"
+#include "ERandom.h"
 
 /* --- TYPE DEFINES --- */
 #endif
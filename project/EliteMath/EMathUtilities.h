@@ -84,25 +84,6 @@ namespace Elite {
 		return a;
 	}
 
-	/*! Random Integer */
-	inline int randomInt(int max = 1)
-	{ return rand() % max; }
-
-	/*! Random Float */
-	inline float randomFloat(float max = 1.f)
-	{ return max * (float(rand()) / RAND_MAX); }
-
-	/*! Random Float */
-	inline float randomFloat(float min, float max)
-	{
-		auto range = max - min;
-		return (range * (float(rand()) / RAND_MAX)) + min;
-	}
-
-	/*! Random Binomial Float */
-	inline float randomBinomial(float max = 1.f)
-	{ return randomFloat(max) - randomFloat(max); }
-
 	/*! Linear Interpolation */
 	/*inline float Lerp(float v0, float v1, float t)
 	{ return (1 - t) * v0 + t * v1;	}*/
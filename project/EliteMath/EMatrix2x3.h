@@ -1,31 +1,34 @@
 #pragma once
 #include <vector>
+#include <string>
+#include <ostream>
+#include "EFastMath.h"
 
 struct Matrix2x3
 {
 	// -------------------------
-	// Constructors 
+	// Constructors
 	// -------------------------
 	// Default constructor results in a unity matrix
-	explicit Matrix2x3( Elite::Vector2 dirX = Elite::Vector2{ 1, 0 }, Elite::Vector2 dirY = Elite::Vector2{ 0, 1 }, Elite::Vector2 origTrans = Elite::Vector2{ 0, 0 } );
+	constexpr explicit Matrix2x3( Elite::Vector2 dirX = Elite::Vector2{ 1, 0 }, Elite::Vector2 dirY = Elite::Vector2{ 0, 1 }, Elite::Vector2 origTrans = Elite::Vector2{ 0, 0 } );
 	// Constructor, using floats, all required
-	explicit Matrix2x3( float e1X, float e1Y, float e2X, float e2Y, float oX, float oY );
+	constexpr explicit Matrix2x3( float e1X, float e1Y, float e2X, float e2Y, float oX, float oY );
 
 	// -------------------------
-	// General Methods 
+	// General Methods
 	// -------------------------
 	// Elite::Vector2 vTransformed = mat.Transform(v);
-	Elite::Vector2 Transform( const Elite::Vector2& v ) const;
+	constexpr Elite::Vector2 Transform( const Elite::Vector2& v ) const;
 
 	// Calculate the determinant
-	float Determinant( ) const;
+	constexpr float Determinant( ) const;
 
 	// Calculate the inverse matrix
-	Matrix2x3 Inverse( ) const;
+	constexpr Matrix2x3 Inverse( ) const;
 
-	// Are two matrices equal within a threshold?	
+	// Are two matrices equal within a threshold?
 	// mat1.Equals(mat2)
-	bool Equals( const Matrix2x3& other, float epsilon = 0.001f ) const;
+	constexpr bool Equals( const Matrix2x3& other, float epsilon = 0.001f ) const;
 
 	// Creates a string containing a text representation of the values of the matrix
 	std::string ToString( ) const;
@@ -43,30 +46,45 @@ struct Matrix2x3
 	// Converts this matrix into a Scale matrix
 	void SetAsScale( float s );
 
+	// -------------------------
+	// Batch Methods
+	// -------------------------
+	// The same transform over many points, 4 or 8 at once when the build has SSE2 or AVX.
+	// Outputs may be the inputs.
+	// Points as separate x & y arrays: mat.TransformPoints(xs, ys, localXs, localYs, count);
+	void TransformPoints( const float* xs, const float* ys, float* transformedXs, float* transformedYs, unsigned int count ) const;
+	// Points as an array of Elite::Vector2, like a polygon's: mat.TransformPolygon(corners.data(), localCorners.data(), 4);
+	void TransformPolygon( const Elite::Vector2* pPoints, Elite::Vector2* pTransformed, unsigned int count ) const;
+	// Same, through the inverse, which is worked out once: toLocal.InverseTransformPolygon(localCorners, worldCorners, 4);
+	void InverseTransformPolygon( const Elite::Vector2* pPoints, Elite::Vector2* pTransformed, unsigned int count ) const;
+
 	// -------------------------------------------
-	// Static Matrix2x3 object creation methods 
+	// Static Matrix2x3 object creation methods
 	// -------------------------------------------
-	// Instantiate a rotation matrix: 
+	// Instantiate a rotation matrix:
 	// Matrix matRot = Matrix::Rotation(45.0f);
 	static Matrix2x3 CreateRotationMatrix( float degrees );
-	// Instantiate an identity matrix: 
+	// Instantiate an identity matrix:
 	// Matrix2x3 matId = Matrix2x3::Identity();
-	static Matrix2x3 CreateIdentityMatrix( );
-	// Instantiate a scale matrix: 
+	static constexpr Matrix2x3 CreateIdentityMatrix( );
+	// Instantiate a scale matrix:
 	// Matrix matScale = Matrix::Scaling(2.0f);
-	static Matrix2x3 CreateScalingMatrix( float scale );
-	// Instantiate a scale matrix: 
+	static constexpr Matrix2x3 CreateScalingMatrix( float scale );
+	// Instantiate a scale matrix:
 	// Matrix matScale = Matrix::Scaling(2.0f,-3.0f);
-	static Matrix2x3 CreateScalingMatrix( float scaleX, float scaleY );
-	// Instantiate a scale matrix: 
+	static constexpr Matrix2x3 CreateScalingMatrix( float scaleX, float scaleY );
+	// Instantiate a scale matrix:
 	// Matrix matScale = Matrix::Scaling( Elite::Vector2(2.0f,-3.0f) );
-	static Matrix2x3 CreateScalingMatrix( Elite::Vector2 scaleVector );
-	// Instantiate a translation matrix: 
+	static constexpr Matrix2x3 CreateScalingMatrix( Elite::Vector2 scaleVector );
+	// Instantiate a translation matrix:
 	// Matrix matTrans = Matrix::Translation( Elite::Vector2(2.0f,3.0f) );
-	static Matrix2x3 CreateTranslationMatrix( Elite::Vector2 origin );
-	// Instantiate a translation matrix: 
+	static constexpr Matrix2x3 CreateTranslationMatrix( Elite::Vector2 origin );
+	// Instantiate a translation matrix:
 	// Matrix matTrans = Matrix::Translation(2.0f, 3.0f);
-	static Matrix2x3 CreateTranslationMatrix( float tx, float ty );
+	static constexpr Matrix2x3 CreateTranslationMatrix( float tx, float ty );
+	// Multiply a chain of matrices, the last one is applied first like in chain[0] * chain[1] * ...:
+	// Matrix2x3 matChain = Matrix2x3::Compose(chain, 3);
+	static constexpr Matrix2x3 Compose( const Matrix2x3* pChain, unsigned int count );
 
 	// -------------------------
 	// Datamembers
@@ -77,17 +95,255 @@ struct Matrix2x3
 };
 
 // -------------------------
-// Operators 
+// Operators
 // -------------------------
-// Are two matrices exactly equal?				
+// Are two matrices exactly equal?
 // mat1 == mat2
-bool operator==( const Matrix2x3& lhs, const Matrix2x3& rhs );
-// Are two matrices exactly unequal?			
+constexpr bool operator==( const Matrix2x3& lhs, const Matrix2x3& rhs );
+// Are two matrices exactly unequal?
 // mat1 != mat2
-bool operator!=( const Matrix2x3& lhs, const Matrix2x3& rhs );
+constexpr bool operator!=( const Matrix2x3& lhs, const Matrix2x3& rhs );
 // Multiply matrices
 // Matrix2x3 matProduct {mat1 * mat2};
-Matrix2x3 operator*( const Matrix2x3& lhs, const Matrix2x3& rhs );
+constexpr Matrix2x3 operator*( const Matrix2x3& lhs, const Matrix2x3& rhs );
 // Send matrix to output stream
 // std::cout << mat;
-std::ostream& operator<<( std::ostream& os, const Matrix2x3& matrix );
\ No newline at end of file
+std::ostream& operator<<( std::ostream& os, const Matrix2x3& matrix );
+
+// -------------------------
+// Implementation
+// -------------------------
+// Everything is inline so the transforms fold into the loops that call them
+constexpr Matrix2x3::Matrix2x3(Elite::Vector2 dirX, Elite::Vector2 dirY, Elite::Vector2 orig)
+	: dirX{ dirX }, dirY{ dirY }, orig{ orig }
+{}
+
+constexpr Matrix2x3::Matrix2x3(float e1X, float e1Y, float e2X, float e2Y, float oX, float oY)
+	: dirX{ e1X, e1Y }, dirY{ e2X, e2Y }, orig{ oX, oY }
+{}
+
+constexpr Elite::Vector2 Matrix2x3::Transform(const Elite::Vector2& vector) const
+{
+	return Elite::Vector2{ vector.x * dirX.x + vector.y * dirY.x + orig.x, vector.x * dirX.y + vector.y * dirY.y + orig.y };
+}
+
+constexpr float Matrix2x3::Determinant() const
+{
+	return dirX.x * dirY.y - dirX.y * dirY.x;
+}
+
+constexpr Matrix2x3 Matrix2x3::Inverse() const
+{
+	//Calculate Determinant
+	const float invDet = 1.f / Determinant();
+
+	//1)calculate matrix of minors
+	//2)Use the alternating law of signs to produce the matrix of cofactors
+	//3)Transpose
+	//4)the inverse matrix is 1/Determinant * the resulting matrix
+	return Matrix2x3{
+		+dirY.y * invDet, -dirX.y * invDet,
+		-dirY.x * invDet, +dirX.x * invDet,
+		(dirY.x * orig.y - dirY.y * orig.x) * invDet, -(dirX.x * orig.y - dirX.y * orig.x) * invDet
+	};
+}
+
+constexpr bool Matrix2x3::Equals(const Matrix2x3& other, float epsilon ) const
+{
+	const float differences[6]{ dirX.x - other.dirX.x, dirX.y - other.dirX.y, dirY.x - other.dirY.x,
+		dirY.y - other.dirY.y, orig.x - other.orig.x, orig.y - other.orig.y };
+	for (const float difference : differences)
+	{
+		if (difference > epsilon || difference < -epsilon)
+			return false;
+	}
+	return true;
+}
+
+inline std::string Matrix2x3::ToString() const
+{
+	return std::string( "Matrix2x3( x( ")  +
+		std::to_string(dirX.x) + ", " + std::to_string( dirX.y )
+		+ " ), y( " + std::to_string( dirY.x ) + ", " + std::to_string( dirY.y )
+		+ " ), orig( " + std::to_string( orig.x ) + ", " + std::to_string( orig.y ) +  " )  )";
+}
+
+inline void Matrix2x3::SetAsIdentity()
+{
+	*this = CreateIdentityMatrix();
+}
+
+inline void Matrix2x3::SetAsRotate(float degrees)
+{
+	*this = CreateRotationMatrix(degrees);
+}
+
+inline void Matrix2x3::SetAsTranslate(float tx, float ty)
+{
+	*this = CreateTranslationMatrix(tx, ty);
+}
+
+inline void Matrix2x3::SetAsTranslate(Elite::Vector2 pt)
+{
+	*this = CreateTranslationMatrix(pt);
+}
+
+inline void Matrix2x3::SetAsScale(float scaleX, float scaleY)
+{
+	*this = CreateScalingMatrix(scaleX, scaleY);
+}
+
+inline void Matrix2x3::SetAsScale(float scale)
+{
+	SetAsScale(scale, scale);
+}
+
+inline void Matrix2x3::TransformPoints(const float* xs, const float* ys, float* transformedXs, float* transformedYs, unsigned int count) const
+{
+	using namespace Elite::FastMath;
+	unsigned int i = 0;
+#if defined(ELITE_FAST_MATH_AVX)
+	{
+		const Float8 xX{ dirX.x }, xY{ dirX.y }, yX{ dirY.x }, yY{ dirY.y }, oX{ orig.x }, oY{ orig.y };
+		for (; i + 8 <= count; i += 8)
+		{
+			const Float8 x = _mm256_loadu_ps(xs + i);
+			const Float8 y = _mm256_loadu_ps(ys + i);
+			_mm256_storeu_ps(transformedXs + i, (x * xX + y * yX + oX).v);
+			_mm256_storeu_ps(transformedYs + i, (x * xY + y * yY + oY).v);
+		}
+	}
+#endif
+#if defined(ELITE_FAST_MATH_SSE)
+	{
+		const Float4 xX{ dirX.x }, xY{ dirX.y }, yX{ dirY.x }, yY{ dirY.y }, oX{ orig.x }, oY{ orig.y };
+		for (; i + 4 <= count; i += 4)
+		{
+			const Float4 x = _mm_loadu_ps(xs + i);
+			const Float4 y = _mm_loadu_ps(ys + i);
+			_mm_storeu_ps(transformedXs + i, (x * xX + y * yX + oX).v);
+			_mm_storeu_ps(transformedYs + i, (x * xY + y * yY + oY).v);
+		}
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		const float x = xs[i];
+		const float y = ys[i];
+		transformedXs[i] = x * dirX.x + y * dirY.x + orig.x;
+		transformedYs[i] = x * dirX.y + y * dirY.y + orig.y;
+	}
+}
+
+inline void Matrix2x3::TransformPolygon(const Elite::Vector2* pPoints, Elite::Vector2* pTransformed, unsigned int count) const
+{
+	//x y pairs side by side: {x, y} * {dirX.x, dirY.y} + {y, x} * {dirY.x, dirX.y} + {orig.x, orig.y}
+	using namespace Elite::FastMath;
+	static_assert(sizeof(Elite::Vector2) == 2 * sizeof(float), "Points are read as pairs of floats");
+	const float* pIn = &pPoints[0].x;
+	float* pOut = &pTransformed[0].x;
+	unsigned int i = 0;
+#if defined(ELITE_FAST_MATH_AVX)
+	{
+		const Float8 diagonal = _mm256_setr_ps(dirX.x, dirY.y, dirX.x, dirY.y, dirX.x, dirY.y, dirX.x, dirY.y);
+		const Float8 crossed = _mm256_setr_ps(dirY.x, dirX.y, dirY.x, dirX.y, dirY.x, dirX.y, dirY.x, dirX.y);
+		const Float8 origins = _mm256_setr_ps(orig.x, orig.y, orig.x, orig.y, orig.x, orig.y, orig.x, orig.y);
+		for (; i + 4 <= count; i += 4)
+		{
+			const Float8 points = _mm256_loadu_ps(pIn + 2 * i);
+			const Float8 swapped = _mm256_permute_ps(points.v, _MM_SHUFFLE(2, 3, 0, 1));
+			_mm256_storeu_ps(pOut + 2 * i, (points * diagonal + swapped * crossed + origins).v);
+		}
+	}
+#endif
+#if defined(ELITE_FAST_MATH_SSE)
+	{
+		const Float4 diagonal = _mm_setr_ps(dirX.x, dirY.y, dirX.x, dirY.y);
+		const Float4 crossed = _mm_setr_ps(dirY.x, dirX.y, dirY.x, dirX.y);
+		const Float4 origins = _mm_setr_ps(orig.x, orig.y, orig.x, orig.y);
+		for (; i + 2 <= count; i += 2)
+		{
+			const Float4 points = _mm_loadu_ps(pIn + 2 * i);
+			const Float4 swapped = _mm_shuffle_ps(points.v, points.v, _MM_SHUFFLE(2, 3, 0, 1));
+			_mm_storeu_ps(pOut + 2 * i, (points * diagonal + swapped * crossed + origins).v);
+		}
+	}
+#endif
+	for (; i < count; ++i)
+		pTransformed[i] = Transform(pPoints[i]);
+}
+
+inline void Matrix2x3::InverseTransformPolygon(const Elite::Vector2* pPoints, Elite::Vector2* pTransformed, unsigned int count) const
+{
+	Inverse().TransformPolygon(pPoints, pTransformed, count);
+}
+
+inline Matrix2x3 Matrix2x3::CreateRotationMatrix(float degrees)
+{
+	float radians = degrees * 3.1415926535f / 180;
+	return Matrix2x3( Elite::Vector2{ cos( radians ), sin( radians ) }, Elite::Vector2{ -sin(radians), cos( radians ) }, Elite::Vector2{} );
+}
+
+constexpr Matrix2x3 Matrix2x3::CreateIdentityMatrix()
+{
+	return Matrix2x3( Elite::Vector2{ 1, 0 }, Elite::Vector2{ 0, 1 }, Elite::Vector2{ 0, 0 } );
+}
+
+constexpr Matrix2x3 Matrix2x3::CreateScalingMatrix(float scale)
+{
+	return CreateScalingMatrix(scale, scale);
+}
+
+constexpr Matrix2x3 Matrix2x3::CreateScalingMatrix(Elite::Vector2 scaleVector)
+{
+	return CreateScalingMatrix(scaleVector.x, scaleVector.y);
+}
+
+constexpr Matrix2x3 Matrix2x3::CreateScalingMatrix(float scaleX, float scaleY)
+{
+	return Matrix2x3( Elite::Vector2{ scaleX, 0 }, Elite::Vector2{ 0, scaleY }, Elite::Vector2{ 0, 0 } );
+}
+
+constexpr Matrix2x3 Matrix2x3::CreateTranslationMatrix(Elite::Vector2 origin)
+{
+	return Matrix2x3( Elite::Vector2{ 1, 0 }, Elite::Vector2{ 0, 1 }, origin );
+}
+
+constexpr Matrix2x3 Matrix2x3::CreateTranslationMatrix(float tx, float ty)
+{
+	return CreateTranslationMatrix( Elite::Vector2{ tx, ty } );
+}
+
+constexpr Matrix2x3 Matrix2x3::Compose(const Matrix2x3* pChain, unsigned int count)
+{
+	Matrix2x3 result = CreateIdentityMatrix();
+	for (unsigned int i = 0; i < count; ++i)
+		result = result * pChain[i];
+	return result;
+}
+
+// Operator overloading functionality
+constexpr bool operator==(const Matrix2x3& lhs, const Matrix2x3& rhs)
+{
+	return lhs.Equals(rhs);
+}
+
+constexpr bool operator!=(const Matrix2x3& lhs, const Matrix2x3& rhs)
+{
+	return !(lhs == rhs);
+}
+
+constexpr Matrix2x3 operator*(const Matrix2x3& lhs, const Matrix2x3& rhs)
+{
+	return Matrix2x3{
+		rhs.dirX.x * lhs.dirX.x + rhs.dirX.y * lhs.dirY.x, rhs.dirX.x * lhs.dirX.y + rhs.dirX.y * lhs.dirY.y,
+		rhs.dirY.x * lhs.dirX.x + rhs.dirY.y * lhs.dirY.x, rhs.dirY.x * lhs.dirX.y + rhs.dirY.y * lhs.dirY.y,
+		rhs.orig.x * lhs.dirX.x + rhs.orig.y * lhs.dirY.x + lhs.orig.x, rhs.orig.x * lhs.dirX.y + rhs.orig.y * lhs.dirY.y + lhs.orig.y
+	};
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Matrix2x3& matrix )
+{
+	os << matrix.ToString( );
+	return os;
+}
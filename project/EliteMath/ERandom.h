@@ -0,0 +1,242 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// ERandom.h: Seedable random streams, one per thread by default, 4 lanes at once for bulk
+/*=============================================================================*/
+#ifndef ELITE_MATH_RANDOM
+#define ELITE_MATH_RANDOM
+//Standard C++ includes
+#include <atomic>
+#include <cstdint>
+#include "EFastMath.h"
+#include "EVector2.h"
+
+namespace Elite {
+	//-----------------------------------------------------------------
+	// RANDOM STREAM
+	//-----------------------------------------------------------------
+	// xoshiro256**: 32 bytes of state, a period of 2^256 - 1. A stream is a plain value, so
+	// it can be copied, stored per agent & checkpointed. Jump moves it 2^128 draws ahead,
+	// streams that are a different number of jumps from the same seed never overlap.
+	class RandomStream final
+	{
+	public:
+		static const uint64_t DefaultSeed = 0x853C49E6748FEA9Bull;
+
+		explicit RandomStream(uint64_t seed = DefaultSeed) { Seed(seed); }
+		//The streamIndex'th of the streams for that seed, for one stream per agent or thread
+		static RandomStream CreateStream(uint64_t seed, unsigned int streamIndex)
+		{
+			RandomStream stream{ seed };
+			for (unsigned int i = 0; i < streamIndex; ++i)
+				stream.Jump();
+			return stream;
+		}
+
+		void Seed(uint64_t seed)
+		{
+			//SplitMix64 spreads the seed over the state, which can then never be all zero
+			for (uint64_t& word : m_State)
+			{
+				seed += 0x9E3779B97F4A7C15ull;
+				uint64_t z = seed;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				word = z ^ (z >> 31);
+			}
+		}
+
+		uint64_t Next()
+		{
+			const uint64_t result = RotateLeft(m_State[1] * 5, 7) * 9;
+			const uint64_t shifted = m_State[1] << 17;
+			m_State[2] ^= m_State[0];
+			m_State[3] ^= m_State[1];
+			m_State[1] ^= m_State[2];
+			m_State[0] ^= m_State[3];
+			m_State[2] ^= shifted;
+			m_State[3] = RotateLeft(m_State[3], 45);
+			return result;
+		}
+
+		//In [0, max), without the modulo bias of rand() % max
+		int NextInt(int max) { return int((uint64_t(Next() >> 32) * uint32_t(max)) >> 32); }
+		//In [0, 1), 24 random bits so every value is exactly representable
+		float NextFloat() { return float(Next() >> 40) * (1.f / 16777216.f); }
+		float NextFloat(float min, float max) { return min + (max - min) * NextFloat(); }
+		//In (-max, max), more likely around 0
+		float NextBinomial(float max = 1.f)
+		{
+			const float a = NextFloat();
+			return max * (a - NextFloat());
+		}
+		Vector2 NextVector2(float min, float max)
+		{
+			const float x = NextFloat(min, max);
+			return Vector2{ x, NextFloat(min, max) };
+		}
+
+		void Jump()
+		{
+			const uint64_t jump[4]{ 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+			uint64_t jumped[4]{};
+			for (const uint64_t word : jump)
+			{
+				for (unsigned int bit = 0; bit < 64; ++bit)
+				{
+					if ((word >> bit) & 1)
+					{
+						for (unsigned int i = 0; i < 4; ++i)
+							jumped[i] ^= m_State[i];
+					}
+					Next();
+				}
+			}
+			for (unsigned int i = 0; i < 4; ++i)
+				m_State[i] = jumped[i];
+		}
+
+		const uint64_t* GetState() const { return m_State; }
+		void SetState(const uint64_t(&state)[4]) { for (unsigned int i = 0; i < 4; ++i) m_State[i] = state[i]; }
+
+	private:
+		uint64_t m_State[4];
+
+		static uint64_t RotateLeft(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+	};
+
+	//-----------------------------------------------------------------
+	// RANDOM STREAM X4
+	//-----------------------------------------------------------------
+	// Four xoshiro128** streams side by side, one per SSE lane, for filling arrays. Without
+	// SSE2 the lanes are stepped one by one, the values are the same either way.
+	class RandomStreamX4 final
+	{
+	public:
+		//The lanes are seeded from draws of the stream
+		explicit RandomStreamX4(RandomStream& seedStream)
+		{
+			for (unsigned int word = 0; word < 4; ++word)
+			{
+				for (unsigned int lane = 0; lane < 4; lane += 2)
+				{
+					const uint64_t draw = seedStream.Next();
+					m_State[word][lane] = uint32_t(draw);
+					m_State[word][lane + 1] = uint32_t(draw >> 32);
+				}
+			}
+			for (unsigned int lane = 0; lane < 4; ++lane)
+			{
+				if ((m_State[0][lane] | m_State[1][lane] | m_State[2][lane] | m_State[3][lane]) == 0)
+					m_State[0][lane] = 1;
+			}
+		}
+
+		//count floats in [min, max), for Vector2s pass &vectors[0].x & twice the count
+		void Fill(float* values, unsigned int count, float min = 0.f, float max = 1.f)
+		{
+			const float scale = (max - min) * (1.f / 16777216.f);
+			unsigned int i = 0;
+#if defined(ELITE_FAST_MATH_SSE)
+			__m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_State[0]));
+			__m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_State[1]));
+			__m128i s2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_State[2]));
+			__m128i s3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_State[3]));
+			const __m128 minimum = _mm_set1_ps(min);
+			const __m128 scales = _mm_set1_ps(scale);
+			for (; i + 4 <= count; i += 4)
+			{
+				//No 32-bit multiply before SSE4.1, * 5 & * 9 are a shift & an add
+				const __m128i times5 = _mm_add_epi32(_mm_slli_epi32(s1, 2), s1);
+				const __m128i rotated = _mm_or_si128(_mm_slli_epi32(times5, 7), _mm_srli_epi32(times5, 25));
+				const __m128i result = _mm_add_epi32(_mm_slli_epi32(rotated, 3), rotated);
+
+				const __m128i shifted = _mm_slli_epi32(s1, 9);
+				s2 = _mm_xor_si128(s2, s0);
+				s3 = _mm_xor_si128(s3, s1);
+				s1 = _mm_xor_si128(s1, s2);
+				s0 = _mm_xor_si128(s0, s3);
+				s2 = _mm_xor_si128(s2, shifted);
+				s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+				const __m128 fractions = _mm_cvtepi32_ps(_mm_srli_epi32(result, 8));
+				_mm_storeu_ps(values + i, _mm_add_ps(minimum, _mm_mul_ps(fractions, scales)));
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(m_State[0]), s0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(m_State[1]), s1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(m_State[2]), s2);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(m_State[3]), s3);
+#endif
+			//Lane by lane, a step per 4 values like above
+			for (; i < count; i += 4)
+			{
+				uint32_t results[4];
+				Step(results);
+				for (unsigned int lane = 0; lane < 4 && i + lane < count; ++lane)
+					values[i + lane] = min + float(int(results[lane] >> 8)) * scale;
+			}
+		}
+
+		//Word after word, the four lanes of each side by side
+		const uint32_t* GetState() const { return &m_State[0][0]; }
+		void SetState(const uint32_t(&state)[16]) { for (unsigned int i = 0; i < 16; ++i) m_State[i / 4][i % 4] = state[i]; }
+
+	private:
+		uint32_t m_State[4][4]; //[word][lane]
+
+		static uint32_t RotateLeft(uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); }
+		void Step(uint32_t(&results)[4])
+		{
+			for (unsigned int lane = 0; lane < 4; ++lane)
+			{
+				results[lane] = RotateLeft(m_State[1][lane] * 5, 7) * 9;
+				const uint32_t shifted = m_State[1][lane] << 9;
+				m_State[2][lane] ^= m_State[0][lane];
+				m_State[3][lane] ^= m_State[1][lane];
+				m_State[1][lane] ^= m_State[2][lane];
+				m_State[0][lane] ^= m_State[3][lane];
+				m_State[2][lane] ^= shifted;
+				m_State[3][lane] = RotateLeft(m_State[3][lane], 11);
+			}
+		}
+	};
+
+	//-----------------------------------------------------------------
+	// DEFAULT STREAM
+	//-----------------------------------------------------------------
+	//Every thread gets its own stream, a jump further than the thread that asked before it
+	inline RandomStream& GetRandomStream()
+	{
+		static std::atomic<unsigned int> s_StreamCount{ 0 };
+		thread_local RandomStream stream = RandomStream::CreateStream(RandomStream::DefaultSeed, s_StreamCount++);
+		return stream;
+	}
+	//Only this thread's stream, for a run that can be repeated
+	inline void SeedRandomStream(uint64_t seed) { GetRandomStream().Seed(seed); }
+
+	/*! Random Integer */
+	inline int randomInt(int max = 1)
+	{ return GetRandomStream().NextInt(max); }
+
+	/*! Random Float */
+	inline float randomFloat(float max = 1.f)
+	{ return max * GetRandomStream().NextFloat(); }
+
+	/*! Random Float */
+	inline float randomFloat(float min, float max)
+	{ return GetRandomStream().NextFloat(min, max); }
+
+	/*! Random Binomial Float */
+	inline float randomBinomial(float max = 1.f)
+	{ return GetRandomStream().NextBinomial(max); }
+
+	/*! Random Vector2 */
+	inline Vector2 randomVector2(float max = 1.f)
+	{
+		const float x = randomBinomial(max);
+		return{ x, randomBinomial(max) };
+	}
+	inline Vector2 randomVector2(float min, float max)
+	{ return GetRandomStream().NextVector2(min, max); }
+}
+#endif
@@ -20,7 +20,7 @@ namespace Elite
 
 		//=== Constructors ===
 		Vector2() = default;
-		Vector2(float _x, float _y) :x(_x), y(_y) {};
+		constexpr Vector2(float _x, float _y) :x(_x), y(_y) {};
 
 		//=== Vector Conversions Functions ===
 #ifdef USE_BOX2D
@@ -192,15 +192,6 @@ namespace Elite
 #pragma endregion //GlobalVectorFunctions
 
 #pragma region ExtraFunctions
-	/*! Random Vector2 */
-	inline Vector2 randomVector2(float max = 1.f)
-	{
-		return{ randomBinomial(max),randomBinomial(max) };
-	}
-	inline Vector2 randomVector2(float min, float max)
-	{
-		return{ randomFloat(min, max),randomFloat(min, max) };
-	}
 	/*! Orientation to a Vector2 */
 	inline Vector2 OrientationToVector(float orientation)
 	{
@@ -0,0 +1,150 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "GridDistanceOracle.h"
+
+const unsigned int GridDistanceOracle::Unreachable;
+
+void GridDistanceOracle::Initialize(const WorldInfo& worldInfo, const std::vector<WallTree::Segment>& walls)
+{
+	const float largestSide = std::max(worldInfo.Dimensions.x, worldInfo.Dimensions.y);
+	m_CellSize = std::max(2.f, largestSide / MaxCellsPerAxis);
+	m_Columns = std::max(1, int(ceilf(worldInfo.Dimensions.x / m_CellSize)));
+	m_Rows = std::max(1, int(ceilf(worldInfo.Dimensions.y / m_CellSize)));
+	m_Origin = worldInfo.Center - worldInfo.Dimensions / 2.f;
+
+	const unsigned int cellCount = static_cast<unsigned int>(m_Columns * m_Rows);
+	m_IsBlocked.assign(cellCount, 0);
+
+	//Walk every wall in half cell steps and block what it touches
+	for (const WallTree::Segment& wall : walls)
+	{
+		const Elite::Vector2 wallVector = wall.end - wall.start;
+		const unsigned int steps = static_cast<unsigned int>(wallVector.Magnitude() / (m_CellSize * 0.5f)) + 1;
+		for (unsigned int s = 0; s <= steps; ++s)
+		{
+			const int cell = GetCell(wall.start + wallVector * (float(s) / steps));
+			if (cell >= 0)
+				m_IsBlocked[cell] = 1;
+		}
+	}
+
+	m_Fields.assign(CachedFields * cellCount, Unreachable);
+	m_UseCounter = 0;
+	for (unsigned int f = 0; f < CachedFields; ++f)
+	{
+		m_FieldSources[f] = -1;
+		m_FieldLastUse[f] = 0;
+	}
+	for (std::vector<int>& bucket : m_Buckets)
+	{
+		bucket.clear();
+		bucket.reserve(cellCount / BucketCount + 1);
+	}
+}
+
+float GridDistanceOracle::GetDistance(const Elite::Vector2& from, const Elite::Vector2& to)
+{
+	++m_QueryCount;
+
+	const int fromCell = GetCell(from);
+	const int toCell = GetCell(to);
+	if (fromCell < 0 || toCell < 0 || m_IsBlocked[toCell])
+		return Elite::Distance(from, to);
+
+	const unsigned int cost = GetField(toCell)[fromCell];
+	if (cost == Unreachable)
+		return Elite::Distance(from, to);
+
+	return std::max(Elite::Distance(from, to), cost * m_CellSize / StraightCost);
+}
+
+int GridDistanceOracle::GetCell(const Elite::Vector2& position) const
+{
+	const int column = int((position.x - m_Origin.x) / m_CellSize);
+	const int row = int((position.y - m_Origin.y) / m_CellSize);
+	if (column < 0 || row < 0 || column >= m_Columns || row >= m_Rows)
+		return -1;
+
+	return row * m_Columns + column;
+}
+
+const unsigned int* GridDistanceOracle::GetField(int sourceCell)
+{
+	const unsigned int cellCount = static_cast<unsigned int>(m_Columns * m_Rows);
+	const unsigned int useCounter = ++m_UseCounter;
+
+	unsigned int leastRecent = 0;
+	for (unsigned int f = 0; f < CachedFields; ++f)
+	{
+		if (m_FieldSources[f] == sourceCell)
+		{
+			m_FieldLastUse[f] = useCounter;
+			return m_Fields.data() + f * cellCount;
+		}
+
+		if (m_FieldLastUse[f] < m_FieldLastUse[leastRecent])
+			leastRecent = f;
+	}
+
+	unsigned int* pField = m_Fields.data() + leastRecent * cellCount;
+	Flood(sourceCell, pField);
+	m_FieldSources[leastRecent] = sourceCell;
+	m_FieldLastUse[leastRecent] = useCounter;
+	return pField;
+}
+
+void GridDistanceOracle::Flood(int sourceCell, unsigned int* pField)
+{
+	++m_FloodCount;
+
+	const unsigned int cellCount = static_cast<unsigned int>(m_Columns * m_Rows);
+	std::fill(pField, pField + cellCount, Unreachable);
+
+	const int offsetsX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	const int offsetsY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+	pField[sourceCell] = 0;
+	m_Buckets[0].push_back(sourceCell);
+	unsigned int pending = 1;
+
+	for (unsigned int current = 0; pending > 0; ++current)
+	{
+		std::vector<int>& bucket = m_Buckets[current % BucketCount];
+		while (!bucket.empty())
+		{
+			const int cell = bucket.back();
+			bucket.pop_back();
+			--pending;
+
+			if (pField[cell] != current)
+				continue; //Already reached cheaper
+
+			const int column = cell % m_Columns;
+			const int row = cell / m_Columns;
+			for (int n = 0; n < 8; ++n)
+			{
+				const int neighbourColumn = column + offsetsX[n];
+				const int neighbourRow = row + offsetsY[n];
+				if (neighbourColumn < 0 || neighbourRow < 0 || neighbourColumn >= m_Columns || neighbourRow >= m_Rows)
+					continue;
+
+				const int neighbour = neighbourRow * m_Columns + neighbourColumn;
+				if (m_IsBlocked[neighbour])
+					continue;
+
+				const bool isDiagonal = n >= 4;
+				//No cutting corners past a wall
+				if (isDiagonal && (m_IsBlocked[row * m_Columns + neighbourColumn] || m_IsBlocked[neighbourRow * m_Columns + column]))
+					continue;
+
+				const unsigned int cost = current + (isDiagonal ? DiagonalCost : StraightCost);
+				if (cost < pField[neighbour])
+				{
+					pField[neighbour] = cost;
+					m_Buckets[cost % BucketCount].push_back(neighbour);
+					++pending;
+				}
+			}
+		}
+	}
+}
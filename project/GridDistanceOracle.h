@@ -0,0 +1,56 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// GridDistanceOracle.h: Walking distances over a coarse grid of the world
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "ObstacleAvoidance.h"
+
+//-----------------------------------------------------------------
+// GRID DISTANCE ORACLE
+//-----------------------------------------------------------------
+// The world is rasterized into cells, walls block cells. A query floods the grid
+// from the destination (8-connected, Dial's algorithm on integer costs) and keeps
+// the whole distance field, so every later query towards the same cell is a lookup.
+// A handful of fields are cached, the least recently used one is reused.
+// All memory is allocated in Initialize.
+class GridDistanceOracle final
+{
+public:
+	static const unsigned int CachedFields = 24;
+	static const unsigned int MaxCellsPerAxis = 256;
+
+	void Initialize(const WorldInfo& worldInfo, const std::vector<WallTree::Segment>& walls);
+
+	//Walking distance, falls back to the straight line when either point can't be reached
+	float GetDistance(const Elite::Vector2& from, const Elite::Vector2& to);
+
+	unsigned int GetFloodCount() const { return m_FloodCount; }
+	unsigned int GetQueryCount() const { return m_QueryCount; }
+
+private:
+	static const unsigned int Unreachable = 0xFFFFFFFF;
+	static const unsigned int StraightCost = 5;
+	static const unsigned int DiagonalCost = 7;
+	static const unsigned int BucketCount = 8; //More than the biggest step cost
+
+	Elite::Vector2 m_Origin = {};
+	float m_CellSize = 1.f;
+	int m_Columns = 0;
+	int m_Rows = 0;
+	std::vector<unsigned char> m_IsBlocked = {};
+
+	std::vector<unsigned int> m_Fields = {}; //CachedFields * cell count
+	int m_FieldSources[CachedFields] = {};
+	unsigned int m_FieldLastUse[CachedFields] = {};
+	unsigned int m_UseCounter = 0;
+	std::vector<int> m_Buckets[BucketCount] = {};
+
+	unsigned int m_QueryCount = 0;
+	unsigned int m_FloodCount = 0;
+
+	int GetCell(const Elite::Vector2& position) const;
+	const unsigned int* GetField(int sourceCell);
+	void Flood(int sourceCell, unsigned int* pField);
+};
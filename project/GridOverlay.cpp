@@ -0,0 +1,135 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "GridOverlay.h"
+using namespace Elite;
+
+const unsigned int GridOverlay::PaletteSize;
+const unsigned int GridOverlay::TileSize;
+
+void GridOverlay::Initialize(const Vector2& origin, float cellSize, unsigned int columns, unsigned int rows,
+	float minValue, float maxValue, const Vector3& lowColor, const Vector3& highColor)
+{
+	m_Origin = origin;
+	m_CellSize = cellSize;
+	m_Columns = columns;
+	m_Rows = rows;
+	m_TileColumns = (columns + TileSize - 1) / TileSize;
+	m_MinValue = minValue;
+	m_LevelsPerValue = (PaletteSize - 1) / (maxValue - minValue);
+	for (unsigned int level = 0; level < PaletteSize; ++level)
+	{
+		const float t = float(level) / (PaletteSize - 1);
+		m_Palette[level] = lowColor * (1.f - t) + highColor * t;
+	}
+
+	const unsigned int tileCount = m_TileColumns * ((rows + TileSize - 1) / TileSize);
+	m_Levels.assign(columns * rows, 0);
+	m_IsTileDirty.assign(tileCount, 0);
+	m_TileRects.assign(tileCount, {});
+}
+
+void GridOverlay::SetValue(unsigned int column, unsigned int row, float value)
+{
+	const unsigned char level = Quantize(value);
+	unsigned char& cell = m_Levels[row * m_Columns + column];
+	if (cell == level)
+		return;
+
+	cell = level;
+	m_IsTileDirty[(row / TileSize) * m_TileColumns + column / TileSize] = 1;
+}
+
+void GridOverlay::SetValues(const float* values)
+{
+	for (unsigned int row = 0; row < m_Rows; ++row)
+	{
+		for (unsigned int column = 0; column < m_Columns; ++column)
+			SetValue(column, row, values[row * m_Columns + column]);
+	}
+}
+
+void GridOverlay::Update()
+{
+	for (unsigned int tile = 0; tile < m_IsTileDirty.size(); ++tile)
+	{
+		if (m_IsTileDirty[tile] == 0)
+			continue;
+		MeshTile(tile);
+		m_IsTileDirty[tile] = 0;
+	}
+}
+
+void GridOverlay::Draw(DebugDrawBuffer& debugDraw, DebugLayer layer) const
+{
+	for (const std::vector<Rect>& rects : m_TileRects)
+	{
+		for (const Rect& rect : rects)
+		{
+			const Vector2 min = m_Origin + Vector2{ float(rect.column), float(rect.row) } * m_CellSize;
+			const Vector2 max = min + Vector2{ float(rect.width), float(rect.height) } * m_CellSize;
+			const Vector2 corners[4]{ min, { max.x, min.y }, max, { min.x, max.y } };
+			debugDraw.AddPolygon(corners, 4, m_Palette[rect.level], layer, true);
+		}
+	}
+}
+
+unsigned int GridOverlay::GetRectCount() const
+{
+	size_t count = 0;
+	for (const std::vector<Rect>& rects : m_TileRects)
+		count += rects.size();
+	return static_cast<unsigned int>(count);
+}
+
+unsigned char GridOverlay::Quantize(float value) const
+{
+	const float level = (value - m_MinValue) * m_LevelsPerValue + 0.5f;
+	return static_cast<unsigned char>(Clamp(level, 0.f, float(PaletteSize - 1)));
+}
+
+void GridOverlay::MeshTile(unsigned int tile)
+{
+	const unsigned int firstColumn = (tile % m_TileColumns) * TileSize;
+	const unsigned int firstRow = (tile / m_TileColumns) * TileSize;
+	const unsigned int columns = std::min(TileSize, m_Columns - firstColumn);
+	const unsigned int rows = std::min(TileSize, m_Rows - firstRow);
+
+	//One bit per column of the tile, set once a cell is in a rectangle
+	unsigned int isMeshed[TileSize] = {};
+	static_assert(TileSize <= 32, "A tile row's meshed cells have to fit in one word");
+
+	std::vector<Rect>& rects = m_TileRects[tile];
+	rects.clear();
+	for (unsigned int row = 0; row < rows; ++row)
+	{
+		const unsigned char* pRow = &m_Levels[(firstRow + row) * m_Columns + firstColumn];
+		for (unsigned int column = 0; column < columns; ++column)
+		{
+			const unsigned char level = pRow[column];
+			if (level == 0 || (isMeshed[row] & (1u << column)) != 0)
+				continue;
+
+			//Right as far as the level holds, then down as long as that whole span does
+			unsigned int width = 1;
+			while (column + width < columns && pRow[column + width] == level && (isMeshed[row] & (1u << (column + width))) == 0)
+				++width;
+			const unsigned int spanBits = (width == 32 ? ~0u : (1u << width) - 1) << column;
+
+			unsigned int height = 1;
+			for (; row + height < rows; ++height)
+			{
+				const unsigned char* pNextRow = pRow + height * m_Columns;
+				if ((isMeshed[row + height] & spanBits) != 0)
+					break;
+				if (std::any_of(pNextRow + column, pNextRow + column + width, [level](unsigned char other) { return other != level; }))
+					break;
+			}
+
+			for (unsigned int meshedRow = row; meshedRow < row + height; ++meshedRow)
+				isMeshed[meshedRow] |= spanBits;
+			rects.push_back(Rect{ static_cast<unsigned short>(firstColumn + column), static_cast<unsigned short>(firstRow + row),
+				static_cast<unsigned short>(width), static_cast<unsigned short>(height), level });
+			column += width - 1;
+		}
+	}
+}
@@ -0,0 +1,67 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// GridOverlay.h: Draws a grid of values as a few merged rectangles instead of a polygon per cell
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "DebugDrawBuffer.h"
+
+//-----------------------------------------------------------------
+// GRID OVERLAY
+//-----------------------------------------------------------------
+// Values are quantized into a small palette, level 0 isn't drawn. Cells of the same level
+// are merged into rectangles (greedy meshing: grow right, then down while the whole row
+// matches). The grid is split in tiles that are meshed on their own, so a changed cell only
+// gets its own tile meshed again on the next Update.
+class GridOverlay final
+{
+public:
+	static const unsigned int PaletteSize = 8;
+	static const unsigned int TileSize = 32; //Cells per tile side
+
+	//Values from minValue & lower are level 0, maxValue & higher the last level.
+	//Levels fade from lowColor to highColor
+	void Initialize(const Elite::Vector2& origin, float cellSize, unsigned int columns, unsigned int rows,
+		float minValue, float maxValue, const Elite::Vector3& lowColor, const Elite::Vector3& highColor);
+
+	void SetValue(unsigned int column, unsigned int row, float value);
+	//A value per cell, row after row
+	void SetValues(const float* values);
+
+	//Meshes the tiles that changed since the last Update
+	void Update();
+	void Draw(DebugDrawBuffer& debugDraw, DebugLayer layer) const;
+
+	unsigned int GetRectCount() const;
+	const Elite::Vector2& GetOrigin() const { return m_Origin; }
+	float GetCellSize() const { return m_CellSize; }
+	unsigned int GetColumns() const { return m_Columns; }
+	unsigned int GetRows() const { return m_Rows; }
+
+private:
+	struct Rect
+	{
+		unsigned short column;
+		unsigned short row;
+		unsigned short width;
+		unsigned short height;
+		unsigned char level;
+	};
+
+	Elite::Vector2 m_Origin = {};
+	float m_CellSize = 1.f;
+	unsigned int m_Columns = 0;
+	unsigned int m_Rows = 0;
+	unsigned int m_TileColumns = 0;
+	float m_MinValue = 0.f;
+	float m_LevelsPerValue = 1.f;
+	Elite::Vector3 m_Palette[PaletteSize] = {};
+
+	std::vector<unsigned char> m_Levels = {};
+	std::vector<unsigned char> m_IsTileDirty = {};
+	std::vector<std::vector<Rect>> m_TileRects = {};
+
+	unsigned char Quantize(float value) const;
+	void MeshTile(unsigned int tile);
+};
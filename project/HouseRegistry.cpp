@@ -0,0 +1,126 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "HouseRegistry.h"
+
+unsigned int HouseRegistry::AddHouse(const HouseInfo& house)
+{
+	const unsigned int index = static_cast<unsigned int>(m_Houses.size());
+	m_Houses.push_back(House{ house, -FLT_MAX, 0, false });
+	m_Queue.Push(index, CalculateKey(m_Houses.back()));
+	return index;
+}
+
+void HouseRegistry::Update(float time, const AgentInfo& agentInfo, Elite::JobSystem& jobSystem)
+{
+	m_UpdateTime = time;
+	m_UpdateAgentInfo = agentInfo;
+	jobSystem.ParallelFor(static_cast<unsigned int>(m_Houses.size()), 16, &HouseRegistry::RefreshHouses, this);
+
+	//The heap isn't thread safe, only the house we're in got a new visit time
+	m_CurrentHouse = -1;
+	for (unsigned int h = 0; h < m_Houses.size(); ++h)
+	{
+		if (m_Houses[h].isAgentInside)
+		{
+			m_CurrentHouse = int(h);
+			m_Queue.ChangeKey(h, CalculateKey(m_Houses[h]));
+		}
+	}
+}
+
+void HouseRegistry::RefreshHouses(void* pData, unsigned int begin, unsigned int end)
+{
+	HouseRegistry* pRegistry = static_cast<HouseRegistry*>(pData);
+	const AgentInfo& agentInfo = pRegistry->m_UpdateAgentInfo;
+
+	for (unsigned int h = begin; h < end; ++h)
+	{
+		House& house = pRegistry->m_Houses[h];
+		house.isAgentInside = pRegistry->IsInside(h, agentInfo.Position);
+		if (house.isAgentInside)
+			house.lastVisitTime = pRegistry->m_UpdateTime;
+	}
+}
+
+void HouseRegistry::OnItemDiscovered(const Elite::Vector2& location)
+{
+	for (unsigned int h = 0; h < m_Houses.size(); ++h)
+	{
+		if (IsInside(h, location))
+		{
+			++m_Houses[h].itemsFound;
+			m_Queue.ChangeKey(h, CalculateKey(m_Houses[h]));
+			return;
+		}
+	}
+}
+
+void HouseRegistry::SaveState(Elite::CheckpointWriter& writer) const
+{
+	writer.WriteTag("HREG");
+	writer.WriteArray(m_Houses);
+	m_Queue.SaveState(writer);
+	writer.Write(m_CurrentHouse);
+}
+
+bool HouseRegistry::LoadState(Elite::CheckpointReader& reader)
+{
+	if (!reader.ReadTag("HREG") || !reader.ReadArray(m_Houses) || !m_Queue.LoadState(reader) || !reader.Read(m_CurrentHouse))
+		return false;
+	return m_Queue.GetIdCount() == m_Houses.size() && m_CurrentHouse >= -1 && m_CurrentHouse < int(m_Houses.size());
+}
+
+int HouseRegistry::GetBestHouse() const
+{
+	int bestHouse = -1;
+	float bestPriority = FLT_MAX;
+	if (!m_Queue.IsEmpty())
+		FindBestHouse(0, bestHouse, bestPriority);
+	return bestHouse;
+}
+
+void HouseRegistry::FindBestHouse(unsigned int position, int& bestHouse, float& bestPriority) const
+{
+	//Keys only grow going down the heap, a key past the best priority rules out everything below it
+	if (position >= m_Queue.GetSize())
+		return;
+	const unsigned int house = m_Queue.GetAt(position);
+	if (bestHouse >= 0 && m_Queue.GetKey(house) >= bestPriority)
+		return;
+
+	const float priority = CalculatePriority(m_Houses[house]);
+	if (priority < bestPriority)
+	{
+		bestHouse = int(house);
+		bestPriority = priority;
+	}
+	FindBestHouse(position * 2 + 1, bestHouse, bestPriority);
+	FindBestHouse(position * 2 + 2, bestHouse, bestPriority);
+}
+
+bool HouseRegistry::IsWorthVisiting(unsigned int house, float time) const
+{
+	return time - m_Houses[house].lastVisitTime > RespawnTime;
+}
+
+bool HouseRegistry::IsInside(unsigned int house, const Elite::Vector2& position) const
+{
+	const HouseInfo& info = m_Houses[house].info;
+	return abs(position.x - info.Center.x) <= info.Size.x / 2.f
+		&& abs(position.y - info.Center.y) <= info.Size.y / 2.f;
+}
+
+float HouseRegistry::CalculateKey(const House& house)
+{
+	const float restockedTime = (house.lastVisitTime == -FLT_MAX) ? -FLT_MAX : house.lastVisitTime + RespawnTime;
+	return restockedTime - ItemValue * house.itemsFound;
+}
+
+float HouseRegistry::CalculatePriority(const House& house) const
+{
+	//Earliest time we could be there with something to find
+	const float restockedTime = (house.lastVisitTime == -FLT_MAX) ? -FLT_MAX : house.lastVisitTime + RespawnTime;
+	const float speed = std::max(m_UpdateAgentInfo.MaxLinearSpeed, 1.f);
+	const float arrivalTime = m_UpdateTime + Elite::Distance(house.info.Center, m_UpdateAgentInfo.Position) / speed;
+	return std::max(restockedTime, arrivalTime) - ItemValue * house.itemsFound;
+}
@@ -0,0 +1,67 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// HouseRegistry.h: Discovered houses, when we were there & which one to go to next
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "EIndexedHeap.h"
+#include "EJobSystem.h"
+
+//-----------------------------------------------------------------
+// HOUSE REGISTRY
+//-----------------------------------------------------------------
+// Houses keep the index they were discovered with. Every house sits in an indexed
+// min-heap on the earliest time a visit could pay off: not before its items respawned,
+// a bit earlier for houses that had a lot of loot. Walking there adds to that, so the
+// travel time is only added to the houses at the top of the heap when asking for the best
+// one. Walking around doesn't move anything in the heap, visiting a house or finding an
+// item in it only moves that house.
+class HouseRegistry final
+{
+public:
+	static constexpr float RespawnTime = 60.f; //Seconds before a looted house is assumed to have new items
+	static constexpr float ItemValue = 5.f; //Seconds a house gains on the others per item found there before
+
+	unsigned int AddHouse(const HouseInfo& house);
+	//Visit detection, split over the job system
+	void Update(float time, const AgentInfo& agentInfo, Elite::JobSystem& jobSystem);
+	void OnItemDiscovered(const Elite::Vector2& location);
+
+	void SaveState(Elite::CheckpointWriter& writer) const;
+	bool LoadState(Elite::CheckpointReader& reader);
+
+	//House worth going to the most from where the agent was during the last update, -1 if there are none
+	int GetBestHouse() const;
+	bool IsWorthVisiting(unsigned int house, float time) const;
+	bool IsInside(unsigned int house, const Elite::Vector2& position) const;
+	//House the agent was in during the last update, -1 if none
+	int GetCurrentHouse() const { return m_CurrentHouse; }
+
+	unsigned int GetHouseCount() const { return static_cast<unsigned int>(m_Houses.size()); }
+	const HouseInfo& GetHouse(unsigned int house) const { return m_Houses[house].info; }
+	float GetLastVisitTime(unsigned int house) const { return m_Houses[house].lastVisitTime; }
+
+private:
+	struct House
+	{
+		HouseInfo info;
+		float lastVisitTime; //-FLT_MAX if never visited
+		unsigned int itemsFound;
+		bool isAgentInside;
+	};
+
+	std::vector<House> m_Houses = {};
+	Elite::IndexedHeap<float> m_Queue{};
+	int m_CurrentHouse = -1; //House the agent is in
+
+	//Per tick input of RefreshHouses
+	float m_UpdateTime = 0.f;
+	AgentInfo m_UpdateAgentInfo = {};
+
+	static void RefreshHouses(void* pData, unsigned int begin, unsigned int end);
+	//The heap key, never later than the priority so it bounds every house below it
+	static float CalculateKey(const House& house);
+	float CalculatePriority(const House& house) const;
+	void FindBestHouse(unsigned int position, int& bestHouse, float& bestPriority) const;
+};
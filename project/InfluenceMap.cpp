@@ -0,0 +1,262 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "InfluenceMap.h"
+#include "GridOverlay.h"
+using namespace Elite;
+
+const unsigned int InfluenceMap::TileSize;
+const unsigned int InfluenceMap::CellsPerTile;
+
+//-----------------------------------------------------------------
+// GRID
+//-----------------------------------------------------------------
+bool InfluenceMap::Grid::GetCell(const Vector2& position, unsigned int& tile, unsigned int& cell) const
+{
+	const Vector2 cellPosition = (position - origin) / CellSize;
+	if (cellPosition.x < 0.f || cellPosition.y < 0.f || cellPosition.x >= float(columns) || cellPosition.y >= float(rows))
+		return false;
+
+	const unsigned int column = static_cast<unsigned int>(cellPosition.x);
+	const unsigned int row = static_cast<unsigned int>(cellPosition.y);
+	tile = (row / TileSize) * tileColumns + column / TileSize;
+	cell = (row % TileSize) * TileSize + column % TileSize;
+	return true;
+}
+
+//-----------------------------------------------------------------
+// INFLUENCE MAP
+//-----------------------------------------------------------------
+void InfluenceMap::Initialize(const WorldInfo& worldInfo)
+{
+	m_Grid.origin = worldInfo.Center - worldInfo.Dimensions / 2.f;
+	m_Grid.columns = std::max(1u, static_cast<unsigned int>(ceilf(worldInfo.Dimensions.x / CellSize)));
+	m_Grid.rows = std::max(1u, static_cast<unsigned int>(ceilf(worldInfo.Dimensions.y / CellSize)));
+	m_Grid.tileColumns = (m_Grid.columns + TileSize - 1) / TileSize;
+	m_Grid.decayRate = logf(2.f) / HalfLife;
+	m_Time = 0.f;
+
+	const unsigned int tileCount = m_Grid.GetTileCount();
+	m_Values.assign(tileCount * CellsPerTile, 0.f);
+	m_TileTimes.assign(tileCount, 0.f);
+	m_TilePeaks.assign(tileCount, 0.f);
+	m_IsTileOnOverlay.assign(tileCount, 0);
+	m_IsTileChanged.assign(tileCount, 0);
+	m_ChangedTiles.clear();
+	m_ChangedTiles.reserve(tileCount);
+	//Whoever mirrors the tiles has to start over as well
+	MarkAllTilesChanged();
+}
+
+void InfluenceMap::Update(float time, const std::list<EnemyInfo>& enemiesInFOV)
+{
+	m_Time = time;
+	for (const EnemyInfo& enemy : enemiesInFOV)
+		Stamp(enemy);
+}
+
+void InfluenceMap::SaveState(CheckpointWriter& writer) const
+{
+	writer.WriteTag("INFM");
+	writer.Write(m_Time);
+	for (const std::vector<float>* pArray : { &m_Values, &m_TileTimes, &m_TilePeaks })
+		writer.WriteArray(*pArray);
+}
+
+bool InfluenceMap::LoadState(CheckpointReader& reader)
+{
+	const size_t tileCount = m_TilePeaks.size();
+	if (!reader.ReadTag("INFM") || !reader.Read(m_Time))
+		return false;
+	for (std::vector<float>* pArray : { &m_Values, &m_TileTimes, &m_TilePeaks })
+	{
+		if (!reader.ReadArray(*pArray))
+			return false;
+	}
+	//Saved by a plugin on another world, nothing in it lines up with this grid
+	if (m_TilePeaks.size() != tileCount || m_TileTimes.size() != tileCount || m_Values.size() != tileCount * CellsPerTile)
+		return false;
+	m_IsTileOnOverlay.assign(tileCount, 1);
+	MarkAllTilesChanged();
+	return true;
+}
+
+float InfluenceMap::GetDanger(const Vector2& position) const
+{
+	unsigned int tile = 0, cell = 0;
+	if (!m_Grid.GetCell(position, tile, cell) || m_TilePeaks[tile] == 0.f)
+		return 0.f;
+	return m_Values[tile * CellsPerTile + cell] * GetDecay(tile);
+}
+
+float InfluenceMap::GetPathDanger(const Vector2& from, const Vector2& to) const
+{
+	return Grid::IntegrateDanger(from, to, [this](const Vector2& position) { return GetDanger(position); });
+}
+
+void InfluenceMap::UpdateOverlay(GridOverlay& overlay)
+{
+	for (unsigned int tile = 0; tile < m_TilePeaks.size(); ++tile)
+	{
+		if (m_TilePeaks[tile] > 0.f)
+			DecayTile(tile);
+		else if (m_IsTileOnOverlay[tile] == 0)
+			continue;
+
+		//A tile that just went idle is written once more, to clear it
+		m_IsTileOnOverlay[tile] = m_TilePeaks[tile] > 0.f ? 1 : 0;
+		const unsigned int firstColumn = (tile % m_Grid.tileColumns) * TileSize;
+		const unsigned int firstRow = (tile / m_Grid.tileColumns) * TileSize;
+		const unsigned int columns = std::min(TileSize, m_Grid.columns - firstColumn);
+		const unsigned int rows = std::min(TileSize, m_Grid.rows - firstRow);
+		const float* pTile = &m_Values[tile * CellsPerTile];
+		for (unsigned int row = 0; row < rows; ++row)
+		{
+			for (unsigned int column = 0; column < columns; ++column)
+				overlay.SetValue(firstColumn + column, firstRow + row, pTile[row * TileSize + column]);
+		}
+	}
+}
+
+void InfluenceMap::ClearChangedTiles()
+{
+	for (const unsigned int tile : m_ChangedTiles)
+		m_IsTileChanged[tile] = 0;
+	m_ChangedTiles.clear();
+}
+
+float InfluenceMap::GetTypeWeight(eEnemyType type)
+{
+	switch (type)
+	{
+	case eEnemyType::ZOMBIE_RUNNER:
+		return 1.5f; //Catches up
+	case eEnemyType::ZOMBIE_HEAVY:
+		return 2.f; //Bites hardest & takes the most ammo
+	default:
+		return 1.f;
+	}
+}
+
+unsigned int InfluenceMap::GetActiveTileCount() const
+{
+	//Tiles nothing was stamped in for a while only get cleared when touched again
+	unsigned int count = 0;
+	for (unsigned int tile = 0; tile < m_TilePeaks.size(); ++tile)
+	{
+		if (m_TilePeaks[tile] * GetDecay(tile) >= MinDanger)
+			++count;
+	}
+	return count;
+}
+
+unsigned int InfluenceMap::GetCellIndex(unsigned int column, unsigned int row) const
+{
+	const unsigned int tile = (row / TileSize) * m_Grid.tileColumns + column / TileSize;
+	return tile * CellsPerTile + (row % TileSize) * TileSize + column % TileSize;
+}
+
+float InfluenceMap::GetDecay(unsigned int tile) const
+{
+	return m_Grid.GetDecay(m_Time - m_TileTimes[tile]);
+}
+
+void InfluenceMap::DecayTile(unsigned int tile)
+{
+	const float decay = GetDecay(tile);
+	m_TileTimes[tile] = m_Time;
+	if (m_TilePeaks[tile] == 0.f || decay == 1.f)
+		return;
+	MarkTileChanged(tile);
+
+	float* pTile = &m_Values[tile * CellsPerTile];
+	if (m_TilePeaks[tile] * decay < MinDanger)
+	{
+		std::fill(pTile, pTile + CellsPerTile, 0.f);
+		m_TilePeaks[tile] = 0.f;
+		return;
+	}
+
+	unsigned int i = 0;
+	float peak = 0.f;
+#if defined(ELITE_FAST_MATH_SSE)
+	const __m128 decays = _mm_set1_ps(decay);
+	__m128 peaks = _mm_setzero_ps();
+	for (; i + 4 <= CellsPerTile; i += 4)
+	{
+		const __m128 values = _mm_mul_ps(_mm_loadu_ps(pTile + i), decays);
+		_mm_storeu_ps(pTile + i, values);
+		peaks = _mm_max_ps(peaks, values);
+	}
+	float lanes[4];
+	_mm_storeu_ps(lanes, peaks);
+	peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+	for (; i < CellsPerTile; ++i)
+	{
+		pTile[i] *= decay;
+		peak = std::max(peak, pTile[i]);
+	}
+	m_TilePeaks[tile] = peak;
+}
+
+void InfluenceMap::Stamp(const EnemyInfo& enemy)
+{
+	//Falls off quadratically over a few meters around the capsule
+	const float weight = GetTypeWeight(enemy.Type);
+	const float radius = 6.f + enemy.Size;
+	const Vector2 start = enemy.Location;
+	const Vector2 end = start + enemy.LinearVelocity * LookAhead;
+	const Vector2 axis = end - start;
+	const float axisLengthSquared = axis.MagnitudeSquared();
+
+	const Vector2 boundsMin = (Vector2{ std::min(start.x, end.x), std::min(start.y, end.y) } - Vector2{ radius, radius } - m_Grid.origin) / CellSize;
+	const Vector2 boundsMax = (Vector2{ std::max(start.x, end.x), std::max(start.y, end.y) } + Vector2{ radius, radius } - m_Grid.origin) / CellSize;
+	const int firstColumn = Clamp(int(boundsMin.x), 0, int(m_Grid.columns)), lastColumn = Clamp(int(boundsMax.x) + 1, 0, int(m_Grid.columns));
+	const int firstRow = Clamp(int(boundsMin.y), 0, int(m_Grid.rows)), lastRow = Clamp(int(boundsMax.y) + 1, 0, int(m_Grid.rows));
+	if (firstColumn >= lastColumn || firstRow >= lastRow)
+		return;
+
+	//Every tile has to be at this time before the kernel is maxed into it
+	for (int tileRow = firstRow / int(TileSize); tileRow <= (lastRow - 1) / int(TileSize); ++tileRow)
+	{
+		for (int tileColumn = firstColumn / int(TileSize); tileColumn <= (lastColumn - 1) / int(TileSize); ++tileColumn)
+			DecayTile(tileRow * m_Grid.tileColumns + tileColumn);
+	}
+
+	for (int row = firstRow; row < lastRow; ++row)
+	{
+		for (int column = firstColumn; column < lastColumn; ++column)
+		{
+			const Vector2 cellCenter = m_Grid.origin + Vector2{ column + 0.5f, row + 0.5f } * CellSize;
+			const Vector2 toCell = cellCenter - start;
+			const float t = axisLengthSquared > 0.f ? Clamp(toCell.Dot(axis) / axisLengthSquared, 0.f, 1.f) : 0.f;
+			const float distance = Distance(cellCenter, start + axis * t);
+			if (distance >= radius)
+				continue;
+
+			const float falloff = 1.f - distance / radius;
+			const float danger = weight * falloff * falloff;
+			float& value = m_Values[GetCellIndex(column, row)];
+			if (danger <= value)
+				continue;
+			value = danger;
+			const unsigned int tile = (row / TileSize) * m_Grid.tileColumns + column / TileSize;
+			m_TilePeaks[tile] = std::max(m_TilePeaks[tile], danger);
+			MarkTileChanged(tile);
+		}
+	}
+}
+
+void InfluenceMap::MarkTileChanged(unsigned int tile)
+{
+	if (m_IsTileChanged[tile])
+		return;
+	m_IsTileChanged[tile] = 1;
+	m_ChangedTiles.push_back(tile);
+}
+
+void InfluenceMap::MarkAllTilesChanged()
+{
+	for (unsigned int tile = 0; tile < m_TilePeaks.size(); ++tile)
+		MarkTileChanged(tile);
+}
@@ -0,0 +1,122 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// InfluenceMap.h: Decaying danger left behind by the zombies we saw, for risk-aware routing
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "ECheckpoint.h"
+
+class GridOverlay;
+
+//-----------------------------------------------------------------
+// INFLUENCE MAP
+//-----------------------------------------------------------------
+// A grid over the world, every zombie in sight stamps a kernel: a capsule from where it
+// is to where it'll be in a moment, scaled by how dangerous its type is. Stamps keep the
+// highest value per cell, so a zombie seen for many ticks doesn't pile up.
+// Danger halves every HalfLife seconds. Cells are stored tile by tile & every tile only
+// remembers when it was last decayed; a tile is brought up to date (one SSE pass over its
+// cells) when it gets stamped, reads scale by the missing decay on the fly. Tiles nobody
+// saw a zombie in cost nothing per tick. The tiles that changed are listed, so the world
+// model only copies those into the next snapshot for the planning thread.
+class InfluenceMap final
+{
+public:
+	static const unsigned int TileSize = 16; //Cells per tile side
+	static const unsigned int CellsPerTile = TileSize * TileSize;
+	static constexpr float CellSize = 2.f;
+	static constexpr float HalfLife = 3.f;
+	static constexpr float LookAhead = 0.75f; //Seconds of velocity the kernel stretches over
+	static constexpr float MinDanger = 0.02f; //Tiles decayed below this are cleared
+
+	//Where the cells are & how fast they decay, world snapshots read their copy of the tiles with it
+	struct Grid
+	{
+		Elite::Vector2 origin = {};
+		unsigned int columns = 0;
+		unsigned int rows = 0;
+		unsigned int tileColumns = 0;
+		float decayRate = 0.f; //Per second, ln(2) / HalfLife
+
+		unsigned int GetTileCount() const { return tileColumns * ((rows + TileSize - 1) / TileSize); }
+		//False outside the grid, cell is the index within the tile
+		bool GetCell(const Elite::Vector2& position, unsigned int& tile, unsigned int& cell) const;
+		float GetDecay(float elapsed) const { return expf(-decayRate * elapsed); }
+
+		//Samples every half cell along the straight line, getDanger(position) reads one
+		template<typename Sampler>
+		static float IntegrateDanger(const Elite::Vector2& from, const Elite::Vector2& to, Sampler getDanger);
+	};
+	struct TileState
+	{
+		float time; //When the tile's values were last decayed
+		float peak; //Highest value in the tile at its time, 0 when idle
+	};
+	struct TileRow
+	{
+		float values[TileSize];
+	};
+
+	void Initialize(const WorldInfo& worldInfo);
+
+	//Decays to time & stamps every enemy in sight
+	void Update(float time, const std::list<EnemyInfo>& enemiesInFOV);
+
+	void SaveState(Elite::CheckpointWriter& writer) const;
+	bool LoadState(Elite::CheckpointReader& reader);
+
+	//Roughly 1 next to a normal zombie, more for the worse types, as of the last Update
+	float GetDanger(const Elite::Vector2& position) const;
+	//Danger summed along the straight line, per meter, to weigh a leg by what it walks through
+	float GetPathDanger(const Elite::Vector2& from, const Elite::Vector2& to) const;
+
+	//Writes the tiles that hold danger (or just lost it) into an overlay of the same grid
+	void UpdateOverlay(GridOverlay& overlay);
+
+	//Tiles whose values or state changed since the last ClearChangedTiles, all of them after Initialize & LoadState
+	const std::vector<unsigned int>& GetChangedTiles() const { return m_ChangedTiles; }
+	void ClearChangedTiles();
+	TileState GetTileState(unsigned int tile) const { return TileState{ m_TileTimes[tile], m_TilePeaks[tile] }; }
+	//CellsPerTile values, row by row
+	const float* GetTileValues(unsigned int tile) const { return &m_Values[tile * CellsPerTile]; }
+
+	static float GetTypeWeight(eEnemyType type);
+	const Grid& GetGrid() const { return m_Grid; }
+	const Elite::Vector2& GetOrigin() const { return m_Grid.origin; }
+	unsigned int GetColumns() const { return m_Grid.columns; }
+	unsigned int GetRows() const { return m_Grid.rows; }
+	unsigned int GetActiveTileCount() const;
+
+private:
+	Grid m_Grid = {};
+	float m_Time = 0.f;
+
+	std::vector<float> m_Values = {}; //Tile after tile, every tile row by row
+	std::vector<float> m_TileTimes = {}; //When the tile's values were last decayed
+	std::vector<float> m_TilePeaks = {}; //Highest value in the tile at its time, 0 when idle
+	std::vector<unsigned char> m_IsTileOnOverlay = {};
+	std::vector<unsigned char> m_IsTileChanged = {};
+	std::vector<unsigned int> m_ChangedTiles = {};
+
+	unsigned int GetCellIndex(unsigned int column, unsigned int row) const;
+	float GetDecay(unsigned int tile) const;
+	void DecayTile(unsigned int tile);
+	void Stamp(const EnemyInfo& enemy);
+	void MarkTileChanged(unsigned int tile);
+	void MarkAllTilesChanged();
+};
+
+template<typename Sampler>
+float InfluenceMap::Grid::IntegrateDanger(const Elite::Vector2& from, const Elite::Vector2& to, Sampler getDanger)
+{
+	//Half a cell per sample, so no cell is stepped over
+	const float length = Elite::Distance(from, to);
+	const unsigned int steps = static_cast<unsigned int>(length / (CellSize * 0.5f)) + 1;
+	const Elite::Vector2 step = (to - from) / float(steps);
+
+	float danger = 0.f;
+	for (unsigned int s = 0; s < steps; ++s)
+		danger += getDanger(from + step * (s + 0.5f));
+	return danger * (length / steps);
+}
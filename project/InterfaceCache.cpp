@@ -0,0 +1,155 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "InterfaceCache.h"
+
+void CachedExamInterface::BeginTick()
+{
+	m_ItemInfoCache.Clear();
+	m_EnemyInfoCache.Clear();
+	m_PurgeZoneInfoCache.Clear();
+	m_ItemValueCache.Clear();
+}
+
+#pragma region Entities
+bool CachedExamInterface::Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy)
+{
+	bool result = false;
+	if (m_EnemyInfoCache.Find(entity.EntityHash, result, enemy))
+	{
+		++m_Hits;
+		return result;
+	}
+
+	++m_Misses;
+	result = m_pInterface->Enemy_GetInfo(entity, enemy);
+	m_EnemyInfoCache.Insert(entity.EntityHash, result, enemy);
+	return result;
+}
+
+bool CachedExamInterface::PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone)
+{
+	bool result = false;
+	if (m_PurgeZoneInfoCache.Find(entity.EntityHash, result, zone))
+	{
+		++m_Hits;
+		return result;
+	}
+
+	++m_Misses;
+	result = m_pInterface->PurgeZone_GetInfo(entity, zone);
+	m_PurgeZoneInfoCache.Insert(entity.EntityHash, result, zone);
+	return result;
+}
+#pragma endregion
+
+#pragma region Items
+bool CachedExamInterface::Item_GetInfo(EntityInfo entity, ItemInfo& item)
+{
+	bool result = false;
+	if (m_ItemInfoCache.Find(entity.EntityHash, result, item))
+	{
+		++m_Hits;
+		return result;
+	}
+
+	++m_Misses;
+	result = m_pInterface->Item_GetInfo(entity, item);
+	m_ItemInfoCache.Insert(entity.EntityHash, result, item);
+	return result;
+}
+
+bool CachedExamInterface::Item_Grab(EntityInfo entity, ItemInfo& item)
+{
+	const bool result = m_pInterface->Item_Grab(entity, item);
+	if (result)
+	{
+		//With AutoGrabClosestItem the grabbed item isn't necessarily 'entity', so drop them all
+		m_ItemInfoCache.Clear();
+	}
+	return result;
+}
+
+bool CachedExamInterface::Item_Destroy(EntityInfo entity)
+{
+	const bool result = m_pInterface->Item_Destroy(entity);
+	if (result)
+	{
+		m_ItemInfoCache.Erase(entity.EntityHash);
+	}
+	return result;
+}
+
+int CachedExamInterface::Weapon_GetAmmo(ItemInfo& item)
+{
+	bool result = false;
+	int ammo = 0;
+	if (m_ItemValueCache.Find(item.ItemHash, result, ammo))
+	{
+		++m_Hits;
+		return ammo;
+	}
+
+	++m_Misses;
+	ammo = m_pInterface->Weapon_GetAmmo(item);
+	m_ItemValueCache.Insert(item.ItemHash, true, ammo);
+	return ammo;
+}
+
+int CachedExamInterface::Medkit_GetHealth(ItemInfo& item)
+{
+	bool result = false;
+	int health = 0;
+	if (m_ItemValueCache.Find(item.ItemHash, result, health))
+	{
+		++m_Hits;
+		return health;
+	}
+
+	++m_Misses;
+	health = m_pInterface->Medkit_GetHealth(item);
+	m_ItemValueCache.Insert(item.ItemHash, true, health);
+	return health;
+}
+
+int CachedExamInterface::Food_GetEnergy(ItemInfo& item)
+{
+	bool result = false;
+	int energy = 0;
+	if (m_ItemValueCache.Find(item.ItemHash, result, energy))
+	{
+		++m_Hits;
+		return energy;
+	}
+
+	++m_Misses;
+	energy = m_pInterface->Food_GetEnergy(item);
+	m_ItemValueCache.Insert(item.ItemHash, true, energy);
+	return energy;
+}
+#pragma endregion
+
+#pragma region Inventory
+bool CachedExamInterface::Inventory_AddItem(UINT slotId, ItemInfo item)
+{
+	InvalidateInventory();
+	return m_pInterface->Inventory_AddItem(slotId, item);
+}
+
+bool CachedExamInterface::Inventory_UseItem(UINT slotId)
+{
+	InvalidateInventory();
+	return m_pInterface->Inventory_UseItem(slotId);
+}
+
+bool CachedExamInterface::Inventory_RemoveItem(UINT slotId)
+{
+	InvalidateInventory();
+	return m_pInterface->Inventory_RemoveItem(slotId);
+}
+
+void CachedExamInterface::InvalidateInventory()
+{
+	//The framework only tells us the slot, not which item lives there
+	m_ItemValueCache.Clear();
+}
+#pragma endregion
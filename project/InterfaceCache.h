@@ -0,0 +1,184 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// InterfaceCache.h: Per-tick memoizing decorator around IExamInterface
+/*=============================================================================*/
+#pragma once
+#include "IExamInterface.h"
+
+//-----------------------------------------------------------------
+// TICK CACHE TABLE
+//-----------------------------------------------------------------
+// Small open-addressing table (linear probing) whose entries are only valid
+// for the epoch they were written in. Clearing the table is a single increment.
+template<typename T, unsigned int Capacity>
+class TickCacheTable final
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	//Invalidates every entry in O(1)
+	void Clear() { ++m_Epoch; }
+
+	bool Find(int key, bool& result, T& value) const
+	{
+		for (unsigned int probe = 0, i = Hash(key); probe < Capacity; ++probe, i = (i + 1) & (Capacity - 1))
+		{
+			const Slot& slot = m_Slots[i];
+			if (slot.epoch != m_Epoch)
+				return false;
+
+			if (slot.key == key && slot.isValid)
+			{
+				result = slot.result;
+				value = slot.value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Insert(int key, bool result, const T& value)
+	{
+		for (unsigned int probe = 0, i = Hash(key); probe < Capacity; ++probe, i = (i + 1) & (Capacity - 1))
+		{
+			Slot& slot = m_Slots[i];
+			if (slot.epoch != m_Epoch || slot.key == key)
+			{
+				slot = Slot{ key, m_Epoch, true, result, value };
+				return;
+			}
+		}
+		//Table is full for this epoch, the query simply won't be cached
+	}
+
+	void Erase(int key)
+	{
+		for (unsigned int probe = 0, i = Hash(key); probe < Capacity; ++probe, i = (i + 1) & (Capacity - 1))
+		{
+			Slot& slot = m_Slots[i];
+			if (slot.epoch != m_Epoch)
+				return;
+
+			if (slot.key == key)
+			{
+				slot.isValid = false; //Tombstone, keeps the probe chain intact
+				return;
+			}
+		}
+	}
+
+private:
+	struct Slot
+	{
+		int key = 0;
+		unsigned int epoch = 0;
+		bool isValid = false;
+		bool result = false;
+		T value = {};
+	};
+
+	static unsigned int Hash(int key)
+	{
+		return (static_cast<unsigned int>(key) * 2654435761u) & (Capacity - 1);
+	}
+
+	Slot m_Slots[Capacity] = {};
+	unsigned int m_Epoch = 1;
+};
+
+//-----------------------------------------------------------------
+// CACHED EXAM INTERFACE
+//-----------------------------------------------------------------
+// Forwards everything to the framework interface, but memoizes the entity & item
+// queries for the duration of one tick. Mutating calls invalidate what they touch.
+class CachedExamInterface final : public IExamInterface
+{
+public:
+	explicit CachedExamInterface(IExamInterface* pInterface) : m_pInterface(pInterface) {}
+	~CachedExamInterface() = default;
+
+	//Starts a new tick epoch, call once before any behavior queries the interface
+	void BeginTick();
+
+	unsigned int GetHitCount() const { return m_Hits; }
+	unsigned int GetMissCount() const { return m_Misses; }
+
+	//WORLD & ENTITIES
+	WorldInfo World_GetInfo() const override { return m_pInterface->World_GetInfo(); }
+	StatisticsInfo World_GetStats() const override { return m_pInterface->World_GetStats(); }
+
+	bool Fov_GetHouseByIndex(UINT index, HouseInfo& houseInfo) const override { return m_pInterface->Fov_GetHouseByIndex(index, houseInfo); }
+	bool Fov_GetEntityByIndex(UINT index, EntityInfo& enemyInfo) const override { return m_pInterface->Fov_GetEntityByIndex(index, enemyInfo); }
+
+	AgentInfo Agent_GetInfo() const override { return m_pInterface->Agent_GetInfo(); }
+	bool Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy) override;
+
+	//NAVMESH
+	Elite::Vector2 NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const override { return m_pInterface->NavMesh_GetClosestPathPoint(goal); }
+
+	//INVENTORY
+	bool Inventory_AddItem(UINT slotId, ItemInfo item) override;
+	bool Inventory_UseItem(UINT slotId) override;
+	bool Inventory_RemoveItem(UINT slotId) override;
+	bool Inventory_GetItem(UINT slotId, ItemInfo& item) override { return m_pInterface->Inventory_GetItem(slotId, item); }
+	UINT Inventory_GetCapacity() const override { return m_pInterface->Inventory_GetCapacity(); }
+
+	bool Item_GetInfo(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Grab(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Destroy(EntityInfo entity) override;
+
+	int Weapon_GetAmmo(ItemInfo& item) override;
+	int Medkit_GetHealth(ItemInfo& item) override;
+	int Food_GetEnergy(ItemInfo& item) override;
+
+	//PURGEZONE
+	bool PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone) override;
+
+	//DEBUG
+	Elite::Vector2 Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const override { return m_pInterface->Debug_ConvertScreenToWorld(screenPos); }
+	Elite::Vector2 Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const override { return m_pInterface->Debug_ConvertWorldToScreen(worldPos); }
+
+	//INPUT
+	bool Input_IsKeyboardKeyDown(Elite::InputScancode key) const override { return m_pInterface->Input_IsKeyboardKeyDown(key); }
+	bool Input_IsKeyboardKeyUp(Elite::InputScancode key) const override { return m_pInterface->Input_IsKeyboardKeyUp(key); }
+	bool Input_IsMouseButtonDown(Elite::InputMouseButton button) const override { return m_pInterface->Input_IsMouseButtonDown(button); }
+	bool Input_IsMouseButtonUp(Elite::InputMouseButton button) const override { return m_pInterface->Input_IsMouseButtonUp(button); }
+	Elite::MouseData Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button = Elite::InputMouseButton(0)) const override { return m_pInterface->Input_GetMouseData(type, button); }
+
+	//EVENT
+	void RequestShutdown() const override { m_pInterface->RequestShutdown(); }
+
+	//RENDERER
+	using IBaseInterface::Draw_Polygon;
+	using IBaseInterface::Draw_SolidPolygon;
+	using IBaseInterface::Draw_Circle;
+	using IBaseInterface::Draw_SolidCircle;
+	using IBaseInterface::Draw_Segment;
+	using IBaseInterface::Draw_Transform;
+	using IBaseInterface::Draw_Point;
+
+	void Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth) override { m_pInterface->Draw_Polygon(points, count, color, depth); }
+	void Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate = false) override { m_pInterface->Draw_SolidPolygon(points, count, color, depth, triangulate); }
+	void Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth) override { m_pInterface->Draw_Circle(center, radius, color, depth); }
+	void Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth) override { m_pInterface->Draw_SolidCircle(center, radius, axis, color, depth); }
+	void Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth) override { m_pInterface->Draw_Segment(p1, p2, color, depth); }
+	void Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth = 0.9f) override { m_pInterface->Draw_Direction(p, dir, length, color, depth); }
+	void Draw_Transform(const b2Transform& xf, float depth) override { m_pInterface->Draw_Transform(xf, depth); }
+	void Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth) override { m_pInterface->Draw_Point(p, size, color, depth); }
+
+	float NextDepthSlice() override { return m_pInterface->NextDepthSlice(); }
+
+private:
+	IExamInterface* m_pInterface = nullptr;
+
+	TickCacheTable<ItemInfo, 64> m_ItemInfoCache{};
+	TickCacheTable<EnemyInfo, 64> m_EnemyInfoCache{};
+	TickCacheTable<PurgeZoneInfo, 16> m_PurgeZoneInfoCache{};
+	TickCacheTable<int, 16> m_ItemValueCache{}; //Ammo, health & energy, keyed by ItemHash
+
+	unsigned int m_Hits = 0;
+	unsigned int m_Misses = 0;
+
+	void InvalidateInventory();
+};
@@ -0,0 +1,228 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "Inventory.h"
+#include "IExamInterface.h"
+
+void Inventory::Initialize(IExamInterface* pInterface, unsigned int maxGuns, unsigned int maxMedkits, unsigned int maxFood)
+{
+	m_pInterface = pInterface;
+
+	const unsigned int maxCounts[StorableTypeCount] = { maxGuns, maxMedkits, maxFood };
+	const unsigned int totalSlots = maxGuns + maxMedkits + maxFood;
+	assert(totalSlots <= pInterface->Inventory_GetCapacity() && "Inventory layout doesn't fit the framework inventory");
+
+	m_Slots.assign(totalSlots, Slot{});
+	m_SlotTypes.clear();
+	m_SlotTypes.reserve(totalSlots);
+
+	unsigned int slot = 0;
+	for (unsigned int type = 0; type < StorableTypeCount; ++type)
+	{
+		TypeData& typeData = m_Types[type];
+		typeData.maxCount = maxCounts[type];
+		typeData.freeSlots.clear();
+		typeData.occupiedSlots.clear();
+		typeData.occupiedSlots.reserve(typeData.maxCount);
+
+		//Pushed in reverse so the lowest slot gets handed out first
+		for (unsigned int i = 0; i < typeData.maxCount; ++i)
+		{
+			m_SlotTypes.push_back(static_cast<eItemType>(type));
+			typeData.freeSlots.push_back(slot + typeData.maxCount - 1 - i);
+		}
+		slot += typeData.maxCount;
+	}
+}
+
+bool Inventory::AddItem(const ItemInfo& item)
+{
+	if (!IsStorable(item.Type))
+		return false;
+
+	TypeData& typeData = GetTypeData(item.Type);
+	if (typeData.freeSlots.empty())
+		return false;
+
+	const unsigned int slot = typeData.freeSlots.back();
+	if (!m_pInterface->Inventory_AddItem(slot, item))
+		return false;
+
+	typeData.freeSlots.pop_back();
+
+	Slot& newSlot = m_Slots[slot];
+	newSlot.item = item;
+	newSlot.value = QueryValue(newSlot.item);
+	newSlot.isOccupied = true;
+	SortIn(typeData, slot);
+	return true;
+}
+
+bool Inventory::UseItem(unsigned int slot)
+{
+	if (slot >= m_Slots.size() || !m_Slots[slot].isOccupied)
+		return false;
+
+	if (!m_pInterface->Inventory_UseItem(slot))
+		return false;
+
+	const eItemType type = m_SlotTypes[slot];
+	if (type != eItemType::PISTOL)
+	{
+		RemoveItem(slot);
+		return true;
+	}
+
+	//One bullet fired, re-sort the gun instead of asking the framework for the ammo
+	TypeData& typeData = GetTypeData(type);
+	SortOut(typeData, slot);
+	--m_Slots[slot].value;
+	SortIn(typeData, slot);
+
+	if (m_Slots[slot].value <= 0)
+	{
+		RemoveItem(slot);
+	}
+	return true;
+}
+
+void Inventory::RemoveItem(unsigned int slot)
+{
+	if (slot >= m_Slots.size() || !m_Slots[slot].isOccupied)
+		return;
+
+	TypeData& typeData = GetTypeData(m_SlotTypes[slot]);
+	SortOut(typeData, slot);
+	typeData.freeSlots.push_back(slot);
+
+	m_Slots[slot] = Slot{};
+	m_pInterface->Inventory_RemoveItem(slot);
+}
+
+unsigned int Inventory::GetCount(eItemType type) const
+{
+	if (!IsStorable(type))
+		return 0;
+
+	return static_cast<unsigned int>(GetTypeData(type).occupiedSlots.size());
+}
+
+unsigned int Inventory::GetMaxCount(eItemType type) const
+{
+	if (!IsStorable(type))
+		return 0;
+
+	return GetTypeData(type).maxCount;
+}
+
+bool Inventory::NeedsAnyItem() const
+{
+	return NeedsItem(eItemType::PISTOL) || NeedsItem(eItemType::MEDKIT) || NeedsItem(eItemType::FOOD);
+}
+
+bool Inventory::IsSlotOfType(int slot, eItemType type) const
+{
+	if (slot < 0 || static_cast<unsigned int>(slot) >= m_Slots.size())
+		return false;
+
+	return m_Slots[slot].isOccupied && m_SlotTypes[slot] == type;
+}
+
+int Inventory::GetLeastAmmoGun() const
+{
+	const TypeData& guns = GetTypeData(eItemType::PISTOL);
+	return guns.occupiedSlots.empty() ? -1 : int(guns.occupiedSlots.front());
+}
+
+int Inventory::GetBestMedkit(float damageTaken) const
+{
+	const TypeData& medkits = GetTypeData(eItemType::MEDKIT);
+	for (auto it = medkits.occupiedSlots.rbegin(); it != medkits.occupiedSlots.rend(); ++it)
+	{
+		if (m_Slots[*it].value < damageTaken)
+			return int(*it);
+	}
+	return -1;
+}
+
+int Inventory::GetAnyFood() const
+{
+	const TypeData& food = GetTypeData(eItemType::FOOD);
+	return food.occupiedSlots.empty() ? -1 : int(food.occupiedSlots.front());
+}
+
+int Inventory::QueryValue(ItemInfo& item) const
+{
+	switch (item.Type)
+	{
+	case eItemType::PISTOL:
+		return m_pInterface->Weapon_GetAmmo(item);
+	case eItemType::MEDKIT:
+		return m_pInterface->Medkit_GetHealth(item);
+	case eItemType::FOOD:
+		return m_pInterface->Food_GetEnergy(item);
+	default:
+		return 0;
+	}
+}
+
+void Inventory::SortIn(TypeData& typeData, unsigned int slot)
+{
+	const int value = m_Slots[slot].value;
+	auto it = std::find_if(typeData.occupiedSlots.begin(), typeData.occupiedSlots.end(),
+		[this, value](unsigned int other) { return m_Slots[other].value > value; });
+	typeData.occupiedSlots.insert(it, slot);
+}
+
+void Inventory::SortOut(TypeData& typeData, unsigned int slot)
+{
+	auto it = std::find(typeData.occupiedSlots.begin(), typeData.occupiedSlots.end(), slot);
+	if (it != typeData.occupiedSlots.end())
+		typeData.occupiedSlots.erase(it);
+}
+
+bool Inventory::MarkRefused(int itemHash)
+{
+	if (IsRefused(itemHash))
+		return false;
+	m_RefusedHashes.push_back(itemHash);
+	return true;
+}
+
+bool Inventory::IsRefused(int itemHash) const
+{
+	return std::find(m_RefusedHashes.begin(), m_RefusedHashes.end(), itemHash) != m_RefusedHashes.end();
+}
+
+void Inventory::SaveState(Elite::CheckpointWriter& writer) const
+{
+	writer.WriteTag("INVT");
+	writer.WriteArray(m_Slots);
+	for (const TypeData& typeData : m_Types)
+	{
+		writer.WriteArray(typeData.freeSlots);
+		writer.WriteArray(typeData.occupiedSlots);
+	}
+	writer.WriteArray(m_RefusedHashes);
+}
+
+bool Inventory::LoadState(Elite::CheckpointReader& reader)
+{
+	const unsigned int slotCount = static_cast<unsigned int>(m_Slots.size());
+	if (!reader.ReadTag("INVT") || !reader.ReadArray(m_Slots) || m_Slots.size() != slotCount)
+		return false;
+
+	for (TypeData& typeData : m_Types)
+	{
+		if (!reader.ReadArray(typeData.freeSlots) || !reader.ReadArray(typeData.occupiedSlots))
+			return false;
+		for (const std::vector<unsigned int>* pSlots : { &typeData.freeSlots, &typeData.occupiedSlots })
+		{
+			for (unsigned int slot : *pSlots)
+			{
+				if (slot >= slotCount)
+					return false;
+			}
+		}
+	}
+	return reader.ReadArray(m_RefusedHashes);
+}
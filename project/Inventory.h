@@ -0,0 +1,91 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// Inventory.h: Typed inventory model, owns the slot layout & caches per-slot values
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "ECheckpoint.h"
+
+class IExamInterface;
+
+// Every slot belongs to one item type, handed out through a per-type free list.
+// The resource value of a slot (ammo, health or energy) is read from the framework once,
+// at pickup, and afterwards only updated locally when the item gets used.
+// Per type the occupied slots are kept sorted on that value, so the queries below
+// are O(1) (or O(max count of that type) for GetBestMedkit, which is at most a handful).
+class Inventory final
+{
+public:
+	Inventory() = default;
+	~Inventory() = default;
+	//Spelled out, with only the destructor declared a swap would copy every vector
+	Inventory(const Inventory&) = default;
+	Inventory(Inventory&&) = default;
+	Inventory& operator=(const Inventory&) = default;
+	Inventory& operator=(Inventory&&) = default;
+
+	//Lays out the slots: [guns][medkits][food], must fit in the framework capacity
+	void Initialize(IExamInterface* pInterface, unsigned int maxGuns, unsigned int maxMedkits, unsigned int maxFood);
+
+	//Stores a grabbed item in a free slot of its type, returns false if there is none
+	bool AddItem(const ItemInfo& item);
+	//Uses the item in the slot, consumables are removed, a gun loses one bullet (and is removed when empty)
+	bool UseItem(unsigned int slot);
+	void RemoveItem(unsigned int slot);
+
+	unsigned int GetCount(eItemType type) const;
+	unsigned int GetMaxCount(eItemType type) const;
+	bool HasItem(eItemType type) const { return GetCount(type) > 0; }
+	bool NeedsItem(eItemType type) const { return GetCount(type) < GetMaxCount(type); }
+	bool NeedsAnyItem() const;
+
+	//Items the framework wouldn't store are skipped from then on, true the first time one is marked
+	bool MarkRefused(int itemHash);
+	bool IsRefused(int itemHash) const;
+	unsigned int GetRefusedCount() const { return static_cast<unsigned int>(m_RefusedHashes.size()); }
+
+	//The layout & what's in every slot, restoring needs an inventory initialized with the same layout
+	void SaveState(Elite::CheckpointWriter& writer) const;
+	bool LoadState(Elite::CheckpointReader& reader);
+
+	bool IsSlotOfType(int slot, eItemType type) const;
+	const ItemInfo& GetItem(unsigned int slot) const { return m_Slots[slot].item; }
+	int GetValue(unsigned int slot) const { return m_Slots[slot].value; }
+
+	//Slot queries, return -1 when no suitable item is held
+	int GetLeastAmmoGun() const;
+	int GetBestMedkit(float damageTaken) const; //Biggest medkit that doesn't go to waste
+	int GetAnyFood() const; //Smallest food item, the first one to fit an energy need
+
+private:
+	enum { StorableTypeCount = 3 }; //PISTOL, MEDKIT, FOOD
+
+	struct Slot
+	{
+		ItemInfo item = {};
+		int value = 0; //Ammo, health or energy
+		bool isOccupied = false;
+	};
+
+	struct TypeData
+	{
+		unsigned int maxCount = 0;
+		std::vector<unsigned int> freeSlots = {};
+		std::vector<unsigned int> occupiedSlots = {}; //Sorted ascending on value
+	};
+
+	IExamInterface* m_pInterface = nullptr;
+	std::vector<Slot> m_Slots = {};
+	std::vector<eItemType> m_SlotTypes = {};
+	TypeData m_Types[StorableTypeCount] = {};
+	std::vector<int> m_RefusedHashes = {}; //A handful at most, scanned
+
+	static bool IsStorable(eItemType type) { return static_cast<unsigned int>(type) < StorableTypeCount; }
+	TypeData& GetTypeData(eItemType type) { return m_Types[static_cast<unsigned int>(type)]; }
+	const TypeData& GetTypeData(eItemType type) const { return m_Types[static_cast<unsigned int>(type)]; }
+
+	int QueryValue(ItemInfo& item) const;
+	void SortIn(TypeData& typeData, unsigned int slot);
+	void SortOut(TypeData& typeData, unsigned int slot);
+};
@@ -0,0 +1,211 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "ItemMemory.h"
+#include "PurgeZoneMemory.h"
+
+namespace
+{
+	unsigned int Quantize(float value, float origin, float scale)
+	{
+		const float code = (value - origin) * scale + 0.5f;
+		if (code <= 0.f)
+			return 0;
+		if (code >= float(ItemMemory::MaxCode))
+			return ItemMemory::MaxCode;
+		return static_cast<unsigned int>(code);
+	}
+}
+
+void ItemMemory::Initialize(const WorldInfo& worldInfo)
+{
+	m_Origin = worldInfo.Center - worldInfo.Dimensions / 2.f;
+	m_Scale.x = float(MaxCode) / std::max(worldInfo.Dimensions.x, 1.f);
+	m_Scale.y = float(MaxCode) / std::max(worldInfo.Dimensions.y, 1.f);
+	Clear();
+}
+
+bool ItemMemory::Add(const ItemInfo& item)
+{
+	const unsigned int code = Encode(item.Location);
+	if (Find(code) != -1)
+		return false;
+
+	const unsigned int index = GetCount();
+	m_Positions.push_back(code);
+	m_Hashes.push_back(item.ItemHash);
+	if (index % TypesPerWord == 0)
+		m_TypeWords.push_back(0);
+	SetType(index, static_cast<unsigned int>(item.Type));
+	return true;
+}
+
+int ItemMemory::Remove(const Elite::Vector2& location)
+{
+	const int found = Find(Encode(location));
+	if (found == -1)
+		return -1;
+
+	//The last item takes its place
+	const unsigned int index = static_cast<unsigned int>(found);
+	const unsigned int last = GetCount() - 1;
+	m_Positions[index] = m_Positions[last];
+	m_Hashes[index] = m_Hashes[last];
+	SetType(index, static_cast<unsigned int>(GetType(last)));
+
+	m_Positions.pop_back();
+	m_Hashes.pop_back();
+	if (last % TypesPerWord == 0)
+		m_TypeWords.pop_back();
+	return found;
+}
+
+void ItemMemory::Clear()
+{
+	m_Positions.clear();
+	m_TypeWords.clear();
+	m_Hashes.clear();
+}
+
+void ItemMemory::SaveState(Elite::CheckpointWriter& writer) const
+{
+	writer.WriteTag("ITMM");
+	writer.Write(m_Origin);
+	writer.Write(m_Scale);
+	writer.WriteArray(m_Positions);
+	writer.WriteArray(m_TypeWords);
+	writer.WriteArray(m_Hashes);
+}
+
+bool ItemMemory::LoadState(Elite::CheckpointReader& reader)
+{
+	if (!reader.ReadTag("ITMM") || !reader.Read(m_Origin) || !reader.Read(m_Scale)
+		|| !reader.ReadArray(m_Positions) || !reader.ReadArray(m_TypeWords) || !reader.ReadArray(m_Hashes))
+		return false;
+	return m_Hashes.size() == m_Positions.size() && m_TypeWords.size() == (m_Positions.size() + TypesPerWord - 1) / TypesPerWord;
+}
+
+ItemInfo ItemMemory::GetItem(unsigned int index) const
+{
+	ItemInfo item{};
+	item.Type = GetType(index);
+	item.Location = GetLocation(index);
+	item.ItemHash = m_Hashes[index];
+	return item;
+}
+
+eItemType ItemMemory::GetType(unsigned int index) const
+{
+	const unsigned int shift = (index % TypesPerWord) * TypeBits;
+	return static_cast<eItemType>((m_TypeWords[index / TypesPerWord] >> shift) & ((1u << TypeBits) - 1));
+}
+
+bool ItemMemory::FindClosest(eItemType type, const Elite::Vector2& position, const PurgeZoneMemory& purgeZones, ItemInfo& closestItem) const
+{
+	//Distances in code space, scaled back per axis so both axes weigh the same
+	const float invScaleSqrX = 1.f / (m_Scale.x * m_Scale.x);
+	const float invScaleSqrY = 1.f / (m_Scale.y * m_Scale.y);
+	const float fromX = (position.x - m_Origin.x) * m_Scale.x;
+	const float fromY = (position.y - m_Origin.y) * m_Scale.y;
+
+	//Every 2 bit lane of the word that holds the wanted type ends up as 01 in matches
+	const unsigned int lowBits = 0x55555555;
+	const unsigned int wantedLanes = static_cast<unsigned int>(type) * lowBits;
+	const unsigned int count = GetCount();
+
+	float closestDistance = FLT_MAX;
+	int closest = -1;
+	for (unsigned int w = 0; w < m_TypeWords.size(); ++w)
+	{
+		const unsigned int difference = m_TypeWords[w] ^ wantedLanes;
+		unsigned int matches = ~(difference | (difference >> 1)) & lowBits;
+		while (matches != 0)
+		{
+			unsigned int lane = 0;
+			while (((matches >> (lane * TypeBits)) & 1) == 0)
+				++lane;
+			matches &= matches - 1;
+
+			const unsigned int i = w * TypesPerWord + lane;
+			if (i >= count)
+				break;
+
+			const float dx = float(m_Positions[i] & MaxCode) - fromX;
+			const float dy = float(m_Positions[i] >> 16) - fromY;
+			const float distance = dx * dx * invScaleSqrX + dy * dy * invScaleSqrY;
+			if (distance < closestDistance && !purgeZones.IsInside(GetLocation(i)))
+			{
+				closestDistance = distance;
+				closest = int(i);
+			}
+		}
+	}
+
+	if (closest == -1)
+		return false;
+
+	closestItem = GetItem(closest);
+	return true;
+}
+
+unsigned int ItemMemory::GetKnownTypes() const
+{
+	unsigned int knownTypes = 0;
+	for (unsigned int i = 0; i < m_Positions.size(); ++i)
+		knownTypes |= 1u << static_cast<unsigned int>(GetType(i));
+	return knownTypes;
+}
+
+unsigned int ItemMemory::GetMemoryUsage() const
+{
+	return static_cast<unsigned int>(m_Positions.capacity() * sizeof(unsigned int)
+		+ m_TypeWords.capacity() * sizeof(unsigned int) + m_Hashes.capacity() * sizeof(int));
+}
+
+unsigned int ItemMemory::Encode(const Elite::Vector2& position) const
+{
+	return Quantize(position.x, m_Origin.x, m_Scale.x) | (Quantize(position.y, m_Origin.y, m_Scale.y) << 16);
+}
+
+Elite::Vector2 ItemMemory::Decode(unsigned int code) const
+{
+	return Elite::Vector2{ m_Origin.x + float(code & MaxCode) / m_Scale.x, m_Origin.y + float(code >> 16) / m_Scale.y };
+}
+
+void ItemMemory::GetTransformedLocations(const Matrix2x3& transform, float* xs, float* ys) const
+{
+	//Decoding is a scale & a translation, so it goes into the same matrix
+	const Matrix2x3 codeToTransformed = transform * Matrix2x3{ 1.f / m_Scale.x, 0.f, 0.f, 1.f / m_Scale.y, m_Origin.x, m_Origin.y };
+	const unsigned int count = GetCount();
+	const unsigned int* pCodes = m_Positions.data();
+	unsigned int i = 0;
+#if defined(ELITE_FAST_MATH_SSE)
+	const __m128i lowMask = _mm_set1_epi32(MaxCode);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pCodes + i));
+		_mm_storeu_ps(xs + i, _mm_cvtepi32_ps(_mm_and_si128(codes, lowMask)));
+		_mm_storeu_ps(ys + i, _mm_cvtepi32_ps(_mm_srli_epi32(codes, 16)));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		//Through int, 16-bit codes fit & signed converts in one instruction
+		xs[i] = float(int(pCodes[i] & MaxCode));
+		ys[i] = float(int(pCodes[i] >> 16));
+	}
+	codeToTransformed.TransformPoints(xs, ys, xs, ys, count);
+}
+
+int ItemMemory::Find(unsigned int code) const
+{
+	const auto it = std::find(m_Positions.begin(), m_Positions.end(), code);
+	return it == m_Positions.end() ? -1 : int(it - m_Positions.begin());
+}
+
+void ItemMemory::SetType(unsigned int index, unsigned int type)
+{
+	const unsigned int shift = (index % TypesPerWord) * TypeBits;
+	const unsigned int mask = ((1u << TypeBits) - 1) << shift;
+	unsigned int& word = m_TypeWords[index / TypesPerWord];
+	word = (word & ~mask) | ((type << shift) & mask);
+}
@@ -0,0 +1,70 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// ItemMemory.h: Remembered items, stored as 16-bit fixed-point positions
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "ECheckpoint.h"
+
+class PurgeZoneMemory;
+
+//-----------------------------------------------------------------
+// ITEM MEMORY
+//-----------------------------------------------------------------
+// Positions are 16-bit fixed point over the world bounds (x in the low half, y in the
+// high half of one 32-bit word), the item type is 2 bits packed 16 to a word and the
+// hash lives in a side table that scans never touch. A scan reads 4.25 bytes per item
+// instead of the 16 of an ItemInfo. Quantizing a decoded position gives back the same
+// code, so an item's identity is its quantized position.
+class ItemMemory final
+{
+public:
+	static const unsigned int MaxCode = 0xFFFF;
+	static const unsigned int TypeBits = 2;
+	static const unsigned int TypesPerWord = 32 / TypeBits;
+
+	void Initialize(const WorldInfo& worldInfo);
+
+	//False when an item at that position is already remembered
+	bool Add(const ItemInfo& item);
+	//Index the item had, the last item takes its place. -1 when nothing was remembered there
+	int Remove(const Elite::Vector2& location);
+	void Clear();
+
+	//The quantization comes along, so a checkpoint restores into a memory initialized for any world
+	void SaveState(Elite::CheckpointWriter& writer) const;
+	bool LoadState(Elite::CheckpointReader& reader);
+
+	unsigned int GetCount() const { return static_cast<unsigned int>(m_Positions.size()); }
+	ItemInfo GetItem(unsigned int index) const;
+	eItemType GetType(unsigned int index) const;
+	Elite::Vector2 GetLocation(unsigned int index) const { return Decode(m_Positions[index]); }
+	//Every location through the transform at once, xs & ys need GetCount() floats
+	void GetTransformedLocations(const Matrix2x3& transform, float* xs, float* ys) const;
+
+	//Closest item of that type outside every remembered purge zone
+	bool FindClosest(eItemType type, const Elite::Vector2& position, const PurgeZoneMemory& purgeZones, ItemInfo& closestItem) const;
+	//Bit (1 << type) is set for every type there is at least one item of
+	unsigned int GetKnownTypes() const;
+
+	//Size of one quantization step in world units, the round-trip error is at most half of it
+	Elite::Vector2 GetResolution() const { return Elite::Vector2{ 1.f / m_Scale.x, 1.f / m_Scale.y }; }
+	unsigned int GetMemoryUsage() const;
+
+	unsigned int Encode(const Elite::Vector2& position) const;
+	Elite::Vector2 Decode(unsigned int code) const;
+	//Remembered locations are quantized, compare them with what's in sight through this
+	bool IsSameLocation(const Elite::Vector2& a, const Elite::Vector2& b) const { return Encode(a) == Encode(b); }
+
+private:
+	Elite::Vector2 m_Origin = {};
+	Elite::Vector2 m_Scale = { 1.f, 1.f }; //Codes per world unit
+
+	std::vector<unsigned int> m_Positions = {}; //x | y << 16
+	std::vector<unsigned int> m_TypeWords = {}; //TypesPerWord types per word
+	std::vector<int> m_Hashes = {}; //Cold, only needed to give back a full ItemInfo
+
+	int Find(unsigned int code) const;
+	void SetType(unsigned int index, unsigned int type);
+};
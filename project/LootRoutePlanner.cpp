@@ -0,0 +1,304 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "LootRoutePlanner.h"
+#include "GridDistanceOracle.h"
+#include "WorldModel.h"
+
+void LootRoutePlanner::GatherStops(const WorldSnapshot& world, std::vector<Stop>& stops)
+{
+	stops.clear();
+
+	world.items.ForEach([&world, &stops](const ItemInfo& item)
+		{
+			if (world.NeedsItem(item.Type) && !world.IsInPurgeZone(item.Location))
+				stops.push_back(Stop{ item.Location, -1, item });
+		});
+
+	for (unsigned int h = 0; h < world.houses.GetSize(); ++h)
+	{
+		const HouseInfo& house = world.houses[h].info;
+		if (world.IsWorthVisiting(h) && !world.IsInPurgeZone(house.Center))
+			stops.push_back(Stop{ house.Center, int(h), ItemInfo{} });
+	}
+
+	//Too many stops, keep the closest ones
+	if (stops.size() > MaxStops)
+	{
+		const Elite::Vector2 position = world.agentInfo.Position;
+		std::partial_sort(stops.begin(), stops.begin() + MaxStops, stops.end(),
+			[position](const Stop& a, const Stop& b)
+			{
+				return DistanceSquared(a.position, position) < DistanceSquared(b.position, position);
+			});
+		stops.resize(MaxStops);
+	}
+}
+
+void LootRoutePlanner::Update(const WorldSnapshot& world, const std::vector<Stop>& stops, GridDistanceOracle& distanceOracle)
+{
+	Elite::ScopedTimer timer{ m_UpdateStats };
+
+	m_Candidates.assign(stops.begin(), stops.end());
+	if (HaveStopsChanged())
+	{
+		Rebuild(world, distanceOracle);
+	}
+	else
+	{
+		//Only the agent moved, or the danger along its legs changed
+		const unsigned int nodeCount = static_cast<unsigned int>(m_Stops.size() + 1);
+		for (unsigned int s = 1; s < nodeCount; ++s)
+		{
+			const float distance = GetLegCost(world, distanceOracle, world.agentInfo.Position, m_Stops[s - 1].position);
+			m_Distances[s] = distance;
+			m_Distances[s * nodeCount] = distance;
+		}
+
+		//Moving can make another stop a better first one
+		for (unsigned int j = 2; m_IsConverged && j < m_Tour.size(); ++j)
+		{
+			if (TryTwoOpt(1, j))
+			{
+				++m_ImprovementCount;
+				RestartImprovement();
+			}
+		}
+	}
+}
+
+void LootRoutePlanner::GetTour(std::vector<Stop>& tour) const
+{
+	tour.clear();
+	for (unsigned int t = 1; t < m_Tour.size(); ++t)
+		tour.push_back(m_Stops[m_Tour[t] - 1]);
+}
+
+bool LootRoutePlanner::HaveStopsChanged() const
+{
+	if (m_Candidates.size() != m_Stops.size())
+		return true;
+
+	for (const Stop& candidate : m_Candidates)
+	{
+		const auto isSame = [&candidate](const Stop& stop) { return IsSameStop(candidate, stop); };
+		if (std::find_if(m_Stops.begin(), m_Stops.end(), isSame) == m_Stops.end())
+			return true;
+	}
+	return false;
+}
+
+void LootRoutePlanner::Rebuild(const WorldSnapshot& world, GridDistanceOracle& distanceOracle)
+{
+	//Warm start, the stops that are still wanted keep their order on the tour
+	std::vector<Stop> stops{};
+	stops.reserve(m_Candidates.size());
+	for (unsigned int t = 1; t < m_Tour.size(); ++t)
+	{
+		const Stop& stop = m_Stops[m_Tour[t] - 1];
+		const auto isSame = [&stop](const Stop& candidate) { return IsSameStop(candidate, stop); };
+		const auto candidate = std::find_if(m_Candidates.begin(), m_Candidates.end(), isSame);
+		if (candidate != m_Candidates.end())
+			stops.push_back(*candidate); //The candidate has the latest item info
+	}
+
+	const unsigned int keptCount = static_cast<unsigned int>(stops.size());
+	for (const Stop& candidate : m_Candidates)
+	{
+		const auto isSame = [&candidate](const Stop& stop) { return IsSameStop(candidate, stop); };
+		if (std::find_if(stops.begin(), stops.begin() + keptCount, isSame) == stops.begin() + keptCount)
+			stops.push_back(candidate);
+	}
+	m_Stops.swap(stops);
+
+	//Leg costs between every pair of nodes, node 0 being the agent
+	const unsigned int nodeCount = static_cast<unsigned int>(m_Stops.size() + 1);
+	m_Distances.assign(nodeCount * nodeCount, 0.f);
+	for (unsigned int a = 0; a < nodeCount; ++a)
+	{
+		const Elite::Vector2 from = (a == 0) ? world.agentInfo.Position : m_Stops[a - 1].position;
+		for (unsigned int b = a + 1; b < nodeCount; ++b)
+		{
+			const float distance = GetLegCost(world, distanceOracle, from, m_Stops[b - 1].position);
+			m_Distances[a * nodeCount + b] = distance;
+			m_Distances[b * nodeCount + a] = distance;
+		}
+	}
+
+	m_Tour.clear();
+	m_Tour.push_back(0);
+	if (keptCount == 0)
+	{
+		//Nearest neighbour seed
+		std::vector<bool> isOnTour(nodeCount, false);
+		isOnTour[0] = true;
+		for (unsigned int t = 1; t < nodeCount; ++t)
+		{
+			unsigned int nearest = 0;
+			float nearestDistance = FLT_MAX;
+			for (unsigned int n = 1; n < nodeCount; ++n)
+			{
+				if (!isOnTour[n] && GetDistance(m_Tour.back(), n) < nearestDistance)
+				{
+					nearest = n;
+					nearestDistance = GetDistance(m_Tour.back(), n);
+				}
+			}
+			isOnTour[nearest] = true;
+			m_Tour.push_back(nearest);
+		}
+	}
+	else
+	{
+		for (unsigned int n = 1; n <= keptCount; ++n)
+			m_Tour.push_back(n);
+
+		//New stops go where they add the least distance
+		for (unsigned int n = keptCount + 1; n < nodeCount; ++n)
+		{
+			unsigned int bestPosition = static_cast<unsigned int>(m_Tour.size());
+			float bestCost = GetDistance(m_Tour.back(), n);
+			for (unsigned int t = 0; t + 1 < m_Tour.size(); ++t)
+			{
+				const float cost = GetDistance(m_Tour[t], n) + GetDistance(n, m_Tour[t + 1]) - GetDistance(m_Tour[t], m_Tour[t + 1]);
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestPosition = t + 1;
+				}
+			}
+			m_Tour.insert(m_Tour.begin() + bestPosition, n);
+		}
+	}
+
+	RestartImprovement();
+}
+
+void LootRoutePlanner::Step()
+{
+	const unsigned int nodeCount = static_cast<unsigned int>(m_Tour.size());
+	if (nodeCount < 3)
+	{
+		m_IsConverged = true;
+		return;
+	}
+
+	for (unsigned int move = 0; move < MovesPerStep && !m_IsConverged; ++move)
+	{
+		bool hasImproved = false;
+		if (m_Phase == 0)
+		{
+			hasImproved = TryTwoOpt(m_CursorI, m_CursorJ);
+
+			if (++m_CursorJ >= nodeCount)
+			{
+				++m_CursorI;
+				m_CursorJ = m_CursorI + 1;
+			}
+			if (m_CursorI + 1 >= nodeCount)
+			{
+				m_Phase = 1;
+				m_CursorI = 1;
+				m_CursorJ = 0;
+			}
+		}
+		else
+		{
+			hasImproved = TryOrOpt(m_CursorI, m_Phase, m_CursorJ);
+
+			if (++m_CursorJ >= nodeCount)
+			{
+				++m_CursorI;
+				m_CursorJ = 0;
+			}
+			if (m_CursorI + m_Phase > nodeCount)
+			{
+				++m_Phase;
+				m_CursorI = 1;
+				m_CursorJ = 0;
+			}
+			if (m_Phase > 3)
+			{
+				//End of a pass, stop once a whole pass didn't find anything
+				m_IsConverged = !m_HasImprovedThisPass;
+				m_HasImprovedThisPass = false;
+				m_Phase = 0;
+				m_CursorI = 1;
+				m_CursorJ = 2;
+			}
+		}
+
+		if (hasImproved)
+		{
+			m_HasImprovedThisPass = true;
+			++m_ImprovementCount;
+		}
+	}
+}
+
+bool LootRoutePlanner::TryTwoOpt(unsigned int i, unsigned int j)
+{
+	//Reverses [i, j], the tour is open so there might be nothing after j
+	const unsigned int nodeCount = static_cast<unsigned int>(m_Tour.size());
+	if (i == 0 || j <= i || j >= nodeCount)
+		return false;
+
+	const bool hasNext = j + 1 < nodeCount;
+	const float before = GetDistance(m_Tour[i - 1], m_Tour[i]) + (hasNext ? GetDistance(m_Tour[j], m_Tour[j + 1]) : 0.f);
+	const float after = GetDistance(m_Tour[i - 1], m_Tour[j]) + (hasNext ? GetDistance(m_Tour[i], m_Tour[j + 1]) : 0.f);
+	if (after >= before - 0.01f)
+		return false;
+
+	std::reverse(m_Tour.begin() + i, m_Tour.begin() + j + 1);
+	return true;
+}
+
+bool LootRoutePlanner::TryOrOpt(unsigned int i, unsigned int segmentLength, unsigned int insertAfter)
+{
+	//Moves [i, i + segmentLength) to right after insertAfter
+	const unsigned int nodeCount = static_cast<unsigned int>(m_Tour.size());
+	const unsigned int end = i + segmentLength;
+	if (i == 0 || end > nodeCount || (insertAfter + 1 >= i && insertAfter < end) || insertAfter >= nodeCount)
+		return false;
+
+	const unsigned int previous = m_Tour[i - 1];
+	const unsigned int first = m_Tour[i];
+	const unsigned int last = m_Tour[end - 1];
+	const bool hasNext = end < nodeCount;
+	const float removeGain = GetDistance(previous, first)
+		+ (hasNext ? GetDistance(last, m_Tour[end]) - GetDistance(previous, m_Tour[end]) : 0.f);
+
+	const bool hasAfterInsert = insertAfter + 1 < nodeCount;
+	const float insertCost = GetDistance(m_Tour[insertAfter], first)
+		+ (hasAfterInsert ? GetDistance(last, m_Tour[insertAfter + 1]) - GetDistance(m_Tour[insertAfter], m_Tour[insertAfter + 1]) : 0.f);
+	if (insertCost >= removeGain - 0.01f)
+		return false;
+
+	if (insertAfter < i)
+		std::rotate(m_Tour.begin() + insertAfter + 1, m_Tour.begin() + i, m_Tour.begin() + end);
+	else
+		std::rotate(m_Tour.begin() + i, m_Tour.begin() + end, m_Tour.begin() + insertAfter + 1);
+	return true;
+}
+
+void LootRoutePlanner::RestartImprovement()
+{
+	m_Phase = 0;
+	m_CursorI = 1;
+	m_CursorJ = 2;
+	m_HasImprovedThisPass = false;
+	m_IsConverged = false;
+}
+
+bool LootRoutePlanner::IsSameStop(const Stop& a, const Stop& b)
+{
+	if (a.house != -1 || b.house != -1)
+		return a.house == b.house;
+
+	return a.item.Location == b.item.Location;
+}
+
+float LootRoutePlanner::GetLegCost(const WorldSnapshot& world, GridDistanceOracle& distanceOracle, const Elite::Vector2& from, const Elite::Vector2& to)
+{
+	//The danger is taken along the straight line, the walking path usually stays close to it
+	return distanceOracle.GetDistance(from, to) + DangerDistance * world.GetPathDanger(from, to);
+}
@@ -0,0 +1,82 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// LootRoutePlanner.h: Keeps a short tour over the items we need & the houses worth a visit
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "EProfiler.h"
+#include "ETimeSlicing.h"
+
+class GridDistanceOracle;
+struct WorldSnapshot;
+
+//-----------------------------------------------------------------
+// LOOT ROUTE PLANNER
+//-----------------------------------------------------------------
+// Stops are the remembered items we still need and the houses worth a visit, gathered
+// from a world snapshot. Planning only needs a snapshot & the distance oracle, so all
+// of it can run on the planning thread. The tour starts at the agent
+// and is seeded with nearest neighbour,
+// then improved with 2-opt and Or-opt moves as a budgeted job, resuming where the
+// previous tick stopped. The tour is valid after every step. When the stops change the previous order
+// is kept and new stops are inserted where they're cheapest (warm start).
+// A leg costs its walking distance plus DangerDistance per unit of danger the snapshot's
+// influence map puts on its straight line. The legs from the agent are costed again with
+// every snapshot, the ones between stops when the stops change.
+class LootRoutePlanner final : public Elite::IBudgetedJob
+{
+public:
+	static const unsigned int MaxStops = 24;
+	static const unsigned int MovesPerStep = 16;
+	static constexpr float DangerDistance = 10.f; //Meters of detour worth one unit of path danger, walking past a zombie is about 4
+
+	struct Stop
+	{
+		Elite::Vector2 position;
+		int house; //-1 for items
+		ItemInfo item;
+	};
+
+	//The closest MaxStops stops worth going to
+	static void GatherStops(const WorldSnapshot& world, std::vector<Stop>& stops);
+
+	void Update(const WorldSnapshot& world, const std::vector<Stop>& stops, GridDistanceOracle& distanceOracle);
+
+	//Improvement, done once a whole pass over the moves found nothing
+	bool IsDone() const override { return m_IsConverged; }
+	void Step() override;
+
+	//Stops in the order they'll be visited
+	void GetTour(std::vector<Stop>& tour) const;
+
+	unsigned int GetStopCount() const { return static_cast<unsigned int>(m_Stops.size()); }
+	unsigned int GetImprovementCount() const { return m_ImprovementCount; }
+	const Elite::SampleStats& GetUpdateStats() const { return m_UpdateStats; }
+
+private:
+	std::vector<Stop> m_Stops = {};
+	std::vector<Stop> m_Candidates = {};
+	std::vector<unsigned int> m_Tour = {}; //Node 0 is the agent, the others index m_Stops + 1
+	std::vector<float> m_Distances = {}; //Leg costs, (stops + 1)^2, row & column 0 are the agent
+
+	//Improvement cursor, survives between ticks
+	unsigned int m_Phase = 0; //0: 2-opt, 1..3: Or-opt with segments of that length
+	unsigned int m_CursorI = 1;
+	unsigned int m_CursorJ = 2;
+	bool m_HasImprovedThisPass = false;
+	bool m_IsConverged = true;
+
+	unsigned int m_ImprovementCount = 0;
+	Elite::SampleStats m_UpdateStats{};
+
+	bool HaveStopsChanged() const;
+	void Rebuild(const WorldSnapshot& world, GridDistanceOracle& distanceOracle);
+	bool TryTwoOpt(unsigned int i, unsigned int j);
+	bool TryOrOpt(unsigned int i, unsigned int segmentLength, unsigned int insertAfter);
+	void RestartImprovement();
+
+	float GetDistance(unsigned int from, unsigned int to) const { return m_Distances[from * (m_Stops.size() + 1) + to]; }
+	static bool IsSameStop(const Stop& a, const Stop& b);
+	static float GetLegCost(const WorldSnapshot& world, GridDistanceOracle& distanceOracle, const Elite::Vector2& from, const Elite::Vector2& to);
+};
@@ -0,0 +1,325 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "ObstacleAvoidance.h"
+
+namespace
+{
+	//Slab test of the ray [origin, origin + direction * maxFraction] against a box
+	bool RayOverlapsBox(const Elite::Vector2& origin, const Elite::Vector2& direction, float maxFraction,
+		const Elite::Vector2& min, const Elite::Vector2& max)
+	{
+		float tMin = 0.f;
+		float tMax = maxFraction;
+
+		const float origins[2] = { origin.x, origin.y };
+		const float directions[2] = { direction.x, direction.y };
+		const float mins[2] = { min.x, min.y };
+		const float maxs[2] = { max.x, max.y };
+
+		for (int axis = 0; axis < 2; ++axis)
+		{
+			if (abs(directions[axis]) < FLT_EPSILON)
+			{
+				if (origins[axis] < mins[axis] || origins[axis] > maxs[axis])
+					return false;
+				continue;
+			}
+
+			const float inverse = 1.f / directions[axis];
+			float t1 = (mins[axis] - origins[axis]) * inverse;
+			float t2 = (maxs[axis] - origins[axis]) * inverse;
+			if (t1 > t2)
+				std::swap(t1, t2);
+
+			tMin = std::max(tMin, t1);
+			tMax = std::min(tMax, t2);
+			if (tMin > tMax)
+				return false;
+		}
+		return true;
+	}
+}
+
+//-----------------------------------------------------------------
+// WALL TREE
+//-----------------------------------------------------------------
+void WallTree::Build(const std::vector<Segment>& segments)
+{
+	m_Segments = segments;
+	m_Nodes.clear();
+	if (m_Segments.empty())
+		return;
+
+	m_Nodes.reserve(2 * m_Segments.size());
+	BuildNode(0, static_cast<unsigned int>(m_Segments.size()), 0);
+}
+
+unsigned int WallTree::BuildNode(unsigned int first, unsigned int count, unsigned int depth)
+{
+	Elite::Vector2 min{ FLT_MAX, FLT_MAX };
+	Elite::Vector2 max{ -FLT_MAX, -FLT_MAX };
+	for (unsigned int i = first; i < first + count; ++i)
+	{
+		const Segment& segment = m_Segments[i];
+		min.x = std::min(min.x, std::min(segment.start.x, segment.end.x));
+		min.y = std::min(min.y, std::min(segment.start.y, segment.end.y));
+		max.x = std::max(max.x, std::max(segment.start.x, segment.end.x));
+		max.y = std::max(max.y, std::max(segment.start.y, segment.end.y));
+	}
+
+	const unsigned int index = static_cast<unsigned int>(m_Nodes.size());
+	m_Nodes.push_back(Node{ min, max, first, count });
+
+	if (count <= MaxLeafSegments || depth + 1 >= MaxDepth)
+		return index;
+
+	//Median split on the segment centers along the longest axis
+	const bool splitOnX = (max.x - min.x) >= (max.y - min.y);
+	const unsigned int leftCount = count / 2;
+	std::nth_element(m_Segments.begin() + first, m_Segments.begin() + first + leftCount, m_Segments.begin() + first + count,
+		[splitOnX](const Segment& a, const Segment& b)
+		{
+			return splitOnX ? (a.start.x + a.end.x) < (b.start.x + b.end.x) : (a.start.y + a.end.y) < (b.start.y + b.end.y);
+		});
+
+	BuildNode(first, leftCount, depth + 1);
+	const unsigned int right = BuildNode(first + leftCount, count - leftCount, depth + 1);
+
+	m_Nodes[index].first = right;
+	m_Nodes[index].count = 0;
+	return index;
+}
+
+void WallTree::RayCast(RayPacket& packet, int ignoredHouse, int ignoredHouse2) const
+{
+	assert(packet.count <= MaxRays && "Too many rays in one packet");
+	for (unsigned int r = 0; r < packet.count; ++r)
+	{
+		packet.fractions[r] = 1.f;
+		packet.normals[r] = Elite::ZeroVector2;
+	}
+
+	if (m_Nodes.empty())
+		return;
+
+	unsigned int stack[MaxDepth];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_Nodes[stack[--stackSize]];
+
+		//Rays that already hit something closer than this box skip it
+		bool isOverlapped = false;
+		for (unsigned int r = 0; r < packet.count && !isOverlapped; ++r)
+			isOverlapped = RayOverlapsBox(packet.origin, packet.directions[r], packet.fractions[r], node.min, node.max);
+
+		if (!isOverlapped)
+			continue;
+
+		if (node.count == 0)
+		{
+			stack[stackSize++] = node.first;
+			stack[stackSize++] = static_cast<unsigned int>(&node - m_Nodes.data()) + 1;
+			continue;
+		}
+
+		for (unsigned int i = node.first; i < node.first + node.count; ++i)
+		{
+			const Segment& segment = m_Segments[i];
+			if (segment.house != -1 && (segment.house == ignoredHouse || segment.house == ignoredHouse2))
+				continue;
+
+			const Elite::Vector2 wall = segment.end - segment.start;
+			const Elite::Vector2 toWall = segment.start - packet.origin;
+
+			for (unsigned int r = 0; r < packet.count; ++r)
+			{
+				const Elite::Vector2& direction = packet.directions[r];
+				const float denominator = direction.Cross(wall);
+				if (abs(denominator) < FLT_EPSILON)
+					continue; //Parallel
+
+				const float t = toWall.Cross(wall) / denominator;
+				const float u = toWall.Cross(direction) / denominator;
+				if (t < 0.f || t >= packet.fractions[r] || u < 0.f || u > 1.f)
+					continue;
+
+				Elite::Vector2 normal{ -wall.y, wall.x };
+				normal.Normalize();
+				if (normal.Dot(direction) > 0.f)
+					normal *= -1.f;
+
+				packet.fractions[r] = t;
+				packet.normals[r] = normal;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------
+// OBSTACLE AVOIDANCE
+//-----------------------------------------------------------------
+bool ObstacleAvoidance::LoadLevel(const std::string& path)
+{
+	std::ifstream file{ path, std::ios::binary };
+	if (!file)
+	{
+		printf("ObstacleAvoidance: couldn't open %s, using discovered houses instead\n", path.c_str());
+		return false;
+	}
+
+	auto readFloat = [&file]() { float value = 0.f; file.read(reinterpret_cast<char*>(&value), sizeof(value)); return value; };
+	auto readUInt = [&file]() { unsigned int value = 0; file.read(reinterpret_cast<char*>(&value), sizeof(value)); return value; };
+	auto readVector = [&readFloat]() { const float x = readFloat(); return Elite::Vector2{ x, readFloat() }; };
+
+	std::vector<HouseInfo> houses{};
+	std::vector<WallTree::Segment> walls{};
+	std::vector<Elite::Vector2> vertices{}; //One wall's polygon, reused
+
+	readVector(); //World size
+	const unsigned int houseCount = readUInt();
+	for (unsigned int h = 0; h < houseCount && file; ++h)
+	{
+		HouseInfo house{};
+		house.Center = readVector();
+		house.Size = readVector();
+		houses.push_back(house);
+
+		const unsigned int wallCount = readUInt();
+		for (unsigned int w = 0; w < wallCount && file; ++w)
+		{
+			//Every wall is a closed polygon (a quad in practice)
+			const unsigned int vertexCount = readUInt();
+			vertices.clear();
+			for (unsigned int v = 0; v < vertexCount && file; ++v)
+				vertices.push_back(readVector());
+
+			const unsigned int edgeCount = static_cast<unsigned int>(vertices.size());
+			for (unsigned int v = 0; v < edgeCount; ++v)
+				walls.push_back(WallTree::Segment{ vertices[v], vertices[(v + 1) % edgeCount], int(h) });
+		}
+
+		//Other shapes of the house (floor outlines), not needed for avoidance
+		const unsigned int shapeCount = readUInt();
+		for (unsigned int s = 0; s < shapeCount && file; ++s)
+		{
+			const unsigned int vertexCount = readUInt();
+			file.seekg(vertexCount * 2 * sizeof(float), std::ios::cur);
+		}
+	}
+
+	if (!file || houses.empty())
+	{
+		printf("ObstacleAvoidance: %s is not a valid level, using discovered houses instead\n", path.c_str());
+		return false;
+	}
+
+	m_LevelHouses = houses;
+	m_Walls = walls;
+	m_Tree.Build(m_Walls);
+	m_IsUsingLevelGeometry = true;
+	printf("ObstacleAvoidance: loaded %u walls of %u houses from %s\n", m_Tree.GetSegmentCount(), houseCount, path.c_str());
+	return true;
+}
+
+void ObstacleAvoidance::OnHouseDiscovered(const HouseInfo& house)
+{
+	m_DiscoveredHouses.push_back(house);
+
+	if (m_IsUsingLevelGeometry)
+	{
+		const float margin = 0.5f;
+		for (const HouseInfo& levelHouse : m_LevelHouses)
+		{
+			if (DistanceSquared(levelHouse.Center, house.Center) < margin * margin)
+				return;
+		}
+
+		//The game runs on another level than the one we loaded
+		printf("ObstacleAvoidance: discovered a house that isn't in the level file, using discovered houses instead\n");
+		m_IsUsingLevelGeometry = false;
+	}
+
+	BuildFromHouseRectangles();
+}
+
+void ObstacleAvoidance::BuildFromHouseRectangles()
+{
+	m_Walls.clear();
+	for (unsigned int h = 0; h < m_DiscoveredHouses.size(); ++h)
+	{
+		const HouseInfo& house = m_DiscoveredHouses[h];
+		const Elite::Vector2 halfSize = house.Size / 2.f;
+		const Elite::Vector2 corners[4] =
+		{
+			{ house.Center.x - halfSize.x, house.Center.y - halfSize.y },
+			{ house.Center.x + halfSize.x, house.Center.y - halfSize.y },
+			{ house.Center.x + halfSize.x, house.Center.y + halfSize.y },
+			{ house.Center.x - halfSize.x, house.Center.y + halfSize.y }
+		};
+
+		for (unsigned int c = 0; c < 4; ++c)
+			m_Walls.push_back(WallTree::Segment{ corners[c], corners[(c + 1) % 4], int(h) });
+	}
+	m_Tree.Build(m_Walls);
+}
+
+int ObstacleAvoidance::FindHouse(const Elite::Vector2& position) const
+{
+	for (unsigned int h = 0; h < m_DiscoveredHouses.size(); ++h)
+	{
+		const HouseInfo& house = m_DiscoveredHouses[h];
+		if (abs(position.x - house.Center.x) <= house.Size.x / 2.f && abs(position.y - house.Center.y) <= house.Size.y / 2.f)
+			return int(h);
+	}
+	return -1;
+}
+
+Elite::Vector2 ObstacleAvoidance::CalculateSteering(const AgentInfo& agentInfo, const Elite::Vector2& target)
+{
+	Elite::ScopedTimer timer{ m_QueryStats };
+
+	if (m_Tree.GetSegmentCount() == 0)
+		return Elite::ZeroVector2;
+
+	Elite::Vector2 heading = agentInfo.LinearVelocity;
+	const float speed = heading.Magnitude();
+	if (speed < 0.1f)
+		heading = Elite::OrientationToVector(agentInfo.Orientation);
+	heading.Normalize();
+
+	//Forward feeler scales with the speed, the side feelers are shorter
+	const float feelerLength = agentInfo.AgentSize * 2.f + speed * 0.75f;
+	const float angles[5] = { 0.f, Elite::ToRadians(30.f), -Elite::ToRadians(30.f), Elite::ToRadians(60.f), -Elite::ToRadians(60.f) };
+	const float lengths[5] = { 1.f, 0.75f, 0.75f, 0.5f, 0.5f };
+
+	WallTree::RayPacket packet{};
+	packet.origin = agentInfo.Position;
+	packet.count = 5;
+	for (unsigned int r = 0; r < packet.count; ++r)
+	{
+		const float c = cosf(angles[r]);
+		const float s = sinf(angles[r]);
+		packet.directions[r] = Elite::Vector2{ heading.x * c - heading.y * s, heading.x * s + heading.y * c } * (feelerLength * lengths[r]);
+	}
+
+	//House rectangles have no doors, don't block the house we're in or the one we want to get in
+	const int ignoredHouse = m_IsUsingLevelGeometry ? -1 : FindHouse(agentInfo.Position);
+	const int ignoredHouse2 = m_IsUsingLevelGeometry ? -1 : FindHouse(target);
+	m_Tree.RayCast(packet, ignoredHouse, ignoredHouse2);
+
+	//Push away from every wall a feeler went into, harder the deeper it went
+	Elite::Vector2 avoidance{};
+	for (unsigned int r = 0; r < packet.count; ++r)
+		avoidance += packet.normals[r] * (1.f - packet.fractions[r]);
+
+	avoidance *= agentInfo.MaxLinearSpeed;
+	if (avoidance.Magnitude() > agentInfo.MaxLinearSpeed)
+	{
+		avoidance.Normalize();
+		avoidance *= agentInfo.MaxLinearSpeed;
+	}
+	return avoidance;
+}
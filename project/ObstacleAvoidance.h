@@ -0,0 +1,92 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// ObstacleAvoidance.h: Wall bounding volume tree & feeler based avoidance steering
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "EProfiler.h"
+
+//-----------------------------------------------------------------
+// WALL TREE
+//-----------------------------------------------------------------
+// Static AABB tree over wall segments, stored as a flat array in depth first order.
+// Building allocates, querying never does: traversal uses a fixed stack and a whole
+// packet of feeler rays is tested against every node in one pass.
+class WallTree final
+{
+public:
+	static const unsigned int MaxRays = 8;
+
+	struct Segment
+	{
+		Elite::Vector2 start;
+		Elite::Vector2 end;
+		int house; //Index of the house the wall belongs to, -1 if none
+	};
+
+	//Rays share the origin, a fraction of 1 means nothing was hit
+	struct RayPacket
+	{
+		Elite::Vector2 origin = {};
+		Elite::Vector2 directions[MaxRays] = {}; //Scaled to the length of the ray
+		unsigned int count = 0;
+
+		float fractions[MaxRays] = {};
+		Elite::Vector2 normals[MaxRays] = {}; //Facing the origin
+	};
+
+	void Build(const std::vector<Segment>& segments);
+	void RayCast(RayPacket& packet, int ignoredHouse = -1, int ignoredHouse2 = -1) const;
+
+	unsigned int GetSegmentCount() const { return static_cast<unsigned int>(m_Segments.size()); }
+
+private:
+	struct Node
+	{
+		Elite::Vector2 min;
+		Elite::Vector2 max;
+		unsigned int first; //Leaf: first segment, internal: index of the right child (left is the next node)
+		unsigned int count; //0 for internal nodes
+	};
+
+	static const unsigned int MaxLeafSegments = 4;
+	static const unsigned int MaxDepth = 64;
+
+	std::vector<Node> m_Nodes = {};
+	std::vector<Segment> m_Segments = {};
+
+	unsigned int BuildNode(unsigned int first, unsigned int count, unsigned int depth);
+};
+
+//-----------------------------------------------------------------
+// OBSTACLE AVOIDANCE
+//-----------------------------------------------------------------
+// Walls come from the level file when it matches the houses we see, otherwise
+// from the discovered house rectangles. Rectangles have no doors, so the walls of
+// the house we're in or heading to are ignored.
+class ObstacleAvoidance final
+{
+public:
+	bool LoadLevel(const std::string& path);
+	void OnHouseDiscovered(const HouseInfo& house);
+
+	//Returns the avoidance velocity, zero when the way ahead is clear
+	Elite::Vector2 CalculateSteering(const AgentInfo& agentInfo, const Elite::Vector2& target);
+
+	bool IsUsingLevelGeometry() const { return m_IsUsingLevelGeometry; }
+	unsigned int GetWallCount() const { return m_Tree.GetSegmentCount(); }
+	const std::vector<WallTree::Segment>& GetWalls() const { return m_Walls; }
+	const Elite::SampleStats& GetQueryStats() const { return m_QueryStats; }
+
+private:
+	WallTree m_Tree{};
+	std::vector<HouseInfo> m_LevelHouses = {};
+	std::vector<HouseInfo> m_DiscoveredHouses = {};
+	std::vector<WallTree::Segment> m_Walls = {};
+	bool m_IsUsingLevelGeometry = false;
+	Elite::SampleStats m_QueryStats{};
+
+	void BuildFromHouseRectangles();
+	int FindHouse(const Elite::Vector2& position) const;
+};
@@ -2,26 +2,41 @@
 #include "Plugin.h"
 #include "IExamInterface.h"
 
+const unsigned int Plugin::CheckpointVersion;
+
 //Called only once, during initialization
 void Plugin::Initialize(IBaseInterface* pInterface, PluginInfo& info)
 {
 	//Retrieving the interface
 	//This interface gives you access to certain actions the AI_Framework can perform for you
 	m_pInterface = static_cast<IExamInterface*>(pInterface);
+	m_pCachedInterface = new CachedExamInterface(m_pInterface);
 
 	info.BotName = "BestBot";
 	info.Student_FirstName = "Henri-Thibault";
 	info.Student_LastName = "Huyghe";
 	info.Student_Class = "2DAE01";
 
+	// Walls to avoid, the houses we discover are used when the level file doesn't match
+	if (!m_ObstacleAvoidance.LoadLevel(LEVEL_FILE))
+	{
+		printf("WARNING: No walls from %s, avoidance only knows the houses discovered so far\n", LEVEL_FILE);
+	}
+	m_BackgroundPlanner.SetWalls(m_pInterface->World_GetInfo(), m_ObstacleAvoidance.GetWalls());
+	m_ItemMemory.Initialize(m_pInterface->World_GetInfo());
+	InitializeCoverage(m_pInterface->World_GetInfo());
+	InitializeInfluenceMap(m_pInterface->World_GetInfo());
+
 	m_pBlackboard = new Blackboard();
-	m_pBlackboard->AddData("SteeringOutput", SteeringPlugin_Output{});
+	m_pBlackboard->AddData("SteeringPipeline", &m_SteeringPipeline);
 	m_pBlackboard->AddData("IsRunning", false);
 	m_pBlackboard->AddData("StrafeInfo", StrafeInfo{});
 	m_pBlackboard->AddData("Target", Elite::Vector2{0,0});
-	m_pBlackboard->AddData("PluginInterface", m_pInterface);
+	m_pBlackboard->AddData("PluginInterface", static_cast<IExamInterface*>(m_pCachedInterface));
 	m_pBlackboard->AddData("WorldInfo", m_pInterface->World_GetInfo());
 	m_pBlackboard->AddData("AgentInfo", m_pInterface->Agent_GetInfo());
+	m_AgentFrame.Update(m_pInterface->Agent_GetInfo());
+	m_pBlackboard->AddData("AgentFrame", static_cast<const AgentFrame*>(&m_AgentFrame));
 
 	// Exploring & Houses
 	m_pBlackboard->AddData("ExpandingSquareSearchData", ExpandingSearchData{ 25.f, 0, {0,0} });
@@ -35,190 +50,435 @@ void Plugin::Initialize(IBaseInterface* pInterface, PluginInfo& info)
 	m_pBlackboard->AddData("ItemsInFOV", &m_ItemsInFOV);
 	m_pBlackboard->AddData("EnemiesInFOV", &m_EnemiesInFOV);
 	m_pBlackboard->AddData("PurgeZonesInFOV", &m_PurgeZoneInFOV);
-	m_pBlackboard->AddData("DangerousPurgeZone", &m_DangerousPurgeZone);
+	m_pBlackboard->AddData("PurgeZoneMemory", &m_PurgeZoneMemory);
+	m_pBlackboard->AddData("InfluenceMap", static_cast<const InfluenceMap*>(&m_InfluenceMap));
+	m_pBlackboard->AddData("LootRoute", &m_BackgroundPlanner.AcquireLootRoute());
+	m_pBlackboard->AddData("HouseRegistry", &m_HouseRegistry);
 
 	// Inventory
-	m_DesiredInventoryCounts.maxGuns = 2;
-	m_DesiredInventoryCounts.maxMedkits = 2;
-	m_DesiredInventoryCounts.maxFood = 1;
-	m_DesiredInventoryCounts.inventorySlots.resize(m_pInterface->Inventory_GetCapacity());
+	m_Inventory.Initialize(m_pCachedInterface, 2, 2, 1); // guns, medkits, food
 
-	m_pBlackboard->AddData("Inventory", &m_DesiredInventoryCounts);
+	m_pBlackboard->AddData("Inventory", &m_Inventory);
 	m_pBlackboard->AddData("MedkitToUse", -1);
-	m_pBlackboard->AddData("GunToUse", -1);
+	m_pBlackboard->AddData("FoodToUse", -1);
 	m_pBlackboard->AddData("GarbageSeen", ItemInfo{});
 	m_pBlackboard->AddData("ItemMemory", &m_ItemMemory);
+	m_pBlackboard->AddData("WorldModel", &m_WorldModel);
+	m_pBlackboard->AddData("WorldSnapshot", &m_WorldModel.GetLatest());
 	m_pBlackboard->AddData("ItemFetchMaxRange", 75.f);
 	m_pBlackboard->AddData("ItemBeingFetched", ItemInfo{});
 
-	m_pBehaviorTree = new BehaviorTree(m_pBlackboard,
+#if defined(USE_UTILITY_AI)
+	m_pDecisionMaking = CreateUtilityDecisionMaker(m_pBlackboard);
+#elif defined(USE_STATE_MACHINE)
+	m_pDecisionMaking = CreateStateMachine(m_pBlackboard);
+#else
+	m_pDecisionMaking = CreateBehaviorTree(m_pBlackboard);
+#endif
+
+	CreateTickPhases();
+
+	m_RestoreScratch.inventory = m_Inventory;
+	m_RestoreScratch.itemMemory = m_ItemMemory;
+	m_RestoreScratch.houseRegistry = m_HouseRegistry;
+	m_RestoreScratch.purgeZoneMemory = m_PurgeZoneMemory;
+	m_RestoreScratch.influenceMap = m_InfluenceMap;
+}
+
+#pragma region Decision Making
+Elite::IDecisionMaking* Plugin::CreateBehaviorTree(Blackboard* pBlackboard)
+{
+	return new BehaviorTree(pBlackboard,
 		new BehaviorSelector(
 			{
-#pragma region Item Use
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(IsHurt),
-						new BehaviorConditional(ShouldUseMedkit),
-						new BehaviorAction(UseMedkit)
-					}
-				),
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(IsHungry),
-						new BehaviorConditional(ShouldEat),
-						new BehaviorAction(UseFood)
-					}
-				),
-#pragma endregion
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(IsInPurgeZone),
-						new BehaviorAction(LeavePurgeZone),
-					}
-				),
-#pragma region Zombie Killing
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(IsZombieInFOV),
-						new BehaviorSelector(
-							{
-								new BehaviorSequence(
-									{
-										new BehaviorConditional(IsArmed),
-										new BehaviorSelector(
-											{
-												new BehaviorSequence(
-													{
-														new BehaviorConditional(IsFacingEnemy),
-														new BehaviorAction(Shoot)
-													}
-												),
-												new BehaviorSequence(
-													{
-														new BehaviorInvertedConditional(IsFacingEnemy),
-														new BehaviorAction(SetEnemyAsTarget),
-														new BehaviorAction(Face)
-													}
-												)
-											}
-										)
-									}
-								)
-							}
-						),
-						
-					}
-				),
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(IsStrafing),
-						new BehaviorAction(StrafeAndTurn)
-					}
-				),
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(WasBitten),
-						new BehaviorInvertedConditional(IsZombieInFOV),
-						new BehaviorConditional(IsArmed),
-						new BehaviorAction(StrafeAndTurn)
-					}
-				),
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(WasBitten),
-						new BehaviorInvertedConditional(IsArmed),
-						new BehaviorAction(ToggleRun),
-						new BehaviorAction(Flee)
-					}
-				),
-
-#pragma endregion				
-#pragma region Looting
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(SeesItem),
-						new BehaviorAction(PickupItem),
-						new BehaviorAction(Seek)
-					}
-				),
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(SeesGarbage),
-						new BehaviorSelector(
-							{
-								new BehaviorSequence(
-									{
-										new BehaviorConditional(GarbageIsInGrabRange),
-										new BehaviorAction(DestroyGarbageInRange)
-									}
-								),
-								new BehaviorSequence(
-									{
-										new BehaviorInvertedConditional(GarbageIsInGrabRange),
-										new BehaviorAction(SetGarbageAsTarget),
-										new BehaviorAction(Seek)
-									}
-								),
-							}
-						),
-						
-					}
-				),
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(IsInNeedOfItem),
-						new BehaviorConditional(IsANeededItemClose),
-						new BehaviorAction(SetNeededItemAsTarget),
-						new BehaviorAction(Seek)
-					}
-				),
-#pragma endregion
-#pragma region House
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(IsGoingTohouse),
-						new BehaviorAction(Seek)
-					}
-				),
-				new BehaviorSequence(
-					{
-						new BehaviorConditional(IsNewHouseDiscovered),
-						new BehaviorAction(Seek)
-					}
-				),
-#pragma endregion
-#pragma region Exploration
-				new BehaviorSequence(
-					{
-						new BehaviorInvertedConditional(IsDoneExploring),
-						new BehaviorAction(ExpandingSquareSearch),
-						new BehaviorAction(Seek)
-					}
-				),
-				new BehaviorSequence(
-					{
-						new BehaviorAction(SetHouseAsTarget),
-						new BehaviorAction(Seek)
-					}
-				)
-#pragma endregion
+				CreateHealBehavior(),
+				CreateEatBehavior(),
+				CreateLeavePurgeZoneBehavior(),
+				CreateCombatBehavior(),
+				CreateLootBehavior(),
+				CreateHouseBehavior(),
+				CreateExploreBehavior(),
+				CreateRevisitHouseBehavior()
 			}
 		)
 	);
 }
 
+Elite::IDecisionMaking* Plugin::CreateUtilityDecisionMaker(Blackboard* pBlackboard)
+{
+	enum Considerations
+	{
+		eDamageTaken, eHasUsableMedkit, eEnergyMissing, eHasUsableFood,
+		ePurgeZoneDanger, eZombieThreat, eLootOpportunity, eExplorationLeft, eKnownHouses
+	};
+
+	std::vector<Consideration> considerations =
+	{
+		DamageTaken, HasUsableMedkit, EnergyMissing, HasUsableFood,
+		PurgeZoneDanger, ZombieThreat, LootOpportunity, ExplorationLeft, KnownHouses
+	};
+
+	const ResponseCurve isTrue = ResponseCurve::CreateStep();
+	const ResponseCurve urgency = ResponseCurve::CreateLinear(0.5f, 0.5f); // any need counts, a bigger need counts more
+
+	std::vector<UtilityAction> actions =
+	{
+		{ "Flee Purge Zone", 1.0f, { { ePurgeZoneDanger, isTrue } }, CreateLeavePurgeZoneBehavior() },
+		{ "Heal", 0.9f, { { eHasUsableMedkit, isTrue }, { eDamageTaken, urgency } }, CreateHealBehavior() },
+		{ "Eat", 0.85f, { { eHasUsableFood, isTrue }, { eEnergyMissing, urgency } }, CreateEatBehavior() },
+		{ "Fight", 0.8f, { { eZombieThreat, ResponseCurve::CreateLinear() } }, CreateCombatBehavior() },
+		{ "Loot", 0.6f, { { eLootOpportunity, ResponseCurve::CreateLinear() } }, CreateLootBehavior() },
+		{ "Explore", 0.4f, { { eExplorationLeft, isTrue } },
+			new BehaviorSelector({ CreateHouseBehavior(), CreateExploreBehavior() }) },
+		{ "Revisit House", 0.2f, { { eKnownHouses, isTrue } }, CreateRevisitHouseBehavior() }
+	};
+
+	return new UtilityDecisionMaker(pBlackboard, considerations, actions);
+}
+
+Elite::IDecisionMaking* Plugin::CreateStateMachine(Blackboard* pBlackboard)
+{
+	FiniteStateMachine* pStateMachine = new FiniteStateMachine(pBlackboard);
+
+	// Item use doesn't steer, so it runs on top of whatever mode we're in
+	const FSMStateId alive = pStateMachine->AddState("Alive", InvalidFSMState,
+		new BehaviorSelector({ CreateHealBehavior(), CreateEatBehavior() }));
+
+	const FSMStateId normal = pStateMachine->AddState("Normal", alive);
+	const FSMStateId wander = pStateMachine->AddState("Wander", normal,
+		new BehaviorSelector({ CreateHouseBehavior(), CreateExploreBehavior(), CreateRevisitHouseBehavior() }));
+	const FSMStateId loot = pStateMachine->AddState("Loot", normal, CreateLootBehavior());
+
+	const FSMStateId leavePurgeZone = pStateMachine->AddState("Leave Purge Zone", alive, new BehaviorAction(LeavePurgeZone));
+	const FSMStateId combat = pStateMachine->AddState("Combat", alive, CreateCombatBehavior());
+	const FSMStateId strafe = pStateMachine->AddState("Strafe", alive, new BehaviorAction(StrafeAndTurn));
+	const FSMStateId evade = pStateMachine->AddState("Evade", alive,
+		new BehaviorSequence({ new BehaviorAction(ToggleRun), new BehaviorAction(Flee) }));
+
+	auto isArmedAndSeesZombie = [](Blackboard* pBB) { return IsZombieInFOV(pBB) && IsArmed(pBB); };
+	auto wasBittenByUnseenZombie = [](Blackboard* pBB) { return WasBitten(pBB) && !IsZombieInFOV(pBB) && IsArmed(pBB); };
+	auto wasBittenUnarmed = [](Blackboard* pBB) { return WasBitten(pBB) && !IsArmed(pBB); };
+
+	// a purge zone interrupts every mode
+	pStateMachine->AddTransition(alive, leavePurgeZone, IsInPurgeZone);
+	pStateMachine->AddTransition(leavePurgeZone, normal, [](Blackboard* pBB) { return !IsInPurgeZone(pBB); });
+
+	pStateMachine->AddTransition(normal, combat, isArmedAndSeesZombie);
+	pStateMachine->AddTransition(normal, strafe, wasBittenByUnseenZombie);
+	pStateMachine->AddTransition(normal, evade, wasBittenUnarmed);
+	pStateMachine->AddTransition(wander, loot, [](Blackboard* pBB) { return LootOpportunity(pBB) > 0.f; });
+	pStateMachine->AddTransition(loot, wander, [](Blackboard* pBB) { return LootOpportunity(pBB) <= 0.f; });
+
+	pStateMachine->AddTransition(combat, normal, [](Blackboard* pBB) { return !IsZombieInFOV(pBB) || !IsArmed(pBB); });
+	// the strafe is a multi tick mode, it only ends when the turn is done
+	pStateMachine->AddTransition(strafe, combat, isArmedAndSeesZombie);
+	pStateMachine->AddTransition(strafe, normal, [](Blackboard* pBB) { return !IsStrafing(pBB); });
+	pStateMachine->AddTransition(evade, normal, [](Blackboard* pBB) { return !WasBitten(pBB); });
+
+	pStateMachine->SetStartState(normal);
+	return pStateMachine;
+}
+
+Elite::IBehavior* Plugin::CreateHealBehavior()
+{
+	return new BehaviorSequence(
+		{
+			new BehaviorConditional(IsHurt),
+			new BehaviorConditional(ShouldUseMedkit),
+			new BehaviorAction(UseMedkit)
+		}
+	);
+}
+
+Elite::IBehavior* Plugin::CreateEatBehavior()
+{
+	return new BehaviorSequence(
+		{
+			new BehaviorConditional(IsHungry),
+			new BehaviorConditional(ShouldEat),
+			new BehaviorAction(UseFood)
+		}
+	);
+}
+
+Elite::IBehavior* Plugin::CreateLeavePurgeZoneBehavior()
+{
+	return new BehaviorSequence(
+		{
+			new BehaviorConditional(IsInPurgeZone),
+			new BehaviorAction(LeavePurgeZone),
+			// with a zombie in sight, fall through so combat can face & shoot while we flee
+			new BehaviorInvertedConditional(IsZombieInFOV)
+		}
+	);
+}
+
+Elite::IBehavior* Plugin::CreateCombatBehavior()
+{
+	return new BehaviorSelector(
+		{
+			new BehaviorSequence(
+				{
+					new BehaviorConditional(IsZombieInFOV),
+					new BehaviorConditional(IsArmed),
+					new BehaviorSelector(
+						{
+							new BehaviorSequence(
+								{
+									new BehaviorConditional(IsFacingEnemy),
+									new BehaviorAction(Shoot)
+								}
+							),
+							new BehaviorSequence(
+								{
+									new BehaviorInvertedConditional(IsFacingEnemy),
+									new BehaviorAction(SetEnemyAsTarget),
+									new BehaviorAction(Face)
+								}
+							)
+						}
+					)
+				}
+			),
+			new BehaviorSequence(
+				{
+					new BehaviorConditional(IsStrafing),
+					new BehaviorAction(StrafeAndTurn)
+				}
+			),
+			new BehaviorSequence(
+				{
+					new BehaviorConditional(WasBitten),
+					new BehaviorInvertedConditional(IsZombieInFOV),
+					new BehaviorConditional(IsArmed),
+					new BehaviorAction(StrafeAndTurn)
+				}
+			),
+			new BehaviorSequence(
+				{
+					new BehaviorConditional(WasBitten),
+					new BehaviorInvertedConditional(IsArmed),
+					new BehaviorAction(ToggleRun),
+					new BehaviorAction(Flee)
+				}
+			)
+		}
+	);
+}
+
+Elite::IBehavior* Plugin::CreateLootBehavior()
+{
+	return new BehaviorSelector(
+		{
+			new BehaviorSequence(
+				{
+					new BehaviorConditional(SeesItem),
+					new BehaviorAction(PickupItem),
+					new BehaviorAction(Seek)
+				}
+			),
+			new BehaviorSequence(
+				{
+					new BehaviorConditional(SeesGarbage),
+					new BehaviorSelector(
+						{
+							new BehaviorSequence(
+								{
+									new BehaviorConditional(GarbageIsInGrabRange),
+									new BehaviorAction(DestroyGarbageInRange)
+								}
+							),
+							new BehaviorSequence(
+								{
+									new BehaviorInvertedConditional(GarbageIsInGrabRange),
+									new BehaviorAction(SetGarbageAsTarget),
+									new BehaviorAction(Seek)
+								}
+							),
+						}
+					),
+				}
+			),
+			// fetches what we need from memory, finding new items is left to the house & explore behaviors
+			CreateGoapBehavior()
+		}
+	);
+}
+
+Elite::IBehavior* Plugin::CreateGoapBehavior()
+{
+	GoapPlanner* pPlanner = new GoapPlanner();
+
+	// fetching is optimistic about filling the slot, the plan gets repaired when there's still room after a pickup
+	pPlanner->AddAction({ "Fetch Gun", 2.f, { eKnowsGun | eNeedsGun, eKnowsGun | eNeedsGun }, eHoldsGun, eNeedsGun, GoapFetchGun });
+	pPlanner->AddAction({ "Fetch Medkit", 2.f, { eKnowsMedkit | eNeedsMedkit, eKnowsMedkit | eNeedsMedkit }, eHoldsMedkit, eNeedsMedkit, GoapFetchMedkit });
+	pPlanner->AddAction({ "Fetch Food", 2.f, { eKnowsFood | eNeedsFood, eKnowsFood | eNeedsFood }, eHoldsFood, eNeedsFood, GoapFetchFood });
+	pPlanner->AddAction({ "Use Medkit", 1.f, { eHoldsMedkit | eBadlyHurt, eHoldsMedkit | eBadlyHurt }, 0, eBadlyHurt | eHoldsMedkit, GoapUseMedkit });
+	pPlanner->AddAction({ "Eat", 1.f, { eHoldsFood | eStarving, eHoldsFood | eStarving }, 0, eStarving | eHoldsFood, GoapEat });
+
+	// same order as the GoapGoal enum
+	pPlanner->AddGoal({ eBadlyHurt, 0 });
+	pPlanner->AddGoal({ eStarving, 0 });
+	pPlanner->AddGoal({ eNeedsGun, 0 });
+	pPlanner->AddGoal({ eNeedsMedkit, 0 });
+	pPlanner->AddGoal({ eNeedsFood, 0 });
+
+	return new BehaviorGoap(pPlanner, SelectGoapGoal, GetGoapWorldState);
+}
+
+Elite::IBehavior* Plugin::CreateHouseBehavior()
+{
+	return new BehaviorSelector(
+		{
+			new BehaviorSequence(
+				{
+					new BehaviorConditional(IsGoingTohouse),
+					new BehaviorAction(Seek)
+				}
+			),
+			new BehaviorSequence(
+				{
+					new BehaviorConditional(IsNewHouseDiscovered),
+					new BehaviorAction(Seek)
+				}
+			)
+		}
+	);
+}
+
+Elite::IBehavior* Plugin::CreateExploreBehavior()
+{
+	return new BehaviorSequence(
+		{
+			new BehaviorInvertedConditional(IsDoneExploring),
+			new BehaviorAction(ExpandingSquareSearch),
+			new BehaviorAction(Seek)
+		}
+	);
+}
+
+Elite::IBehavior* Plugin::CreateRevisitHouseBehavior()
+{
+	return new BehaviorSequence(
+		{
+			new BehaviorConditional(KnowsAHouse),
+			new BehaviorAction(SetHouseAsTarget),
+			new BehaviorAction(Seek)
+		}
+	);
+}
+#pragma endregion
+
 //Called only once
 void Plugin::DllInit()
 {
 	//Called when the plugin is loaded
+	m_BackgroundPlanner.Start();
+
+	// the tick thread & the background planner already have a core each
+	const unsigned int coreCount = std::thread::hardware_concurrency();
+	m_JobSystem.Start(coreCount > 2 ? coreCount - 2 : 0);
 }
 
 //Called only once
 void Plugin::DllShutdown()
 {
 	//Called wheb the plugin gets unloaded
+#if defined(PRINT_DECISION_MAKING_REPORT)
+	if (!m_IsReportPrinted)
+	{
+		PrintDecisionMakingReport(false); // the world might already be gone
+	}
+#endif
+	m_BackgroundPlanner.Stop();
+#if defined(PRINT_DECISION_MAKING_REPORT)
+	m_BackgroundPlanner.PrintReport(); // planning thread stats, safe to read once it's joined
+#endif
+	m_JobSystem.Stop();
+#if defined(DUMP_JOURNAL_ON_SHUTDOWN)
+	if (m_pBlackboard && !m_pBlackboard->GetJournal().Dump("BlackboardJournal.bin"))
+	{
+		printf("WARNING: Couldn't write the blackboard journal\n");
+	}
+#endif
+	SAFE_DELETE(m_pDecisionMaking); // also deletes the blackboard
+	SAFE_DELETE(m_pCachedInterface);
 }
 
+#pragma region Checkpoints
+void Plugin::SaveCheckpoint(std::vector<unsigned char>& blob) const
+{
+	// what's in sight & the interface cache are rebuilt every tick, the background planner replans from the next snapshot
+	Elite::CheckpointWriter writer{ blob };
+	writer.WriteTag("BOTC");
+	writer.Write(CheckpointVersion);
+	writer.Write(m_Time);
+	writer.Write(m_AgentInfo);
+	writer.WriteArray(m_DiscoveredHouses);
+	m_pBlackboard->SaveState(writer);
+	m_pDecisionMaking->SaveState(writer);
+	m_Inventory.SaveState(writer);
+	m_ItemMemory.SaveState(writer);
+	m_HouseRegistry.SaveState(writer);
+	m_PurgeZoneMemory.SaveState(writer);
+	m_InfluenceMap.SaveState(writer);
+}
+
+bool Plugin::RestoreCheckpoint(const unsigned char* pData, size_t size)
+{
+	// everything is read into the scratch memories & checked first, the bot only changes once the whole checkpoint fits
+	Elite::CheckpointReader reader{ pData, size };
+	unsigned int version = 0;
+	if (!reader.ReadTag("BOTC") || !reader.Read(version) || version != CheckpointVersion)
+	{
+		printf("WARNING: Checkpoint isn't version %u of this plugin's, nothing was restored\n", CheckpointVersion);
+		return false;
+	}
+
+	float time = 0.f;
+	AgentInfo agentInfo{};
+	RestoreScratch& scratch = m_RestoreScratch;
+	bool isValid = reader.Read(time)
+		&& reader.Read(agentInfo)
+		&& reader.ReadArray(scratch.discoveredHouses)
+		&& m_pBlackboard->ReadState(reader, scratch.blackboardState);
+
+	// the decision maker can't be copied, it's checked on a copy of the reader & loaded last
+	const Elite::CheckpointReader decisionMakingReader = reader;
+	isValid = isValid
+		&& m_pDecisionMaking->ValidateState(reader)
+		&& scratch.inventory.LoadState(reader)
+		&& scratch.itemMemory.LoadState(reader)
+		&& scratch.houseRegistry.LoadState(reader)
+		&& scratch.purgeZoneMemory.LoadState(reader)
+		&& scratch.influenceMap.LoadState(reader)
+		&& scratch.houseRegistry.GetHouseCount() == scratch.discoveredHouses.size()
+		&& reader.IsAtEnd();
+	if (!isValid)
+	{
+		printf("WARNING: Checkpoint doesn't match this plugin, nothing was restored\n");
+		return false;
+	}
+
+	// swapped, not moved, so the scratch keeps the old buffers for the next restore
+	m_Time = time;
+	m_AgentInfo = agentInfo;
+	m_DiscoveredHouses.swap(scratch.discoveredHouses);
+	m_pBlackboard->ApplyState(scratch.blackboardState);
+	Elite::CheckpointReader loadReader = decisionMakingReader;
+	m_pDecisionMaking->LoadState(loadReader);
+	std::swap(m_Inventory, scratch.inventory);
+	std::swap(m_ItemMemory, scratch.itemMemory);
+	std::swap(m_HouseRegistry, scratch.houseRegistry);
+	std::swap(m_PurgeZoneMemory, scratch.purgeZoneMemory);
+	std::swap(m_InfluenceMap, scratch.influenceMap);
+
+	m_AgentFrame.Update(m_AgentInfo);
+	m_WorldModel.Rebuild(m_ItemMemory, m_HouseRegistry, m_PurgeZoneMemory);
+	return true;
+}
+#pragma endregion
+
 #pragma region Debug
 //Called only once, during initialization
 void Plugin::InitGameDebugParams(GameDebugParams& params)
@@ -229,12 +489,41 @@ void Plugin::InitGameDebugParams(GameDebugParams& params)
 	params.EnemyCount = 20; //How many enemies? (Default = 20)
 	params.GodMode = false; //GodMode > You can't die, can be usefull to inspect certain behaviours (Default = false)
 	params.AutoGrabClosestItem = true; //A call to Item_Grab(...) returns the closest item that can be grabbed. (EntityInfo argument is ignored)
+	params.LevelFile = LEVEL_FILE; //The same level avoidance loaded its walls from
 }
 
 //Only Active in DEBUG Mode
 //(=Use only for Debug Purposes)
 void Plugin::Update(float dt)
 {
+	if (m_pInterface->Input_IsKeyboardKeyUp(Elite::eScancode_F5))
+	{
+		SaveCheckpoint(m_Checkpoint);
+		if (!Elite::WriteCheckpointFile("BotCheckpoint.bin", m_Checkpoint))
+		{
+			printf("WARNING: Couldn't write the checkpoint\n");
+		}
+	}
+	else if (m_pInterface->Input_IsKeyboardKeyUp(Elite::eScancode_F6))
+	{
+		// the last Capacity changes, for looking at offline
+		if (!m_pBlackboard->GetJournal().Dump("BlackboardJournal.bin"))
+		{
+			printf("WARNING: Couldn't write the blackboard journal\n");
+		}
+	}
+	else if (m_pInterface->Input_IsKeyboardKeyUp(Elite::eScancode_F9))
+	{
+		// the last one saved this run, or the one on disk from an earlier run
+		if (!m_Checkpoint.empty() || Elite::ReadCheckpointFile("BotCheckpoint.bin", m_Checkpoint))
+		{
+			const Elite::ProfileClock::time_point start = Elite::ProfileClock::now();
+			const bool isRestored = RestoreCheckpoint(m_Checkpoint.data(), m_Checkpoint.size());
+			printf("Checkpoint of %u bytes %s in %.1f us\n", static_cast<unsigned int>(m_Checkpoint.size()),
+				isRestored ? "restored" : "failed to restore", Elite::ElapsedMicroseconds(start));
+		}
+	}
+
 	//Demo Event Code
 	//In the end your AI should be able to walk around without external input
 	if (m_pInterface->Input_IsMouseButtonUp(Elite::InputMouseButton::eLeft))
@@ -277,16 +566,173 @@ void Plugin::Update(float dt)
 //This function should only be used for rendering debug elements
 void Plugin::Render(float dt) const
 {
+	FlushDebugDraw();
+	RenderJournalScrubber();
+}
+
+void Plugin::InitializeCoverage(const WorldInfo& worldInfo)
+{
+	const float cellSize = 2.f;
+	const unsigned int columns = static_cast<unsigned int>(ceilf(worldInfo.Dimensions.x / cellSize));
+	const unsigned int rows = static_cast<unsigned int>(ceilf(worldInfo.Dimensions.y / cellSize));
+	m_CoverageTicks.assign(columns * rows, 0);
+	// a cell looked at for 10 seconds (at 60 ticks per second) gets the brightest color
+	m_CoverageOverlay.Initialize(worldInfo.Center - worldInfo.Dimensions / 2.f, cellSize, columns, rows,
+		0.f, 600.f, { 0.1f, 0.1f, 0.4f }, { 0.3f, 0.8f, 1.f });
+}
+
+void Plugin::UpdateCoverage()
+{
+	// only the cells around the agent can be in the FOV
+	const Vector2 origin = m_CoverageOverlay.GetOrigin();
+	const float cellSize = m_CoverageOverlay.GetCellSize();
+	const int columns = int(m_CoverageOverlay.GetColumns());
+	const int rows = int(m_CoverageOverlay.GetRows());
+	const Vector2 rangeMin = (m_AgentInfo.Position - origin) / cellSize - Vector2{ 1.f, 1.f } * (m_AgentInfo.FOV_Range / cellSize);
+	const Vector2 rangeMax = (m_AgentInfo.Position - origin) / cellSize + Vector2{ 1.f, 1.f } * (m_AgentInfo.FOV_Range / cellSize);
+	const int firstColumn = Clamp(int(rangeMin.x), 0, columns), lastColumn = Clamp(int(rangeMax.x) + 1, 0, columns);
+	const int firstRow = Clamp(int(rangeMin.y), 0, rows), lastRow = Clamp(int(rangeMax.y) + 1, 0, rows);
+
+	for (int row = firstRow; row < lastRow; ++row)
+	{
+		for (int column = firstColumn; column < lastColumn; ++column)
+		{
+			const Vector2 cellCenter = origin + Vector2{ column + 0.5f, row + 0.5f } * cellSize;
+			unsigned short& ticks = m_CoverageTicks[row * columns + column];
+			if (ticks == 0xFFFF || !m_AgentFrame.IsInFOV(cellCenter))
+				continue;
+			++ticks;
+			m_CoverageOverlay.SetValue(column, row, ticks);
+		}
+	}
+}
+
+void Plugin::InitializeInfluenceMap(const WorldInfo& worldInfo)
+{
+	m_InfluenceMap.Initialize(worldInfo);
+	// next to a heavy zombie is the brightest color
+	m_DangerOverlay.Initialize(m_InfluenceMap.GetOrigin(), InfluenceMap::CellSize, m_InfluenceMap.GetColumns(), m_InfluenceMap.GetRows(),
+		InfluenceMap::MinDanger, 2.f, { 0.4f, 0.3f, 0.1f }, { 1.f, 0.1f, 0.1f });
+}
+
+void Plugin::FillDebugDraw()
+{
+	// called at the end of every tick, nothing is drawn until Render flushes it
+	m_DebugDraw.Clear();
+
 	Vector2 targetPos{};
-	m_pBlackboard->GetData("Target", targetPos);
-	m_pInterface->Draw_SolidCircle(targetPos, .7f, { 0,0 }, { 1, 0, 0 });
-	
-	AgentInfo agentInfo{};
 	float maxFetchRange{};
-	m_pBlackboard->GetData("AgentInfo", agentInfo);
+	m_pBlackboard->GetData("Target", targetPos);
 	m_pBlackboard->GetData("ItemFetchMaxRange", maxFetchRange);
+	m_DebugDraw.AddCircle(targetPos, .7f, { 1, 0, 0 }, DebugLayer::Agent, true);
+	m_DebugDraw.AddCircle(m_AgentInfo.Position, maxFetchRange, { 1, 0, 0 }, DebugLayer::Agent);
+
+	const Vector3 itemColors[]{ { 0.9f, 0.9f, 0.2f }, { 0.2f, 0.9f, 0.2f }, { 0.9f, 0.5f, 0.1f }, { 0.5f, 0.5f, 0.5f } }; // pistol, medkit, food, garbage
+	for (unsigned int i = 0; i < m_ItemMemory.GetCount(); ++i)
+	{
+		const unsigned int type = static_cast<unsigned int>(m_ItemMemory.GetType(i));
+		m_DebugDraw.AddPoint(m_ItemMemory.GetLocation(i), 4.f, itemColors[type < 4 ? type : 3], DebugLayer::Memory);
+	}
+	for (unsigned int i = 0; i < m_PurgeZoneMemory.GetZoneCount(); ++i)
+	{
+		const PurgeZoneInfo zone = m_PurgeZoneMemory.GetZone(i);
+		m_DebugDraw.AddCircle(zone.Center, zone.Radius, { 0.8f, 0.1f, 0.8f }, DebugLayer::Memory);
+	}
 
-	m_pInterface->Draw_Circle(agentInfo.Position, maxFetchRange, { 1, 0, 0 });
+	for (unsigned int i = 0; i < m_HouseRegistry.GetHouseCount(); ++i)
+	{
+		const HouseInfo& house = m_HouseRegistry.GetHouse(i);
+		const Vector2 halfSize = house.Size / 2.f;
+		const Vector2 corners[4]{ house.Center - halfSize, { house.Center.x + halfSize.x, house.Center.y - halfSize.y },
+			house.Center + halfSize, { house.Center.x - halfSize.x, house.Center.y + halfSize.y } };
+		const bool isWorthVisiting = m_HouseRegistry.IsWorthVisiting(i, m_Time);
+		m_DebugDraw.AddPolygon(corners, 4, isWorthVisiting ? Vector3{ 0.2f, 0.8f, 1.f } : Vector3{ 0.3f, 0.3f, 0.4f }, DebugLayer::Houses);
+	}
+
+	// the segments chain into one strip
+	const LootRoutePlan* pLootRoute = nullptr;
+	m_pBlackboard->GetData("LootRoute", pLootRoute);
+	Vector2 from = m_AgentInfo.Position;
+	for (const LootRoutePlanner::Stop& stop : pLootRoute->tour)
+	{
+		m_DebugDraw.AddSegment(from, stop.position, { 0.2f, 1.f, 0.6f }, DebugLayer::Route);
+		from = stop.position;
+	}
+
+	// only the tiles the FOV touched since the last tick get meshed again
+	m_CoverageOverlay.Update();
+	m_CoverageOverlay.Draw(m_DebugDraw, DebugLayer::Grids);
+
+	// only tiles with danger in them are copied over
+	if (m_DebugDraw.IsLayerEnabled(DebugLayer::Danger))
+	{
+		m_InfluenceMap.UpdateOverlay(m_DangerOverlay);
+		m_DangerOverlay.Update();
+		m_DangerOverlay.Draw(m_DebugDraw, DebugLayer::Danger);
+	}
+}
+
+void Plugin::FlushDebugDraw() const
+{
+	// what the camera sees, the screen's y axis can point either way in the world
+	const ImVec2 displaySize = ImGui::GetIO().DisplaySize;
+	const Vector2 corner1 = m_pInterface->Debug_ConvertScreenToWorld(Vector2{ 0.f, 0.f });
+	const Vector2 corner2 = m_pInterface->Debug_ConvertScreenToWorld(Vector2{ displaySize.x, displaySize.y });
+	const Vector2 visibleMin{ std::min(corner1.x, corner2.x), std::min(corner1.y, corner2.y) };
+	const Vector2 visibleMax{ std::max(corner1.x, corner2.x), std::max(corner1.y, corner2.y) };
+	const DebugDrawBuffer::FlushStats stats = m_DebugDraw.Flush(m_pInterface, visibleMin, visibleMax);
+
+	const char* layerNames[]{ "Agent", "Memory", "Houses", "Route", "Grids", "Danger" };
+	static_assert(sizeof(layerNames) / sizeof(layerNames[0]) == size_t(DebugLayer::Count), "Every layer needs a name");
+	ImGui::Begin("Debug draw");
+	for (unsigned int layer = 0; layer < static_cast<unsigned int>(DebugLayer::Count); ++layer)
+	{
+		bool isEnabled = m_DebugDraw.IsLayerEnabled(DebugLayer(layer));
+		if (ImGui::Checkbox(layerNames[layer], &isEnabled))
+		{
+			m_DebugDraw.SetLayerEnabled(DebugLayer(layer), isEnabled);
+		}
+	}
+	ImGui::Text("%u primitives, %u culled, %u draw calls", stats.primitiveCount, stats.culledCount, stats.drawCallCount);
+	ImGui::End();
+}
+
+void Plugin::RenderJournalScrubber() const
+{
+	// the blackboard as it was at the end of any tick still in the journal, changes of that tick highlighted
+	const BlackboardJournal& journal = m_pBlackboard->GetJournal();
+	const int oldestTick = int(journal.GetOldestTick());
+	const int newestTick = int(journal.GetTick());
+	JournalScrubber& scrubber = m_JournalScrubber;
+
+	ImGui::Begin("Blackboard journal");
+	ImGui::Checkbox("Follow", &scrubber.isFollowing);
+	if (scrubber.isFollowing)
+	{
+		scrubber.tick = newestTick;
+	}
+	scrubber.tick = Clamp(scrubber.tick, oldestTick, newestTick);
+	ImGui::SliderInt("Tick", &scrubber.tick, oldestTick, newestTick);
+
+	// only formatted again when the tick or the journal changed, following applies just the new entries
+	if (journal.UpdateView(static_cast<unsigned int>(scrubber.tick), scrubber.view))
+	{
+		char text[128]{};
+		scrubber.texts.resize(journal.GetKeyCount());
+		for (unsigned int key = 0; key < journal.GetKeyCount(); ++key)
+		{
+			journal.FormatValue(scrubber.view.image, key, text, sizeof(text));
+			scrubber.texts[key] = text;
+		}
+	}
+	for (unsigned int key = 0; key < scrubber.texts.size(); ++key)
+	{
+		if (scrubber.view.isKeyChanged[key])
+			ImGui::TextColored(ImVec4{ 1.f, 0.8f, 0.2f, 1.f }, "%s: %s", journal.GetKeyName(key).c_str(), scrubber.texts[key].c_str());
+		else
+			ImGui::Text("%s: %s", journal.GetKeyName(key).c_str(), scrubber.texts[key].c_str());
+	}
+	ImGui::End();
 }
 #pragma endregion
 
@@ -295,31 +741,46 @@ void Plugin::Render(float dt) const
 SteeringPlugin_Output Plugin::UpdateSteering(float dt)
 {
 	// Reset Data
+	m_pBlackboard->GetJournal().NextTick();
+	m_pCachedInterface->BeginTick();
+	m_SteeringPipeline.BeginTick();
 	m_pBlackboard->ChangeData("IsNewHouseDiscovered", false);
 	m_pBlackboard->ChangeData("IsRunning", false);
 	m_ItemsInFOV.clear();
+	m_ItemInfosInFOV.clear();
 	m_EnemiesInFOV.clear();
 	m_PurgeZoneInFOV.clear();
 
-	AssignEntitiesInFOV();
-	AddNewItemsToMemory();
-
 	auto steering = SteeringPlugin_Output();
+	m_Time += dt;
 
-	auto agentInfo = m_pInterface->Agent_GetInfo();
-	m_pBlackboard->ChangeData("AgentInfo", agentInfo);
+	// perception, coverage & the memory updates, forked once there's enough to go around
+	m_TickPhases.Execute(m_JobSystem, m_TickEntityCount);
+	const AgentInfo agentInfo = m_AgentInfo;
+	m_pBlackboard->ChangeData("LootRoute", &m_BackgroundPlanner.AcquireLootRoute());
 
-	auto vHousesInFOV = GetHousesInFOV();
-	auto vEntitiesInFOV = GetEntitiesInFOV();
+	{
+		ScopedTimer timer{ m_DecisionMakingStats };
+		m_pDecisionMaking->Update(dt);
+	}
 
-	for (auto& houseInFOV : vHousesInFOV)
+	Elite::Vector2 target{};
+	m_pBlackboard->GetData("Target", target);
+	const Elite::Vector2 avoidance = m_ObstacleAvoidance.CalculateSteering(agentInfo, target);
+	if (avoidance != Elite::ZeroVector2)
 	{
-		AddHouseIfNew(houseInFOV);
+		m_SteeringPipeline.AddLinear(avoidance, 1.f, SteeringPriority::Critical);
 	}
 
-	m_pBehaviorTree->Update(dt);
+#if defined(PRINT_DECISION_MAKING_REPORT)
+	if (agentInfo.Death && !m_IsReportPrinted)
+	{
+		PrintDecisionMakingReport(true);
+	}
+#endif
 
-	m_pBlackboard->GetData("SteeringOutput", steering);
+	steering = m_SteeringPipeline.Resolve(agentInfo.MaxLinearSpeed, agentInfo.MaxAngularSpeed);
+	FillDebugDraw();
 
 	//Reset State
 	m_GrabItem = false; 
@@ -383,6 +844,15 @@ void Plugin::AddHouseIfNew(const HouseInfo& houseInfo)
 	if (!IsHouseInList)
 	{
 		m_DiscoveredHouses.push_back(houseInfo);
+		m_HouseRegistry.AddHouse(houseInfo);
+		m_WorldModel.AddHouse(houseInfo);
+		const bool wasUsingLevelGeometry = m_ObstacleAvoidance.IsUsingLevelGeometry();
+		m_ObstacleAvoidance.OnHouseDiscovered(houseInfo);
+		if (wasUsingLevelGeometry && !m_ObstacleAvoidance.IsUsingLevelGeometry())
+		{
+			// house rectangles have no doors, distances ignore walls from now on
+			m_BackgroundPlanner.SetWalls(m_pInterface->World_GetInfo(), {});
+		}
 		m_pBlackboard->ChangeData("IsNewHouseDiscovered", true);
 	}
 }
@@ -394,46 +864,111 @@ void Plugin::AssignEntitiesInFOV()
 	{
 		if (e.Type == eEntityType::ITEM)
 		{
-			//ItemInfo itemInfo;
-			//m_pInterface->Item_GetInfo(e, itemInfo);
+			ItemInfo itemInfo;
+			m_pCachedInterface->Item_GetInfo(e, itemInfo);
 			m_ItemsInFOV.push_back(e);
+			m_ItemInfosInFOV.push_back(itemInfo);
 		}
 
 		if (e.Type == eEntityType::ENEMY)
 		{
 			EnemyInfo enemyInfo;
-			m_pInterface->Enemy_GetInfo(e, enemyInfo);
+			m_pCachedInterface->Enemy_GetInfo(e, enemyInfo);
 			m_EnemiesInFOV.push_back(enemyInfo);
 		}
 
 		if (e.Type == eEntityType::PURGEZONE)
 		{
 			PurgeZoneInfo zoneInfo;
-			m_pInterface->PurgeZone_GetInfo(e, zoneInfo);
+			m_pCachedInterface->PurgeZone_GetInfo(e, zoneInfo);
 			m_PurgeZoneInFOV.push_back(zoneInfo);
 		}
 	}
 }
 void Plugin::AddNewItemsToMemory()
 {
-	for (EntityInfo& e : m_ItemsInFOV)
+	for (const ItemInfo& item : m_ItemInfosInFOV)
 	{
-		ItemInfo item{};
-		m_pInterface->Item_GetInfo(e, item);
+		// items the inventory refused stay out of memory, or they'd be fetched again
+		if (!m_Inventory.IsRefused(item.ItemHash) && m_ItemMemory.Add(item))
+		{
+			m_WorldModel.AddItem(m_ItemMemory.GetItem(m_ItemMemory.GetCount() - 1));
+			m_HouseRegistry.OnItemDiscovered(item.Location);
+		}
+	}
+}
+void Plugin::CreateTickPhases()
+{
+	m_TickPhases.SetForkThreshold(TICK_PHASES_FORK_THRESHOLD);
 
-		bool isItemInMemory = false;
-		for(ItemInfo& itemInMemory : m_ItemMemory)
+	// everything that talks to the interface or the blackboard stays on the tick thread
+	const unsigned int perception = m_TickPhases.AddCallingThreadTask("Perception", [this]()
 		{
-			if (itemInMemory.Location == item.Location)
+			AssignEntitiesInFOV();
+			m_AgentInfo = m_pInterface->Agent_GetInfo();
+			m_pBlackboard->ChangeData("AgentInfo", m_AgentInfo);
+			m_AgentFrame.Update(m_AgentInfo);
+			for (const HouseInfo& houseInFOV : GetHousesInFOV())
 			{
-				isItemInMemory = true;
+				AddHouseIfNew(houseInFOV);
 			}
-		};
-
-		if (!isItemInMemory)
+			m_TickEntityCount = static_cast<unsigned int>(m_ItemInfosInFOV.size() + m_EnemiesInFOV.size() + m_PurgeZoneInFOV.size())
+				+ m_HouseRegistry.GetHouseCount();
+		});
+
+	// only plugin state from here on, perception already fetched what these need from the interface
+	m_TickPhases.AddTask("Coverage", [this]() { UpdateCoverage(); }, { perception });
+	const unsigned int itemMemory = m_TickPhases.AddTask("Item memory", [this]() { AddNewItemsToMemory(); }, { perception });
+	// the zombies in sight, scored into danger
+	const unsigned int influence = m_TickPhases.AddTask("Influence map", [this]()
 		{
-			m_ItemMemory.push_back(item);
-		}
+			m_InfluenceMap.Update(m_Time, m_EnemiesInFOV);
+			m_WorldModel.SetInfluenceTiles(m_InfluenceMap);
+		}, { perception });
+	const unsigned int purgeZones = m_TickPhases.AddTask("Purge zone memory", [this]()
+		{
+			m_PurgeZoneMemory.Update(m_Time, m_PurgeZoneInFOV, m_AgentInfo.Position, m_AgentInfo.AgentSize);
+			m_WorldModel.SetPurgeZones(m_PurgeZoneMemory);
+		}, { perception });
+	// items found in a house make it worth more
+	const unsigned int houses = m_TickPhases.AddTask("House registry", [this]()
+		{
+			m_HouseRegistry.Update(m_Time, m_AgentInfo, m_JobSystem);
+			if (m_HouseRegistry.GetCurrentHouse() != -1)
+				m_WorldModel.SetHouseVisited(m_HouseRegistry.GetCurrentHouse(), m_Time);
+		}, { itemMemory });
+	m_TickPhases.AddTask("Planning snapshot", [this]()
+		{
+			m_BackgroundPlanner.SubmitSnapshot(m_WorldModel.Publish(m_Time, m_AgentInfo, m_Inventory, m_ItemInfosInFOV, m_EnemiesInFOV));
+		}, { itemMemory, influence, purgeZones, houses });
+}
+void Plugin::PrintDecisionMakingReport(bool includeWorldStats)
+{
+	// Run every decision maker on the same seed & level to compare them
+#if defined(USE_UTILITY_AI)
+	printf("=== Utility AI ===\n");
+#elif defined(USE_STATE_MACHINE)
+	printf("=== State Machine ===\n");
+#else
+	printf("=== Behavior Tree ===\n");
+#endif
+	m_DecisionMakingStats.Print("Decision making cost per tick (us)");
+	printf("Obstacle avoidance: %u walls (%s)\n", m_ObstacleAvoidance.GetWallCount(),
+		m_ObstacleAvoidance.IsUsingLevelGeometry() ? "level file" : "discovered houses");
+	m_ObstacleAvoidance.GetQueryStats().Print("Obstacle avoidance cost per tick (us)");
+	printf("Steering pipeline: %u requests dropped on a full buffer\n", m_SteeringPipeline.GetDroppedCount());
+	m_BackgroundPlanner.PrintTickReport();
+	printf("Item memory: %u items in %u bytes, %u items refused by the inventory\n", m_ItemMemory.GetCount(), m_ItemMemory.GetMemoryUsage(), m_Inventory.GetRefusedCount());
+	printf("Influence map: %ux%u cells, %u tiles holding danger\n", m_InfluenceMap.GetColumns(), m_InfluenceMap.GetRows(), m_InfluenceMap.GetActiveTileCount());
+	m_WorldModel.PrintReport();
+	m_TickPhases.PrintReport();
+	printf("Job system: %u workers, %u steals\n", m_JobSystem.GetWorkerCount(), m_JobSystem.GetStealCount());
+
+	if (includeWorldStats)
+	{
+		const StatisticsInfo stats = m_pInterface->World_GetStats();
+		printf("Score: %d, survived: %.1fs, kills: %d, items picked up: %d, missed shots: %d\n",
+			stats.Score, stats.TimeSurvived, stats.NumEnemiesKilled, stats.NumItemsPickUp, stats.NumMissedShots);
 	}
+	m_IsReportPrinted = true;
 }
-
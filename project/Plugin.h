@@ -8,6 +8,42 @@ using namespace Elite;
 #include "EBlackboard.h"
 #include "Stucts.h"
 #include "Behaviors.h"
+#include "InterfaceCache.h"
+#include "EUtilityDecisionMaking.h"
+#include "EFiniteStateMachine.h"
+#include "EProfiler.h"
+#include "ObstacleAvoidance.h"
+#include "PurgeZoneMemory.h"
+#include "BackgroundPlanner.h"
+#include "ItemMemory.h"
+#include "WorldModel.h"
+#include "EJobSystem.h"
+#include "HouseRegistry.h"
+#include "AgentFrame.h"
+#include "DebugDrawBuffer.h"
+#include "GridOverlay.h"
+#include "InfluenceMap.h"
+
+// Decision making, the behavior tree is used unless one of these is defined
+//#define USE_UTILITY_AI
+//#define USE_STATE_MACHINE
+
+// Write the blackboard journal to BlackboardJournal.bin when the plugin unloads, F6 writes it any time
+//#define DUMP_JOURNAL_ON_SHUTDOWN
+
+// Print what decision making, avoidance, memories & threads cost on death (or unload), to compare runs
+//#define PRINT_DECISION_MAKING_REPORT
+
+// Entities in the FOV plus known houses from which the tick phases get forked over the workers, below it
+// waking them costs more than they save. Tests/JobSystemBench --workers n estimates it for the machine it runs on
+#ifndef TICK_PHASES_FORK_THRESHOLD
+#define TICK_PHASES_FORK_THRESHOLD 64
+#endif
+
+// Level the host loads in debug builds & the walls avoidance is built from, relative to the working directory
+#ifndef LEVEL_FILE
+#define LEVEL_FILE "GameLevel.gppl"
+#endif
 
 class IBaseInterface;
 class IExamInterface;
@@ -28,6 +64,13 @@ public:
 	SteeringPlugin_Output UpdateSteering(float dt) override;
 	void Render(float dt) const override;
 
+	// Checkpoints of everything the bot decided & remembered, the world itself isn't in them.
+	// Restoring needs a plugin that was initialized the same way, the whole checkpoint is checked
+	// before anything is restored so a checkpoint that doesn't fit leaves the bot as it was
+	static const unsigned int CheckpointVersion = 5; // bump whenever what's saved changes
+	void SaveCheckpoint(std::vector<unsigned char>& blob) const;
+	bool RestoreCheckpoint(const unsigned char* pData, size_t size);
+
 private:
 	//Interface, used to request data from/perform actions with the AI Framework
 	IExamInterface* m_pInterface = nullptr;
@@ -43,21 +86,87 @@ private:
 
 
 	// Own Additions
+	CachedExamInterface* m_pCachedInterface = nullptr; // what the behaviors get handed as "PluginInterface"
 	Blackboard* m_pBlackboard = nullptr;
-	BehaviorTree* m_pBehaviorTree = nullptr;
-	std::vector<HouseInfo> m_DiscoveredHouses = {}; // might make a struct which has a time since last visited & have list of that instead
+	Elite::IDecisionMaking* m_pDecisionMaking = nullptr;
+	SteeringPipeline m_SteeringPipeline{};
+	ObstacleAvoidance m_ObstacleAvoidance{};
+	Elite::SampleStats m_DecisionMakingStats{};
+	// UI state of the journal window, only Render reads or writes it so it's mutable
+	struct JournalScrubber
+	{
+		int tick = 0;
+		bool isFollowing = true;
+		Elite::JournalView view = {};
+		std::vector<std::string> texts = {}; // formatted values of the view, per key
+	};
+	mutable JournalScrubber m_JournalScrubber{};
+	bool m_IsReportPrinted = false;
+	std::vector<unsigned char> m_Checkpoint = {}; // F5 saves, F9 restores
+	mutable DebugDrawBuffer m_DebugDraw{}; // filled every tick, flushed in Render where the layers get toggled
+	std::vector<unsigned short> m_CoverageTicks = {}; // per cell, ticks it was in the FOV
+	GridOverlay m_CoverageOverlay{};
+	InfluenceMap m_InfluenceMap{}; // danger the zombies we saw leave behind
+	GridOverlay m_DangerOverlay{};
+	std::vector<HouseInfo> m_DiscoveredHouses = {};
+	HouseRegistry m_HouseRegistry{};
 
 	std::list<EntityInfo> m_ItemsInFOV = {};
+	std::vector<ItemInfo> m_ItemInfosInFOV = {};
 	std::list<EnemyInfo> m_EnemiesInFOV = {};
 	std::list<PurgeZoneInfo> m_PurgeZoneInFOV = {};
-	PurgeZoneInfo m_DangerousPurgeZone = {};
+	PurgeZoneMemory m_PurgeZoneMemory{};
+	BackgroundPlanner m_BackgroundPlanner{};
+	Elite::JobSystem m_JobSystem{};
+	Elite::TaskGraph m_TickPhases{};
+	float m_Time = 0.f;
+	AgentInfo m_AgentInfo{}; // this tick's, for the tick phases
+	AgentFrame m_AgentFrame{}; // derived from it, for the behaviors
+	unsigned int m_TickEntityCount = 0; // seen by last tick's perception, what the tick phases are forked on
 	
-	Inventory m_DesiredInventoryCounts{};
-	std::vector<ItemInfo> m_ItemMemory{};
+	Inventory m_Inventory{};
+	ItemMemory m_ItemMemory{};
+	WorldModel m_WorldModel{}; // versions of the memories above, for other threads
+
+	// what RestoreCheckpoint loads into & swaps with the live ones, so restoring over & over doesn't allocate.
+	// Starts out as a copy of them after Initialize, it's only ever set up the way they are
+	struct RestoreScratch
+	{
+		std::vector<HouseInfo> discoveredHouses = {};
+		Elite::BlackboardState blackboardState = {};
+		Inventory inventory = {};
+		ItemMemory itemMemory = {};
+		HouseRegistry houseRegistry = {};
+		PurgeZoneMemory purgeZoneMemory = {};
+		InfluenceMap influenceMap = {};
+	};
+	RestoreScratch m_RestoreScratch{};
 
 	void AddHouseIfNew(const HouseInfo& houseInfo);
 	void AssignEntitiesInFOV();
 	void AddNewItemsToMemory();
+	void CreateTickPhases();
+	void PrintDecisionMakingReport(bool includeWorldStats);
+	void RenderJournalScrubber() const;
+	void InitializeCoverage(const WorldInfo& worldInfo);
+	void UpdateCoverage();
+	void InitializeInfluenceMap(const WorldInfo& worldInfo);
+	void FillDebugDraw();
+	void FlushDebugDraw() const;
+
+	// Decision making, every branch is built fresh so the different decision makers can share them
+	static Elite::IDecisionMaking* CreateBehaviorTree(Blackboard* pBlackboard);
+	static Elite::IDecisionMaking* CreateUtilityDecisionMaker(Blackboard* pBlackboard);
+	static Elite::IDecisionMaking* CreateStateMachine(Blackboard* pBlackboard);
+	static Elite::IBehavior* CreateHealBehavior();
+	static Elite::IBehavior* CreateEatBehavior();
+	static Elite::IBehavior* CreateLeavePurgeZoneBehavior();
+	static Elite::IBehavior* CreateCombatBehavior();
+	static Elite::IBehavior* CreateLootBehavior();
+	static Elite::IBehavior* CreateGoapBehavior();
+	static Elite::IBehavior* CreateHouseBehavior();
+	static Elite::IBehavior* CreateExploreBehavior();
+	static Elite::IBehavior* CreateRevisitHouseBehavior();
 };
 
 //ENTRY
@@ -0,0 +1,212 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "PurgeZoneMemory.h"
+
+void PurgeZoneMemory::Update(float time, const std::list<PurgeZoneInfo>& zonesInFOV, const Elite::Vector2& agentPosition, float margin)
+{
+	for (const PurgeZoneInfo& zoneInfo : zonesInFOV)
+	{
+		const int zone = Find(zoneInfo.ZoneHash);
+		if (zone >= 0)
+		{
+			m_ExpiryTimes[zone] = time + TimeToLive;
+			continue;
+		}
+
+		m_Hashes.push_back(zoneInfo.ZoneHash);
+		m_CentersX.push_back(zoneInfo.Center.x);
+		m_CentersY.push_back(zoneInfo.Center.y);
+		m_Radii.push_back(zoneInfo.Radius);
+		m_SpawnTimes.push_back(time);
+		m_ExpiryTimes.push_back(time + TimeToLive);
+	}
+
+	for (unsigned int zone = 0; zone < m_Hashes.size();)
+	{
+		if (m_ExpiryTimes[zone] < time)
+			Remove(zone);
+		else
+			++zone;
+	}
+
+	CalculateExit(agentPosition, margin);
+}
+
+void PurgeZoneMemory::SaveState(Elite::CheckpointWriter& writer) const
+{
+	writer.WriteTag("PZMM");
+	for (const std::vector<float>* pArray : { &m_CentersX, &m_CentersY, &m_Radii, &m_SpawnTimes, &m_ExpiryTimes })
+		writer.WriteArray(*pArray);
+	writer.WriteArray(m_Hashes);
+	writer.Write(m_IsAgentInside);
+	writer.Write(m_ExitVector);
+}
+
+bool PurgeZoneMemory::LoadState(Elite::CheckpointReader& reader)
+{
+	if (!reader.ReadTag("PZMM"))
+		return false;
+	for (std::vector<float>* pArray : { &m_CentersX, &m_CentersY, &m_Radii, &m_SpawnTimes, &m_ExpiryTimes })
+	{
+		if (!reader.ReadArray(*pArray))
+			return false;
+	}
+	if (!reader.ReadArray(m_Hashes) || !reader.Read(m_IsAgentInside) || !reader.Read(m_ExitVector))
+		return false;
+
+	//One entry per zone in every array
+	for (const std::vector<float>* pArray : { &m_CentersX, &m_CentersY, &m_Radii, &m_SpawnTimes, &m_ExpiryTimes })
+	{
+		if (pArray->size() != m_Hashes.size())
+			return false;
+	}
+	return true;
+}
+
+bool PurgeZoneMemory::IsInside(const Elite::Vector2& position, float margin) const
+{
+	bool isInside = false;
+	TestPoints(&position, 1, &isInside, margin);
+	return isInside;
+}
+
+void PurgeZoneMemory::TestPoints(const Elite::Vector2* points, unsigned int count, bool* isInside, float margin) const
+{
+	for (unsigned int p = 0; p < count; ++p)
+		isInside[p] = false;
+
+	for (unsigned int zone = 0; zone < m_Hashes.size(); ++zone)
+	{
+		const float centerX = m_CentersX[zone];
+		const float centerY = m_CentersY[zone];
+		const float radius = m_Radii[zone] + margin;
+		const float radiusSquared = radius * radius;
+
+		for (unsigned int p = 0; p < count; ++p)
+		{
+			const float dx = points[p].x - centerX;
+			const float dy = points[p].y - centerY;
+			isInside[p] |= (dx * dx + dy * dy) < radiusSquared;
+		}
+	}
+}
+
+Elite::Vector2 PurgeZoneMemory::GetSafeTarget(const Elite::Vector2& from, const Elite::Vector2& target, float margin) const
+{
+	Elite::Vector2 safeTarget = target;
+
+	//A target inside a zone is moved to its rim, on the side we're coming from
+	for (unsigned int zone = 0; zone < m_Hashes.size(); ++zone)
+	{
+		const Elite::Vector2 center{ m_CentersX[zone], m_CentersY[zone] };
+		const float radius = m_Radii[zone] + margin;
+		if (DistanceSquared(safeTarget, center) >= radius * radius)
+			continue;
+
+		Elite::Vector2 outward = safeTarget - center;
+		if (outward.Magnitude() < FLT_EPSILON)
+			outward = from - center;
+		outward.Normalize();
+		safeTarget = center + outward * radius;
+	}
+
+	//Detour around the first zone the straight line runs through
+	const Elite::Vector2 path = safeTarget - from;
+	const float pathLengthSquared = path.MagnitudeSquared();
+	if (pathLengthSquared < FLT_EPSILON)
+		return safeTarget;
+
+	float closestCrossing = FLT_MAX;
+	Elite::Vector2 detour = safeTarget;
+	for (unsigned int zone = 0; zone < m_Hashes.size(); ++zone)
+	{
+		const Elite::Vector2 center{ m_CentersX[zone], m_CentersY[zone] };
+		const float radius = m_Radii[zone] + margin;
+
+		//Leaving a zone we're in is handled by the exit vector
+		if (DistanceSquared(from, center) < radius * radius)
+			continue;
+
+		const float t = Elite::Clamp((center - from).Dot(path) / pathLengthSquared, 0.f, 1.f);
+		const Elite::Vector2 closestPoint = from + path * t;
+		if (DistanceSquared(closestPoint, center) >= radius * radius || t >= closestCrossing)
+			continue;
+
+		Elite::Vector2 sideways = closestPoint - center;
+		if (sideways.Magnitude() < FLT_EPSILON)
+			sideways = Elite::Vector2{ -path.y, path.x };
+		sideways.Normalize();
+
+		closestCrossing = t;
+		detour = center + sideways * (radius * 1.1f);
+	}
+
+	return detour;
+}
+
+int PurgeZoneMemory::Find(int zoneHash) const
+{
+	for (unsigned int zone = 0; zone < m_Hashes.size(); ++zone)
+	{
+		if (m_Hashes[zone] == zoneHash)
+			return int(zone);
+	}
+	return -1;
+}
+
+void PurgeZoneMemory::Remove(unsigned int zone)
+{
+	//Swap with the last one, the order doesn't matter
+	m_Hashes[zone] = m_Hashes.back();
+	m_CentersX[zone] = m_CentersX.back();
+	m_CentersY[zone] = m_CentersY.back();
+	m_Radii[zone] = m_Radii.back();
+	m_SpawnTimes[zone] = m_SpawnTimes.back();
+	m_ExpiryTimes[zone] = m_ExpiryTimes.back();
+
+	m_Hashes.pop_back();
+	m_CentersX.pop_back();
+	m_CentersY.pop_back();
+	m_Radii.pop_back();
+	m_SpawnTimes.pop_back();
+	m_ExpiryTimes.pop_back();
+}
+
+void PurgeZoneMemory::CalculateExit(const Elite::Vector2& position, float margin)
+{
+	m_IsAgentInside = false;
+	m_ExitVector = Elite::ZeroVector2;
+
+	//Candidate exits are straight out of every zone we're in, the shortest one that
+	//doesn't end up in another zone wins
+	float shortestExit = FLT_MAX;
+	Elite::Vector2 fallbackExit{};
+	for (unsigned int zone = 0; zone < m_Hashes.size(); ++zone)
+	{
+		const Elite::Vector2 center{ m_CentersX[zone], m_CentersY[zone] };
+		const float radius = m_Radii[zone] + margin;
+		if (DistanceSquared(position, center) >= radius * radius)
+			continue;
+
+		Elite::Vector2 outward = position - center;
+		if (outward.Magnitude() < FLT_EPSILON)
+			outward = Elite::Vector2{ 1.f, 0.f };
+		outward.Normalize();
+
+		const Elite::Vector2 exit = center + outward * radius;
+		const Elite::Vector2 exitVector = exit - position;
+		if (!m_IsAgentInside)
+			fallbackExit = exitVector;
+		m_IsAgentInside = true;
+
+		const float length = exitVector.Magnitude();
+		if (length < shortestExit && !IsInside(exit + outward * 0.1f, margin))
+		{
+			shortestExit = length;
+			m_ExitVector = exitVector;
+		}
+	}
+
+	if (m_IsAgentInside && shortestExit == FLT_MAX)
+		m_ExitVector = fallbackExit;
+}
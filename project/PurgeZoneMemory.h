@@ -0,0 +1,54 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// PurgeZoneMemory.h: Remembered purge zones, used to steer around them
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "ECheckpoint.h"
+
+//-----------------------------------------------------------------
+// PURGE ZONE MEMORY
+//-----------------------------------------------------------------
+// Zones are keyed on their ZoneHash and kept for a while after they were last seen,
+// the interface doesn't tell how long a zone lasts. Stored as a structure of arrays
+// so testing a batch of points against every zone is a tight loop.
+class PurgeZoneMemory final
+{
+public:
+	static constexpr float TimeToLive = 10.f; //Seconds a zone is remembered after it was last seen
+
+	//Refreshes the zones in sight, forgets expired ones and precomputes the exit for the agent
+	void Update(float time, const std::list<PurgeZoneInfo>& zonesInFOV, const Elite::Vector2& agentPosition, float margin);
+
+	void SaveState(Elite::CheckpointWriter& writer) const;
+	bool LoadState(Elite::CheckpointReader& reader);
+
+	bool IsAgentInside() const { return m_IsAgentInside; }
+	//Shortest way out of every zone the agent is in, zero when it's not in one
+	const Elite::Vector2& GetExitVector() const { return m_ExitVector; }
+
+	bool IsInside(const Elite::Vector2& position, float margin = 0.f) const;
+	//Batched circle test, isInside[i] tells whether points[i] is in a zone
+	void TestPoints(const Elite::Vector2* points, unsigned int count, bool* isInside, float margin = 0.f) const;
+	//Moves the target out of zones and returns a detour point when the straight line crosses one
+	Elite::Vector2 GetSafeTarget(const Elite::Vector2& from, const Elite::Vector2& target, float margin) const;
+
+	unsigned int GetZoneCount() const { return static_cast<unsigned int>(m_Hashes.size()); }
+	PurgeZoneInfo GetZone(unsigned int zone) const { return PurgeZoneInfo{ Elite::Vector2{ m_CentersX[zone], m_CentersY[zone] }, m_Radii[zone], m_Hashes[zone] }; }
+
+private:
+	std::vector<int> m_Hashes = {};
+	std::vector<float> m_CentersX = {};
+	std::vector<float> m_CentersY = {};
+	std::vector<float> m_Radii = {};
+	std::vector<float> m_SpawnTimes = {}; //First time we saw it
+	std::vector<float> m_ExpiryTimes = {};
+
+	bool m_IsAgentInside = false;
+	Elite::Vector2 m_ExitVector = {};
+
+	int Find(int zoneHash) const;
+	void Remove(unsigned int zone);
+	void CalculateExit(const Elite::Vector2& position, float margin);
+};
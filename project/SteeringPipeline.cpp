@@ -0,0 +1,90 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "SteeringPipeline.h"
+
+bool SteeringPipeline::AddLinear(const Elite::Vector2& velocity, float weight, SteeringPriority priority, bool runMode)
+{
+	return Add(Request{ velocity, 0.f, weight, priority, true, runMode });
+}
+
+bool SteeringPipeline::AddAngular(float angularVelocity, float weight, SteeringPriority priority)
+{
+	return Add(Request{ Elite::ZeroVector2, angularVelocity, weight, priority, false, false });
+}
+
+bool SteeringPipeline::Add(const Request& request)
+{
+	assert(m_RequestCount < MaxRequests && "More steering requests in one tick than MaxRequests");
+	if (m_RequestCount == MaxRequests)
+	{
+		++m_DroppedCount;
+		return false;
+	}
+
+	m_Requests[m_RequestCount++] = request;
+	return true;
+}
+
+SteeringPlugin_Output SteeringPipeline::Resolve(float maxLinearSpeed, float maxAngularSpeed) const
+{
+	SteeringPlugin_Output output{};
+	bool hasAngular = false;
+
+	for (unsigned int p = static_cast<unsigned int>(SteeringPriority::Count); p > 0; --p)
+	{
+		const SteeringPriority priority = static_cast<SteeringPriority>(p - 1);
+
+		Elite::Vector2 linear{};
+		float angular = 0.f;
+		bool runMode = false;
+		bool hasLinearInGroup = false;
+		bool hasAngularInGroup = false;
+
+		for (unsigned int i = 0; i < m_RequestCount; ++i)
+		{
+			const Request& request = m_Requests[i];
+			if (request.priority != priority)
+				continue;
+
+			if (request.isLinear)
+			{
+				linear += request.linearVelocity * request.weight;
+				runMode |= request.runMode;
+				hasLinearInGroup = true;
+			}
+			else
+			{
+				angular += request.angularVelocity * request.weight;
+				hasAngularInGroup = true;
+			}
+		}
+
+		if (hasLinearInGroup)
+		{
+			const float remaining = maxLinearSpeed - output.LinearVelocity.Magnitude();
+			if (remaining > 0.f)
+			{
+				const float magnitude = linear.Magnitude();
+				if (magnitude > remaining)
+					linear *= remaining / magnitude;
+
+				output.LinearVelocity += linear;
+				output.RunMode |= runMode;
+			}
+		}
+
+		if (hasAngularInGroup)
+		{
+			const float remaining = maxAngularSpeed - abs(output.AngularVelocity);
+			if (remaining > 0.f)
+			{
+				output.AngularVelocity += Elite::Clamp(angular, -remaining, remaining);
+				hasAngular = true;
+			}
+		}
+	}
+
+	//Without any turning request the agent looks where it's going
+	output.AutoOrient = !hasAngular;
+	return output;
+}
@@ -0,0 +1,62 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// SteeringPipeline.h: Per-tick buffer of steering requests, blended into one output
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+
+//Higher priorities get the speed budget first, lower ones only get what's left
+enum class SteeringPriority : unsigned int
+{
+	Low,
+	Normal,
+	High,
+	Critical,
+	//---
+	Count
+};
+
+//-----------------------------------------------------------------
+// STEERING PIPELINE
+//-----------------------------------------------------------------
+// Movement behaviors add requests instead of overwriting the output, so several objectives
+// (flee a purge zone while facing a zombie, ...) can be served in the same tick.
+// Linear and angular requests are blended separately: per priority the weighted sum is taken,
+// and the groups are accumulated from the highest priority down, each one truncated to the
+// speed that is still left (prioritized truncated running sum).
+class SteeringPipeline final
+{
+public:
+	static const unsigned int MaxRequests = 16;
+
+	void BeginTick() { m_RequestCount = 0; }
+
+	bool AddLinear(const Elite::Vector2& velocity, float weight = 1.f,
+		SteeringPriority priority = SteeringPriority::Normal, bool runMode = false);
+	bool AddAngular(float angularVelocity, float weight = 1.f,
+		SteeringPriority priority = SteeringPriority::Normal);
+
+	SteeringPlugin_Output Resolve(float maxLinearSpeed, float maxAngularSpeed) const;
+
+	unsigned int GetRequestCount() const { return m_RequestCount; }
+	//Requests that didn't fit in MaxRequests since the pipeline was made, asserts in debug
+	unsigned int GetDroppedCount() const { return m_DroppedCount; }
+
+private:
+	struct Request
+	{
+		Elite::Vector2 linearVelocity;
+		float angularVelocity;
+		float weight;
+		SteeringPriority priority;
+		bool isLinear;
+		bool runMode;
+	};
+
+	Request m_Requests[MaxRequests] = {};
+	unsigned int m_RequestCount = 0;
+	unsigned int m_DroppedCount = 0;
+
+	bool Add(const Request& request);
+};
@@ -9,6 +9,33 @@
 //	left
 //};
 
+// GOAP world state bits
+enum GoapFact : unsigned int
+{
+	eHoldsGun = 1 << 0,
+	eHoldsMedkit = 1 << 1,
+	eHoldsFood = 1 << 2,
+	eNeedsGun = 1 << 3, // room for another one in the inventory
+	eNeedsMedkit = 1 << 4,
+	eNeedsFood = 1 << 5,
+	eKnowsGun = 1 << 6,
+	eKnowsMedkit = 1 << 7,
+	eKnowsFood = 1 << 8,
+	eBadlyHurt = 1 << 9,
+	eStarving = 1 << 10
+};
+
+// GOAP goals, in the order they are added to the planner
+enum GoapGoal : int
+{
+	eGoalNone = -1,
+	eGoalHealed,
+	eGoalFed,
+	eGoalArmed,
+	eGoalMedkitsStocked,
+	eGoalFoodStocked
+};
+
 // STRUCTS
 struct ExpandingSearchData
 {
@@ -18,19 +45,6 @@ struct ExpandingSearchData
 	// Direction lastDirection = Direction::up
 };
 
-struct Inventory
-{
-	unsigned int maxGuns = 0;
-	unsigned int maxMedkits = 0;
-	unsigned int maxFood = 0;
-
-	unsigned int currentGuns = 0;
-	unsigned int currentMedkits = 0;
-	unsigned int currentFood = 0;
-
-	std::vector<ItemInfo> inventorySlots = {};
-};
-
 struct StrafeInfo 
 {
 	float startOrientation = 0.f;
@@ -0,0 +1,103 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include <thread>
+#include "TestHelpers.h"
+#include "BotBatchStandIn.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// BATCHED BEHAVIOR TREE SCALING
+//-----------------------------------------------------------------
+// Microseconds per agent for the bot's tree, batched & as one BehaviorTree per agent, from 1
+// to 10k agents. Then the batched tree again on the job system, which only forks once there
+// are more agents than the inline threshold. Pass --workers n to change the worker count
+// (3 by default).
+
+namespace
+{
+	const unsigned int AgentCounts[] = { 1, 10, 100, 1000, 10000 };
+
+	unsigned int GetTickCount(unsigned int agentCount)
+	{
+		return agentCount >= 10000 ? 30 : 200;
+	}
+
+	void BenchInline()
+	{
+		JobSystem jobSystem{};
+		printf("Inline (us per agent)   batched   per-agent   agents per leaf call\n");
+		for (unsigned int agentCount : AgentCounts)
+		{
+			BotBatch batchedBots{}, perAgentBots{};
+			batchedBots.Resize(agentCount);
+			perAgentBots.Resize(agentCount);
+			Test::StandInWorld batchedWorld{ 42 }, perAgentWorld{ 42 };
+			BatchedBehaviorTree batchedTree{ BotBatch::CreateBehavior() };
+			batchedTree.SetAgentCount(agentCount);
+			std::vector<BehaviorTree*> perAgentTrees = Test::CreatePerAgentTrees(BotBatch::CreateBehavior(), perAgentBots);
+
+			const unsigned int tickCount = GetTickCount(agentCount);
+			double batchedTime = 0.0, perAgentTime = 0.0;
+			for (unsigned int tick = 0; tick < tickCount; ++tick)
+			{
+				batchedWorld.Perceive(batchedBots, tick);
+				ProfileClock::time_point start = ProfileClock::now();
+				batchedTree.Update(&batchedBots, jobSystem);
+				batchedTime += ElapsedMicroseconds(start);
+
+				perAgentWorld.Perceive(perAgentBots, tick);
+				start = ProfileClock::now();
+				for (BehaviorTree* pTree : perAgentTrees)
+					pTree->Update(0.f);
+				perAgentTime += ElapsedMicroseconds(start);
+			}
+			for (BehaviorTree* pTree : perAgentTrees)
+				delete pTree;
+
+			const double agentTicks = double(agentCount) * tickCount;
+			printf("  %5u agents          %7.3f     %7.3f   %7.1f\n", agentCount, batchedTime / agentTicks, perAgentTime / agentTicks,
+				double(batchedTree.GetLeafAgentCount()) / batchedTree.GetLeafCallCount());
+		}
+	}
+
+	void BenchWorkers(unsigned int workerCount)
+	{
+		JobSystem jobSystem{};
+		jobSystem.Start(workerCount);
+		printf("%u workers, %u hardware threads (us per agent)\n", jobSystem.GetWorkerCount(), std::thread::hardware_concurrency());
+		for (unsigned int agentCount : AgentCounts)
+		{
+			BotBatch bots{};
+			bots.Resize(agentCount);
+			Test::StandInWorld world{ 42 };
+			BatchedBehaviorTree tree{ BotBatch::CreateBehavior() };
+			tree.SetAgentCount(agentCount);
+
+			const unsigned int tickCount = GetTickCount(agentCount);
+			double time = 0.0;
+			for (unsigned int tick = 0; tick < tickCount; ++tick)
+			{
+				world.Perceive(bots, tick);
+				const ProfileClock::time_point start = ProfileClock::now();
+				tree.Update(&bots, jobSystem);
+				time += ElapsedMicroseconds(start);
+			}
+			printf("  %5u agents          %7.3f\n", agentCount, time / (double(agentCount) * tickCount));
+		}
+		jobSystem.Stop();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int workerCount = 3;
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--workers") == 0)
+			workerCount = static_cast<unsigned int>(atoi(argv[i + 1]));
+	}
+
+	BenchInline();
+	BenchWorkers(workerCount);
+	return 0;
+}
@@ -0,0 +1,90 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+#include "BotBatchStandIn.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// BATCHED BEHAVIOR TREE EQUIVALENCE
+//-----------------------------------------------------------------
+// The batched tree has to decide exactly what one BehaviorTree per agent decides, tick after
+// tick: once for BotBatch's model of the bot & once for a tree of partial sequences that
+// keeps agents running across ticks. BotBatchLeavesTest holds the model to the plugin's leaves.
+
+namespace
+{
+	const unsigned int AgentCount = 1000;
+	const unsigned int TickCount = 200;
+
+	//Leaves with state of their own, each side of the comparison counts in its own array
+	std::vector<unsigned int>* g_pToggleCounts = nullptr;
+
+	void Toggle(void*, const unsigned int* agents, unsigned int count, bool* results)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			results[i] = ++(*g_pToggleCounts)[agents[i]] % 3 != 0;
+	}
+	void Step(void*, const unsigned int*, unsigned int count, BehaviorState* results)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			results[i] = Success;
+	}
+	void RunOnOdd(void*, const unsigned int* agents, unsigned int count, BehaviorState* results)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			results[i] = (agents[i] % 2) ? Running : Success;
+	}
+
+	void TestEquivalence(const char* treeName, const BatchedBehavior& behavior)
+	{
+		BotBatch batchedBots{}, perAgentBots{};
+		batchedBots.Resize(AgentCount);
+		perAgentBots.Resize(AgentCount);
+		Test::StandInWorld batchedWorld{ 42 }, perAgentWorld{ 42 };
+		std::vector<unsigned int> batchedToggles(AgentCount, 0), perAgentToggles(AgentCount, 0);
+
+		JobSystem jobSystem{};
+		BatchedBehaviorTree batchedTree{ behavior };
+		batchedTree.SetAgentCount(AgentCount);
+		std::vector<BehaviorTree*> perAgentTrees = Test::CreatePerAgentTrees(behavior, perAgentBots);
+
+		unsigned int mismatchCount = 0;
+		for (unsigned int tick = 0; tick < TickCount; ++tick)
+		{
+			batchedWorld.Perceive(batchedBots, tick);
+			g_pToggleCounts = &batchedToggles;
+			batchedTree.Update(&batchedBots, jobSystem);
+
+			perAgentWorld.Perceive(perAgentBots, tick);
+			g_pToggleCounts = &perAgentToggles;
+			for (BehaviorTree* pTree : perAgentTrees)
+				pTree->Update(0.f);
+
+			for (unsigned int agent = 0; agent < AgentCount; ++agent)
+			{
+				if (batchedBots.decisions[agent] != perAgentBots.decisions[agent]
+					|| batchedBots.targetsX[agent] != perAgentBots.targetsX[agent]
+					|| batchedBots.targetsY[agent] != perAgentBots.targetsY[agent]
+					|| batchedBots.isRunning[agent] != perAgentBots.isRunning[agent]
+					|| batchedToggles[agent] != perAgentToggles[agent])
+					++mismatchCount;
+			}
+		}
+		for (BehaviorTree* pTree : perAgentTrees)
+			delete pTree;
+
+		TEST_CHECK(mismatchCount == 0, "%s: %u of %u agent ticks decided otherwise than the per-agent trees",
+			treeName, mismatchCount, AgentCount * TickCount);
+		printf("%s (%u nodes): %u agents, %u ticks\n", treeName, batchedTree.GetNodeCount(), AgentCount, TickCount);
+	}
+}
+
+int main()
+{
+	TestEquivalence("Bot tree", BotBatch::CreateBehavior());
+	TestEquivalence("Partial sequence tree", BatchedSelector({
+		BatchedPartialSequence({ BatchedConditionalLeaf(Toggle), BatchedActionLeaf(Step), BatchedActionLeaf(RunOnOdd), BatchedSequence({}) }),
+		BatchedSelector({}),
+		BatchedActionLeaf(RunOnOdd) }));
+	return Test::Finish("BatchedBehaviorTreeTest");
+}
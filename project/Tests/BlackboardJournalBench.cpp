@@ -0,0 +1,93 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+#include "EBlackboard.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// BLACKBOARD JOURNAL COST
+//-----------------------------------------------------------------
+// Nanoseconds per record for values of one entry & of several, what the journal adds to a
+// ChangeData, and what the scrubber pays to follow the newest tick next to a full rebuild.
+
+namespace
+{
+	const unsigned int RecordCount = 1000000;
+
+	//Three entries' worth of payload
+	struct Wide
+	{
+		float values[18];
+	};
+}
+
+int main()
+{
+	Blackboard blackboard{};
+	blackboard.AddData("IsRunning", false);
+	blackboard.AddData("Count", 0);
+	blackboard.AddData("Target", Vector2{});
+	blackboard.AddData("Wide", Wide{});
+	BlackboardJournal& journal = blackboard.GetJournal();
+	const BlackboardKey countKey = blackboard.GetKey("Count");
+	const unsigned int isRunningId = blackboard.GetKey("IsRunning").id;
+	const unsigned int targetId = blackboard.GetKey("Target").id;
+	const unsigned int wideId = blackboard.GetKey("Wide").id;
+
+	printf("Record bool (1 byte)       %6.2f ns\n", Test::MeasureNanoseconds(RecordCount, [&]()
+		{
+			for (unsigned int i = 0; i < RecordCount; ++i)
+				journal.Record(isRunningId, (i & 1) != 0);
+		}, 5));
+	printf("Record Vector2 (8 bytes)   %6.2f ns\n", Test::MeasureNanoseconds(RecordCount, [&]()
+		{
+			for (unsigned int i = 0; i < RecordCount; ++i)
+				journal.Record(targetId, Vector2{ float(i), 1.f });
+		}, 5));
+	const Wide wide{};
+	printf("Record %2u bytes, %u entries %6.2f ns\n", unsigned(sizeof(Wide)), unsigned(sizeof(Wide) + BlackboardJournal::PayloadSize - 1) / BlackboardJournal::PayloadSize,
+		Test::MeasureNanoseconds(RecordCount, [&]()
+		{
+			for (unsigned int i = 0; i < RecordCount; ++i)
+				journal.Record(wideId, wide);
+		}, 5));
+	printf("ChangeData by key          %6.2f ns\n", Test::MeasureNanoseconds(RecordCount, [&]()
+		{
+			for (unsigned int i = 0; i < RecordCount; ++i)
+				blackboard.ChangeData(countKey, int(i));
+		}, 5));
+	printf("ChangeData by name         %6.2f ns\n", Test::MeasureNanoseconds(RecordCount, [&]()
+		{
+			for (unsigned int i = 0; i < RecordCount; ++i)
+				blackboard.ChangeData("Count", int(i));
+		}, 5));
+
+	//A tick the size of the bot's: a handful of changes, the scrubber following along
+	const unsigned int tickCount = 10000;
+	JournalView view{};
+	std::vector<unsigned char> image{};
+	const double followNs = Test::MeasureNanoseconds(tickCount, [&]()
+		{
+			for (unsigned int tick = 0; tick < tickCount; ++tick)
+			{
+				journal.NextTick();
+				blackboard.ChangeData(countKey, int(tick));
+				journal.Record(targetId, Vector2{ float(tick), 0.f });
+				journal.Record(isRunningId, (tick & 1) != 0);
+				journal.UpdateView(journal.GetTick(), view);
+			}
+		}, 5);
+	const double rebuildNs = Test::MeasureNanoseconds(tickCount, [&]()
+		{
+			for (unsigned int tick = 0; tick < tickCount; ++tick)
+			{
+				journal.NextTick();
+				blackboard.ChangeData(countKey, int(tick));
+				journal.Record(targetId, Vector2{ float(tick), 0.f });
+				journal.Record(isRunningId, (tick & 1) != 0);
+				journal.Rebuild(journal.GetTick(), image);
+			}
+		}, 5);
+	printf("Tick of 3 changes, view following %8.2f us, rebuilding %8.2f us\n", followNs / 1000.0, rebuildNs / 1000.0);
+	return 0;
+}
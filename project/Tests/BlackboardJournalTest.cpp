@@ -0,0 +1,155 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+#include "EBlackboard.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// BLACKBOARD JOURNAL
+//-----------------------------------------------------------------
+// A history long enough to wrap the ring a few times, then every way of getting a tick back
+// has to agree with what was written in it: Rebuild, a JournalView that's moved forward &
+// back, and a journal that went through Dump & Load.
+
+namespace
+{
+	const unsigned int TickCount = 20000;
+	const char* DumpPath = "BlackboardJournalTest.bin";
+
+	//Larger than one entry's payload, so it's spread over several
+	struct Wide
+	{
+		float values[12];
+	};
+
+	struct History
+	{
+		std::vector<int> counts = {};
+		std::vector<Vector2> targets = {};
+		std::vector<unsigned char> isRunning = {};
+	};
+
+	void WriteHistory(Blackboard& blackboard, History& history)
+	{
+		blackboard.AddData("Count", 0);
+		blackboard.AddData("Target", Vector2{});
+		blackboard.AddData("IsRunning", false);
+		blackboard.AddData("Wide", Wide{});
+		const BlackboardKey countKey = blackboard.GetKey("Count");
+		bool isRunning = false;
+		for (unsigned int tick = 1; tick <= TickCount; ++tick)
+		{
+			blackboard.GetJournal().NextTick();
+			blackboard.ChangeData(countKey, int(tick * 3));
+			blackboard.ChangeData("Target", Vector2{ float(tick), -float(tick) });
+			if (tick % 5 == 0)
+			{
+				isRunning = !isRunning;
+				blackboard.ChangeData("IsRunning", isRunning);
+			}
+			Wide wide{};
+			for (unsigned int i = 0; i < 12; ++i)
+				wide.values[i] = float(tick + i);
+			blackboard.ChangeData("Wide", wide);
+
+			history.counts.push_back(int(tick * 3));
+			history.targets.push_back(Vector2{ float(tick), -float(tick) });
+			history.isRunning.push_back(isRunning);
+		}
+	}
+
+	//Whether the image holds the values written up to that tick
+	bool IsImageOf(const BlackboardJournal& journal, const std::vector<unsigned char>& image, const History& history, unsigned int tick)
+	{
+		char text[256], expected[64];
+		journal.FormatValue(image, 0, text, sizeof(text));
+		if (atoi(text) != history.counts[tick - 1])
+			return false;
+		journal.FormatValue(image, 1, text, sizeof(text));
+		snprintf(expected, sizeof(expected), "(%.2f, %.2f)", history.targets[tick - 1].x, history.targets[tick - 1].y);
+		if (strcmp(text, expected) != 0)
+			return false;
+		journal.FormatValue(image, 2, text, sizeof(text));
+		return strcmp(text, history.isRunning[tick - 1] ? "true" : "false") == 0;
+	}
+
+	void TestRebuild(const BlackboardJournal& journal, const History& history)
+	{
+		TEST_CHECK(journal.GetOldestTick() > 1, "the ring didn't wrap in %u ticks", TickCount);
+		unsigned int wrongCount = 0, checkedCount = 0;
+		std::vector<unsigned char> image{};
+		for (unsigned int tick = journal.GetOldestTick(); tick <= journal.GetTick(); tick += 37, ++checkedCount)
+		{
+			journal.Rebuild(tick, image);
+			if (!IsImageOf(journal, image, history, tick))
+				++wrongCount;
+		}
+		TEST_CHECK(wrongCount == 0, "%u of %u rebuilt ticks don't match what was written", wrongCount, checkedCount);
+	}
+
+	void TestView(const BlackboardJournal& journal, const History& history)
+	{
+		JournalView view{};
+		std::vector<unsigned char> image{};
+		unsigned int wrongCount = 0, wrongChangeCount = 0;
+		auto check = [&](unsigned int tick)
+		{
+			journal.UpdateView(tick, view);
+			journal.Rebuild(tick, image);
+			if (view.image != image || !IsImageOf(journal, view.image, history, tick))
+				++wrongCount;
+			//Count & Wide change every tick, IsRunning every fifth
+			const bool isRunningChanged = tick % 5 == 0;
+			if (!view.isKeyChanged[0] || view.isKeyChanged[2] != isRunningChanged || !view.isKeyChanged[3])
+				++wrongChangeCount;
+		};
+
+		//Following the newest tick, then scrubbing back & forward again
+		const unsigned int newest = journal.GetTick();
+		for (unsigned int tick = newest - 200; tick <= newest; ++tick)
+			check(tick);
+		for (unsigned int tick = newest; tick > newest - 2000; tick -= 97)
+			check(tick);
+		for (unsigned int tick = journal.GetOldestTick(); tick <= newest; tick += 501)
+			check(tick);
+
+		TEST_CHECK(wrongCount == 0, "%u views differ from a rebuild of their tick", wrongCount);
+		TEST_CHECK(wrongChangeCount == 0, "%u views got the changed keys wrong", wrongChangeCount);
+		TEST_CHECK(!journal.UpdateView(view.tick, view), "staying on a tick still changed the view");
+	}
+
+	void TestDumpLoad(const BlackboardJournal& journal)
+	{
+		BlackboardJournal loaded{};
+		TEST_CHECK(journal.Dump(DumpPath), "dumping to %s failed", DumpPath);
+		TEST_CHECK(loaded.Load(DumpPath), "loading %s failed", DumpPath);
+		remove(DumpPath);
+		TEST_CHECK(loaded.GetOldestTick() == journal.GetOldestTick() && loaded.GetTick() == journal.GetTick(),
+			"loaded ticks %u to %u instead of %u to %u", loaded.GetOldestTick(), loaded.GetTick(), journal.GetOldestTick(), journal.GetTick());
+
+		unsigned int wrongCount = 0;
+		std::vector<unsigned char> image{}, loadedImage{};
+		for (unsigned int tick = journal.GetOldestTick(); tick <= journal.GetTick(); tick += 101)
+		{
+			journal.Rebuild(tick, image);
+			loaded.Rebuild(tick, loadedImage);
+			if (image != loadedImage)
+				++wrongCount;
+		}
+		TEST_CHECK(wrongCount == 0, "%u ticks rebuild differently after a dump & load", wrongCount);
+	}
+}
+
+int main()
+{
+	Blackboard blackboard{};
+	History history{};
+	WriteHistory(blackboard, history);
+	const BlackboardJournal& journal = blackboard.GetJournal();
+	printf("%llu entries written, ticks %u to %u in the ring\n", journal.GetWriteCount(), journal.GetOldestTick(), journal.GetTick());
+
+	TestRebuild(journal, history);
+	TestView(journal, history);
+	TestDumpLoad(journal);
+	return Test::Finish("BlackboardJournalTest");
+}
@@ -0,0 +1,188 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+#include "FakeExamInterface.h"
+#include "Behaviors.h"
+#include "BotBatch.h"
+
+//-----------------------------------------------------------------
+// BOT BATCH LEAVES
+//-----------------------------------------------------------------
+// BotBatch is a model of the bot, this keeps it honest: random situations are set up once on a
+// blackboard the way the plugin fills its own & once in a BotBatch of one, then every BotBatch
+// conditional has to decide what the Behaviors.h leaf of the same name decides. Facing is set
+// up close to the margins, so both sides of them get tried.
+
+namespace
+{
+	const unsigned int SituationCount = 20000;
+
+	typedef bool(*Leaf)(Blackboard*);
+	struct LeafPair
+	{
+		const char* name;
+		Leaf leaf;
+		BatchedConditional batchedLeaf;
+		unsigned int mismatchCount;
+		unsigned int trueCount;
+	};
+
+	//Everything the leaves read, owned here & pointed to by the blackboard like the plugin's members
+	struct Situation
+	{
+		Test::FakeExamInterface fakeInterface{};
+		Inventory inventory{};
+		PurgeZoneMemory purgeZones{};
+		AgentFrame agentFrame{};
+		std::list<EnemyInfo> enemiesInFOV{};
+		std::list<EntityInfo> itemsInFOV{};
+	};
+
+	float NextStat(RandomStream& stream, float max)
+	{
+		//Full now & then, so the small margins of IsHurt & IsHungry get tried
+		return stream.NextInt(4) == 0 ? max : stream.NextFloat(0.f, max);
+	}
+
+	//Adds 0 to maxCount items of a type, returns the smallest value or 0 without any
+	int AddItems(Situation& situation, eItemType type, int maxCount, int maxValue, int& nextHash, RandomStream& stream)
+	{
+		int smallest = 0;
+		const int count = stream.NextInt(maxCount + 1);
+		for (int i = 0; i < count; ++i)
+		{
+			const int value = 1 + stream.NextInt(maxValue);
+			ItemInfo item{ type, Vector2{}, ++nextHash };
+			situation.fakeInterface.SetItemValue(item.ItemHash, value);
+			if (situation.inventory.AddItem(item) && (smallest == 0 || value < smallest))
+				smallest = value;
+		}
+		return smallest;
+	}
+
+	void CreateSituation(Situation& situation, BotBatch& bot, float time, RandomStream& stream)
+	{
+		AgentInfo& agentInfo = situation.fakeInterface.agentInfo;
+		agentInfo = AgentInfo{};
+		agentInfo.Health = NextStat(stream, BotBatch::MaxHealth);
+		agentInfo.Energy = NextStat(stream, BotBatch::MaxEnergy);
+		agentInfo.Position = stream.NextVector2(-100.f, 100.f);
+		agentInfo.Orientation = stream.NextFloat(-float(E_PI), float(E_PI));
+		agentInfo.FOV_Range = stream.NextFloat(10.f, 30.f);
+		agentInfo.FOV_Angle = 1.5f;
+		agentInfo.GrabRange = 2.f;
+		agentInfo.AgentSize = 1.f;
+
+		//Guns, medkits & food laid out like the plugin's inventory
+		int nextHash = 0;
+		situation.fakeInterface.ClearInventory();
+		situation.inventory.Initialize(&situation.fakeInterface, 2, 2, 1);
+		const int leastAmmo = AddItems(situation, eItemType::PISTOL, 2, 20, nextHash, stream);
+		const int smallestMedkit = AddItems(situation, eItemType::MEDKIT, 2, 6, nextHash, stream);
+		const int smallestFood = AddItems(situation, eItemType::FOOD, 1, 6, nextHash, stream);
+
+		//Zones around the agent, some of them over it
+		std::list<PurgeZoneInfo> zonesInFOV{};
+		for (int zone = stream.NextInt(3); zone > 0; --zone)
+			zonesInFOV.push_back(PurgeZoneInfo{ agentInfo.Position + stream.NextVector2(-20.f, 20.f), stream.NextFloat(5.f, 15.f), zone });
+		situation.purgeZones = PurgeZoneMemory{};
+		situation.purgeZones.Update(time, zonesInFOV, agentInfo.Position, agentInfo.AgentSize);
+
+		//Enemies close & far, the agent is turned to the first one give or take a bit now & then
+		situation.enemiesInFOV.clear();
+		for (int enemy = stream.NextInt(4); enemy > 0; --enemy)
+		{
+			EnemyInfo enemyInfo{};
+			enemyInfo.Location = agentInfo.Position + OrientationToVector(stream.NextFloat(-float(E_PI), float(E_PI))) * stream.NextFloat(1.f, agentInfo.FOV_Range);
+			enemyInfo.EnemyHash = enemy;
+			situation.enemiesInFOV.push_back(enemyInfo);
+		}
+		if (!situation.enemiesInFOV.empty() && stream.NextInt(2) == 0)
+		{
+			const Vector2 toEnemy = situation.enemiesInFOV.front().Location - agentInfo.Position;
+			const float jitters[4] = { 0.f, 0.001f, 0.01f, 0.2f };
+			agentInfo.Orientation = FastMath::GetOrientationFromVelocity(toEnemy) + jitters[stream.NextInt(4)] * stream.NextFloat(-1.f, 1.f);
+		}
+		situation.agentFrame.Update(agentInfo);
+
+		situation.itemsInFOV.clear();
+		if (stream.NextInt(3) == 0)
+			situation.itemsInFOV.push_back(EntityInfo{ eEntityType::ITEM, agentInfo.Position + stream.NextVector2(-10.f, 10.f), 1 });
+
+		//The same for the batch, with what the plugin would have worked out for it
+		bot.positionsX[0] = agentInfo.Position.x;
+		bot.positionsY[0] = agentInfo.Position.y;
+		bot.orientations[0] = agentInfo.Orientation;
+		bot.fovRanges[0] = agentInfo.FOV_Range;
+		bot.health[0] = agentInfo.Health;
+		bot.energy[0] = agentInfo.Energy;
+		bot.isInPurgeZone[0] = situation.purgeZones.IsAgentInside();
+		bot.exitsX[0] = situation.purgeZones.GetExitVector().x;
+		bot.exitsY[0] = situation.purgeZones.GetExitVector().y;
+		bot.seesEnemy[0] = !situation.enemiesInFOV.empty();
+		bot.enemiesX[0] = bot.seesEnemy[0] ? situation.enemiesInFOV.front().Location.x : 0.f;
+		bot.enemiesY[0] = bot.seesEnemy[0] ? situation.enemiesInFOV.front().Location.y : 0.f;
+		bot.seesItem[0] = !situation.itemsInFOV.empty();
+		bot.itemsX[0] = bot.seesItem[0] ? situation.itemsInFOV.front().Location.x : 0.f;
+		bot.itemsY[0] = bot.seesItem[0] ? situation.itemsInFOV.front().Location.y : 0.f;
+		bot.smallestMedkitValues[0] = float(smallestMedkit);
+		bot.smallestFoodValues[0] = float(smallestFood);
+		bot.ammo[0] = static_cast<unsigned int>(leastAmmo);
+	}
+}
+
+int main()
+{
+	LeafPair leaves[] =
+	{
+		{ "IsHurt", IsHurt, BotBatchConditionals::IsHurt, 0, 0 },
+		{ "ShouldUseMedkit", ShouldUseMedkit, BotBatchConditionals::ShouldUseMedkit, 0, 0 },
+		{ "IsHungry", IsHungry, BotBatchConditionals::IsHungry, 0, 0 },
+		{ "ShouldEat", ShouldEat, BotBatchConditionals::ShouldEat, 0, 0 },
+		{ "IsInPurgeZone", IsInPurgeZone, BotBatchConditionals::IsInPurgeZone, 0, 0 },
+		{ "IsZombieInFOV", IsZombieInFOV, BotBatchConditionals::IsZombieInFOV, 0, 0 },
+		{ "IsArmed", IsArmed, BotBatchConditionals::IsArmed, 0, 0 },
+		{ "IsFacingEnemy", IsFacingEnemy, BotBatchConditionals::IsFacingEnemy, 0, 0 },
+		{ "SeesItem", SeesItem, BotBatchConditionals::SeesItem, 0, 0 }
+	};
+
+	Situation situation{};
+	Blackboard blackboard{};
+	blackboard.AddData("AgentInfo", AgentInfo{});
+	blackboard.AddData("AgentFrame", static_cast<const AgentFrame*>(&situation.agentFrame));
+	blackboard.AddData("Inventory", &situation.inventory);
+	blackboard.AddData("MedkitToUse", -1);
+	blackboard.AddData("FoodToUse", -1);
+	blackboard.AddData("PurgeZoneMemory", &situation.purgeZones);
+	blackboard.AddData("EnemiesInFOV", &situation.enemiesInFOV);
+	blackboard.AddData("ItemsInFOV", &situation.itemsInFOV);
+
+	BotBatch bot{};
+	bot.Resize(1);
+	const unsigned int agent = 0;
+	RandomStream stream{ 17 };
+	for (unsigned int s = 0; s < SituationCount; ++s)
+	{
+		CreateSituation(situation, bot, float(s), stream);
+		blackboard.ChangeData("AgentInfo", situation.fakeInterface.agentInfo);
+		for (LeafPair& pair : leaves)
+		{
+			bool batchedResult = false;
+			pair.batchedLeaf(&bot, &agent, 1, &batchedResult);
+			const bool result = pair.leaf(&blackboard);
+			if (result != batchedResult)
+				++pair.mismatchCount;
+			if (result)
+				++pair.trueCount;
+		}
+	}
+
+	for (const LeafPair& pair : leaves)
+	{
+		TEST_CHECK(pair.mismatchCount == 0, "%s: %u of %u situations decided otherwise than the plugin's leaf", pair.name, pair.mismatchCount, SituationCount);
+		TEST_CHECK(pair.trueCount > 0 && pair.trueCount < SituationCount, "%s: never %s, the situations don't try it", pair.name,
+			pair.trueCount == 0 ? "true" : "false");
+		printf("%-16s true in %5u of %u situations\n", pair.name, pair.trueCount, SituationCount);
+	}
+	return Test::Finish("BotBatchLeavesTest");
+}
@@ -0,0 +1,116 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// BotBatchStandIn.h: A made up world for BotBatch & the per-agent trees to compare with
+/*=============================================================================*/
+#pragma once
+#include "BotBatch.h"
+#include "EBehaviorTree.h"
+
+namespace Test
+{
+	//-----------------------------------------------------------------
+	// STAND-IN WORLD
+	//-----------------------------------------------------------------
+	// Takes the place of the exam interface: walks every bot toward its target & makes up
+	// what it perceives. Two worlds with the same seed perceive the same, as long as the
+	// bots made the same decisions.
+	class StandInWorld final
+	{
+	public:
+		explicit StandInWorld(uint64_t seed) : m_Stream(seed) {}
+
+		void Perceive(BotBatch& bots, unsigned int tick)
+		{
+			for (unsigned int bot = 0; bot < bots.GetCount(); ++bot)
+			{
+				const unsigned int hash = (bot * 2654435761u) ^ (tick * 40503u);
+				bots.fovRanges[bot] = 15.f + float(bot % 4) * 5.f;
+				bots.health[bot] = (bots.decisions[bot] & BotBatch::eUseMedkit) ? BotBatch::MaxHealth : std::max(0.f, bots.health[bot] - 0.01f);
+				bots.energy[bot] = (bots.decisions[bot] & BotBatch::eEat) ? BotBatch::MaxEnergy : std::max(0.f, bots.energy[bot] - 0.02f);
+				bots.isInPurgeZone[bot] = hash % 97 < 5;
+				bots.exitsX[bot] = m_Stream.NextBinomial();
+				bots.exitsY[bot] = m_Stream.NextBinomial();
+				bots.seesEnemy[bot] = hash % 13 < 3;
+				bots.enemiesX[bot] = bots.positionsX[bot] + m_Stream.NextBinomial(10.f);
+				bots.enemiesY[bot] = bots.positionsY[bot] + m_Stream.NextBinomial(10.f);
+				bots.seesItem[bot] = hash % 7 == 0;
+				bots.itemsX[bot] = m_Stream.NextBinomial(100.f);
+				bots.itemsY[bot] = m_Stream.NextBinomial(100.f);
+				bots.smallestMedkitValues[bot] = float((hash >> 8) % 4);
+				bots.smallestFoodValues[bot] = float((hash >> 10) % 4);
+				bots.ammo[bot] = (hash >> 12) % 3;
+
+				//Now & then a bot that sees an enemy happens to face it
+				if (!bots.seesEnemy[bot])
+					bots.orientations[bot] += 0.05f;
+				else if (hash % 5 == 0)
+					bots.orientations[bot] = atan2f(bots.enemiesY[bot] - bots.positionsY[bot], bots.enemiesX[bot] - bots.positionsX[bot]) - float(E_PI_2);
+
+				const Elite::Vector2 toTarget{ bots.targetsX[bot] - bots.positionsX[bot], bots.targetsY[bot] - bots.positionsY[bot] };
+				const Elite::Vector2 step = toTarget * (0.1f / (toTarget.Magnitude() + 1e-4f));
+				bots.positionsX[bot] += step.x;
+				bots.positionsY[bot] += step.y;
+				bots.decisions[bot] = BotBatch::eNoDecision;
+				bots.isRunning[bot] = 0;
+			}
+		}
+
+	private:
+		Elite::RandomStream m_Stream;
+	};
+
+	//-----------------------------------------------------------------
+	// PER-AGENT TREES
+	//-----------------------------------------------------------------
+	// The way the batched tree replaces: the same description as one IBehavior tree per bot.
+	// The leaves know their bot instead of looking it up on a blackboard, every blackboard
+	// carries a journal ring of its own & thousands of those don't fit in memory.
+	inline Elite::IBehavior* CreatePerAgentBehavior(const Elite::BatchedBehavior& behavior, BotBatch* pBots, unsigned int bot)
+	{
+		using namespace Elite;
+		std::vector<IBehavior*> children{};
+		for (const BatchedBehavior& child : behavior.children)
+			children.push_back(CreatePerAgentBehavior(child, pBots, bot));
+
+		const BatchedConditional fpConditional = behavior.fpConditional;
+		const BatchedAction fpAction = behavior.fpAction;
+		auto conditional = [fpConditional, pBots, bot](Blackboard*)
+		{
+			bool result = false;
+			fpConditional(pBots, &bot, 1, &result);
+			return result;
+		};
+
+		switch (behavior.type)
+		{
+		case BatchedNodeType::Selector:
+			return new BehaviorSelector(children);
+		case BatchedNodeType::Sequence:
+			return new BehaviorSequence(children);
+		case BatchedNodeType::PartialSequence:
+			return new BehaviorPartialSequence(children);
+		case BatchedNodeType::Conditional:
+			return new BehaviorConditional(conditional);
+		case BatchedNodeType::InvertedConditional:
+			return new BehaviorInvertedConditional(conditional);
+		case BatchedNodeType::Action:
+			return new BehaviorAction([fpAction, pBots, bot](Blackboard*)
+				{
+					BehaviorState result = Failure;
+					fpAction(pBots, &bot, 1, &result);
+					return result;
+				});
+		}
+		return nullptr;
+	}
+
+	//One tree per bot, delete them when done
+	inline std::vector<Elite::BehaviorTree*> CreatePerAgentTrees(const Elite::BatchedBehavior& behavior, BotBatch& bots)
+	{
+		std::vector<Elite::BehaviorTree*> trees{};
+		for (unsigned int bot = 0; bot < bots.GetCount(); ++bot)
+			trees.push_back(new Elite::BehaviorTree{ nullptr, CreatePerAgentBehavior(behavior, &bots, bot) });
+		return trees;
+	}
+}
@@ -0,0 +1,271 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+#include "EBlackboard.h"
+#include "EFiniteStateMachine.h"
+#include "EBehaviorTree.h"
+#include "HouseRegistry.h"
+#include "Inventory.h"
+#include "PurgeZoneMemory.h"
+#include "FakeExamInterface.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// CHECKPOINT RESTORE
+//-----------------------------------------------------------------
+// Restoring a checkpoint that was saved by something set up differently, or that got cut
+// short, has to be turned down as a whole & leave whatever it was restored into as it was.
+// Restoring the same checkpoint over & over the way the plugin does mustn't allocate.
+
+namespace
+{
+	unsigned long long g_AllocationCount = 0;
+}
+
+//Counts every allocation of the test
+void* operator new(size_t size)
+{
+	++g_AllocationCount;
+	if (void* pMemory = malloc(size > 0 ? size : 1))
+		return pMemory;
+	throw std::bad_alloc{};
+}
+void operator delete(void* pMemory) noexcept { free(pMemory); }
+void operator delete(void* pMemory, size_t) noexcept { free(pMemory); }
+
+namespace
+{
+	Blackboard* CreateBlackboard(float health, int ammo)
+	{
+		Blackboard* pBlackboard = new Blackboard{};
+		pBlackboard->AddData("Health", health);
+		pBlackboard->AddData("Ammo", ammo);
+		return pBlackboard;
+	}
+
+	bool Restore(Blackboard& blackboard, const std::vector<unsigned char>& blob)
+	{
+		CheckpointReader reader{ blob.data(), blob.size() };
+		return blackboard.LoadState(reader);
+	}
+
+	void TestBlackboard()
+	{
+		Blackboard* pSaved = CreateBlackboard(25.f, 7);
+		std::vector<unsigned char> blob{};
+		CheckpointWriter writer{ blob };
+		pSaved->SaveState(writer);
+		delete pSaved;
+
+		Blackboard* pRestored = CreateBlackboard(100.f, 0);
+		float health = 0.f;
+		int ammo = 0;
+		TEST_CHECK(Restore(*pRestored, blob), "a matching blackboard checkpoint was turned down");
+		pRestored->GetData("Health", health);
+		pRestored->GetData("Ammo", ammo);
+		TEST_CHECK(health == 25.f && ammo == 7, "restored %.1f health & %d ammo instead of 25 & 7", health, ammo);
+		delete pRestored;
+
+		//Another key, another type & a key less
+		Blackboard renamed{};
+		renamed.AddData("Health", 100.f);
+		renamed.AddData("Food", 3);
+		Blackboard resized{};
+		resized.AddData("Health", 100.f);
+		resized.AddData("Ammo", 3.0);
+		Blackboard shorter{};
+		shorter.AddData("Health", 100.f);
+		Blackboard* pMismatches[] = { &renamed, &resized, &shorter };
+		for (Blackboard* pBlackboard : pMismatches)
+		{
+			TEST_CHECK(!Restore(*pBlackboard, blob), "a blackboard with other keys took the checkpoint");
+			health = 0.f;
+			pBlackboard->GetData("Health", health);
+			TEST_CHECK(health == 100.f, "a turned down checkpoint still changed Health to %.1f", health);
+		}
+
+		//Cut short in the last value
+		Blackboard* pTruncated = CreateBlackboard(100.f, 0);
+		const std::vector<unsigned char> truncatedBlob{ blob.begin(), blob.end() - 1 };
+		TEST_CHECK(!Restore(*pTruncated, truncatedBlob), "a truncated blackboard checkpoint was taken");
+		pTruncated->GetData("Health", health);
+		TEST_CHECK(health == 100.f, "a truncated checkpoint still changed Health to %.1f", health);
+		delete pTruncated;
+	}
+
+	//Two states, the second is entered once Ammo isn't 0
+	FiniteStateMachine* CreateMachine(int ammo)
+	{
+		FiniteStateMachine* pMachine = new FiniteStateMachine{ CreateBlackboard(100.f, ammo) };
+		const FSMStateId idle = pMachine->AddState("Idle");
+		const FSMStateId shoot = pMachine->AddState("Shoot");
+		pMachine->AddTransition(idle, shoot, [](Blackboard* pBlackboard)
+			{
+				int ammo = 0;
+				return pBlackboard->GetData("Ammo", ammo) && ammo != 0;
+			});
+		pMachine->Update(0.f);
+		pMachine->Update(0.f);
+		return pMachine;
+	}
+
+	void TestFiniteStateMachine()
+	{
+		FiniteStateMachine* pSaved = CreateMachine(5);
+		std::vector<unsigned char> blob{};
+		CheckpointWriter writer{ blob };
+		pSaved->SaveState(writer);
+		const FSMStateId savedState = pSaved->GetCurrentState();
+		delete pSaved;
+
+		FiniteStateMachine* pRestored = CreateMachine(0);
+		const FSMStateId liveState = pRestored->GetCurrentState();
+		TEST_CHECK(liveState != savedState, "both machines ended up in the same state");
+
+		const std::vector<unsigned char> truncatedBlob{ blob.begin(), blob.end() - 1 };
+		CheckpointReader truncatedReader{ truncatedBlob.data(), truncatedBlob.size() };
+		TEST_CHECK(!pRestored->LoadState(truncatedReader), "a truncated machine checkpoint was taken");
+		TEST_CHECK(pRestored->GetCurrentState() == liveState, "a truncated checkpoint still changed the state");
+
+		//A state this machine doesn't have
+		std::vector<unsigned char> badStateBlob = blob;
+		const FSMStateId badState = 9;
+		memcpy(badStateBlob.data() + 4 + sizeof(unsigned int), &badState, sizeof(badState));
+		CheckpointReader badStateReader{ badStateBlob.data(), badStateBlob.size() };
+		TEST_CHECK(!pRestored->LoadState(badStateReader), "a machine checkpoint in an unknown state was taken");
+		TEST_CHECK(pRestored->GetCurrentState() == liveState, "an unknown state still changed the state");
+
+		CheckpointReader reader{ blob.data(), blob.size() };
+		TEST_CHECK(pRestored->LoadState(reader), "a matching machine checkpoint was turned down");
+		TEST_CHECK(pRestored->GetCurrentState() == savedState, "restored state %u instead of %u", pRestored->GetCurrentState(), savedState);
+		delete pRestored;
+	}
+
+	BehaviorTree* CreateTree(unsigned int childCount)
+	{
+		std::vector<IBehavior*> children{};
+		for (unsigned int c = 0; c < childCount; ++c)
+			children.push_back(new BehaviorAction{ [](Blackboard*) { return Success; } });
+		return new BehaviorTree{ CreateBlackboard(100.f, 0), new BehaviorPartialSequence{ children } };
+	}
+
+	void TestBehaviorTree()
+	{
+		BehaviorTree* pSaved = CreateTree(3);
+		std::vector<unsigned char> blob{};
+		CheckpointWriter writer{ blob };
+		pSaved->SaveState(writer);
+		delete pSaved;
+
+		BehaviorTree* pSame = CreateTree(3);
+		CheckpointReader reader{ blob.data(), blob.size() };
+		TEST_CHECK(pSame->LoadState(reader) && reader.IsAtEnd(), "a matching tree checkpoint was turned down");
+		delete pSame;
+
+		//A tree with fewer children, then a sequence index past the children
+		BehaviorTree* pSmaller = CreateTree(2);
+		CheckpointReader smallerReader{ blob.data(), blob.size() };
+		TEST_CHECK(!pSmaller->LoadState(smallerReader), "a tree took the checkpoint of a tree with more children");
+		delete pSmaller;
+
+		std::vector<unsigned char> farBlob = blob;
+		const unsigned int farIndex = 3;
+		memcpy(farBlob.data() + farBlob.size() - sizeof(farIndex), &farIndex, sizeof(farIndex));
+		BehaviorTree* pFar = CreateTree(3);
+		CheckpointReader farReader{ farBlob.data(), farBlob.size() };
+		TEST_CHECK(!pFar->LoadState(farReader), "a tree took a sequence index past its children");
+		delete pFar;
+	}
+
+	void TestHouseRegistry()
+	{
+		HouseRegistry saved{};
+		saved.AddHouse(HouseInfo{ Vector2{ 10.f, 0.f }, Vector2{ 5.f, 5.f } });
+		saved.AddHouse(HouseInfo{ Vector2{ -10.f, 0.f }, Vector2{ 5.f, 5.f } });
+		std::vector<unsigned char> blob{};
+		CheckpointWriter writer{ blob };
+		saved.SaveState(writer);
+
+		HouseRegistry restored{};
+		CheckpointReader reader{ blob.data(), blob.size() };
+		TEST_CHECK(restored.LoadState(reader) && restored.GetHouseCount() == 2, "a matching registry checkpoint was turned down");
+
+		//Houses without the queue entries that go with them
+		std::vector<unsigned char> extraBlob = blob;
+		const unsigned int houseCount = 1;
+		memcpy(extraBlob.data() + 4, &houseCount, sizeof(houseCount));
+		extraBlob.erase(extraBlob.begin() + 8 + sizeof(HouseInfo), extraBlob.begin() + 8 + 2 * sizeof(HouseInfo));
+		HouseRegistry mismatched{};
+		CheckpointReader extraReader{ extraBlob.data(), extraBlob.size() };
+		TEST_CHECK(!mismatched.LoadState(extraReader), "a registry took houses that don't match its queue");
+	}
+
+	//Read into scratch objects, checked & swapped with the live ones, like Plugin::RestoreCheckpoint. The
+	//first restores grow the buffers of both, after that they have what the checkpoint needs
+	void TestRestoreWithoutAllocating()
+	{
+		Blackboard* pBlackboard = CreateBlackboard(25.f, 7);
+		pBlackboard->AddData("ExpandingSquareSearchData", Vector2{ 3.f, 4.f }); //Too long for a short string
+		FiniteStateMachine* pMachine = CreateMachine(5);
+		Test::FakeExamInterface fakeInterface{};
+		Inventory inventory{};
+		inventory.Initialize(&fakeInterface, 2, 2, 1);
+		fakeInterface.SetItemValue(1, 5);
+		inventory.AddItem(ItemInfo{ eItemType::MEDKIT, Vector2{}, 1 });
+		HouseRegistry houseRegistry{};
+		houseRegistry.AddHouse(HouseInfo{ Vector2{ 10.f, 0.f }, Vector2{ 5.f, 5.f } });
+		houseRegistry.AddHouse(HouseInfo{ Vector2{ -10.f, 0.f }, Vector2{ 5.f, 5.f } });
+		PurgeZoneMemory purgeZones{};
+		purgeZones.Update(0.f, { PurgeZoneInfo{ Vector2{ 1.f, 1.f }, 5.f, 1 } }, Vector2{}, 1.f);
+
+		std::vector<unsigned char> blob{};
+		CheckpointWriter writer{ blob };
+		pBlackboard->SaveState(writer);
+		pMachine->SaveState(writer);
+		inventory.SaveState(writer);
+		houseRegistry.SaveState(writer);
+		purgeZones.SaveState(writer);
+
+		BlackboardState blackboardState{};
+		Inventory scratchInventory = inventory;
+		HouseRegistry scratchHouseRegistry = houseRegistry;
+		PurgeZoneMemory scratchPurgeZones = purgeZones;
+		unsigned long long allocationCount = 0;
+		for (unsigned int restore = 0; restore < 3; ++restore)
+		{
+			const unsigned long long startCount = g_AllocationCount;
+			CheckpointReader reader{ blob.data(), blob.size() };
+			bool isValid = pBlackboard->ReadState(reader, blackboardState);
+			CheckpointReader machineReader = reader;
+			isValid = isValid
+				&& pMachine->ValidateState(reader)
+				&& scratchInventory.LoadState(reader)
+				&& scratchHouseRegistry.LoadState(reader)
+				&& scratchPurgeZones.LoadState(reader)
+				&& reader.IsAtEnd();
+			TEST_CHECK(isValid, "restore %u turned down a matching checkpoint", restore);
+
+			pBlackboard->ApplyState(blackboardState);
+			pMachine->LoadState(machineReader);
+			std::swap(inventory, scratchInventory);
+			std::swap(houseRegistry, scratchHouseRegistry);
+			std::swap(purgeZones, scratchPurgeZones);
+			allocationCount = g_AllocationCount - startCount;
+		}
+		TEST_CHECK(allocationCount == 0, "the third restore of the same checkpoint still allocated %llu times", allocationCount);
+		TEST_CHECK(inventory.HasItem(eItemType::MEDKIT) && houseRegistry.GetHouseCount() == 2 && purgeZones.GetZoneCount() == 1,
+			"the restored objects don't hold what was saved");
+		delete pMachine;
+		delete pBlackboard;
+	}
+}
+
+int main()
+{
+	TestBlackboard();
+	TestFiniteStateMachine();
+	TestBehaviorTree();
+	TestHouseRegistry();
+	TestRestoreWithoutAllocating();
+	return Test::Finish("CheckpointTest");
+}
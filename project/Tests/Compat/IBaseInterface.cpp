@@ -0,0 +1,48 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "IExamInterface.h"
+
+//-----------------------------------------------------------------
+// BASE INTERFACE
+//-----------------------------------------------------------------
+// The framework's GPP_PluginBase library isn't part of the repo. These are the overloads
+// without a depth that the plugin code calls, they draw on the next depth slice.
+IBaseInterface::IBaseInterface() = default;
+IBaseInterface::~IBaseInterface() = default;
+IExamInterface::IExamInterface() = default;
+IExamInterface::~IExamInterface() = default;
+
+void IBaseInterface::Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color)
+{
+	Draw_Polygon(points, count, color, NextDepthSlice());
+}
+
+void IBaseInterface::Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color)
+{
+	Draw_SolidPolygon(points, count, color, NextDepthSlice());
+}
+
+void IBaseInterface::Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color)
+{
+	Draw_Circle(center, radius, color, NextDepthSlice());
+}
+
+void IBaseInterface::Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color)
+{
+	Draw_SolidCircle(center, radius, axis, color, NextDepthSlice());
+}
+
+void IBaseInterface::Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color)
+{
+	Draw_Segment(p1, p2, color, NextDepthSlice());
+}
+
+void IBaseInterface::Draw_Transform(const b2Transform& xf)
+{
+	Draw_Transform(xf, NextDepthSlice());
+}
+
+void IBaseInterface::Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color)
+{
+	Draw_Point(p, size, color, NextDepthSlice());
+}
@@ -0,0 +1,14 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// windows.h: The handle types SDL_syswm.h names, so stdafx.h compiles off Windows
+/*=============================================================================*/
+#pragma once
+
+//The vendored SDL config is the Windows one, nothing in the tests creates a window
+typedef void* HWND;
+typedef void* HDC;
+typedef void* HINSTANCE;
+typedef unsigned int UINT;
+typedef long long WPARAM;
+typedef long long LPARAM;
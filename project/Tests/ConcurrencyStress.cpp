@@ -0,0 +1,226 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include <thread>
+#include "TestHelpers.h"
+#include "EConcurrency.h"
+#include "BackgroundPlanner.h"
+#include "Inventory.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// CONCURRENCY STRESS
+//-----------------------------------------------------------------
+// A producer & a consumer thread hammer the lock-free hand-offs. Every message carries its
+// sequence number in every word, so a message that's read while it's being written shows up
+// as words that disagree. Build with ELITE_TESTS_TSAN to have ThreadSanitizer watch as well,
+// --long sends ten times as many messages.
+
+namespace
+{
+	//Lengths vary, so slots keep reallocating until they've all held the longest one
+	void FillMessage(std::vector<unsigned int>& message, unsigned int sequence)
+	{
+		message.assign(8 + sequence % 24, sequence);
+	}
+
+	bool IsMessageWhole(const std::vector<unsigned int>& message)
+	{
+		if (message.empty() || message.size() != 8 + message[0] % 24)
+			return false;
+		for (unsigned int word : message)
+		{
+			if (word != message[0])
+				return false;
+		}
+		return true;
+	}
+
+	//Spinning on one core would starve the other side
+	void Backoff()
+	{
+		std::this_thread::yield();
+	}
+
+	void TestSpscRing(unsigned int messageCount)
+	{
+		SpscRing<std::vector<unsigned int>, 8> ring{};
+		unsigned int tornCount = 0, outOfOrderCount = 0, receivedCount = 0;
+
+		std::thread consumer{ [&]()
+			{
+				unsigned int expected = 0;
+				while (expected < messageCount)
+				{
+					const std::vector<unsigned int>* pMessage = ring.BeginPop();
+					if (!pMessage)
+					{
+						Backoff();
+						continue;
+					}
+					if (!IsMessageWhole(*pMessage))
+						++tornCount;
+					else if ((*pMessage)[0] != expected)
+						++outOfOrderCount;
+					ring.EndPop();
+					++expected;
+					++receivedCount;
+				}
+			} };
+
+		for (unsigned int sequence = 0; sequence < messageCount;)
+		{
+			std::vector<unsigned int>* pMessage = ring.BeginPush();
+			if (!pMessage)
+			{
+				Backoff();
+				continue;
+			}
+			FillMessage(*pMessage, sequence++);
+			ring.EndPush();
+		}
+		consumer.join();
+
+		TEST_CHECK(tornCount == 0, "%u of %u messages were torn", tornCount, messageCount);
+		TEST_CHECK(outOfOrderCount == 0, "%u of %u messages were lost or out of order", outOfOrderCount, messageCount);
+		TEST_CHECK(receivedCount == messageCount, "received %u of %u messages", receivedCount, messageCount);
+		TEST_CHECK(ring.BeginPop() == nullptr, "the ring isn't empty after every message was received");
+		printf("SpscRing: %u messages\n", messageCount);
+	}
+
+	void TestTripleBuffer(unsigned int messageCount)
+	{
+		TripleBuffer<std::vector<unsigned int>> buffer{};
+		std::atomic<bool> isWriting{ true };
+		unsigned int tornCount = 0, staleCount = 0, acquiredCount = 0, lastSequence = 0;
+
+		std::thread reader{ [&]()
+			{
+				bool hasValue = false;
+				for (;;)
+				{
+					//Read the flag first, so a final publish is still acquired after the writer stopped
+					const bool isDone = !isWriting.load(std::memory_order_acquire);
+					if (!buffer.Acquire())
+					{
+						if (isDone)
+							break;
+						Backoff();
+						continue;
+					}
+
+					const std::vector<unsigned int>& message = buffer.GetFront();
+					if (!IsMessageWhole(message))
+					{
+						++tornCount;
+						continue;
+					}
+					//Latest value wins, so sequences skip but never repeat or go back
+					if (hasValue && message[0] <= lastSequence)
+						++staleCount;
+					lastSequence = message[0];
+					hasValue = true;
+					++acquiredCount;
+				}
+			} };
+
+		for (unsigned int sequence = 0; sequence < messageCount; ++sequence)
+		{
+			FillMessage(buffer.GetBack(), sequence);
+			buffer.Publish();
+			if (sequence % 64 == 0)
+				Backoff();
+		}
+		isWriting.store(false, std::memory_order_release);
+		reader.join();
+
+		TEST_CHECK(tornCount == 0, "%u reads were torn", tornCount);
+		TEST_CHECK(staleCount == 0, "%u reads repeated or went back to an older value", staleCount);
+		TEST_CHECK(lastSequence == messageCount - 1, "the last value read is %u instead of %u", lastSequence, messageCount - 1);
+		printf("TripleBuffer: %u published, %u acquired\n", messageCount, acquiredCount);
+	}
+
+	//The tick side of the plugin: snapshots go out every tick, plans get picked up whenever they're there
+	void TestBackgroundPlanner(unsigned int tickCount)
+	{
+		const WorldInfo worldInfo{ Vector2{ 0.f, 0.f }, Vector2{ 400.f, 400.f } };
+		std::vector<WallTree::Segment> walls{};
+		for (int i = -4; i <= 4; ++i)
+			walls.push_back(WallTree::Segment{ Vector2{ i * 40.f, -150.f }, Vector2{ i * 40.f, 100.f }, -1 });
+
+		BackgroundPlanner planner{};
+		WorldModel worldModel{};
+		const Inventory inventory{};
+		const std::vector<ItemInfo> itemsInFOV{};
+		InfluenceMap influenceMap{};
+		std::list<EnemyInfo> enemiesInFOV{};
+		std::vector<Vector2> houseCenters{};
+		RandomStream stream{ 11 };
+
+		influenceMap.Initialize(worldInfo);
+		planner.SetWalls(worldInfo, walls);
+		planner.Start();
+
+		unsigned int staleCount = 0, badStopCount = 0, planCount = 0, lastSnapshotId = 0;
+		for (unsigned int tick = 0; tick < tickCount; ++tick)
+		{
+			if (tick % 25 == 0 && houseCenters.size() < 40)
+			{
+				const Vector2 center{ stream.NextFloat(-180.f, 180.f), stream.NextFloat(-180.f, 180.f) };
+				worldModel.AddHouse(HouseInfo{ center, Vector2{ 12.f, 12.f } });
+				houseCenters.push_back(center);
+			}
+			if (tick % 10 == 5 && !houseCenters.empty())
+				worldModel.SetHouseVisited(tick % houseCenters.size(), tick * 0.1f);
+			//The walls get swapped out halfway, like when a level is reloaded
+			if (tick == tickCount / 2)
+				planner.SetWalls(worldInfo, {});
+
+			AgentInfo agentInfo{};
+			agentInfo.Position = Vector2{ 150.f * sinf(tick * 0.01f), 150.f * cosf(tick * 0.013f) };
+			agentInfo.MaxLinearSpeed = 5.f;
+			//A zombie that keeps crossing the houses, so the planning thread reads tiles this thread keeps changing
+			enemiesInFOV.clear();
+			if (tick % 3 == 0)
+			{
+				EnemyInfo zombie{};
+				zombie.Location = Vector2{ 180.f * cosf(tick * 0.02f), 180.f * sinf(tick * 0.03f) };
+				zombie.Size = 1.f;
+				enemiesInFOV.push_back(zombie);
+			}
+			influenceMap.Update(tick * 0.1f, enemiesInFOV);
+			worldModel.SetInfluenceTiles(influenceMap);
+			planner.SubmitSnapshot(worldModel.Publish(tick * 0.1f, agentInfo, inventory, itemsInFOV, enemiesInFOV));
+
+			const LootRoutePlan& plan = planner.AcquireLootRoute();
+			if (plan.snapshotId < lastSnapshotId)
+				++staleCount;
+			if (plan.snapshotId != lastSnapshotId)
+				++planCount;
+			lastSnapshotId = plan.snapshotId;
+			for (const LootRoutePlanner::Stop& stop : plan.tour)
+			{
+				if (stop.house < 0 || stop.house >= int(houseCenters.size()) || stop.position != houseCenters[stop.house])
+					++badStopCount;
+			}
+
+			//Roughly a tick's worth of slack for the planning thread, even on a single core
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+		planner.Stop();
+
+		TEST_CHECK(staleCount == 0, "%u plans were older than the one before", staleCount);
+		TEST_CHECK(badStopCount == 0, "%u tour stops don't match a submitted house", badStopCount);
+		TEST_CHECK(lastSnapshotId > 0, "no plan came back in %u ticks", tickCount);
+		printf("BackgroundPlanner: %u ticks, %u plans for newer snapshots\n", tickCount, planCount);
+		planner.PrintTickReport();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const unsigned int scale = Test::HasArgument(argc, argv, "--long") ? 10 : 1;
+	TestSpscRing(200000 * scale);
+	TestTripleBuffer(200000 * scale);
+	TestBackgroundPlanner(2000 * scale);
+	return Test::Finish("ConcurrencyStress");
+}
@@ -0,0 +1,389 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+#include "EBehaviorTree.h"
+#include "EUtilityDecisionMaking.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// BEHAVIOR TREE VS UTILITY AI
+//-----------------------------------------------------------------
+// The plugin's two ways of deciding, set up with its priorities, weights & curves, play the
+// same seeded runs of a small survival arena: hunger, zombies, purge zones & items to pick
+// up. How long the bot lasts, what it kills & picks up is the quality, nanoseconds per
+// update the cost. The leaves stand in for the plugin's, which need the exam framework.
+// Pass --runs n to change the number of runs (200 by default).
+
+namespace
+{
+	const float MaxHealth = 10.f;
+	const float MaxEnergy = 10.f;
+	const unsigned int MaxTicks = 6000;
+	const unsigned int SlotsPerKind = 2;
+
+	enum class Choice
+	{
+		None, UseMedkit, UseFood, LeavePurgeZone, Face, Shoot, Flee, Seek, Explore
+	};
+	enum class ItemKind
+	{
+		Medkit, Food, Pistol
+	};
+
+	//-----------------------------------------------------------------
+	// ARENA
+	//-----------------------------------------------------------------
+	struct Arena
+	{
+		RandomStream stream;
+		float health = MaxHealth;
+		float energy = MaxEnergy;
+		std::vector<float> medkits = {};
+		std::vector<float> food = {};
+		unsigned int ammo = 0;
+
+		bool seesZombie = false;
+		float zombieDistance = 0.f;
+		bool isFacingZombie = false;
+		unsigned int bittenTicks = 0;
+
+		bool isInPurgeZone = false;
+		float purgeZoneExit = 0.f;
+		unsigned int purgeZoneTicks = 0;
+
+		bool seesItem = false;
+		ItemKind itemKind = ItemKind::Medkit;
+		float itemDistance = 0.f;
+		unsigned int itemTicks = 0;
+
+		Choice choice = Choice::None;
+		unsigned int kills = 0;
+		unsigned int pickups = 0;
+
+		explicit Arena(uint64_t seed) : stream(seed) {}
+
+		bool IsAlive() const { return health > 0.f; }
+
+		//Carries out what was decided this tick, then the world moves on
+		void Step()
+		{
+			switch (choice)
+			{
+			case Choice::UseMedkit: health = std::min(MaxHealth, health + TakeBest(medkits)); break;
+			case Choice::UseFood: energy = std::min(MaxEnergy, energy + TakeBest(food)); break;
+			case Choice::LeavePurgeZone: purgeZoneExit -= 1.f; energy -= 0.01f; break;
+			case Choice::Face: isFacingZombie = true; break;
+			case Choice::Shoot: --ammo; if (stream.NextFloat() < 0.7f) { seesZombie = false; ++kills; } break;
+			case Choice::Flee: zombieDistance += 1.f; energy -= 0.02f; break;
+			case Choice::Seek: itemDistance -= 1.f; break;
+			default: break;
+			}
+			choice = Choice::None;
+
+			energy -= 0.005f;
+			if (energy <= 0.f)
+			{
+				energy = 0.f;
+				health -= 0.02f;
+			}
+
+			UpdateZombie();
+			UpdatePurgeZone();
+			UpdateItem();
+		}
+
+		float TakeBest(std::vector<float>& values)
+		{
+			if (values.empty())
+				return 0.f;
+			const auto best = std::max_element(values.begin(), values.end());
+			const float value = *best;
+			values.erase(best);
+			return value;
+		}
+
+		void UpdateZombie()
+		{
+			if (bittenTicks > 0)
+				--bittenTicks;
+			if (!seesZombie)
+			{
+				if (stream.NextFloat() < 0.01f)
+				{
+					seesZombie = true;
+					zombieDistance = stream.NextFloat(8.f, 20.f);
+					isFacingZombie = false;
+				}
+				return;
+			}
+			zombieDistance -= 0.4f;
+			if (zombieDistance <= 0.f)
+			{
+				health -= 1.f;
+				bittenTicks = 20;
+				zombieDistance = 3.f;
+			}
+			//Outran it
+			if (zombieDistance > 25.f)
+				seesZombie = false;
+		}
+
+		void UpdatePurgeZone()
+		{
+			if (!isInPurgeZone)
+			{
+				if (stream.NextFloat() < 0.002f)
+				{
+					isInPurgeZone = true;
+					purgeZoneExit = stream.NextFloat(5.f, 25.f);
+					purgeZoneTicks = 0;
+				}
+				return;
+			}
+			if (purgeZoneExit <= 0.f)
+				isInPurgeZone = false;
+			else if (++purgeZoneTicks == 40)
+				health = 0.f;
+		}
+
+		void UpdateItem()
+		{
+			if (seesItem)
+			{
+				if (itemDistance <= 0.f)
+				{
+					seesItem = false;
+					if (Collect())
+						++pickups;
+				}
+				else if (++itemTicks > 60)
+				{
+					seesItem = false; //Wandered out of sight
+				}
+				return;
+			}
+			//Exploring turns up items more often
+			if (stream.NextFloat() < (choice == Choice::Explore ? 0.03f : 0.01f))
+			{
+				seesItem = true;
+				itemKind = ItemKind(stream.NextInt(3));
+				itemDistance = stream.NextFloat(2.f, 15.f);
+				itemTicks = 0;
+			}
+		}
+
+		bool Collect()
+		{
+			switch (itemKind)
+			{
+			case ItemKind::Medkit:
+				if (medkits.size() == SlotsPerKind)
+					return false;
+				medkits.push_back(float(1 + stream.NextInt(5)));
+				return true;
+			case ItemKind::Food:
+				if (food.size() == SlotsPerKind)
+					return false;
+				food.push_back(float(1 + stream.NextInt(5)));
+				return true;
+			case ItemKind::Pistol:
+				ammo += 5 + stream.NextInt(10);
+				return true;
+			}
+			return false;
+		}
+	};
+
+	Arena* GetArena(Blackboard* pBlackboard)
+	{
+		Arena* pArena = nullptr;
+		pBlackboard->GetData("Arena", pArena);
+		return pArena;
+	}
+
+	//-----------------------------------------------------------------
+	// LEAVES
+	//-----------------------------------------------------------------
+	// Same meaning as the plugin's, a medkit or food is only used when none of it is wasted
+	bool IsHurt(Blackboard* pBlackboard) { return GetArena(pBlackboard)->health < MaxHealth; }
+	bool HasUsableMedkit(Blackboard* pBlackboard)
+	{
+		const Arena* pArena = GetArena(pBlackboard);
+		for (float value : pArena->medkits)
+		{
+			if (value <= MaxHealth - pArena->health)
+				return true;
+		}
+		return false;
+	}
+	bool IsHungry(Blackboard* pBlackboard) { return GetArena(pBlackboard)->energy < MaxEnergy; }
+	bool HasUsableFood(Blackboard* pBlackboard)
+	{
+		const Arena* pArena = GetArena(pBlackboard);
+		return !pArena->food.empty() && *std::min_element(pArena->food.begin(), pArena->food.end()) < MaxEnergy - pArena->energy;
+	}
+	bool IsInPurgeZone(Blackboard* pBlackboard) { return GetArena(pBlackboard)->isInPurgeZone; }
+	bool IsZombieInFOV(Blackboard* pBlackboard) { return GetArena(pBlackboard)->seesZombie; }
+	bool IsArmed(Blackboard* pBlackboard) { return GetArena(pBlackboard)->ammo > 0; }
+	bool IsFacingEnemy(Blackboard* pBlackboard) { return GetArena(pBlackboard)->isFacingZombie; }
+	bool WasBitten(Blackboard* pBlackboard) { return GetArena(pBlackboard)->bittenTicks > 0; }
+	bool SeesItem(Blackboard* pBlackboard) { return GetArena(pBlackboard)->seesItem; }
+
+	template<Choice choice>
+	BehaviorState Choose(Blackboard* pBlackboard)
+	{
+		GetArena(pBlackboard)->choice = choice;
+		return Success;
+	}
+
+	IBehavior* CreateHealBehavior()
+	{
+		return new BehaviorSequence({ new BehaviorConditional(IsHurt), new BehaviorConditional(HasUsableMedkit), new BehaviorAction(Choose<Choice::UseMedkit>) });
+	}
+	IBehavior* CreateEatBehavior()
+	{
+		return new BehaviorSequence({ new BehaviorConditional(IsHungry), new BehaviorConditional(HasUsableFood), new BehaviorAction(Choose<Choice::UseFood>) });
+	}
+	IBehavior* CreateLeavePurgeZoneBehavior()
+	{
+		return new BehaviorSequence({ new BehaviorConditional(IsInPurgeZone), new BehaviorAction(Choose<Choice::LeavePurgeZone>), new BehaviorInvertedConditional(IsZombieInFOV) });
+	}
+	IBehavior* CreateCombatBehavior()
+	{
+		return new BehaviorSelector(
+			{
+				new BehaviorSequence(
+					{
+						new BehaviorConditional(IsZombieInFOV),
+						new BehaviorConditional(IsArmed),
+						new BehaviorSelector(
+							{
+								new BehaviorSequence({ new BehaviorConditional(IsFacingEnemy), new BehaviorAction(Choose<Choice::Shoot>) }),
+								new BehaviorAction(Choose<Choice::Face>)
+							})
+					}),
+				new BehaviorSequence({ new BehaviorConditional(IsZombieInFOV), new BehaviorInvertedConditional(IsArmed), new BehaviorAction(Choose<Choice::Flee>) }),
+				new BehaviorSequence({ new BehaviorConditional(WasBitten), new BehaviorInvertedConditional(IsArmed), new BehaviorAction(Choose<Choice::Flee>) })
+			});
+	}
+	IBehavior* CreateLootBehavior()
+	{
+		return new BehaviorSequence({ new BehaviorConditional(SeesItem), new BehaviorAction(Choose<Choice::Seek>) });
+	}
+	IBehavior* CreateExploreBehavior()
+	{
+		return new BehaviorAction(Choose<Choice::Explore>);
+	}
+
+	Blackboard* CreateBlackboard(Arena* pArena)
+	{
+		Blackboard* pBlackboard = new Blackboard{};
+		pBlackboard->AddData("Arena", pArena);
+		return pBlackboard;
+	}
+
+	//Plugin::CreateBehaviorTree
+	IDecisionMaking* CreateBehaviorTree(Arena* pArena)
+	{
+		return new BehaviorTree(CreateBlackboard(pArena), new BehaviorSelector(
+			{
+				CreateHealBehavior(),
+				CreateEatBehavior(),
+				CreateLeavePurgeZoneBehavior(),
+				CreateCombatBehavior(),
+				CreateLootBehavior(),
+				CreateExploreBehavior()
+			}));
+	}
+
+	//Plugin::CreateUtilityDecisionMaker
+	IDecisionMaking* CreateUtilityDecisionMaker(Arena* pArena)
+	{
+		enum Considerations
+		{
+			eDamageTaken, eHasUsableMedkit, eEnergyMissing, eHasUsableFood, ePurgeZoneDanger, eZombieThreat, eLootOpportunity
+		};
+		std::vector<Consideration> considerations =
+		{
+			[](Blackboard* pBlackboard) { return (MaxHealth - GetArena(pBlackboard)->health) / MaxHealth; },
+			[](Blackboard* pBlackboard) { return HasUsableMedkit(pBlackboard) ? 1.f : 0.f; },
+			[](Blackboard* pBlackboard) { return (MaxEnergy - GetArena(pBlackboard)->energy) / MaxEnergy; },
+			[](Blackboard* pBlackboard) { return HasUsableFood(pBlackboard) ? 1.f : 0.f; },
+			[](Blackboard* pBlackboard) { return IsInPurgeZone(pBlackboard) ? 1.f : 0.f; },
+			[](Blackboard* pBlackboard) { return IsZombieInFOV(pBlackboard) ? 1.f : (WasBitten(pBlackboard) ? 0.8f : 0.f); },
+			[](Blackboard* pBlackboard) { return SeesItem(pBlackboard) ? 1.f : 0.f; }
+		};
+
+		const ResponseCurve isTrue = ResponseCurve::CreateStep();
+		const ResponseCurve urgency = ResponseCurve::CreateLinear(0.5f, 0.5f);
+		std::vector<UtilityAction> actions =
+		{
+			{ "Flee Purge Zone", 1.0f, { { ePurgeZoneDanger, isTrue } }, CreateLeavePurgeZoneBehavior() },
+			{ "Heal", 0.9f, { { eHasUsableMedkit, isTrue }, { eDamageTaken, urgency } }, CreateHealBehavior() },
+			{ "Eat", 0.85f, { { eHasUsableFood, isTrue }, { eEnergyMissing, urgency } }, CreateEatBehavior() },
+			{ "Fight", 0.8f, { { eZombieThreat, ResponseCurve::CreateLinear() } }, CreateCombatBehavior() },
+			{ "Loot", 0.6f, { { eLootOpportunity, ResponseCurve::CreateLinear() } }, CreateLootBehavior() },
+			{ "Explore", 0.4f, {}, CreateExploreBehavior() }
+		};
+		return new UtilityDecisionMaker(CreateBlackboard(pArena), considerations, actions);
+	}
+
+	struct Results
+	{
+		double ticks = 0.0;
+		double kills = 0.0;
+		double pickups = 0.0;
+		unsigned int survivedCount = 0;
+		double updateNanoseconds = 0.0;
+		unsigned long long updateCount = 0;
+	};
+
+	Results Play(IDecisionMaking* (*fpCreate)(Arena*), unsigned int runCount)
+	{
+		Results results{};
+		for (unsigned int run = 0; run < runCount; ++run)
+		{
+			Arena arena{ 1000 + run };
+			IDecisionMaking* pDecisionMaking = fpCreate(&arena);
+			unsigned int tick = 0;
+			for (; tick < MaxTicks && arena.IsAlive(); ++tick)
+			{
+				const ProfileClock::time_point start = ProfileClock::now();
+				pDecisionMaking->Update(0.f);
+				results.updateNanoseconds += ElapsedMicroseconds(start) * 1000.0;
+				arena.Step();
+			}
+			delete pDecisionMaking;
+
+			results.ticks += tick;
+			results.kills += arena.kills;
+			results.pickups += arena.pickups;
+			results.updateCount += tick;
+			if (arena.IsAlive())
+				++results.survivedCount;
+		}
+		return results;
+	}
+
+	void Print(const char* name, const Results& results, unsigned int runCount)
+	{
+		printf("%-16s %8.0f   %5.1f%%   %6.1f   %7.1f   %8.1f\n", name, results.ticks / runCount, 100.0 * results.survivedCount / runCount,
+			results.kills / runCount, results.pickups / runCount, results.updateNanoseconds / results.updateCount);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int runCount = 200;
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--runs") == 0)
+			runCount = static_cast<unsigned int>(atoi(argv[i + 1]));
+	}
+
+	printf("%u runs of at most %u ticks\n", runCount, MaxTicks);
+	printf("                    ticks   survived    kills   pickups   ns/update\n");
+	Print("Behavior tree", Play(CreateBehaviorTree, runCount), runCount);
+	Print("Utility AI", Play(CreateUtilityDecisionMaker, runCount), runCount);
+	return 0;
+}
@@ -0,0 +1,107 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// FakeExamInterface.h: An exam interface without a world, for tests of the plugin's leaves
+/*=============================================================================*/
+#pragma once
+#include <unordered_map>
+#include "IExamInterface.h"
+
+namespace Test
+{
+	//-----------------------------------------------------------------
+	// FAKE EXAM INTERFACE
+	//-----------------------------------------------------------------
+	// Holds an inventory & an agent, every item's value is what SetItemValue gave its hash.
+	// Everything else answers as if there's nothing in sight & draws nothing.
+	class FakeExamInterface final : public IExamInterface
+	{
+	public:
+		static const UINT Capacity = 5;
+
+		AgentInfo agentInfo = {};
+
+		void SetItemValue(int itemHash, int value) { m_ItemValues[itemHash] = value; }
+		void ClearInventory()
+		{
+			for (bool& isOccupied : m_IsOccupied)
+				isOccupied = false;
+		}
+
+		//World & entities
+		WorldInfo World_GetInfo() const override { return WorldInfo{}; }
+		StatisticsInfo World_GetStats() const override { return StatisticsInfo{}; }
+		bool Fov_GetHouseByIndex(UINT, HouseInfo&) const override { return false; }
+		bool Fov_GetEntityByIndex(UINT, EntityInfo&) const override { return false; }
+		AgentInfo Agent_GetInfo() const override { return agentInfo; }
+		bool Enemy_GetInfo(EntityInfo, EnemyInfo&) override { return false; }
+		Elite::Vector2 NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const override { return goal; }
+
+		//Inventory
+		bool Inventory_AddItem(UINT slotId, ItemInfo item) override
+		{
+			if (slotId >= Capacity || m_IsOccupied[slotId])
+				return false;
+			m_Slots[slotId] = item;
+			m_IsOccupied[slotId] = true;
+			return true;
+		}
+		bool Inventory_UseItem(UINT slotId) override { return slotId < Capacity && m_IsOccupied[slotId]; }
+		bool Inventory_RemoveItem(UINT slotId) override
+		{
+			if (slotId >= Capacity || !m_IsOccupied[slotId])
+				return false;
+			m_IsOccupied[slotId] = false;
+			return true;
+		}
+		bool Inventory_GetItem(UINT slotId, ItemInfo& item) override
+		{
+			if (slotId >= Capacity || !m_IsOccupied[slotId])
+				return false;
+			item = m_Slots[slotId];
+			return true;
+		}
+		UINT Inventory_GetCapacity() const override { return Capacity; }
+
+		//Items
+		bool Item_GetInfo(EntityInfo, ItemInfo&) override { return false; }
+		bool Item_Grab(EntityInfo, ItemInfo&) override { return false; }
+		bool Item_Destroy(EntityInfo) override { return false; }
+		int Weapon_GetAmmo(ItemInfo& item) override { return GetItemValue(item); }
+		int Medkit_GetHealth(ItemInfo& item) override { return GetItemValue(item); }
+		int Food_GetEnergy(ItemInfo& item) override { return GetItemValue(item); }
+		bool PurgeZone_GetInfo(EntityInfo, PurgeZoneInfo&) override { return false; }
+
+		//Debug & input
+		Elite::Vector2 Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const override { return screenPos; }
+		Elite::Vector2 Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const override { return worldPos; }
+		bool Input_IsKeyboardKeyDown(Elite::InputScancode) const override { return false; }
+		bool Input_IsKeyboardKeyUp(Elite::InputScancode) const override { return true; }
+		bool Input_IsMouseButtonDown(Elite::InputMouseButton) const override { return false; }
+		bool Input_IsMouseButtonUp(Elite::InputMouseButton) const override { return true; }
+		Elite::MouseData Input_GetMouseData(Elite::InputType, Elite::InputMouseButton) const override { return Elite::MouseData{}; }
+		void RequestShutdown() const override {}
+
+		//Renderer
+		void Draw_Polygon(const Elite::Vector2*, int, const Elite::Vector3&, float) override {}
+		void Draw_SolidPolygon(const Elite::Vector2*, int, const Elite::Vector3&, float, bool) override {}
+		void Draw_Circle(const Elite::Vector2&, float, const Elite::Vector3&, float) override {}
+		void Draw_SolidCircle(const Elite::Vector2&, float32, const Elite::Vector2&, const Elite::Vector3&, float) override {}
+		void Draw_Segment(const Elite::Vector2&, const Elite::Vector2&, const Elite::Vector3&, float) override {}
+		void Draw_Direction(const Elite::Vector2&, Elite::Vector2, float, const Elite::Vector3&, float) override {}
+		void Draw_Transform(const b2Transform&, float) override {}
+		void Draw_Point(const Elite::Vector2&, float, const Elite::Vector3&, float) override {}
+		float NextDepthSlice() override { return 0.f; }
+
+	private:
+		ItemInfo m_Slots[Capacity] = {};
+		bool m_IsOccupied[Capacity] = {};
+		std::unordered_map<int, int> m_ItemValues = {};
+
+		int GetItemValue(const ItemInfo& item) const
+		{
+			const auto it = m_ItemValues.find(item.ItemHash);
+			return it == m_ItemValues.end() ? 0 : it->second;
+		}
+	};
+}
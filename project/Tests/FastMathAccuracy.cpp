@@ -0,0 +1,323 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// FAST MATH ACCURACY
+//-----------------------------------------------------------------
+// Checks the bounds EFastMath.h documents against double precision std:: functions, for
+// every lane type the build has: float, Float4 with SSE2 & Float8 with AVX. The wide lanes
+// have to give the same bits as float. By default every 61st float of the range is checked,
+// --exhaustive checks all of them (takes minutes).
+namespace
+{
+	const double SinCosBound = 8e-8;
+	const double Atan2Bound = 2.8e-7;
+	const double WrapBound = 2e-7;
+	const float MinAngle = 9.5367431640625e-7f; //2^-20, below that sin(x) is x
+	const float MaxAngle = 8192.f;
+	const unsigned int ChunkSize = 1 << 14; //A multiple of every lane width
+	const double Pi = 3.14159265358979323846;
+
+	//Loads & stores of one lane type, the kernels are instantiated on it directly
+	template<typename V>
+	struct Lanes;
+	template<>
+	struct Lanes<float>
+	{
+		static const unsigned int Width = 1;
+		static const char* GetName() { return "float"; }
+		static float Load(const float* pValues) { return *pValues; }
+		static void Store(float* pValues, float value) { *pValues = value; }
+	};
+#if defined(ELITE_FAST_MATH_SSE)
+	template<>
+	struct Lanes<FastMath::Float4>
+	{
+		static const unsigned int Width = 4;
+		static const char* GetName() { return "Float4"; }
+		static FastMath::Float4 Load(const float* pValues) { return _mm_loadu_ps(pValues); }
+		static void Store(float* pValues, FastMath::Float4 value) { _mm_storeu_ps(pValues, value.v); }
+	};
+#endif
+#if defined(ELITE_FAST_MATH_AVX)
+	template<>
+	struct Lanes<FastMath::Float8>
+	{
+		static const unsigned int Width = 8;
+		static const char* GetName() { return "Float8"; }
+		static FastMath::Float8 Load(const float* pValues) { return _mm256_loadu_ps(pValues); }
+		static void Store(float* pValues, FastMath::Float8 value) { _mm256_storeu_ps(pValues, value.v); }
+	};
+#endif
+
+	struct AngleResults
+	{
+		std::vector<float> sines = std::vector<float>(ChunkSize);
+		std::vector<float> cosines = std::vector<float>(ChunkSize);
+		std::vector<float> wrapped = std::vector<float>(ChunkSize);
+	};
+
+	template<typename V>
+	void EvaluateAngles(const std::vector<float>& angles, AngleResults& results)
+	{
+		for (unsigned int i = 0; i < angles.size(); i += Lanes<V>::Width)
+		{
+			const V angle = Lanes<V>::Load(&angles[i]);
+			V sine, cosine;
+			FastMath::SinCos(angle, sine, cosine);
+			Lanes<V>::Store(&results.sines[i], sine);
+			Lanes<V>::Store(&results.cosines[i], cosine);
+			Lanes<V>::Store(&results.wrapped[i], FastMath::WrapAngle(angle));
+		}
+	}
+
+	template<typename V>
+	void EvaluateAtan2(const std::vector<float>& ys, const std::vector<float>& xs, std::vector<float>& angles)
+	{
+		for (unsigned int i = 0; i < ys.size(); i += Lanes<V>::Width)
+			Lanes<V>::Store(&angles[i], FastMath::Atan2(Lanes<V>::Load(&ys[i]), Lanes<V>::Load(&xs[i])));
+	}
+
+	bool IsSameBits(const std::vector<float>& a, const std::vector<float>& b)
+	{
+		return memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+	}
+
+	//Wide lanes against the float results
+	template<typename V>
+	void CheckAngleLanes(const std::vector<float>& angles, const AngleResults& expected, AngleResults& results)
+	{
+		EvaluateAngles<V>(angles, results);
+		TEST_CHECK(IsSameBits(results.sines, expected.sines) && IsSameBits(results.cosines, expected.cosines),
+			"%s SinCos differs from float", Lanes<V>::GetName());
+		TEST_CHECK(IsSameBits(results.wrapped, expected.wrapped), "%s WrapAngle differs from float", Lanes<V>::GetName());
+	}
+	template<typename V>
+	void CheckAtan2Lanes(const std::vector<float>& ys, const std::vector<float>& xs, const std::vector<float>& expected, std::vector<float>& angles)
+	{
+		EvaluateAtan2<V>(ys, xs, angles);
+		TEST_CHECK(IsSameBits(angles, expected), "%s Atan2 differs from float", Lanes<V>::GetName());
+	}
+
+	struct MaxError
+	{
+		double error = 0.0;
+		float at = 0.f;
+
+		void Add(double value, float input)
+		{
+			if (value > error)
+			{
+				error = value;
+				at = input;
+			}
+		}
+	};
+
+	struct AngleErrors
+	{
+		MaxError sine, cosine, wrap, orientation;
+		unsigned long long count = 0;
+	};
+
+	void CheckAngleChunk(std::vector<float>& angles, AngleErrors& errors, AngleResults& expected, AngleResults& results)
+	{
+		//Padded to a whole chunk, so every lane width divides it
+		const unsigned int count = static_cast<unsigned int>(angles.size());
+		angles.resize(ChunkSize, angles.empty() ? 0.f : angles.back());
+
+		EvaluateAngles<float>(angles, expected);
+#if defined(ELITE_FAST_MATH_SSE)
+		CheckAngleLanes<FastMath::Float4>(angles, expected, results);
+#endif
+#if defined(ELITE_FAST_MATH_AVX)
+		CheckAngleLanes<FastMath::Float8>(angles, expected, results);
+#endif
+		(void)results;
+
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const double angle = angles[i];
+			errors.sine.Add(fabs(expected.sines[i] - std::sin(angle)), angles[i]);
+			errors.cosine.Add(fabs(expected.cosines[i] - std::cos(angle)), angles[i]);
+
+			//The exact wrap can land on either side of +-pi
+			double wrapError = fabs(expected.wrapped[i] - std::remainder(angle, 2.0 * Pi));
+			if (wrapError > Pi)
+				wrapError = fabs(wrapError - 2.0 * Pi);
+			errors.wrap.Add(wrapError, angles[i]);
+
+			//Scalar only, built on the same SinCos
+			const Vector2 direction = FastMath::OrientationToVector(angles[i]);
+			const double directionError = std::max(fabs(direction.x - std::sin(angle)), fabs(direction.y + std::cos(angle)));
+			errors.orientation.Add(directionError, angles[i]);
+			TEST_CHECK(direction.x == FastMath::Sin(angles[i]) && direction.y == -FastMath::Cos(angles[i]),
+				"OrientationToVector(%.9g) isn't (Sin, -Cos)", angles[i]);
+		}
+		errors.count += count;
+		angles.clear();
+	}
+
+	struct Atan2Errors
+	{
+		MaxError atan2;
+		float worstX = 0.f;
+		unsigned long long count = 0;
+	};
+
+	void CheckAtan2Chunk(std::vector<float>& ys, std::vector<float>& xs, Atan2Errors& errors, std::vector<float>& expected, std::vector<float>& angles)
+	{
+		const unsigned int count = static_cast<unsigned int>(ys.size());
+		ys.resize(ChunkSize, ys.empty() ? 0.f : ys.back());
+		xs.resize(ChunkSize, xs.empty() ? 1.f : xs.back());
+		expected.resize(ChunkSize);
+		angles.resize(ChunkSize);
+
+		EvaluateAtan2<float>(ys, xs, expected);
+#if defined(ELITE_FAST_MATH_SSE)
+		CheckAtan2Lanes<FastMath::Float4>(ys, xs, expected, angles);
+#endif
+#if defined(ELITE_FAST_MATH_AVX)
+		CheckAtan2Lanes<FastMath::Float8>(ys, xs, expected, angles);
+#endif
+
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const double error = fabs(expected[i] - std::atan2(double(ys[i]), double(xs[i])));
+			if (error > errors.atan2.error)
+				errors.worstX = xs[i];
+			errors.atan2.Add(error, ys[i]);
+		}
+		errors.count += count;
+		ys.clear();
+		xs.clear();
+	}
+
+	uint32_t GetBits(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+	float FromBits(uint32_t bits)
+	{
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	void CheckAngles(uint32_t stride)
+	{
+		AngleErrors errors{};
+		AngleResults expected{}, results{};
+		std::vector<float> angles{};
+		angles.reserve(ChunkSize);
+
+		//Positive floats are ordered like their bits
+		const uint32_t first = GetBits(MinAngle);
+		const uint32_t last = GetBits(MaxAngle);
+		for (int sign = 0; sign < 2; ++sign)
+		{
+			for (uint64_t bits = first; bits <= last; bits += stride)
+			{
+				const float angle = FromBits(static_cast<uint32_t>(bits));
+				angles.push_back(sign ? -angle : angle);
+				if (angles.size() == ChunkSize)
+					CheckAngleChunk(angles, errors, expected, results);
+			}
+			angles.push_back(sign ? -MaxAngle : MaxAngle);
+		}
+		CheckAngleChunk(angles, errors, expected, results);
+
+		printf("%llu angles, max errors: sin %.3g (at %.9g), cos %.3g (at %.9g), wrap %.3g (at %.9g), orientation %.3g\n", errors.count,
+			errors.sine.error, errors.sine.at, errors.cosine.error, errors.cosine.at, errors.wrap.error, errors.wrap.at, errors.orientation.error);
+		TEST_CHECK(errors.sine.error <= SinCosBound, "Sin error %.3g at %.9g", errors.sine.error, errors.sine.at);
+		TEST_CHECK(errors.cosine.error <= SinCosBound, "Cos error %.3g at %.9g", errors.cosine.error, errors.cosine.at);
+		TEST_CHECK(errors.wrap.error <= WrapBound, "WrapAngle error %.3g at %.9g", errors.wrap.error, errors.wrap.at);
+		TEST_CHECK(errors.orientation.error <= SinCosBound, "OrientationToVector error %.3g at %.9g", errors.orientation.error, errors.orientation.at);
+	}
+
+	void CheckAtan2(uint32_t stride, unsigned int randomCount)
+	{
+		Atan2Errors errors{};
+		std::vector<float> ys{}, xs{}, expected{}, angles{};
+		ys.reserve(ChunkSize);
+		xs.reserve(ChunkSize);
+
+		//Every ratio in [0, 1] in all eight octants, a ratio of 1e-6 & below is atan's own value
+		auto addPair = [&](float y, float x)
+		{
+			ys.push_back(y);
+			xs.push_back(x);
+			if (ys.size() == ChunkSize)
+				CheckAtan2Chunk(ys, xs, errors, expected, angles);
+		};
+		for (uint64_t bits = GetBits(1e-6f); bits <= GetBits(1.f); bits += stride)
+		{
+			const float ratio = FromBits(static_cast<uint32_t>(bits));
+			for (int octant = 0; octant < 4; ++octant)
+			{
+				const float y = (octant & 1) ? -ratio : ratio;
+				const float x = (octant & 2) ? -1.f : 1.f;
+				addPair(y, x);
+				addPair(x, y);
+			}
+		}
+
+		//Pairs of any magnitude
+		Elite::RandomStream stream{ 1 };
+		for (unsigned int i = 0; i < randomCount; ++i)
+		{
+			const float y = stream.NextFloat(-1.f, 1.f) * ldexpf(1.f, stream.NextInt(60) - 30);
+			const float x = stream.NextFloat(-1.f, 1.f) * ldexpf(1.f, stream.NextInt(60) - 30);
+			addPair(y, x);
+		}
+		CheckAtan2Chunk(ys, xs, errors, expected, angles);
+
+		printf("%llu atan2 pairs, max error %.3g (at y %.9g, x %.9g)\n", errors.count, errors.atan2.error, errors.atan2.at, errors.worstX);
+		TEST_CHECK(errors.atan2.error <= Atan2Bound, "Atan2 error %.3g at y %.9g, x %.9g", errors.atan2.error, errors.atan2.at, errors.worstX);
+
+		//Signed zeros like libm, atan2(0, 0) is 0
+		const float zeroCases[][2]{ { 0.f, 1.f }, { -0.f, 1.f }, { 0.f, -1.f }, { -0.f, -1.f }, { 1.f, 0.f }, { -1.f, 0.f }, { 1.f, -0.f }, { -1.f, -0.f } };
+		for (const auto& zeroCase : zeroCases)
+		{
+			const float angle = FastMath::Atan2(zeroCase[0], zeroCase[1]);
+			const float expectedAngle = std::atan2(zeroCase[0], zeroCase[1]);
+			TEST_CHECK(std::signbit(angle) == std::signbit(expectedAngle) && fabsf(angle - expectedAngle) <= Atan2Bound,
+				"Atan2(%g, %g) is %g instead of %g", zeroCase[0], zeroCase[1], angle, expectedAngle);
+		}
+		TEST_CHECK(FastMath::Atan2(0.f, 0.f) == 0.f, "Atan2(0, 0) is %g", FastMath::Atan2(0.f, 0.f));
+
+		const Vector2 velocities[]{ { 0.f, -1.f }, { 1.f, 0.f }, { -3.f, 4.f }, { 0.5f, 0.25f } };
+		for (const Vector2& velocity : velocities)
+		{
+			const float orientation = FastMath::GetOrientationFromVelocity(velocity);
+			TEST_CHECK(fabs(orientation - std::atan2(double(velocity.x), -double(velocity.y))) <= Atan2Bound,
+				"GetOrientationFromVelocity(%g, %g) is %g", velocity.x, velocity.y, orientation);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (!Test::CanRunAvx())
+	{
+		printf("Built with AVX lanes but this CPU has no AVX, skipped\n");
+		return Test::SkipReturnCode;
+	}
+
+	const bool isExhaustive = Test::HasArgument(argc, argv, "--exhaustive");
+#if defined(ELITE_FAST_MATH_AVX)
+	printf("Lanes: float, Float4, Float8\n");
+#elif defined(ELITE_FAST_MATH_SSE)
+	printf("Lanes: float, Float4\n");
+#else
+	printf("Lanes: float\n");
+#endif
+
+	CheckAngles(isExhaustive ? 1 : 61);
+	CheckAtan2(isExhaustive ? 1 : 61, isExhaustive ? 20000000 : 1000000);
+	return Test::Finish("FastMathAccuracy");
+}
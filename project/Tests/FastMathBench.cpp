@@ -0,0 +1,88 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// FAST MATH THROUGHPUT
+//-----------------------------------------------------------------
+// Nanoseconds per element, the C library next to the scalar & array FastMath paths. The
+// arrays use the widest lanes the build has, build FastMathBenchAvx for Float8.
+int main()
+{
+	const unsigned int count = 4096;
+	std::vector<float> angles(count), ys(count), xs(count), sines(count), cosines(count);
+	RandomStream stream{ 3 };
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		angles[i] = stream.NextFloat(-50.f, 50.f);
+		ys[i] = stream.NextFloat(-50.f, 50.f);
+		xs[i] = stream.NextFloat(-50.f, 50.f);
+	}
+
+#if defined(ELITE_FAST_MATH_AVX)
+	printf("Array lanes: Float8\n");
+#elif defined(ELITE_FAST_MATH_SSE)
+	printf("Array lanes: Float4\n");
+#else
+	printf("Array lanes: float\n");
+#endif
+
+	printf("sinf + cosf          %6.2f ns\n", Test::MeasureNanoseconds(count, [&]()
+		{
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				sines[i] = sinf(angles[i]);
+				cosines[i] = cosf(angles[i]);
+			}
+			Test::KeepAlive(sines[count - 1]);
+		}));
+	printf("FastMath::SinCos     %6.2f ns\n", Test::MeasureNanoseconds(count, [&]()
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				FastMath::SinCos(angles[i], sines[i], cosines[i]);
+			Test::KeepAlive(sines[count - 1]);
+		}));
+	printf("SinCos array         %6.2f ns\n", Test::MeasureNanoseconds(count, [&]()
+		{
+			FastMath::SinCos(angles.data(), sines.data(), cosines.data(), count);
+			Test::KeepAlive(sines[count - 1]);
+		}));
+
+	printf("atan2f               %6.2f ns\n", Test::MeasureNanoseconds(count, [&]()
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				sines[i] = atan2f(ys[i], xs[i]);
+			Test::KeepAlive(sines[count - 1]);
+		}));
+	printf("FastMath::Atan2      %6.2f ns\n", Test::MeasureNanoseconds(count, [&]()
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				sines[i] = FastMath::Atan2(ys[i], xs[i]);
+			Test::KeepAlive(sines[count - 1]);
+		}));
+	printf("Atan2 array          %6.2f ns\n", Test::MeasureNanoseconds(count, [&]()
+		{
+			FastMath::Atan2(ys.data(), xs.data(), sines.data(), count);
+			Test::KeepAlive(sines[count - 1]);
+		}));
+
+	printf("remainderf wrap      %6.2f ns\n", Test::MeasureNanoseconds(count, [&]()
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				sines[i] = remainderf(angles[i], 6.28318531f);
+			Test::KeepAlive(sines[count - 1]);
+		}));
+	printf("FastMath::WrapAngle  %6.2f ns\n", Test::MeasureNanoseconds(count, [&]()
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				sines[i] = FastMath::WrapAngle(angles[i]);
+			Test::KeepAlive(sines[count - 1]);
+		}));
+	printf("WrapAngles array     %6.2f ns\n", Test::MeasureNanoseconds(count, [&]()
+		{
+			FastMath::WrapAngles(angles.data(), sines.data(), count);
+			Test::KeepAlive(sines[count - 1]);
+		}));
+	return 0;
+}
@@ -0,0 +1,246 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+#include "InfluenceMap.h"
+#include "WorldModel.h"
+#include "Inventory.h"
+#include "GridDistanceOracle.h"
+#include "LootRoutePlanner.h"
+#include "EliteMath/ERandom.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// INFLUENCE MAP
+//-----------------------------------------------------------------
+// The lazily decayed map next to a dense grid that's decayed in full every tick & stamped
+// with the same kernel, for zombies that wander around for a while & then go out of sight.
+// Every so often both have to give the same danger everywhere. The snapshots the world model
+// publishes along the way have to read the same as the map, and a kept one mustn't change
+// once later ticks copied their tiles over it. Then a loot route has to go around a zombie.
+
+namespace
+{
+	const WorldInfo World{ Vector2{ 0.f, 0.f }, Vector2{ 500.f, 500.f } };
+	const unsigned int TickCount = 6000;
+	const float TickTime = 1.f / 60.f;
+
+	//Everything in one grid, every cell multiplied by the decay every tick
+	class DenseReference final
+	{
+	public:
+		explicit DenseReference(const InfluenceMap& map)
+			: m_Origin(map.GetOrigin())
+			, m_Columns(map.GetColumns())
+			, m_Rows(map.GetRows())
+			, m_Values(m_Columns * m_Rows, 0.f)
+		{}
+
+		void Decay(float elapsed)
+		{
+			const float decay = expf(-logf(2.f) / InfluenceMap::HalfLife * elapsed);
+			for (float& value : m_Values)
+				value *= decay;
+		}
+
+		void Stamp(const EnemyInfo& enemy)
+		{
+			const float weight = InfluenceMap::GetTypeWeight(enemy.Type);
+			const float radius = 6.f + enemy.Size;
+			const Vector2 start = enemy.Location;
+			const Vector2 axis = enemy.LinearVelocity * InfluenceMap::LookAhead;
+			const float axisLengthSquared = axis.MagnitudeSquared();
+			//Every cell within reach of the start, whichever way the zombie heads
+			const float reach = radius + axis.Magnitude() + InfluenceMap::CellSize;
+			const Vector2 first = (start - Vector2{ reach, reach } - m_Origin) / InfluenceMap::CellSize;
+			const Vector2 last = (start + Vector2{ reach, reach } - m_Origin) / InfluenceMap::CellSize;
+			for (int row = std::max(int(first.y), 0); row < std::min(int(last.y) + 1, int(m_Rows)); ++row)
+			{
+				for (int column = std::max(int(first.x), 0); column < std::min(int(last.x) + 1, int(m_Columns)); ++column)
+				{
+					const Vector2 cellCenter = GetCellCenter(column, row);
+					const float t = axisLengthSquared > 0.f ? Clamp((cellCenter - start).Dot(axis) / axisLengthSquared, 0.f, 1.f) : 0.f;
+					const float distance = Distance(cellCenter, start + axis * t);
+					if (distance >= radius)
+						continue;
+					const float falloff = 1.f - distance / radius;
+					float& value = m_Values[row * m_Columns + column];
+					value = std::max(value, weight * falloff * falloff);
+				}
+			}
+		}
+
+		Vector2 GetCellCenter(unsigned int column, unsigned int row) const { return m_Origin + Vector2{ column + 0.5f, row + 0.5f } * InfluenceMap::CellSize; }
+		float GetValue(unsigned int column, unsigned int row) const { return m_Values[row * m_Columns + column]; }
+		unsigned int GetColumns() const { return m_Columns; }
+		unsigned int GetRows() const { return m_Rows; }
+
+	private:
+		Vector2 m_Origin;
+		unsigned int m_Columns;
+		unsigned int m_Rows;
+		std::vector<float> m_Values;
+	};
+
+	//Largest relative error of the map against the reference. A tile is cleared once its peak decays under
+	//MinDanger, so cells under it may already read 0 & aren't counted
+	float CalculateError(const InfluenceMap& map, const DenseReference& reference)
+	{
+		float largestError = 0.f;
+		for (unsigned int row = 0; row < reference.GetRows(); ++row)
+		{
+			for (unsigned int column = 0; column < reference.GetColumns(); ++column)
+			{
+				const float expected = reference.GetValue(column, row);
+				if (expected < InfluenceMap::MinDanger)
+					continue;
+				const float danger = map.GetDanger(reference.GetCellCenter(column, row));
+				largestError = std::max(largestError, abs(danger - expected) / std::max(expected, 1e-3f));
+			}
+		}
+		return largestError;
+	}
+
+	//Counts the cells where the snapshot reads differently than the map (or than it did before)
+	unsigned int CountSnapshotMismatches(const WorldSnapshot& snapshot, const DenseReference& reference, const std::vector<float>& expected)
+	{
+		unsigned int mismatchCount = 0;
+		for (unsigned int row = 0; row < reference.GetRows(); ++row)
+		{
+			for (unsigned int column = 0; column < reference.GetColumns(); ++column)
+			{
+				if (snapshot.GetDanger(reference.GetCellCenter(column, row)) != expected[row * reference.GetColumns() + column])
+					++mismatchCount;
+			}
+		}
+		return mismatchCount;
+	}
+
+	std::vector<float> ReadMap(const InfluenceMap& map, const DenseReference& reference)
+	{
+		std::vector<float> values{};
+		for (unsigned int row = 0; row < reference.GetRows(); ++row)
+		{
+			for (unsigned int column = 0; column < reference.GetColumns(); ++column)
+				values.push_back(map.GetDanger(reference.GetCellCenter(column, row)));
+		}
+		return values;
+	}
+
+	void TestAgainstDenseReference()
+	{
+		InfluenceMap map{};
+		map.Initialize(World);
+		DenseReference reference{ map };
+		WorldModel worldModel{};
+		const Inventory inventory{};
+		const std::vector<ItemInfo> itemsInFOV{};
+		RandomStream stream{ 7 };
+
+		std::vector<EnemyInfo> zombies(6);
+		for (EnemyInfo& zombie : zombies)
+		{
+			zombie.Location = stream.NextVector2(-60.f, 60.f);
+			zombie.Type = eEnemyType(1 + stream.NextInt(3));
+			zombie.Size = 1.f;
+		}
+
+		//A snapshot kept from halfway through the sightings, with what it read back then
+		WorldSnapshot keptSnapshot{};
+		std::vector<float> keptValues{};
+
+		float largestError = 0.f, time = 0.f;
+		unsigned int snapshotMismatchCount = 0, pathMismatchCount = 0;
+		double lazyMicroseconds = 0.0, eagerMicroseconds = 0.0;
+		for (unsigned int tick = 0; tick < TickCount; ++tick)
+		{
+			time += TickTime;
+			std::list<EnemyInfo> enemiesInFOV{};
+			for (EnemyInfo& zombie : zombies)
+			{
+				zombie.LinearVelocity = stream.NextVector2(-3.f, 3.f);
+				zombie.Location += zombie.LinearVelocity * TickTime;
+				//Seen now & then for the first half, then long enough out of sight for every tile to go idle
+				if (stream.NextFloat() < 0.3f && tick < TickCount / 2)
+					enemiesInFOV.push_back(zombie);
+			}
+
+			const ProfileClock::time_point lazyStart = ProfileClock::now();
+			map.Update(time, enemiesInFOV);
+			lazyMicroseconds += ElapsedMicroseconds(lazyStart);
+			const ProfileClock::time_point eagerStart = ProfileClock::now();
+			reference.Decay(TickTime);
+			eagerMicroseconds += ElapsedMicroseconds(eagerStart);
+			for (const EnemyInfo& enemy : enemiesInFOV)
+				reference.Stamp(enemy);
+
+			worldModel.SetInfluenceTiles(map);
+			const WorldSnapshot& snapshot = worldModel.Publish(time, AgentInfo{}, inventory, itemsInFOV, enemiesInFOV);
+			if (tick % 250 == 0)
+			{
+				largestError = std::max(largestError, CalculateError(map, reference));
+				snapshotMismatchCount += CountSnapshotMismatches(snapshot, reference, ReadMap(map, reference));
+				for (unsigned int p = 0; p < 100; ++p)
+				{
+					const Vector2 from = stream.NextVector2(-100.f, 100.f), to = stream.NextVector2(-100.f, 100.f);
+					if (snapshot.GetPathDanger(from, to) != map.GetPathDanger(from, to))
+						++pathMismatchCount;
+				}
+			}
+			if (tick == TickCount / 4)
+			{
+				keptSnapshot = snapshot;
+				keptValues = ReadMap(map, reference);
+			}
+		}
+
+		const unsigned int keptMismatchCount = CountSnapshotMismatches(keptSnapshot, reference, keptValues);
+		TEST_CHECK(largestError < 1e-3f, "the lazy map is off the dense reference by up to %g", largestError);
+		TEST_CHECK(snapshotMismatchCount == 0, "%u cells read differently in the snapshot than in the map", snapshotMismatchCount);
+		TEST_CHECK(pathMismatchCount == 0, "%u path dangers differ between the snapshot & the map", pathMismatchCount);
+		TEST_CHECK(keptMismatchCount == 0, "%u cells of a kept snapshot changed after it was published", keptMismatchCount);
+		TEST_CHECK(map.GetActiveTileCount() == 0, "%u tiles still hold danger long after the last sighting", map.GetActiveTileCount());
+		printf("Dense reference: %u ticks, largest relative error %g, lazy update %.2f us, full grid decay %.2f us per tick\n",
+			TickCount, largestError, lazyMicroseconds / TickCount, eagerMicroseconds / TickCount);
+		worldModel.PrintReport();
+	}
+
+	//Two houses on either side of the agent, a zombie between the agent & the closer one
+	void TestRiskAwareRoute()
+	{
+		InfluenceMap map{};
+		map.Initialize(World);
+		WorldModel worldModel{};
+		const Inventory inventory{};
+		GridDistanceOracle distanceOracle{};
+		distanceOracle.Initialize(World, {});
+		worldModel.AddHouse(HouseInfo{ Vector2{ 30.f, 0.f }, Vector2{ 10.f, 10.f } });
+		worldModel.AddHouse(HouseInfo{ Vector2{ -40.f, 0.f }, Vector2{ 10.f, 10.f } });
+
+		auto getFirstHouse = [&](const std::list<EnemyInfo>& enemiesInFOV)
+		{
+			map.Update(1.f, enemiesInFOV);
+			worldModel.SetInfluenceTiles(map);
+			const WorldSnapshot& snapshot = worldModel.Publish(1.f, AgentInfo{}, inventory, {}, enemiesInFOV);
+			std::vector<LootRoutePlanner::Stop> stops{}, tour{};
+			LootRoutePlanner::GatherStops(snapshot, stops);
+			LootRoutePlanner planner{};
+			planner.Update(snapshot, stops, distanceOracle);
+			planner.GetTour(tour);
+			return tour.empty() ? -1 : tour.front().house;
+		};
+
+		TEST_CHECK(getFirstHouse({}) == 0, "without zombies the route doesn't start at the closer house");
+		EnemyInfo zombie{};
+		zombie.Location = Vector2{ 15.f, 0.f };
+		zombie.Type = eEnemyType::ZOMBIE_NORMAL;
+		zombie.Size = 1.f;
+		TEST_CHECK(getFirstHouse({ zombie }) == 1, "the route walks past the zombie to the closer house first");
+	}
+}
+
+int main()
+{
+	TestAgainstDenseReference();
+	TestRiskAwareRoute();
+	return Test::Finish("InfluenceMapTest");
+}
@@ -0,0 +1,113 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+#include "ItemMemory.h"
+#include "PurgeZoneMemory.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// ITEM MEMORY FOOTPRINT & SCAN COST
+//-----------------------------------------------------------------
+// The quantized records next to a plain vector<ItemInfo> holding the same items: bytes per
+// item & microseconds per FindClosest. Both scans have to come up with the same item, the
+// run fails when they don't or when a code doesn't survive a decode. Pass --items n to
+// change the item count (100k by default).
+
+namespace
+{
+	const WorldInfo World{ Vector2{ 0.f, 0.f }, Vector2{ 500.f, 500.f } };
+	const unsigned int QueryCount = 200;
+
+	//What the memory replaced: every ItemInfo whole, the type test on each one
+	bool FindClosestPlain(const std::vector<ItemInfo>& items, eItemType type, const Vector2& position,
+		const PurgeZoneMemory& purgeZones, ItemInfo& closestItem)
+	{
+		float closestDistance = FLT_MAX;
+		for (const ItemInfo& item : items)
+		{
+			const float distance = DistanceSquared(item.Location, position);
+			if (item.Type == type && distance < closestDistance && !purgeZones.IsInside(item.Location))
+			{
+				closestDistance = distance;
+				closestItem = item;
+			}
+		}
+		return closestDistance < FLT_MAX;
+	}
+
+	void CheckRoundTrip(const ItemMemory& memory)
+	{
+		unsigned int failedCodes = 0;
+		for (unsigned int code = 0; code <= ItemMemory::MaxCode; code += 7)
+		{
+			const unsigned int packed = code | ((ItemMemory::MaxCode - code) << 16);
+			if (memory.Encode(memory.Decode(packed)) != packed)
+				++failedCodes;
+		}
+		TEST_CHECK(failedCodes == 0, "%u codes changed on a decode & encode", failedCodes);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int itemCount = 100000;
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--items") == 0)
+			itemCount = static_cast<unsigned int>(atoi(argv[i + 1]));
+	}
+
+	ItemMemory memory{};
+	memory.Initialize(World);
+	CheckRoundTrip(memory);
+
+	//Items on the same quantized position are one item, so keep adding until there are enough
+	RandomStream stream{ 1 };
+	std::vector<ItemInfo> plainItems{};
+	plainItems.reserve(itemCount);
+	while (plainItems.size() < itemCount)
+	{
+		const ItemInfo item{ eItemType(stream.NextInt(4)), stream.NextVector2(-250.f, 250.f), int(stream.Next()) };
+		if (memory.Add(item))
+			plainItems.push_back(item);
+	}
+	printf("%u items\n", memory.GetCount());
+	printf("Memory        quantized %7.2f bytes per item, plain %7.2f bytes per item\n",
+		float(memory.GetMemoryUsage()) / itemCount, float(sizeof(ItemInfo)));
+	printf("Scanned       quantized %7.2f bytes per item, plain %7.2f bytes per item\n",
+		sizeof(unsigned int) + float(sizeof(unsigned int)) / ItemMemory::TypesPerWord, float(sizeof(ItemInfo)));
+
+	const PurgeZoneMemory purgeZones{};
+	std::vector<Vector2> positions{};
+	for (unsigned int q = 0; q < QueryCount; ++q)
+		positions.push_back(stream.NextVector2(-250.f, 250.f));
+
+	unsigned int mismatchCount = 0;
+	for (unsigned int q = 0; q < QueryCount; ++q)
+	{
+		ItemInfo quantized{}, plain{};
+		memory.FindClosest(eItemType(q % 3), positions[q], purgeZones, quantized);
+		FindClosestPlain(plainItems, eItemType(q % 3), positions[q], purgeZones, plain);
+		if (!memory.IsSameLocation(quantized.Location, plain.Location) || quantized.ItemHash != plain.ItemHash)
+			++mismatchCount;
+	}
+	TEST_CHECK(mismatchCount == 0, "%u of %u queries found another item than the plain scan", mismatchCount, QueryCount);
+
+	const double quantizedNs = Test::MeasureNanoseconds(QueryCount, [&]()
+		{
+			ItemInfo closestItem{};
+			for (unsigned int q = 0; q < QueryCount; ++q)
+				memory.FindClosest(eItemType(q % 3), positions[q], purgeZones, closestItem);
+			Test::KeepAlive(closestItem.ItemHash);
+		}, 5);
+	const double plainNs = Test::MeasureNanoseconds(QueryCount, [&]()
+		{
+			ItemInfo closestItem{};
+			for (unsigned int q = 0; q < QueryCount; ++q)
+				FindClosestPlain(plainItems, eItemType(q % 3), positions[q], purgeZones, closestItem);
+			Test::KeepAlive(closestItem.ItemHash);
+		}, 5);
+	printf("FindClosest   quantized %7.1f us, plain %7.1f us\n", quantizedNs / 1000.0, plainNs / 1000.0);
+
+	return Test::Finish("ItemMemoryBench");
+}
@@ -0,0 +1,212 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include <thread>
+#include "TestHelpers.h"
+#include "EJobSystem.h"
+#include "HouseRegistry.h"
+#include "InfluenceMap.h"
+#include "Inventory.h"
+#include "ItemMemory.h"
+#include "PurgeZoneMemory.h"
+#include "WorldModel.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// JOB SYSTEM COST
+//-----------------------------------------------------------------
+// What forking costs next to what it saves, for the tick phases graph & the house refresh
+// ParallelFor, and the entity & house counts above which they should fork. Ticks are a
+// millisecond apart, long enough for the workers to park in between like they do at 60 ticks
+// a second.
+// Pass --workers n to change the worker count (3 by default, the plugin uses cores - 2).
+
+namespace
+{
+	const unsigned int TickCount = 300;
+	const WorldInfo World{ Vector2{ 0.f, 0.f }, Vector2{ 500.f, 500.f } };
+
+	//Median microseconds of a tick
+	template<typename Function>
+	double MeasureTicks(Function function)
+	{
+		std::vector<double> samples{};
+		for (unsigned int tick = 0; tick < TickCount; ++tick)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			const ProfileClock::time_point start = ProfileClock::now();
+			function(tick);
+			samples.push_back(ElapsedMicroseconds(start));
+		}
+		std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+		return samples[samples.size() / 2];
+	}
+
+	void AddHouses(HouseRegistry& registry, unsigned int count, RandomStream& stream)
+	{
+		for (unsigned int h = 0; h < count; ++h)
+			registry.AddHouse(HouseInfo{ Vector2{ stream.NextFloat(-240.f, 240.f), stream.NextFloat(-240.f, 240.f) }, Vector2{ 15.f, 15.f } });
+	}
+
+	//The plugin's graph at a load of a few items & zombies in sight per ten houses. Perception
+	//makes them up on this thread, the way the plugin fetches them from the interface
+	struct TickPhasesResult
+	{
+		unsigned int entityCount;
+		double inlineTick;
+		double forkedTick;
+	};
+	TickPhasesResult BenchTickPhases(JobSystem& jobSystem, unsigned int houseCount)
+	{
+		RandomStream stream{ 5 };
+		ItemMemory itemMemory{};
+		InfluenceMap influenceMap{};
+		PurgeZoneMemory purgeZoneMemory{};
+		HouseRegistry houseRegistry{};
+		WorldModel worldModel{};
+		const Inventory inventory{};
+		itemMemory.Initialize(World);
+		influenceMap.Initialize(World);
+		AddHouses(houseRegistry, houseCount, stream);
+
+		float time = 0.f;
+		unsigned int tickIndex = 0;
+		AgentInfo agentInfo{};
+		agentInfo.MaxLinearSpeed = 5.f;
+		std::vector<ItemInfo> itemsInFOV{};
+		std::list<EnemyInfo> enemiesInFOV{};
+		const std::list<PurgeZoneInfo> zonesInFOV{};
+		const unsigned int itemCount = std::max(houseCount / 10, 1u), enemyCount = std::max(houseCount / 5, 1u);
+
+		TaskGraph graph{};
+		const unsigned int perception = graph.AddCallingThreadTask("Perception", [&]()
+			{
+				time = tickIndex / 60.f;
+				agentInfo.Position = Vector2{ 200.f * sinf(time * 0.3f), 200.f * cosf(time * 0.2f) };
+				itemsInFOV.clear();
+				for (unsigned int i = 0; i < itemCount; ++i)
+					itemsInFOV.push_back(ItemInfo{ eItemType(i % 3), Vector2{ stream.NextFloat(-240.f, 240.f), stream.NextFloat(-240.f, 240.f) } });
+				enemiesInFOV.clear();
+				for (unsigned int e = 0; e < enemyCount; ++e)
+				{
+					EnemyInfo enemy{};
+					enemy.Location = agentInfo.Position + Vector2{ 10.f + (e % 8) * 3.f, (e % 8) * 2.f - 6.f };
+					enemy.LinearVelocity = Vector2{ -2.f, 1.f };
+					enemy.Size = 1.f;
+					enemiesInFOV.push_back(enemy);
+				}
+			});
+		const unsigned int items = graph.AddTask("Item memory", [&]()
+			{
+				for (const ItemInfo& item : itemsInFOV)
+				{
+					if (itemMemory.Add(item))
+						worldModel.AddItem(item);
+				}
+			}, { perception });
+		const unsigned int influence = graph.AddTask("Influence map", [&]()
+			{
+				influenceMap.Update(time, enemiesInFOV);
+				worldModel.SetInfluenceTiles(influenceMap);
+			}, { perception });
+		const unsigned int zones = graph.AddTask("Purge zone memory", [&]()
+			{
+				purgeZoneMemory.Update(time, zonesInFOV, agentInfo.Position, 1.f);
+				worldModel.SetPurgeZones(purgeZoneMemory);
+			}, { perception });
+		const unsigned int houses = graph.AddTask("House registry", [&]() { houseRegistry.Update(time, agentInfo, jobSystem); }, { items });
+		graph.AddTask("Planning snapshot", [&]()
+			{
+				Test::KeepAlive(worldModel.Publish(time, agentInfo, inventory, itemsInFOV, enemiesInFOV).version);
+			}, { items, influence, zones, houses });
+
+		const unsigned int entityCount = itemCount + enemyCount + houseCount;
+		auto tick = [&](unsigned int index)
+		{
+			tickIndex = index;
+			graph.Execute(jobSystem, entityCount);
+		};
+
+		TickPhasesResult result{ entityCount, 0.0, 0.0 };
+		graph.SetForkThreshold(~0u);
+		result.inlineTick = MeasureTicks(tick);
+		graph.SetForkThreshold(0);
+		result.forkedTick = MeasureTicks(tick);
+		return result;
+	}
+
+	//Where forking the graph starts to pay off, which is what TICK_PHASES_FORK_THRESHOLD in Plugin.h should be
+	void BenchTickPhases(JobSystem& jobSystem)
+	{
+		printf("Tick phases (us)             inline   forked\n");
+		std::vector<TickPhasesResult> results{};
+		for (unsigned int houseCount = 10; houseCount <= 2560; houseCount *= 4)
+		{
+			results.push_back(BenchTickPhases(jobSystem, houseCount));
+			printf("  %5u entities             %7.1f  %7.1f\n", results.back().entityCount, results.back().inlineTick, results.back().forkedTick);
+		}
+
+		//Perception stays on this thread, the rest can at best be shared between all of them
+		const unsigned int threadCount = jobSystem.GetWorkerCount() + 1;
+		//The item memory keeps growing at the larger loads, the cost per entity near the threshold is what counts
+		const double forkCost = results[0].forkedTick - results[0].inlineTick;
+		const double entityCost = (results[1].inlineTick - results[0].inlineTick) / (results[1].entityCount - results[0].entityCount);
+		const double savedPerEntity = entityCost * (threadCount - 1) / threadCount;
+		printf("Fork & join %.1f us, %.1f ns per entity: forking the tick phases pays off above %.0f entities with %u threads\n",
+			forkCost, entityCost * 1000.0, std::max(forkCost, 0.0) / savedPerEntity, threadCount);
+	}
+
+	//Where splitting the refresh over the workers starts to pay off
+	void BenchHouseRefresh(JobSystem& jobSystem)
+	{
+		double forkCost = 0.0, houseCost = 0.0;
+		printf("House registry update (us)   inline   forked\n");
+		for (unsigned int houseCount = 16; houseCount <= 16384; houseCount *= 4)
+		{
+			RandomStream stream{ 7 };
+			HouseRegistry registry{};
+			AddHouses(registry, houseCount, stream);
+			AgentInfo agentInfo{};
+			agentInfo.MaxLinearSpeed = 5.f;
+			auto update = [&](unsigned int tick)
+			{
+				agentInfo.Position = Vector2{ float(tick % 400) - 200.f, 0.f };
+				registry.Update(tick / 60.f, agentInfo, jobSystem);
+			};
+
+			jobSystem.SetInlineThreshold(~0u);
+			const double inlineUpdate = MeasureTicks(update);
+			jobSystem.SetInlineThreshold(0);
+			const double forkedUpdate = MeasureTicks(update);
+			printf("  %5u houses               %7.1f  %7.1f\n", houseCount, inlineUpdate, forkedUpdate);
+
+			//The smallest count is all overhead, the largest all work
+			if (houseCount == 16)
+				forkCost = forkedUpdate - inlineUpdate;
+			houseCost = inlineUpdate / houseCount;
+		}
+
+		//Even with perfect scaling the workers only take a share of the work off this thread
+		const unsigned int threadCount = jobSystem.GetWorkerCount() + 1;
+		const double savedPerHouse = houseCost * (threadCount - 1) / threadCount;
+		printf("Fork & join %.1f us, %.1f ns per house: forking pays off above %.0f houses with %u threads\n",
+			forkCost, houseCost * 1000.0, forkCost / savedPerHouse, threadCount);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int workerCount = 3;
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--workers") == 0)
+			workerCount = static_cast<unsigned int>(atoi(argv[i + 1]));
+	}
+
+	JobSystem jobSystem{};
+	jobSystem.Start(workerCount);
+	printf("%u workers, %u hardware threads\n", jobSystem.GetWorkerCount(), std::thread::hardware_concurrency());
+	BenchTickPhases(jobSystem);
+	BenchHouseRefresh(jobSystem);
+	jobSystem.Stop();
+	return 0;
+}
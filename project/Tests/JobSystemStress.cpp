@@ -0,0 +1,183 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include <thread>
+#include "TestHelpers.h"
+#include "EJobSystem.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// JOB SYSTEM STRESS
+//-----------------------------------------------------------------
+// Forks & joins from every angle with three workers: plain parallel fors, jobs that fork
+// jobs, a task graph that has to keep its order, and forks after the workers parked.
+// Meant to be run with ELITE_TESTS_TSAN too.
+
+namespace
+{
+	const unsigned int WorkerCount = 3;
+	const unsigned int ElementCount = 10000;
+	const long long ElementSum = static_cast<long long>(ElementCount) * (ElementCount - 1) / 2;
+
+	struct SumData
+	{
+		JobSystem* pJobSystem;
+		std::vector<int> values;
+		std::atomic<long long> total;
+		std::atomic<unsigned int> countedJobCount;
+	};
+
+	void SumRange(void* pData, unsigned int begin, unsigned int end)
+	{
+		SumData* pSum = static_cast<SumData*>(pData);
+		long long total = 0;
+		for (unsigned int i = begin; i < end; ++i)
+			total += pSum->values[i];
+		pSum->total.fetch_add(total, std::memory_order_relaxed);
+	}
+
+	//Every element forks & joins ten of its own
+	void SumNested(void* pData, unsigned int begin, unsigned int end)
+	{
+		SumData* pSum = static_cast<SumData*>(pData);
+		for (unsigned int i = begin; i < end; ++i)
+		{
+			std::atomic<unsigned int> pending{ 0 };
+			pSum->pJobSystem->Run(&SumRange, pSum, i * 10, i * 10 + 10, pending);
+			pSum->pJobSystem->Wait(pending);
+		}
+	}
+
+	void SumRangeCounted(void* pData, unsigned int begin, unsigned int end)
+	{
+		SumData* pSum = static_cast<SumData*>(pData);
+		SumRange(pData, begin, end);
+		pSum->countedJobCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	//Waits until every worker parked, false after a second
+	bool WaitUntilParked(const JobSystem& jobSystem)
+	{
+		const ProfileClock::time_point start = ProfileClock::now();
+		while (jobSystem.GetParkedCount() != jobSystem.GetWorkerCount())
+		{
+			if (ElapsedMicroseconds(start) > 1e6)
+				return false;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	void TestParallelFor(JobSystem& jobSystem, SumData& sum)
+	{
+		unsigned int wrongCount = 0;
+		for (unsigned int run = 0; run < 200; ++run)
+		{
+			sum.total = 0;
+			jobSystem.ParallelFor(ElementCount, 64, &SumRange, &sum);
+			if (sum.total != ElementSum)
+				++wrongCount;
+		}
+		TEST_CHECK(wrongCount == 0, "%u of 200 parallel sums were wrong", wrongCount);
+
+		wrongCount = 0;
+		for (unsigned int run = 0; run < 50; ++run)
+		{
+			sum.total = 0;
+			jobSystem.ParallelFor(ElementCount / 10, 4, &SumNested, &sum);
+			if (sum.total != ElementSum)
+				++wrongCount;
+		}
+		TEST_CHECK(wrongCount == 0, "%u of 50 nested sums were wrong", wrongCount);
+	}
+
+	void TestTaskGraph(JobSystem& jobSystem)
+	{
+		//c needs a & the calling thread task, d needs all of them, so after every run they've all run as often
+		TaskGraph graph{};
+		unsigned int a = 0, b = 0, c = 0, d = 0, e = 0, outOfOrderCount = 0, wrongThreadCount = 0;
+		const std::thread::id callingThread = std::this_thread::get_id();
+		const unsigned int taskE = graph.AddCallingThreadTask("e", [&]()
+			{
+				if (std::this_thread::get_id() != callingThread)
+					++wrongThreadCount;
+				++e;
+			});
+		const unsigned int taskA = graph.AddTask("a", [&]() { ++a; });
+		const unsigned int taskB = graph.AddTask("b", [&]() { ++b; });
+		const unsigned int taskC = graph.AddTask("c", [&]()
+			{
+				if (c + 1 != a || c + 1 != e)
+					++outOfOrderCount;
+				++c;
+			}, { taskA, taskE });
+		graph.AddTask("d", [&]()
+			{
+				if (d + 1 != b || d + 1 != c)
+					++outOfOrderCount;
+				++d;
+			}, { taskA, taskB, taskC });
+
+		for (unsigned int run = 0; run < 2000; ++run)
+			graph.Execute(jobSystem, ElementCount);
+		TEST_CHECK(outOfOrderCount == 0, "%u tasks ran before their dependencies", outOfOrderCount);
+		TEST_CHECK(wrongThreadCount == 0, "the calling thread task was forked %u times", wrongThreadCount);
+		TEST_CHECK(a == 2000 && b == 2000 && c == 2000 && d == 2000 && e == 2000, "tasks ran %u, %u, %u, %u & %u times instead of 2000", a, b, c, d, e);
+	}
+
+	//Like in between ticks: the workers park, the next fork has to get them going again
+	void TestParking(JobSystem& jobSystem, SumData& sum)
+	{
+		unsigned int wrongCount = 0, neverParkedCount = 0;
+		for (unsigned int tick = 0; tick < 20; ++tick)
+		{
+			if (!WaitUntilParked(jobSystem))
+				++neverParkedCount;
+
+			sum.total = 0;
+			jobSystem.ParallelFor(ElementCount, 16, &SumRange, &sum);
+			if (sum.total != ElementSum)
+				++wrongCount;
+		}
+		TEST_CHECK(neverParkedCount == 0, "the workers didn't park within a second %u times", neverParkedCount);
+		TEST_CHECK(wrongCount == 0, "%u of 20 sums after parking were wrong", wrongCount);
+		printf("Parking: %u workers parked & woken 20 times\n", jobSystem.GetWorkerCount());
+
+		//Jobs left in the deque for the parked workers alone to find, this thread doesn't wait on them
+		const unsigned int jobCount = 64;
+		sum.countedJobCount = 0;
+		for (unsigned int tick = 0; tick < 5; ++tick)
+		{
+			WaitUntilParked(jobSystem);
+			const unsigned int countedJobCount = sum.countedJobCount;
+			std::atomic<unsigned int> pending{ 0 };
+			for (unsigned int job = 0; job < jobCount; ++job)
+				jobSystem.Run(&SumRangeCounted, &sum, 0, 1, pending);
+
+			const ProfileClock::time_point start = ProfileClock::now();
+			while (pending.load(std::memory_order_acquire) != 0 && ElapsedMicroseconds(start) < 1e6)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			TEST_CHECK(pending == 0, "%u of %u jobs weren't picked up by the woken workers", pending.load(), jobCount);
+			TEST_CHECK(sum.countedJobCount - countedJobCount == jobCount, "the workers ran %u of %u jobs", sum.countedJobCount - countedJobCount, jobCount);
+			jobSystem.Wait(pending);
+		}
+	}
+}
+
+int main()
+{
+	JobSystem jobSystem{};
+	jobSystem.Start(WorkerCount);
+	jobSystem.SetInlineThreshold(8);
+
+	SumData sum{};
+	sum.pJobSystem = &jobSystem;
+	for (unsigned int i = 0; i < ElementCount; ++i)
+		sum.values.push_back(int(i));
+
+	TestParallelFor(jobSystem, sum);
+	TestTaskGraph(jobSystem);
+	TestParking(jobSystem, sum);
+	printf("%u steals\n", jobSystem.GetStealCount());
+	jobSystem.Stop();
+	return Test::Finish("JobSystemStress");
+}
@@ -0,0 +1,106 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// MATRIX2X3
+//-----------------------------------------------------------------
+// The constexpr parts are checked while compiling. The batch transforms have to give the same
+// bits as Transform for every count from 0 to 1001, so every mix of full lanes & leftovers,
+// into separate outputs & in place. Built once with the default lanes & once with AVX, like
+// FastMathAccuracy.
+
+namespace
+{
+	constexpr Matrix2x3 Chain[3] = { Matrix2x3::CreateTranslationMatrix(3.f, 4.f), Matrix2x3::CreateScalingMatrix(2.f),
+		Matrix2x3{ 0.f, 1.f, -1.f, 0.f, 1.f, 2.f } };
+	constexpr Matrix2x3 Composed = Matrix2x3::Compose(Chain, 3);
+	static_assert(Composed.Equals(Chain[0] * Chain[1] * Chain[2]), "Compose multiplies the chain in order");
+	static_assert(Matrix2x3::Compose(Chain, 0) == Matrix2x3::CreateIdentityMatrix(), "An empty chain is the identity");
+	static_assert(Composed.Inverse() * Composed == Matrix2x3::CreateIdentityMatrix(), "Inverse undoes the matrix");
+	static_assert(Composed.Determinant() == 4.f, "Scaling by 2 & a quarter turn scale areas by 4");
+	static_assert(Composed.Transform(Vector2{ 1.f, 1.f }).x == 3.f && Composed.Transform(Vector2{ 1.f, 1.f }).y == 10.f,
+		"Transform applies the last matrix of the chain first");
+	static_assert(!Matrix2x3{}.Equals(Matrix2x3::CreateTranslationMatrix(0.01f, 0.f)), "Equals is within 0.001 by default");
+	static_assert(Matrix2x3{}.Equals(Matrix2x3::CreateTranslationMatrix(0.01f, 0.f), 0.02f), "Equals takes another epsilon");
+
+	const unsigned int MaxCount = 1001;
+
+	bool IsSame(const Vector2& a, float x, float y)
+	{
+		return a.x == x && a.y == y;
+	}
+
+	void CheckBatches(const Matrix2x3& matrix, RandomStream& stream)
+	{
+		std::vector<float> xs(MaxCount), ys(MaxCount), transformedXs(MaxCount), transformedYs(MaxCount);
+		std::vector<Vector2> points(MaxCount), transformed(MaxCount), inverted(MaxCount);
+		unsigned int wrongCount = 0, wrongInPlaceCount = 0, wrongInverseCount = 0;
+		const Matrix2x3 inverse = matrix.Inverse();
+		for (unsigned int count = 0; count <= MaxCount; ++count)
+		{
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				points[i] = stream.NextVector2(-200.f, 200.f);
+				xs[i] = points[i].x;
+				ys[i] = points[i].y;
+			}
+			//A value past the end that has to stay as it is
+			if (count < MaxCount)
+			{
+				transformedXs[count] = transformedYs[count] = -1.f;
+				transformed[count] = Vector2{ -1.f, -1.f };
+			}
+
+			matrix.TransformPoints(xs.data(), ys.data(), transformedXs.data(), transformedYs.data(), count);
+			matrix.TransformPolygon(points.data(), transformed.data(), count);
+			matrix.InverseTransformPolygon(points.data(), inverted.data(), count);
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				const Vector2 expected = matrix.Transform(points[i]);
+				if (!IsSame(expected, transformedXs[i], transformedYs[i]) || !IsSame(expected, transformed[i].x, transformed[i].y))
+					++wrongCount;
+				if (!IsSame(inverse.Transform(points[i]), inverted[i].x, inverted[i].y))
+					++wrongInverseCount;
+			}
+			if (count < MaxCount && (transformedXs[count] != -1.f || transformedYs[count] != -1.f || !IsSame(transformed[count], -1.f, -1.f)))
+				++wrongCount;
+
+			//In place
+			matrix.TransformPoints(xs.data(), ys.data(), xs.data(), ys.data(), count);
+			std::vector<Vector2> inPlace(points.begin(), points.begin() + count);
+			matrix.TransformPolygon(inPlace.data(), inPlace.data(), count);
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				if (!IsSame(inPlace[i], xs[i], ys[i]) || !IsSame(matrix.Transform(points[i]), xs[i], ys[i]))
+					++wrongInPlaceCount;
+			}
+		}
+		TEST_CHECK(wrongCount == 0, "%u batch transforms differ from Transform", wrongCount);
+		TEST_CHECK(wrongInPlaceCount == 0, "%u batch transforms in place differ from Transform", wrongInPlaceCount);
+		TEST_CHECK(wrongInverseCount == 0, "%u inverse batch transforms differ from Transform through Inverse", wrongInverseCount);
+	}
+}
+
+int main()
+{
+	if (!Test::CanRunAvx())
+	{
+		printf("Built with AVX lanes but this CPU has no AVX, skipped\n");
+		return Test::SkipReturnCode;
+	}
+#if defined(ELITE_FAST_MATH_AVX)
+	printf("Lanes: float, Float4, Float8\n");
+#elif defined(ELITE_FAST_MATH_SSE)
+	printf("Lanes: float, Float4\n");
+#else
+	printf("Lanes: float\n");
+#endif
+
+	RandomStream stream{ 3 };
+	CheckBatches(Matrix2x3::CreateRotationMatrix(33.f) * Matrix2x3::CreateTranslationMatrix(-12.f, 40.f), stream);
+	CheckBatches(Composed, stream);
+	CheckBatches(Matrix2x3{}, stream);
+	return Test::Finish("Matrix2x3Test");
+}
@@ -0,0 +1,158 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "TestHelpers.h"
+#include "ObstacleAvoidance.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// OBSTACLE AVOIDANCE COST
+//-----------------------------------------------------------------
+// Nanoseconds per packet of five feelers, the wall tree next to testing every wall, for towns
+// of a hundred to a few thousand walls. Both have to report the same hits. Then whole avoidance
+// queries on the exam level, pass --level path for another level file.
+
+namespace
+{
+	const unsigned int PacketCount = 4096;
+
+	//Houses on a grid, each a rectangle with a door in its bottom wall, like the level's
+	std::vector<WallTree::Segment> CreateTown(unsigned int houseCount, RandomStream& stream)
+	{
+		std::vector<WallTree::Segment> walls{};
+		const unsigned int columns = static_cast<unsigned int>(ceilf(sqrtf(float(houseCount))));
+		const float spacing = 480.f / columns;
+		for (unsigned int h = 0; h < houseCount; ++h)
+		{
+			const Vector2 center{ -240.f + spacing * (h % columns + 0.5f), -240.f + spacing * (h / columns + 0.5f) };
+			const Vector2 halfSize = Vector2{ stream.NextFloat(0.25f, 0.4f), stream.NextFloat(0.25f, 0.4f) } * spacing;
+			const Vector2 min = center - halfSize, max = center + halfSize;
+			const float door = halfSize.x * 0.3f;
+			const int house = int(h);
+			walls.push_back(WallTree::Segment{ Vector2{ min.x, max.y }, max, house });
+			walls.push_back(WallTree::Segment{ min, Vector2{ min.x, max.y }, house });
+			walls.push_back(WallTree::Segment{ Vector2{ max.x, min.y }, max, house });
+			walls.push_back(WallTree::Segment{ min, Vector2{ center.x - door, min.y }, house });
+			walls.push_back(WallTree::Segment{ Vector2{ center.x + door, min.y }, Vector2{ max.x, min.y }, house });
+		}
+		return walls;
+	}
+
+	//The avoidance feelers from somewhere in the town, heading anywhere
+	WallTree::RayPacket CreateFeelers(RandomStream& stream)
+	{
+		const float angles[5] = { 0.f, ToRadians(30.f), -ToRadians(30.f), ToRadians(60.f), -ToRadians(60.f) };
+		const float lengths[5] = { 1.f, 0.75f, 0.75f, 0.5f, 0.5f };
+		const float orientation = stream.NextFloat(-float(E_PI), float(E_PI));
+		const float feelerLength = stream.NextFloat(2.f, 9.5f);
+
+		WallTree::RayPacket packet{};
+		packet.origin = stream.NextVector2(-240.f, 240.f);
+		packet.count = 5;
+		for (unsigned int r = 0; r < packet.count; ++r)
+			packet.directions[r] = OrientationToVector(orientation + angles[r]) * (feelerLength * lengths[r]);
+		return packet;
+	}
+
+	//Every wall against every feeler, what the tree saves its traversal from
+	void RayCastAll(const std::vector<WallTree::Segment>& walls, WallTree::RayPacket& packet)
+	{
+		for (unsigned int r = 0; r < packet.count; ++r)
+			packet.fractions[r] = 1.f;
+		for (const WallTree::Segment& segment : walls)
+		{
+			const Vector2 wall = segment.end - segment.start;
+			const Vector2 toWall = segment.start - packet.origin;
+			for (unsigned int r = 0; r < packet.count; ++r)
+			{
+				const float denominator = packet.directions[r].Cross(wall);
+				if (abs(denominator) < FLT_EPSILON)
+					continue;
+				const float t = toWall.Cross(wall) / denominator;
+				const float u = toWall.Cross(packet.directions[r]) / denominator;
+				if (t >= 0.f && t < packet.fractions[r] && u >= 0.f && u <= 1.f)
+					packet.fractions[r] = t;
+			}
+		}
+	}
+
+	void BenchTowns()
+	{
+		printf("Feeler packets (ns)      tree   every wall\n");
+		for (unsigned int houseCount = 20; houseCount <= 640; houseCount *= 2)
+		{
+			RandomStream stream{ houseCount };
+			const std::vector<WallTree::Segment> walls = CreateTown(houseCount, stream);
+			WallTree tree{};
+			tree.Build(walls);
+			std::vector<WallTree::RayPacket> packets{}, allPackets{};
+			for (unsigned int p = 0; p < PacketCount; ++p)
+				packets.push_back(CreateFeelers(stream));
+			allPackets = packets;
+
+			const double treeNs = Test::MeasureNanoseconds(PacketCount, [&]()
+				{
+					for (WallTree::RayPacket& packet : packets)
+						tree.RayCast(packet);
+					Test::KeepAlive(packets.back().fractions[0]);
+				});
+			const double allNs = Test::MeasureNanoseconds(PacketCount, [&]()
+				{
+					for (WallTree::RayPacket& packet : allPackets)
+						RayCastAll(walls, packet);
+					Test::KeepAlive(allPackets.back().fractions[0]);
+				}, 5);
+
+			unsigned int mismatchCount = 0, hitCount = 0;
+			for (unsigned int p = 0; p < PacketCount; ++p)
+			{
+				for (unsigned int r = 0; r < packets[p].count; ++r)
+				{
+					if (abs(packets[p].fractions[r] - allPackets[p].fractions[r]) > 1e-5f)
+						++mismatchCount;
+					if (packets[p].fractions[r] < 1.f)
+						++hitCount;
+				}
+			}
+			TEST_CHECK(mismatchCount == 0, "%u of %u feelers hit something else than testing every wall", mismatchCount, PacketCount * 5);
+			printf("  %5u walls          %7.1f  %9.1f   (%.0f%% of feelers hit)\n", unsigned(walls.size()), treeNs, allNs,
+				100.0 * hitCount / (PacketCount * 5));
+		}
+	}
+
+	void BenchLevel(const char* levelPath)
+	{
+		ObstacleAvoidance avoidance{};
+		if (!avoidance.LoadLevel(levelPath))
+		{
+			printf("No level at %s, skipped the level queries\n", levelPath);
+			return;
+		}
+
+		RandomStream stream{ 9 };
+		AgentInfo agentInfo{};
+		agentInfo.AgentSize = 1.f;
+		agentInfo.MaxLinearSpeed = 10.f;
+		for (unsigned int q = 0; q < 100000; ++q)
+		{
+			agentInfo.Position = stream.NextVector2(-150.f, 150.f);
+			agentInfo.LinearVelocity = OrientationToVector(stream.NextFloat(-float(E_PI), float(E_PI))) * 10.f;
+			Test::KeepAlive(avoidance.CalculateSteering(agentInfo, Vector2{ 0.f, 0.f }).x);
+		}
+		printf("%s, %u walls: ", levelPath, avoidance.GetWallCount());
+		avoidance.GetQueryStats().Print("avoidance query (us)");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const char* levelPath = ELITE_TESTS_LEVEL_FILE;
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--level") == 0)
+			levelPath = argv[i + 1];
+	}
+
+	BenchTowns();
+	BenchLevel(levelPath);
+	return Test::Finish("ObstacleAvoidanceBench");
+}
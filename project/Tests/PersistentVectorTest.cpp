@@ -0,0 +1,223 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include <thread>
+#include <deque>
+#include "TestHelpers.h"
+#include "EConcurrency.h"
+#include "EPersistentVector.h"
+#include "EliteMath/ERandom.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// PERSISTENT VECTOR
+//-----------------------------------------------------------------
+// A VersionedVector & a std::vector get the same random changes, every so often a version is
+// published & kept along with a copy of the std::vector. Once done every kept version still
+// has to hold what the std::vector did back then. Then a reader thread holds on to versions
+// while this thread keeps changing the nodes they share, the way the planning thread reads
+// world snapshots. Build with ELITE_TESTS_TSAN to have ThreadSanitizer watch as well, --long
+// runs ten times as many changes.
+
+namespace
+{
+	struct Element
+	{
+		unsigned int id;
+		float x;
+		float y;
+	};
+
+	bool operator==(const Element& a, const Element& b)
+	{
+		return a.id == b.id && a.x == b.x && a.y == b.y;
+	}
+
+	Element CreateElement(RandomStream& stream)
+	{
+		return Element{ static_cast<unsigned int>(stream.Next()), stream.NextFloat(-100.f, 100.f), stream.NextFloat(-100.f, 100.f) };
+	}
+
+	//One random change to both, pushes win so the vectors grow past a few trie levels
+	void ChangeBoth(VersionedVector<Element>& versioned, std::vector<Element>& reference, RandomStream& stream)
+	{
+		const int operation = stream.NextInt(100);
+		const unsigned int size = static_cast<unsigned int>(reference.size());
+		if (operation < 55 || size == 0)
+		{
+			const Element element = CreateElement(stream);
+			versioned.PushBack(element);
+			reference.push_back(element);
+		}
+		else if (operation < 75)
+		{
+			const unsigned int index = static_cast<unsigned int>(stream.NextInt(int(size)));
+			versioned.RemoveSwap(index);
+			reference[index] = reference.back();
+			reference.pop_back();
+		}
+		else if (operation < 99)
+		{
+			const unsigned int index = static_cast<unsigned int>(stream.NextInt(int(size)));
+			const Element element = CreateElement(stream);
+			versioned.Set(index, element);
+			reference[index] = element;
+		}
+		else
+		{
+			//Shrinking & growing again has to bring back default elements, not the old ones
+			const unsigned int newSize = static_cast<unsigned int>(std::max(int(size) - 64 + stream.NextInt(128), 0));
+			versioned.Resize(newSize);
+			reference.resize(newSize, Element{});
+		}
+	}
+
+	//Both ways of reading a version
+	bool IsVersionOf(const PersistentVector<Element>& version, const std::vector<Element>& reference)
+	{
+		if (version.GetSize() != reference.size())
+			return false;
+		for (unsigned int i = 0; i < reference.size(); ++i)
+		{
+			if (!(version[i] == reference[i]))
+				return false;
+		}
+		unsigned int index = 0;
+		bool isSame = true;
+		version.ForEach([&](const Element& element) { isSame &= index < reference.size() && element == reference[index++]; });
+		return isSame && index == reference.size();
+	}
+
+	void TestDifferential(unsigned int changeCount)
+	{
+		const unsigned int keepInterval = changeCount / 2000; //In publishes, about 570 versions are kept for any change count
+		RandomStream stream{ 11 };
+		VersionedVector<Element> versioned{};
+		std::vector<Element> reference{};
+		std::vector<PersistentVector<Element>> versions{};
+		std::vector<std::vector<Element>> references{};
+		unsigned int largestSize = 0;
+
+		for (unsigned int change = 1; change <= changeCount; ++change)
+		{
+			ChangeBoth(versioned, reference, stream);
+			largestSize = std::max(largestSize, static_cast<unsigned int>(reference.size()));
+			//Published often, a version is kept now & then, sometimes two right after each other
+			if (change % 7 == 0)
+			{
+				const PersistentVector<Element> version = versioned.Publish();
+				if ((change / 7) % keepInterval < 2)
+				{
+					versions.push_back(version);
+					references.push_back(reference);
+				}
+			}
+			if (change == changeCount / 2)
+			{
+				versioned.Clear();
+				reference.clear();
+			}
+		}
+
+		unsigned int wrongCount = 0;
+		for (unsigned int v = 0; v < versions.size(); ++v)
+		{
+			if (!IsVersionOf(versions[v], references[v]))
+				++wrongCount;
+		}
+		TEST_CHECK(wrongCount == 0, "%u of %u kept versions changed after they were published", wrongCount, unsigned(versions.size()));
+		TEST_CHECK(largestSize > PersistentVector<Element>::Branching * PersistentVector<Element>::Branching,
+			"the vector only got to %u elements, the trie never got three levels deep", largestSize);
+		printf("Differential: %u changes, %u versions kept, up to %u elements, %u nodes copied\n",
+			changeCount, unsigned(versions.size()), largestSize, versioned.GetCopiedNodeCount());
+	}
+
+	//A version & what it should hold, summed so the reader doesn't need the whole std::vector
+	struct Message
+	{
+		PersistentVector<Element> version;
+		unsigned int size;
+		unsigned long long checksum;
+	};
+
+	unsigned long long CalculateChecksum(const PersistentVector<Element>& version)
+	{
+		unsigned long long checksum = 0;
+		version.ForEach([&checksum](const Element& element) { checksum = checksum * 31 + element.id; });
+		return checksum;
+	}
+
+	void TestConcurrentReader(unsigned int tickCount)
+	{
+		SpscRing<Message, 4> ring{};
+		std::atomic<bool> isWriting{ true };
+		unsigned int wrongCount = 0, readCount = 0;
+
+		//Keeps the last few versions around & checks them again later, this thread lets go of them last
+		std::thread reader{ [&]()
+			{
+				std::deque<Message> kept{};
+				for (;;)
+				{
+					const bool isDone = !isWriting.load(std::memory_order_acquire);
+					const Message* pMessage = ring.BeginPop();
+					if (!pMessage)
+					{
+						if (isDone)
+							break;
+						std::this_thread::yield();
+						continue;
+					}
+					kept.push_back(*pMessage);
+					ring.EndPop();
+
+					for (const Message& message : kept)
+					{
+						if (message.version.GetSize() != message.size || CalculateChecksum(message.version) != message.checksum)
+							++wrongCount;
+						++readCount;
+					}
+					if (kept.size() > 8)
+						kept.pop_front();
+				}
+			} };
+
+		RandomStream stream{ 5 };
+		VersionedVector<Element> versioned{};
+		std::vector<Element> reference{};
+		for (unsigned int i = 0; i < 5000; ++i)
+			ChangeBoth(versioned, reference, stream);
+
+		for (unsigned int tick = 0; tick < tickCount;)
+		{
+			Message* pMessage = ring.BeginPush();
+			if (!pMessage)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			pMessage->version = versioned.Publish();
+			pMessage->size = pMessage->version.GetSize();
+			pMessage->checksum = CalculateChecksum(pMessage->version);
+			ring.EndPush();
+			++tick;
+
+			//Changes the nodes the reader's versions share, so they get copied
+			for (unsigned int change = 0; change < 20; ++change)
+				ChangeBoth(versioned, reference, stream);
+		}
+		isWriting.store(false, std::memory_order_release);
+		reader.join();
+
+		TEST_CHECK(wrongCount == 0, "%u of %u reads found a version that changed under the reader", wrongCount, readCount);
+		TEST_CHECK(IsVersionOf(versioned.Publish(), reference), "the vector doesn't hold what was written after the reader stopped");
+		printf("Concurrent reader: %u versions sent, %u reads\n", tickCount, readCount);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const unsigned int scale = Test::HasArgument(argc, argv, "--long") ? 10 : 1;
+	TestDifferential(100000 * scale);
+	TestConcurrentReader(2000 * scale);
+	return Test::Finish("PersistentVectorTest");
+}
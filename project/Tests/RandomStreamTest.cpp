@@ -0,0 +1,282 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include <cmath>
+#include "TestHelpers.h"
+#include "EliteMath/ERandom.h"
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// RANDOM STREAMS
+//-----------------------------------------------------------------
+// RandomStream has to be xoshiro256**: the first draws & a jump from a known state are the
+// ones the reference code gives, then long runs have to match a copy of that code. The lanes
+// of RandomStreamX4 have to be xoshiro128** & give the same bits whether Fill steps them
+// with SSE or one by one. NextInt has to spread its draws evenly, also for a max that
+// doesn't divide 2^32. Built with AVX too, to check that build doesn't change the bits.
+
+namespace
+{
+	//The reference code by Blackman & Vigna, kept apart from ERandom.h on purpose
+	struct Xoshiro256
+	{
+		uint64_t s[4];
+
+		static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+		uint64_t Next()
+		{
+			const uint64_t result = Rotl(s[1] * 5, 7) * 9;
+			const uint64_t t = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = Rotl(s[3], 45);
+			return result;
+		}
+		void Jump()
+		{
+			static const uint64_t JUMP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+			uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				for (int b = 0; b < 64; ++b)
+				{
+					if (JUMP[i] & uint64_t(1) << b)
+					{
+						s0 ^= s[0];
+						s1 ^= s[1];
+						s2 ^= s[2];
+						s3 ^= s[3];
+					}
+					Next();
+				}
+			}
+			s[0] = s0;
+			s[1] = s1;
+			s[2] = s2;
+			s[3] = s3;
+		}
+	};
+
+	struct Xoshiro128
+	{
+		uint32_t s[4];
+
+		static uint32_t Rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+		uint32_t Next()
+		{
+			const uint32_t result = Rotl(s[1] * 5, 7) * 9;
+			const uint32_t t = s[1] << 9;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = Rotl(s[3], 11);
+			return result;
+		}
+	};
+
+	void CheckReferenceVectors()
+	{
+		//From the state {1, 2, 3, 4}, worked out with the reference code
+		const uint64_t firstDraws[6] = { 0x2d00, 0x0, 0x5a007080, 0x10e0000000009d80, 0x10e0b61ce1009d80, 0x870021ce143ad00 };
+		const uint64_t jumpedState[4] = { 0x8c7a153956b5f3d1, 0x701f1a713401d85e, 0x6527f66a65469085, 0x8386b786c4408050 };
+		const uint64_t jumpedDraws[3] = { 0xbbd2f312298443d8, 0x62e57db2d5706577, 0x34d1890374a6d72b };
+
+		RandomStream stream{};
+		stream.SetState({ 1, 2, 3, 4 });
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			const uint64_t draw = stream.Next();
+			TEST_CHECK(draw == firstDraws[i], "draw %u from {1, 2, 3, 4} is %016llx instead of %016llx", i,
+				(unsigned long long)draw, (unsigned long long)firstDraws[i]);
+		}
+
+		stream.SetState({ 1, 2, 3, 4 });
+		stream.Jump();
+		TEST_CHECK(memcmp(stream.GetState(), jumpedState, sizeof(jumpedState)) == 0, "Jump from {1, 2, 3, 4} went somewhere else");
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			const uint64_t draw = stream.Next();
+			TEST_CHECK(draw == jumpedDraws[i], "draw %u after a jump is %016llx instead of %016llx", i,
+				(unsigned long long)draw, (unsigned long long)jumpedDraws[i]);
+		}
+
+		//The lanes, each from {1, 2, 3, 4}, a Fill over [0, 2^24) gives the 24 bits it keeps of every draw
+		const float firstLaneValues[6] = { 45.f, 0.f, 23152.f, 276637.f, 7936413.f, 6395451.f };
+		uint32_t laneStates[16]{};
+		for (unsigned int word = 0; word < 4; ++word)
+		{
+			for (unsigned int lane = 0; lane < 4; ++lane)
+				laneStates[word * 4 + lane] = word + 1;
+		}
+		RandomStream seedStream{};
+		RandomStreamX4 streamX4{ seedStream };
+		streamX4.SetState(laneStates);
+		float values[24];
+		streamX4.Fill(values, 24, 0.f, 16777216.f);
+		unsigned int wrongCount = 0;
+		for (unsigned int i = 0; i < 24; ++i)
+		{
+			if (values[i] != firstLaneValues[i / 4])
+				++wrongCount;
+		}
+		TEST_CHECK(wrongCount == 0, "%u of the first 24 lane values from {1, 2, 3, 4} aren't xoshiro128**'s", wrongCount);
+	}
+
+	void CheckLongRuns()
+	{
+		unsigned int wrongCount = 0;
+		for (uint64_t seed : { uint64_t(0), uint64_t(42), RandomStream::DefaultSeed })
+		{
+			RandomStream stream{ seed };
+			Xoshiro256 reference{};
+			memcpy(reference.s, stream.GetState(), sizeof(reference.s));
+			for (unsigned int jump = 0; jump < 3; ++jump)
+			{
+				for (unsigned int i = 0; i < 100000; ++i)
+				{
+					if (stream.Next() != reference.Next())
+						++wrongCount;
+				}
+				stream.Jump();
+				reference.Jump();
+			}
+
+			//A stream index is that many jumps
+			RandomStream jumped{ seed };
+			for (unsigned int i = 0; i < 5; ++i)
+				jumped.Jump();
+			const RandomStream created = RandomStream::CreateStream(seed, 5);
+			TEST_CHECK(memcmp(jumped.GetState(), created.GetState(), 4 * sizeof(uint64_t)) == 0, "CreateStream(%llu, 5) isn't 5 jumps", (unsigned long long)seed);
+		}
+		TEST_CHECK(wrongCount == 0, "%u draws differ from the reference xoshiro256**", wrongCount);
+	}
+
+	//Fill in pieces of every size, the SSE loop & the lane by lane tail both take turns
+	void CheckFillLanes()
+	{
+		RandomStream seedStream{ 9 };
+		RandomStreamX4 streamX4{ seedStream };
+		Xoshiro128 lanes[4]{};
+		for (unsigned int word = 0; word < 4; ++word)
+		{
+			for (unsigned int lane = 0; lane < 4; ++lane)
+				lanes[lane].s[word] = streamX4.GetState()[word * 4 + lane];
+		}
+
+		const float min = -2.f, max = 3.f;
+		const float scale = (max - min) * (1.f / 16777216.f);
+		std::vector<float> values(4096);
+		unsigned int wrongCount = 0, valueCount = 0;
+		for (unsigned int count = 0; count <= 1031; count += (count < 64 ? 1 : 97))
+		{
+			streamX4.Fill(values.data(), count, min, max);
+			//Every 4 values are a step of all lanes, the values past count of the last step are dropped
+			for (unsigned int i = 0; i < count; i += 4)
+			{
+				for (unsigned int lane = 0; lane < 4; ++lane)
+				{
+					const float expected = min + float(int(lanes[lane].Next() >> 8)) * scale;
+					if (i + lane < count && values[i + lane] != expected)
+						++wrongCount;
+				}
+			}
+			valueCount += count;
+		}
+		TEST_CHECK(wrongCount == 0, "%u of %u filled values aren't the lanes' xoshiro128** draws", wrongCount, valueCount);
+
+		//Range & mean of a long fill
+		std::vector<float> longFill(1000003);
+		streamX4.Fill(longFill.data(), unsigned(longFill.size()), min, max);
+		double sum = 0.0;
+		unsigned int outsideCount = 0;
+		for (const float value : longFill)
+		{
+			sum += value;
+			if (value < min || value >= max)
+				++outsideCount;
+		}
+		const double mean = sum / longFill.size();
+		TEST_CHECK(outsideCount == 0, "%u filled values outside [%g, %g)", outsideCount, min, max);
+		TEST_CHECK(fabs(mean - 0.5) < 0.01, "the mean of a long fill is %g instead of 0.5", mean);
+	}
+
+	//Chi-square of drawCount draws over bucketCount buckets of [0, max)
+	double CalculateChiSquare(RandomStream& stream, int max, unsigned int bucketCount, unsigned int drawCount, unsigned int& outsideCount)
+	{
+		std::vector<unsigned int> counts(bucketCount, 0);
+		for (unsigned int i = 0; i < drawCount; ++i)
+		{
+			const int value = stream.NextInt(max);
+			if (value < 0 || value >= max)
+			{
+				++outsideCount;
+				continue;
+			}
+			++counts[unsigned(uint64_t(value) * bucketCount / unsigned(max))];
+		}
+
+		//Buckets of equal width, the last one may hold a value less when max doesn't divide evenly
+		double chiSquare = 0.0;
+		for (unsigned int bucket = 0; bucket < bucketCount; ++bucket)
+		{
+			const uint64_t first = (uint64_t(bucket) * unsigned(max) + bucketCount - 1) / bucketCount;
+			const uint64_t end = (uint64_t(bucket + 1) * unsigned(max) + bucketCount - 1) / bucketCount;
+			const double expected = double(drawCount) * double(end - first) / max;
+			chiSquare += (counts[bucket] - expected) * (counts[bucket] - expected) / expected;
+		}
+		return chiSquare;
+	}
+
+	void CheckNextInt()
+	{
+		//Limits a bit past the 0.1% tail of chi-square for the buckets' degrees of freedom
+		struct Case
+		{
+			int max;
+			unsigned int bucketCount;
+			double limit;
+		};
+		//A third of 2^32 & more is where rand() % max would favor the low values twice over
+		const Case cases[] = { { 2, 2, 10.8 }, { 6, 6, 20.5 }, { 7, 7, 22.5 }, { 1000, 1000, 1143.0 },
+			{ 1431655765, 3, 13.8 }, { 0x60000000, 16, 37.7 }, { 0x7FFFFFFF, 64, 103.4 } };
+
+		RandomStream stream{ 1 };
+		unsigned int outsideCount = 0;
+		for (const Case& c : cases)
+		{
+			const double chiSquare = CalculateChiSquare(stream, c.max, c.bucketCount, 2000000, outsideCount);
+			TEST_CHECK(chiSquare < c.limit, "NextInt(%d) over %u buckets has a chi-square of %.1f, over %.1f", c.max, c.bucketCount, chiSquare, c.limit);
+			printf("NextInt(%d): chi-square %.1f over %u buckets\n", c.max, chiSquare, c.bucketCount);
+		}
+		TEST_CHECK(outsideCount == 0, "%u draws of NextInt fell outside [0, max)", outsideCount);
+
+		unsigned int nonZeroCount = 0;
+		for (unsigned int i = 0; i < 1000; ++i)
+			nonZeroCount += stream.NextInt(1) != 0;
+		TEST_CHECK(nonZeroCount == 0, "NextInt(1) wasn't 0 %u times", nonZeroCount);
+	}
+}
+
+int main()
+{
+	if (!Test::CanRunAvx())
+	{
+		printf("Built with AVX lanes but this CPU has no AVX, skipped\n");
+		return Test::SkipReturnCode;
+	}
+#if defined(ELITE_FAST_MATH_SSE)
+	printf("RandomStreamX4 fills with SSE\n");
+#else
+	printf("RandomStreamX4 fills lane by lane\n");
+#endif
+
+	CheckReferenceVectors();
+	CheckLongRuns();
+	CheckFillLanes();
+	CheckNextInt();
+	return Test::Finish("RandomStreamTest");
+}
@@ -0,0 +1,104 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// TestHelpers.h: Checks & timing shared by the tests & benchmarks
+/*=============================================================================*/
+#pragma once
+#include <cstdio>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "EProfiler.h"
+
+namespace Test
+{
+	//ctest reports a test that returns this as skipped instead of failed
+	const int SkipReturnCode = 77;
+
+	inline unsigned int& GetFailureCount()
+	{
+		static unsigned int s_FailureCount = 0;
+		return s_FailureCount;
+	}
+
+	//Exit code of the test, prints how it went
+	inline int Finish(const char* testName)
+	{
+		const unsigned int failures = GetFailureCount();
+		if (failures == 0)
+			printf("%s: passed\n", testName);
+		else
+			printf("%s: %u checks failed\n", testName, failures);
+		return failures == 0 ? 0 : 1;
+	}
+
+	//Whether a build with AVX lanes can run here, tests built without them always can
+	inline bool CanRunAvx()
+	{
+#if !defined(ELITE_FAST_MATH_AVX)
+		return true;
+#elif defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		const bool hasAvx = (info[2] & (1 << 28)) != 0;
+		const bool hasXsave = (info[2] & (1 << 27)) != 0;
+		return hasAvx && hasXsave && (_xgetbv(0) & 6) == 6;
+#else
+		return __builtin_cpu_supports("avx") != 0;
+#endif
+	}
+
+	inline bool HasArgument(int argc, char* argv[], const char* argument)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			if (strcmp(argv[i], argument) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	//Nanoseconds per element of the fastest of a few runs, every run handles elementCount elements
+	template<typename Function>
+	double MeasureNanoseconds(unsigned int elementCount, Function function, unsigned int runs = 20)
+	{
+		double fastest = 1e30;
+		for (unsigned int run = 0; run < runs; ++run)
+		{
+			const Elite::ProfileClock::time_point start = Elite::ProfileClock::now();
+			function();
+			const double nanoseconds = Elite::ElapsedMicroseconds(start) * 1000.0 / elementCount;
+			if (nanoseconds < fastest)
+				fastest = nanoseconds;
+		}
+		return fastest;
+	}
+
+	inline volatile unsigned char& GetSink()
+	{
+		static volatile unsigned char s_Sink = 0;
+		return s_Sink;
+	}
+	//Keeps the optimizer from dropping work whose result is never read
+	template<typename T>
+	void KeepAlive(const T& value)
+	{
+		unsigned char bytes[sizeof(T)];
+		memcpy(bytes, &value, sizeof(T));
+		GetSink() = bytes[0];
+	}
+}
+
+//Counts a failure & says where, the test goes on so every failing check gets printed
+#define TEST_CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			++Test::GetFailureCount(); \
+			printf("%s(%d): check failed: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+		} \
+	} while (false)
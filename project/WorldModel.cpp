@@ -0,0 +1,148 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "WorldModel.h"
+#include "Inventory.h"
+#include "PurgeZoneMemory.h"
+#include "HouseRegistry.h"
+#include "ItemMemory.h"
+
+//-----------------------------------------------------------------
+// WORLD SNAPSHOT
+//-----------------------------------------------------------------
+bool WorldSnapshot::IsWorthVisiting(unsigned int house) const
+{
+	return time - houses[house].lastVisitTime > HouseRegistry::RespawnTime;
+}
+
+bool WorldSnapshot::IsInPurgeZone(const Elite::Vector2& position) const
+{
+	bool isInside = false;
+	purgeZones.ForEach([&position, &isInside](const PurgeZoneInfo& zone)
+		{
+			isInside |= DistanceSquared(position, zone.Center) < zone.Radius * zone.Radius;
+		});
+	return isInside;
+}
+
+float WorldSnapshot::GetDanger(const Elite::Vector2& position) const
+{
+	unsigned int tile = 0, cell = 0;
+	if (!influenceGrid.GetCell(position, tile, cell))
+		return 0.f;
+
+	const InfluenceMap::TileState& state = influenceTiles[tile];
+	if (state.peak == 0.f)
+		return 0.f;
+	const float value = influenceRows[tile * InfluenceMap::TileSize + cell / InfluenceMap::TileSize].values[cell % InfluenceMap::TileSize];
+	return value * influenceGrid.GetDecay(time - state.time);
+}
+
+float WorldSnapshot::GetPathDanger(const Elite::Vector2& from, const Elite::Vector2& to) const
+{
+	return InfluenceMap::Grid::IntegrateDanger(from, to, [this](const Elite::Vector2& position) { return GetDanger(position); });
+}
+
+//-----------------------------------------------------------------
+// WORLD MODEL
+//-----------------------------------------------------------------
+void WorldModel::SetHouseVisited(unsigned int house, float time)
+{
+	KnownHouse knownHouse = m_Houses[house];
+	knownHouse.lastVisitTime = time;
+	m_Houses.Set(house, knownHouse);
+}
+
+void WorldModel::SetPurgeZones(const PurgeZoneMemory& purgeZones)
+{
+	const unsigned int zoneCount = purgeZones.GetZoneCount();
+	for (unsigned int zone = 0; zone < zoneCount; ++zone)
+	{
+		const PurgeZoneInfo zoneInfo = purgeZones.GetZone(zone);
+		if (zone >= m_PurgeZones.GetSize())
+			m_PurgeZones.PushBack(zoneInfo);
+		else if (m_PurgeZones[zone].ZoneHash != zoneInfo.ZoneHash)
+			m_PurgeZones.Set(zone, zoneInfo);
+	}
+	m_PurgeZones.Resize(zoneCount);
+}
+
+void WorldModel::SetInfluenceTiles(InfluenceMap& influenceMap)
+{
+	//A leaf holds the rows of two tiles, so a changed tile copies twice its size instead of the grid
+	const unsigned int tileCount = influenceMap.GetGrid().GetTileCount();
+	m_InfluenceGrid = influenceMap.GetGrid();
+	if (m_InfluenceTiles.GetSize() != tileCount)
+	{
+		m_InfluenceTiles.Clear();
+		m_InfluenceTiles.Resize(tileCount);
+		m_InfluenceRows.Clear();
+		m_InfluenceRows.Resize(tileCount * InfluenceMap::TileSize);
+	}
+
+	for (const unsigned int tile : influenceMap.GetChangedTiles())
+	{
+		m_InfluenceTiles.Set(tile, influenceMap.GetTileState(tile));
+		const float* pValues = influenceMap.GetTileValues(tile);
+		for (unsigned int row = 0; row < InfluenceMap::TileSize; ++row)
+		{
+			InfluenceMap::TileRow tileRow{};
+			std::copy(pValues + row * InfluenceMap::TileSize, pValues + (row + 1) * InfluenceMap::TileSize, tileRow.values);
+			m_InfluenceRows.Set(tile * InfluenceMap::TileSize + row, tileRow);
+		}
+	}
+	influenceMap.ClearChangedTiles();
+}
+
+void WorldModel::Rebuild(const ItemMemory& itemMemory, const HouseRegistry& houseRegistry, const PurgeZoneMemory& purgeZones)
+{
+	m_Items.Clear();
+	for (unsigned int item = 0; item < itemMemory.GetCount(); ++item)
+		m_Items.PushBack(itemMemory.GetItem(item));
+
+	m_Houses.Clear();
+	for (unsigned int house = 0; house < houseRegistry.GetHouseCount(); ++house)
+		m_Houses.PushBack(KnownHouse{ houseRegistry.GetHouse(house), houseRegistry.GetLastVisitTime(house) });
+
+	m_PurgeZones.Clear();
+	SetPurgeZones(purgeZones);
+}
+
+const WorldSnapshot& WorldModel::Publish(float time, const AgentInfo& agentInfo, const Inventory& inventory,
+	const std::vector<ItemInfo>& itemsInFOV, const std::list<EnemyInfo>& enemiesInFOV)
+{
+	//What's in sight is new every tick
+	m_ItemsInFOV.Clear();
+	for (const ItemInfo& item : itemsInFOV)
+		m_ItemsInFOV.PushBack(item);
+	m_EnemiesInFOV.Clear();
+	for (const EnemyInfo& enemy : enemiesInFOV)
+		m_EnemiesInFOV.PushBack(enemy);
+
+	m_Latest.version += 1;
+	m_Latest.time = time;
+	m_Latest.agentInfo = agentInfo;
+	m_Latest.neededTypes = 0;
+	for (unsigned int type = 0; type <= static_cast<unsigned int>(eItemType::GARBAGE); ++type)
+	{
+		if (inventory.NeedsItem(static_cast<eItemType>(type)))
+			m_Latest.neededTypes |= 1u << type;
+	}
+
+	m_Latest.items = m_Items.Publish();
+	m_Latest.houses = m_Houses.Publish();
+	m_Latest.purgeZones = m_PurgeZones.Publish();
+	m_Latest.itemsInFOV = m_ItemsInFOV.Publish();
+	m_Latest.enemiesInFOV = m_EnemiesInFOV.Publish();
+	m_Latest.influenceGrid = m_InfluenceGrid;
+	m_Latest.influenceTiles = m_InfluenceTiles.Publish();
+	m_Latest.influenceRows = m_InfluenceRows.Publish();
+	return m_Latest;
+}
+
+void WorldModel::PrintReport() const
+{
+	const unsigned int copiedNodes = m_Items.GetCopiedNodeCount() + m_Houses.GetCopiedNodeCount() + m_PurgeZones.GetCopiedNodeCount()
+		+ m_InfluenceTiles.GetCopiedNodeCount() + m_InfluenceRows.GetCopiedNodeCount();
+	printf("World model: %u versions, %u items, %u shared nodes copied (%.2f per version)\n", m_Latest.version,
+		m_Items.GetSize(), copiedNodes, m_Latest.version > 0 ? float(copiedNodes) / m_Latest.version : 0.f);
+}
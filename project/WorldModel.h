@@ -0,0 +1,94 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// WorldModel.h: Versioned copy of what the agent knows, for readers on other threads
+/*=============================================================================*/
+#pragma once
+#include "Exam_HelperStructs.h"
+#include "EPersistentVector.h"
+#include "InfluenceMap.h"
+
+class Inventory;
+class PurgeZoneMemory;
+class ItemMemory;
+class HouseRegistry;
+
+//-----------------------------------------------------------------
+// WORLD SNAPSHOT
+//-----------------------------------------------------------------
+struct KnownHouse
+{
+	HouseInfo info;
+	float lastVisitTime; //-FLT_MAX if never visited
+};
+
+//One version of the world model, copying it is cheap & it never changes afterwards
+struct WorldSnapshot
+{
+	unsigned int version = 0;
+	float time = 0.f;
+	AgentInfo agentInfo = {};
+	unsigned int neededTypes = 0; //Bit (1 << type) is set for every item type the inventory has room for
+
+	Elite::PersistentVector<ItemInfo> items = {}; //Remembered items, same order as the ItemMemory
+	Elite::PersistentVector<KnownHouse> houses = {}; //Same order as the HouseRegistry
+	Elite::PersistentVector<PurgeZoneInfo> purgeZones = {}; //Remembered ones
+	Elite::PersistentVector<ItemInfo> itemsInFOV = {};
+	Elite::PersistentVector<EnemyInfo> enemiesInFOV = {};
+
+	//The influence map's tiles as of this version, read at time
+	InfluenceMap::Grid influenceGrid = {};
+	Elite::PersistentVector<InfluenceMap::TileState> influenceTiles = {};
+	Elite::PersistentVector<InfluenceMap::TileRow> influenceRows = {}; //TileSize rows per tile, tile after tile
+
+	bool NeedsItem(eItemType type) const { return (neededTypes & (1u << static_cast<unsigned int>(type))) != 0; }
+	bool IsWorthVisiting(unsigned int house) const;
+	bool IsInPurgeZone(const Elite::Vector2& position) const;
+	//Same as the InfluenceMap's
+	float GetDanger(const Elite::Vector2& position) const;
+	float GetPathDanger(const Elite::Vector2& from, const Elite::Vector2& to) const;
+};
+
+//-----------------------------------------------------------------
+// WORLD MODEL
+//-----------------------------------------------------------------
+// Mirrors the changes the tick makes to the memories, publishing a version costs
+// what changed since the previous one instead of a copy of everything. Each part
+// is only written by the tick phase that owns the memory it mirrors, so phases that
+// run in parallel never touch the same part.
+class WorldModel final
+{
+public:
+	//Item memory phase & behaviors, in the order the ItemMemory saw them
+	void AddItem(const ItemInfo& item) { m_Items.PushBack(item); }
+	void RemoveItem(unsigned int index) { m_Items.RemoveSwap(index); }
+
+	void AddHouse(const HouseInfo& house) { m_Houses.PushBack(KnownHouse{ house, -FLT_MAX }); }
+	//House registry phase
+	void SetHouseVisited(unsigned int house, float time);
+	//Purge zone phase, only writes zones that changed
+	void SetPurgeZones(const PurgeZoneMemory& purgeZones);
+	//Influence map phase, copies the tiles the map changed & clears its list of them
+	void SetInfluenceTiles(InfluenceMap& influenceMap);
+	//Starts over from the memories, after they were restored from a checkpoint
+	void Rebuild(const ItemMemory& itemMemory, const HouseRegistry& houseRegistry, const PurgeZoneMemory& purgeZones);
+
+	//Once every phase is done, the snapshot stays valid until the next call
+	const WorldSnapshot& Publish(float time, const AgentInfo& agentInfo, const Inventory& inventory,
+		const std::vector<ItemInfo>& itemsInFOV, const std::list<EnemyInfo>& enemiesInFOV);
+	const WorldSnapshot& GetLatest() const { return m_Latest; }
+
+	void PrintReport() const;
+
+private:
+	Elite::VersionedVector<ItemInfo> m_Items{};
+	Elite::VersionedVector<KnownHouse> m_Houses{};
+	Elite::VersionedVector<PurgeZoneInfo> m_PurgeZones{};
+	Elite::VersionedVector<ItemInfo> m_ItemsInFOV{};
+	Elite::VersionedVector<EnemyInfo> m_EnemiesInFOV{};
+	InfluenceMap::Grid m_InfluenceGrid{};
+	Elite::VersionedVector<InfluenceMap::TileState> m_InfluenceTiles{};
+	Elite::VersionedVector<InfluenceMap::TileRow> m_InfluenceRows{};
+
+	WorldSnapshot m_Latest{};
+};